@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include "os/mynewt.h"
+#include "console/console.h"
+#include "crc/crc8.h"
+#include "crc/crc16.h"
+#include "crc/crc32.h"
+
+/*
+ * Computes each CRC over the same buffer with 1, 4 and 8 bytes per lookup
+ * round and prints the throughput.  The result of every variant is checked
+ * against the byte-at-a-time one.
+ */
+
+static uint8_t crc_bench_buf[MYNEWT_VAL(CRC_BENCH_BUF_SIZE)];
+
+static const int crc_bench_slices[] = { 1, 4, 8 };
+
+static uint32_t
+crc_bench_crc8(int slices)
+{
+    return crc8_calc_sliced(crc8_init(), crc_bench_buf, sizeof crc_bench_buf,
+                            slices);
+}
+
+static uint32_t
+crc_bench_crc16(int slices)
+{
+    return crc16_ccitt_sliced(CRC16_INITIAL_CRC, crc_bench_buf,
+                              sizeof crc_bench_buf, slices);
+}
+
+static uint32_t
+crc_bench_crc32_ieee(int slices)
+{
+    return crc32_ieee_sliced(CRC32_INITIAL_CRC, crc_bench_buf,
+                             sizeof crc_bench_buf, slices);
+}
+
+static uint32_t
+crc_bench_crc32c(int slices)
+{
+    return crc32c_sliced(CRC32_INITIAL_CRC, crc_bench_buf,
+                         sizeof crc_bench_buf, slices);
+}
+
+static const struct {
+    const char *name;
+    uint32_t (*fn)(int slices);
+} crc_bench_algs[] = {
+    { "crc8", crc_bench_crc8 },
+    { "crc16-ccitt", crc_bench_crc16 },
+    { "crc32-ieee", crc_bench_crc32_ieee },
+    { "crc32c", crc_bench_crc32c },
+};
+
+static void
+crc_bench_run(void)
+{
+    uint32_t expected;
+    uint32_t start;
+    uint32_t usecs;
+    uint32_t crc;
+    int i;
+    int j;
+    int k;
+
+    console_printf("%d bytes x %d passes\n", (int)sizeof crc_bench_buf,
+                   MYNEWT_VAL(CRC_BENCH_ITERATIONS));
+
+    for (i = 0; i < ARRAY_SIZE(crc_bench_algs); i++) {
+        expected = crc_bench_algs[i].fn(1);
+
+        for (j = 0; j < ARRAY_SIZE(crc_bench_slices); j++) {
+            crc = 0;
+            start = os_cputime_get32();
+            for (k = 0; k < MYNEWT_VAL(CRC_BENCH_ITERATIONS); k++) {
+                crc = crc_bench_algs[i].fn(crc_bench_slices[j]);
+            }
+            usecs = os_cputime_ticks_to_usecs(os_cputime_get32() - start);
+            assert(crc == expected);
+
+            console_printf("%-12s slice-by-%d: %8lu us, %6lu kB/s\n",
+                           crc_bench_algs[i].name, crc_bench_slices[j],
+                           (unsigned long)usecs,
+                           (unsigned long)((uint64_t)sizeof crc_bench_buf *
+                                           MYNEWT_VAL(CRC_BENCH_ITERATIONS) *
+                                           1000000 / 1024 / max(usecs, 1)));
+        }
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    uint32_t x;
+    int i;
+
+    sysinit();
+
+    x = 1;
+    for (i = 0; i < sizeof crc_bench_buf; i++) {
+        x = x * 1103515245 + 12345;
+        crc_bench_buf[i] = x >> 16;
+    }
+
+    crc_bench_run();
+
+    while (1) {
+        os_eventq_run(os_eventq_dflt_get());
+    }
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include "os/mynewt.h"
+#include "console/console.h"
+
+/*
+ * Measures an event put followed by a get from the same queue, once through
+ * a producer ring and once with os_eventq_put().  Nothing blocks, so this
+ * only compares the queueing paths.
+ */
+
+#define EVQ_RING_BENCH_ITERS    MYNEWT_VAL(EVQ_RING_BENCH_ITERS)
+#define EVQ_RING_BENCH_SIZE     MYNEWT_VAL(EVQ_RING_BENCH_RING_SIZE)
+
+static struct os_eventq evq_ring_bench_evq;
+static struct os_eventq_ring evq_ring_bench_ring;
+static struct os_event *evq_ring_bench_buf[EVQ_RING_BENCH_SIZE];
+static struct os_event evq_ring_bench_ev;
+
+static uint32_t
+evq_ring_bench_run(bool ring)
+{
+    uint32_t start;
+    int i;
+
+    start = os_cputime_get32();
+    for (i = 0; i < EVQ_RING_BENCH_ITERS; i++) {
+        if (ring) {
+            os_eventq_ring_put(&evq_ring_bench_ring, &evq_ring_bench_ev);
+        } else {
+            os_eventq_put(&evq_ring_bench_evq, &evq_ring_bench_ev);
+        }
+        os_eventq_get_no_wait(&evq_ring_bench_evq);
+    }
+
+    return os_cputime_get32() - start;
+}
+
+int
+main(int argc, char **argv)
+{
+    uint32_t ring_ticks;
+    uint32_t put_ticks;
+    int rc;
+
+    sysinit();
+
+    os_eventq_init(&evq_ring_bench_evq);
+    rc = os_eventq_ring_init(&evq_ring_bench_evq, &evq_ring_bench_ring,
+                             evq_ring_bench_buf, EVQ_RING_BENCH_SIZE);
+    assert(rc == 0);
+
+    ring_ticks = evq_ring_bench_run(true);
+    put_ticks = evq_ring_bench_run(false);
+
+    console_printf("os_eventq: %d put/get: ring %lu us, os_eventq_put %lu us\n",
+                   EVQ_RING_BENCH_ITERS,
+                   (unsigned long)os_cputime_ticks_to_usecs(ring_ticks),
+                   (unsigned long)os_cputime_ticks_to_usecs(put_ticks));
+
+    while (1) {
+        os_eventq_run(os_eventq_dflt_get());
+    }
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "os/mynewt.h"
+#include "console/console.h"
+#include "crc/crc32.h"
+#include "executor/executor.h"
+
+/*
+ * Hashes EXECUTOR_BENCH_BLOCKS blocks of data with CRC-32, first in the
+ * main task alone, then spread over the workers of an executor: once with a
+ * job per block, and twice with executor_parallel_for().  Each measurement
+ * repeats EXECUTOR_BENCH_ROUNDS times.
+ *
+ * The workers run below the main task, so the main task queues all the work
+ * before the workers start on it.  On a single core, jobs only take turns on
+ * the CPU; the difference from the single task figure is the cost of the
+ * executor.
+ */
+
+#define EXECUTOR_BENCH_NUM_BLOCKS   MYNEWT_VAL(EXECUTOR_BENCH_BLOCKS)
+#define EXECUTOR_BENCH_BLOCK_SIZE   MYNEWT_VAL(EXECUTOR_BENCH_BLOCK_SIZE)
+#define EXECUTOR_BENCH_NUM_ROUNDS   MYNEWT_VAL(EXECUTOR_BENCH_ROUNDS)
+#define EXECUTOR_BENCH_NUM_WORKERS  MYNEWT_VAL(EXECUTOR_BENCH_WORKERS)
+#define EXECUTOR_BENCH_STACK_SIZE   OS_STACK_ALIGN(256)
+
+struct executor_bench_worker {
+    struct executor_worker worker;
+    os_stack_t stack[EXECUTOR_BENCH_STACK_SIZE];
+};
+
+static struct executor executor_bench_ex;
+static struct executor_bench_worker
+    executor_bench_workers[EXECUTOR_BENCH_NUM_WORKERS];
+
+static uint8_t executor_bench_data[EXECUTOR_BENCH_NUM_BLOCKS]
+                                  [EXECUTOR_BENCH_BLOCK_SIZE];
+static uint32_t executor_bench_hash[EXECUTOR_BENCH_NUM_BLOCKS];
+static uint32_t executor_bench_expected[EXECUTOR_BENCH_NUM_BLOCKS];
+static struct executor_job executor_bench_jobs[EXECUTOR_BENCH_NUM_BLOCKS];
+
+static void
+executor_bench_hash_block(uint32_t idx)
+{
+    executor_bench_hash[idx] = crc32_ieee(0, executor_bench_data[idx],
+                                          EXECUTOR_BENCH_BLOCK_SIZE);
+}
+
+static int
+executor_bench_job(void *arg)
+{
+    executor_bench_hash_block((uintptr_t)arg);
+    return 0;
+}
+
+static void
+executor_bench_range(uint32_t start, uint32_t end, void *arg)
+{
+    uint32_t i;
+
+    for (i = start; i < end; i++) {
+        executor_bench_hash_block(i);
+    }
+}
+
+static void
+executor_bench_round_single(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < EXECUTOR_BENCH_NUM_BLOCKS; i++) {
+        executor_bench_hash_block(i);
+    }
+}
+
+static void
+executor_bench_round_jobs(void)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < EXECUTOR_BENCH_NUM_BLOCKS; i++) {
+        rc = executor_submit(&executor_bench_ex, &executor_bench_jobs[i]);
+        assert(rc == 0);
+    }
+    for (i = 0; i < EXECUTOR_BENCH_NUM_BLOCKS; i++) {
+        rc = executor_join(&executor_bench_jobs[i], OS_TIMEOUT_NEVER, NULL);
+        assert(rc == 0);
+    }
+}
+
+static void
+executor_bench_round_for_1(void)
+{
+    executor_parallel_for(&executor_bench_ex, EXECUTOR_BENCH_NUM_BLOCKS, 1,
+                          executor_bench_range, NULL);
+}
+
+static void
+executor_bench_round_for_even(void)
+{
+    executor_parallel_for(&executor_bench_ex, EXECUTOR_BENCH_NUM_BLOCKS, 0,
+                          executor_bench_range, NULL);
+}
+
+static void
+executor_bench_run(const char *name, void (*round)(void))
+{
+    uint32_t start;
+    uint32_t usecs;
+    uint64_t bytes;
+    int i;
+
+    memset(executor_bench_hash, 0, sizeof executor_bench_hash);
+
+    start = os_cputime_get32();
+    for (i = 0; i < EXECUTOR_BENCH_NUM_ROUNDS; i++) {
+        round();
+    }
+    usecs = os_cputime_ticks_to_usecs(os_cputime_get32() - start);
+
+    assert(memcmp(executor_bench_hash, executor_bench_expected,
+                  sizeof executor_bench_hash) == 0);
+
+    bytes = (uint64_t)EXECUTOR_BENCH_NUM_ROUNDS * EXECUTOR_BENCH_NUM_BLOCKS *
+            EXECUTOR_BENCH_BLOCK_SIZE;
+    console_printf("%-20s: %8lu us, %8lu blocks/s, %6lu KB/s\n",
+                   name, (unsigned long)usecs,
+                   (unsigned long)((uint64_t)EXECUTOR_BENCH_NUM_ROUNDS *
+                                   EXECUTOR_BENCH_NUM_BLOCKS * 1000000 /
+                                   max(usecs, 1)),
+                   (unsigned long)(bytes * 1000000 / 1024 / max(usecs, 1)));
+}
+
+static void
+executor_bench_init(void)
+{
+    struct executor_bench_worker *w;
+    uint32_t i;
+    int rc;
+
+    for (i = 0; i < EXECUTOR_BENCH_NUM_BLOCKS; i++) {
+        memset(executor_bench_data[i], i, EXECUTOR_BENCH_BLOCK_SIZE);
+        executor_bench_expected[i] = crc32_ieee(0, executor_bench_data[i],
+                                                EXECUTOR_BENCH_BLOCK_SIZE);
+        executor_job_init(&executor_bench_jobs[i], executor_bench_job,
+                          (void *)(uintptr_t)i);
+    }
+
+    rc = executor_init(&executor_bench_ex);
+    assert(rc == 0);
+
+    for (i = 0; i < EXECUTOR_BENCH_NUM_WORKERS; i++) {
+        w = &executor_bench_workers[i];
+        rc = executor_add_worker(&executor_bench_ex, &w->worker,
+                                 "executor_bench",
+                                 MYNEWT_VAL(OS_MAIN_TASK_PRIO) + 1 + i,
+                                 w->stack, EXECUTOR_BENCH_STACK_SIZE);
+        assert(rc == 0);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    sysinit();
+
+    executor_bench_init();
+
+    console_printf("%d rounds of %d blocks of %d bytes, %d workers\n",
+                   EXECUTOR_BENCH_NUM_ROUNDS, EXECUTOR_BENCH_NUM_BLOCKS,
+                   EXECUTOR_BENCH_BLOCK_SIZE, EXECUTOR_BENCH_NUM_WORKERS);
+
+    executor_bench_run("single task", executor_bench_round_single);
+    executor_bench_run("job per block", executor_bench_round_jobs);
+    executor_bench_run("parallel for, 1", executor_bench_round_for_1);
+    executor_bench_run("parallel for, even", executor_bench_round_for_even);
+
+    while (1) {
+        os_eventq_run(os_eventq_dflt_get());
+    }
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include "os/mynewt.h"
+#include "console/console.h"
+
+/*
+ * Reads a packet as a sequence of 4-byte fields, once with an
+ * os_mbuf_copydata() call per field, which walks the chain from the head
+ * every time, and once with an os_mbuf_cursor, which continues from where
+ * the previous read stopped.
+ */
+
+#define MBUF_CURSOR_BENCH_PKT_LEN   MYNEWT_VAL(MBUF_CURSOR_BENCH_PKT_LEN)
+#define MBUF_CURSOR_BENCH_BUF_DATA  MYNEWT_VAL(MBUF_CURSOR_BENCH_BUF_DATA)
+#define MBUF_CURSOR_BENCH_ITERS     MYNEWT_VAL(MBUF_CURSOR_BENCH_ITERS)
+#define MBUF_CURSOR_BENCH_BUF_SIZE  \
+    (MBUF_CURSOR_BENCH_BUF_DATA + sizeof(struct os_mbuf) + \
+     sizeof(struct os_mbuf_pkthdr))
+#define MBUF_CURSOR_BENCH_BUF_COUNT \
+    (MBUF_CURSOR_BENCH_PKT_LEN / MBUF_CURSOR_BENCH_BUF_DATA + 1)
+
+static os_membuf_t mbuf_cursor_bench_mem[
+    OS_MEMPOOL_SIZE(MBUF_CURSOR_BENCH_BUF_COUNT, MBUF_CURSOR_BENCH_BUF_SIZE)];
+static struct os_mempool mbuf_cursor_bench_mempool;
+static struct os_mbuf_pool mbuf_cursor_bench_mbuf_pool;
+
+static uint32_t
+mbuf_cursor_bench_sum_copydata(const struct os_mbuf *om)
+{
+    uint32_t field;
+    uint32_t sum;
+    int off;
+
+    sum = 0;
+    for (off = 0; off < MBUF_CURSOR_BENCH_PKT_LEN; off += sizeof field) {
+        os_mbuf_copydata(om, off, sizeof field, &field);
+        sum += field;
+    }
+
+    return sum;
+}
+
+static uint32_t
+mbuf_cursor_bench_sum_cursor(struct os_mbuf *om)
+{
+    struct os_mbuf_cursor omc;
+    uint32_t field;
+    uint32_t sum;
+
+    sum = 0;
+    os_mbuf_cursor_init(&omc, om);
+    while (os_mbuf_cursor_read(&omc, &field, sizeof field) == 0) {
+        sum += field;
+    }
+
+    return sum;
+}
+
+static struct os_mbuf *
+mbuf_cursor_bench_pkt(void)
+{
+    struct os_mbuf *om;
+    uint32_t val;
+    int rc;
+
+    rc = os_mempool_init(&mbuf_cursor_bench_mempool,
+                         MBUF_CURSOR_BENCH_BUF_COUNT,
+                         MBUF_CURSOR_BENCH_BUF_SIZE, mbuf_cursor_bench_mem,
+                         "mbuf_cursor_bench");
+    assert(rc == 0);
+    rc = os_mbuf_pool_init(&mbuf_cursor_bench_mbuf_pool,
+                           &mbuf_cursor_bench_mempool,
+                           MBUF_CURSOR_BENCH_BUF_SIZE,
+                           MBUF_CURSOR_BENCH_BUF_COUNT);
+    assert(rc == 0);
+
+    om = os_mbuf_get_pkthdr(&mbuf_cursor_bench_mbuf_pool, 0);
+    assert(om != NULL);
+    for (val = 0; OS_MBUF_PKTLEN(om) < MBUF_CURSOR_BENCH_PKT_LEN; val++) {
+        rc = os_mbuf_append(om, &val, sizeof val);
+        assert(rc == 0);
+    }
+
+    return om;
+}
+
+int
+main(int argc, char **argv)
+{
+    struct os_mbuf *om;
+    uint32_t copydata_ticks;
+    uint32_t cursor_ticks;
+    uint32_t start;
+    uint32_t sum;
+    int i;
+
+    sysinit();
+
+    om = mbuf_cursor_bench_pkt();
+
+    sum = 0;
+    start = os_cputime_get32();
+    for (i = 0; i < MBUF_CURSOR_BENCH_ITERS; i++) {
+        sum += mbuf_cursor_bench_sum_copydata(om);
+    }
+    copydata_ticks = os_cputime_get32() - start;
+
+    start = os_cputime_get32();
+    for (i = 0; i < MBUF_CURSOR_BENCH_ITERS; i++) {
+        sum -= mbuf_cursor_bench_sum_cursor(om);
+    }
+    cursor_ticks = os_cputime_get32() - start;
+    assert(sum == 0);
+
+    console_printf("os_mbuf: parse %d bytes in %d-byte mbufs: "
+                   "copydata %lu us, cursor %lu us\n",
+                   MBUF_CURSOR_BENCH_PKT_LEN, MBUF_CURSOR_BENCH_BUF_DATA,
+                   (unsigned long)os_cputime_ticks_to_usecs(copydata_ticks),
+                   (unsigned long)os_cputime_ticks_to_usecs(cursor_ticks));
+
+    os_mbuf_free_chain(om);
+
+    while (1) {
+        os_eventq_run(os_eventq_dflt_get());
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include "os/mynewt.h"
+#include "console/console.h"
+
+/*
+ * Takes every block of a pool and returns them again, once with an
+ * os_memblock_get()/os_memblock_put() call per block and once with a single
+ * os_memblock_get_n()/os_memblock_put_n() call each way.
+ */
+
+#define MEMPOOL_BENCH_BLOCKS        MYNEWT_VAL(MEMPOOL_BENCH_BLOCKS)
+#define MEMPOOL_BENCH_BLOCK_SIZE    MYNEWT_VAL(MEMPOOL_BENCH_BLOCK_SIZE)
+#define MEMPOOL_BENCH_ITERS         MYNEWT_VAL(MEMPOOL_BENCH_ITERS)
+
+static os_membuf_t mempool_bench_mem[
+    OS_MEMPOOL_SIZE(MEMPOOL_BENCH_BLOCKS, MEMPOOL_BENCH_BLOCK_SIZE)];
+static struct os_mempool mempool_bench_pool;
+static void *mempool_bench_blocks[MEMPOOL_BENCH_BLOCKS];
+
+static uint32_t
+mempool_bench_run(bool bulk)
+{
+    uint32_t start;
+    int rc;
+    int i;
+    int j;
+
+    start = os_cputime_get32();
+    for (i = 0; i < MEMPOOL_BENCH_ITERS; i++) {
+        if (bulk) {
+            rc = os_memblock_get_n(&mempool_bench_pool, mempool_bench_blocks,
+                                   MEMPOOL_BENCH_BLOCKS);
+            assert(rc == 0);
+            os_memblock_put_n(&mempool_bench_pool, mempool_bench_blocks,
+                              MEMPOOL_BENCH_BLOCKS);
+        } else {
+            for (j = 0; j < MEMPOOL_BENCH_BLOCKS; j++) {
+                mempool_bench_blocks[j] =
+                    os_memblock_get(&mempool_bench_pool);
+            }
+            for (j = 0; j < MEMPOOL_BENCH_BLOCKS; j++) {
+                os_memblock_put(&mempool_bench_pool, mempool_bench_blocks[j]);
+            }
+        }
+    }
+
+    return os_cputime_get32() - start;
+}
+
+int
+main(int argc, char **argv)
+{
+    uint32_t single_ticks;
+    uint32_t bulk_ticks;
+    int rc;
+
+    sysinit();
+
+    rc = os_mempool_init(&mempool_bench_pool, MEMPOOL_BENCH_BLOCKS,
+                         MEMPOOL_BENCH_BLOCK_SIZE, mempool_bench_mem,
+                         "mempool_bench");
+    assert(rc == 0);
+
+    single_ticks = mempool_bench_run(false);
+    bulk_ticks = mempool_bench_run(true);
+
+    console_printf("os_mempool: %d blocks x %d: get/put %lu us, "
+                   "get_n/put_n %lu us\n",
+                   MEMPOOL_BENCH_BLOCKS, MEMPOOL_BENCH_ITERS,
+                   (unsigned long)os_cputime_ticks_to_usecs(single_ticks),
+                   (unsigned long)os_cputime_ticks_to_usecs(bulk_ticks));
+
+    while (1) {
+        os_eventq_run(os_eventq_dflt_get());
+    }
+
+    return 0;
+}
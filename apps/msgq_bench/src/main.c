@@ -0,0 +1,265 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "os/mynewt.h"
+#include "console/console.h"
+
+/*
+ * Passes MSGQ_BENCH_MSG_COUNT small messages from the main task to a
+ * consumer task, once through an os_msgq and once with the usual pattern of
+ * taking a payload block and an event from mempools and posting the event to
+ * an os_eventq.  The eventq variant uses a semaphore for flow control so the
+ * producer blocks when the pools run dry, as the msgq variant does when the
+ * queue is full.
+ *
+ * Each variant runs against a consumer with higher priority than the
+ * producer (every message is handed over immediately; measures latency) and
+ * one with lower priority (the producer fills the queue; measures
+ * throughput).
+ */
+
+#define MSGQ_BENCH_COUNT        MYNEWT_VAL(MSGQ_BENCH_MSG_COUNT)
+#define MSGQ_BENCH_DEPTH        MYNEWT_VAL(MSGQ_BENCH_QUEUE_DEPTH)
+#define MSGQ_BENCH_BATCH        MYNEWT_VAL(MSGQ_BENCH_BATCH)
+#define MSGQ_BENCH_STACK_SIZE   OS_STACK_ALIGN(256)
+
+struct msgq_bench_msg {
+    uint32_t seq;
+    /* os_cputime when the message was sent */
+    uint32_t sent;
+    uint8_t payload[8];
+};
+
+enum msgq_bench_mode {
+    MSGQ_BENCH_MODE_MSGQ,
+    MSGQ_BENCH_MODE_EVENTQ,
+};
+
+struct msgq_bench_consumer {
+    const char *name;
+    uint8_t prio;
+    struct os_task task;
+    os_stack_t stack[MSGQ_BENCH_STACK_SIZE];
+    struct os_sem start;
+    struct os_msgq mq;
+    uint8_t mq_buf[OS_MSGQ_BUF_SIZE(sizeof(struct msgq_bench_msg),
+                                    MSGQ_BENCH_DEPTH)];
+    struct os_eventq evq;
+
+    uint32_t received;
+    uint64_t lat_sum;
+    uint32_t lat_max;
+};
+
+static struct msgq_bench_consumer msgq_bench_consumers[] = {
+    { .name = "high", .prio = MYNEWT_VAL(OS_MAIN_TASK_PRIO) - 1 },
+    { .name = "low", .prio = MYNEWT_VAL(OS_MAIN_TASK_PRIO) + 1 },
+};
+
+static enum msgq_bench_mode msgq_bench_mode;
+static struct os_sem msgq_bench_done;
+
+static struct os_mempool msgq_bench_msg_pool;
+static os_membuf_t msgq_bench_msg_mem[
+    OS_MEMPOOL_SIZE(MSGQ_BENCH_DEPTH, sizeof(struct msgq_bench_msg))];
+static struct os_mempool msgq_bench_ev_pool;
+static os_membuf_t msgq_bench_ev_mem[
+    OS_MEMPOOL_SIZE(MSGQ_BENCH_DEPTH, sizeof(struct os_event))];
+/* Free pool blocks; the eventq variant's equivalent of free queue slots */
+static struct os_sem msgq_bench_credits;
+
+static void
+msgq_bench_record(struct msgq_bench_consumer *c,
+                  const struct msgq_bench_msg *msg)
+{
+    uint32_t lat;
+
+    assert(msg->seq == c->received);
+    lat = os_cputime_get32() - msg->sent;
+    c->lat_sum += lat;
+    if (lat > c->lat_max) {
+        c->lat_max = lat;
+    }
+    c->received++;
+}
+
+static void
+msgq_bench_consumer_handler(void *arg)
+{
+    struct msgq_bench_msg batch[MSGQ_BENCH_BATCH];
+    struct msgq_bench_consumer *c;
+    struct msgq_bench_msg *msg;
+    struct os_event *ev;
+    uint16_t cnt;
+    int rc;
+    int i;
+
+    c = arg;
+
+    while (1) {
+        os_sem_pend(&c->start, OS_TIMEOUT_NEVER);
+
+        if (msgq_bench_mode == MSGQ_BENCH_MODE_MSGQ) {
+            while (c->received < MSGQ_BENCH_COUNT) {
+                rc = os_msgq_recv_multi(&c->mq, batch, MSGQ_BENCH_BATCH,
+                                        OS_TIMEOUT_NEVER, &cnt);
+                assert(rc == 0);
+                for (i = 0; i < cnt; i++) {
+                    msgq_bench_record(c, &batch[i]);
+                }
+            }
+        } else {
+            while (c->received < MSGQ_BENCH_COUNT) {
+                ev = os_eventq_get(&c->evq);
+                msg = ev->ev_arg;
+                msgq_bench_record(c, msg);
+                os_memblock_put(&msgq_bench_msg_pool, msg);
+                os_memblock_put(&msgq_bench_ev_pool, ev);
+                os_sem_release(&msgq_bench_credits);
+            }
+        }
+
+        os_sem_release(&msgq_bench_done);
+    }
+}
+
+static void
+msgq_bench_send(struct msgq_bench_consumer *c, uint32_t seq)
+{
+    struct msgq_bench_msg *msg;
+    struct msgq_bench_msg local;
+    struct os_event *ev;
+    int rc;
+
+    if (msgq_bench_mode == MSGQ_BENCH_MODE_MSGQ) {
+        local.seq = seq;
+        memset(local.payload, seq, sizeof local.payload);
+        local.sent = os_cputime_get32();
+        rc = os_msgq_send(&c->mq, &local, OS_TIMEOUT_NEVER);
+        assert(rc == 0);
+    } else {
+        rc = os_sem_pend(&msgq_bench_credits, OS_TIMEOUT_NEVER);
+        assert(rc == 0);
+        msg = os_memblock_get(&msgq_bench_msg_pool);
+        ev = os_memblock_get(&msgq_bench_ev_pool);
+        assert(msg != NULL && ev != NULL);
+
+        msg->seq = seq;
+        memset(msg->payload, seq, sizeof msg->payload);
+        memset(ev, 0, sizeof *ev);
+        ev->ev_arg = msg;
+        msg->sent = os_cputime_get32();
+        os_eventq_put(&c->evq, ev);
+    }
+}
+
+static void
+msgq_bench_run(struct msgq_bench_consumer *c, enum msgq_bench_mode mode)
+{
+    uint32_t start;
+    uint32_t usecs;
+    uint32_t i;
+
+    msgq_bench_mode = mode;
+    c->received = 0;
+    c->lat_sum = 0;
+    c->lat_max = 0;
+    os_sem_release(&c->start);
+
+    start = os_cputime_get32();
+    for (i = 0; i < MSGQ_BENCH_COUNT; i++) {
+        msgq_bench_send(c, i);
+    }
+    os_sem_pend(&msgq_bench_done, OS_TIMEOUT_NEVER);
+    usecs = os_cputime_ticks_to_usecs(os_cputime_get32() - start);
+
+    console_printf("%-6s consumer %-4s: %8lu us, %8lu msg/s, "
+                   "latency avg %5lu us max %6lu us\n",
+                   mode == MSGQ_BENCH_MODE_MSGQ ? "msgq" : "eventq",
+                   c->name, (unsigned long)usecs,
+                   (unsigned long)((uint64_t)MSGQ_BENCH_COUNT * 1000000 /
+                                   max(usecs, 1)),
+                   (unsigned long)os_cputime_ticks_to_usecs(
+                       c->lat_sum / MSGQ_BENCH_COUNT),
+                   (unsigned long)os_cputime_ticks_to_usecs(c->lat_max));
+}
+
+static void
+msgq_bench_init(void)
+{
+    struct msgq_bench_consumer *c;
+    int rc;
+    int i;
+
+    rc = os_sem_init(&msgq_bench_done, 0);
+    assert(rc == 0);
+    rc = os_sem_init(&msgq_bench_credits, MSGQ_BENCH_DEPTH);
+    assert(rc == 0);
+    rc = os_mempool_init(&msgq_bench_msg_pool, MSGQ_BENCH_DEPTH,
+                         sizeof(struct msgq_bench_msg), msgq_bench_msg_mem,
+                         "msgq_bench_msg");
+    assert(rc == 0);
+    rc = os_mempool_init(&msgq_bench_ev_pool, MSGQ_BENCH_DEPTH,
+                         sizeof(struct os_event), msgq_bench_ev_mem,
+                         "msgq_bench_ev");
+    assert(rc == 0);
+
+    for (i = 0; i < ARRAY_SIZE(msgq_bench_consumers); i++) {
+        c = &msgq_bench_consumers[i];
+
+        rc = os_sem_init(&c->start, 0);
+        assert(rc == 0);
+        rc = os_msgq_init(&c->mq, c->mq_buf, sizeof(struct msgq_bench_msg),
+                          MSGQ_BENCH_DEPTH);
+        assert(rc == 0);
+        os_eventq_init(&c->evq);
+
+        rc = os_task_init(&c->task, "msgq_bench", msgq_bench_consumer_handler,
+                          c, c->prio, OS_WAIT_FOREVER, c->stack,
+                          MSGQ_BENCH_STACK_SIZE);
+        assert(rc == 0);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    int i;
+
+    sysinit();
+
+    msgq_bench_init();
+
+    console_printf("%d messages of %d bytes, queue depth %d\n",
+                   MSGQ_BENCH_COUNT, (int)sizeof(struct msgq_bench_msg),
+                   MSGQ_BENCH_DEPTH);
+
+    for (i = 0; i < ARRAY_SIZE(msgq_bench_consumers); i++) {
+        msgq_bench_run(&msgq_bench_consumers[i], MSGQ_BENCH_MODE_EVENTQ);
+        msgq_bench_run(&msgq_bench_consumers[i], MSGQ_BENCH_MODE_MSGQ);
+    }
+
+    while (1) {
+        os_eventq_run(os_eventq_dflt_get());
+    }
+
+    return 0;
+}
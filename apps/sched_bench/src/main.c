@@ -0,0 +1,133 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include "os/mynewt.h"
+#include "console/console.h"
+
+/*
+ * Measures a sleep/wakeup cycle of the lowest priority task while an
+ * increasing number of higher priority tasks are ready.  This is the worst
+ * case for the linear run list insert, whose cost grows with the number of
+ * ready tasks; with OS_SCHED_PRIO_BITMAP it should stay flat.  Build with
+ * OS_SCHED_PRIO_BITMAP set to 0 and 1 to compare the two implementations.
+ *
+ * Interrupts stay disabled while measuring, so none of the tasks run.  The
+ * timing needs a hardware cputime source.
+ */
+
+#define SCHED_BENCH_NUM_TASKS   MYNEWT_VAL(SCHED_BENCH_NUM_TASKS)
+#define SCHED_BENCH_ITERS       MYNEWT_VAL(SCHED_BENCH_ITERS)
+#define SCHED_BENCH_STACK_SIZE  OS_STACK_ALIGN(256)
+
+static struct os_task sched_bench_tasks[SCHED_BENCH_NUM_TASKS];
+static os_stack_t sched_bench_stacks[SCHED_BENCH_NUM_TASKS]
+                                    [SCHED_BENCH_STACK_SIZE];
+
+static void
+sched_bench_handler(void *arg)
+{
+    while (1) {
+        os_time_delay(OS_TIMEOUT_NEVER);
+    }
+}
+
+static uint32_t
+sched_bench_run(int ready)
+{
+    struct os_task *t;
+    uint32_t start;
+    uint32_t ticks;
+    os_sr_t sr;
+    int i;
+
+    t = &sched_bench_tasks[SCHED_BENCH_NUM_TASKS - 1];
+
+    OS_ENTER_CRITICAL(sr);
+
+    /* Leave the first ready tasks in the run list, ahead of the measured one */
+    for (i = 0; i < SCHED_BENCH_NUM_TASKS - 1; i++) {
+        if (i < ready) {
+            if (sched_bench_tasks[i].t_state == OS_TASK_SLEEP) {
+                os_sched_wakeup(&sched_bench_tasks[i]);
+            }
+        } else if (sched_bench_tasks[i].t_state == OS_TASK_READY) {
+            os_sched_sleep(&sched_bench_tasks[i], OS_TIMEOUT_NEVER);
+        }
+    }
+
+    start = os_cputime_get32();
+    for (i = 0; i < SCHED_BENCH_ITERS; i++) {
+        os_sched_sleep(t, OS_TIMEOUT_NEVER);
+        os_sched_wakeup(t);
+    }
+    ticks = os_cputime_get32() - start;
+
+    OS_EXIT_CRITICAL(sr);
+
+    return ticks;
+}
+
+static void
+sched_bench_init(void)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < SCHED_BENCH_NUM_TASKS; i++) {
+        rc = os_task_init(&sched_bench_tasks[i], "sched_bench",
+                          sched_bench_handler, NULL,
+                          MYNEWT_VAL(OS_MAIN_TASK_PRIO) + 1 + i,
+                          OS_WAIT_FOREVER, sched_bench_stacks[i],
+                          SCHED_BENCH_STACK_SIZE);
+        assert(rc == 0);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    uint32_t ticks;
+    int ready;
+
+    sysinit();
+
+    sched_bench_init();
+
+    console_printf("os_sched: bitmap=%d, %d sleep/wakeup cycles\n",
+                   MYNEWT_VAL(OS_SCHED_PRIO_BITMAP), SCHED_BENCH_ITERS);
+
+    ready = 0;
+    while (1) {
+        ticks = sched_bench_run(ready);
+        console_printf("%3d tasks ready ahead: %8lu us\n", ready,
+                       (unsigned long)os_cputime_ticks_to_usecs(ticks));
+
+        if (ready == SCHED_BENCH_NUM_TASKS - 1) {
+            break;
+        }
+        ready = min(ready == 0 ? 1 : ready * 2, SCHED_BENCH_NUM_TASKS - 1);
+    }
+
+    while (1) {
+        os_eventq_run(os_eventq_dflt_get());
+    }
+
+    return 0;
+}
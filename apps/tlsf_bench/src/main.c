@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include "os/mynewt.h"
+#include "console/console.h"
+#include "tlsf/tlsf.h"
+
+/*
+ * Runs a seeded random mix of tlsf_malloc(), tlsf_realloc() and tlsf_free()
+ * over a fixed set of slots, timing each call.  Reports the average and
+ * worst case call time, the number of requests that could not be satisfied,
+ * and the heap statistics at the end of the run.
+ */
+
+#define TLSF_BENCH_HEAP_SIZE    MYNEWT_VAL(TLSF_BENCH_HEAP_SIZE)
+#define TLSF_BENCH_SLOTS        MYNEWT_VAL(TLSF_BENCH_SLOTS)
+#define TLSF_BENCH_ITERS        MYNEWT_VAL(TLSF_BENCH_ITERS)
+#define TLSF_BENCH_MAX_LEN      MYNEWT_VAL(TLSF_BENCH_MAX_LEN)
+
+static struct tlsf tlsf_bench_tlsf;
+static uint8_t tlsf_bench_heap[TLSF_BENCH_HEAP_SIZE];
+static void *tlsf_bench_slots[TLSF_BENCH_SLOTS];
+
+/* Mostly small requests with an occasional large one. */
+static size_t
+tlsf_bench_rand_len(void)
+{
+    if (rand() % 8 == 0) {
+        return 1 + rand() % TLSF_BENCH_MAX_LEN;
+    }
+    return 1 + rand() % 128;
+}
+
+int
+main(int argc, char **argv)
+{
+    struct tlsf_stats stats;
+    uint32_t total;
+    uint32_t start;
+    uint32_t ticks;
+    uint32_t max;
+    uint32_t fails;
+    void **slot;
+    void *p;
+    int rc;
+    int i;
+
+    sysinit();
+
+    tlsf_init(&tlsf_bench_tlsf);
+    rc = tlsf_add_pool(&tlsf_bench_tlsf, tlsf_bench_heap,
+                       sizeof tlsf_bench_heap);
+    assert(rc == 0);
+
+    srand(1);
+    total = 0;
+    max = 0;
+    fails = 0;
+
+    for (i = 0; i < TLSF_BENCH_ITERS; i++) {
+        slot = &tlsf_bench_slots[rand() % TLSF_BENCH_SLOTS];
+
+        if (*slot == NULL || rand() % 4 == 0) {
+            /* tlsf_realloc() of NULL is a malloc. */
+            start = os_cputime_get32();
+            p = tlsf_realloc(&tlsf_bench_tlsf, *slot, tlsf_bench_rand_len());
+            ticks = os_cputime_get32() - start;
+            if (p == NULL) {
+                fails++;
+            } else {
+                *slot = p;
+            }
+        } else {
+            start = os_cputime_get32();
+            tlsf_free(&tlsf_bench_tlsf, *slot);
+            ticks = os_cputime_get32() - start;
+            *slot = NULL;
+        }
+
+        total += ticks;
+        if (ticks > max) {
+            max = ticks;
+        }
+    }
+
+    tlsf_stats(&tlsf_bench_tlsf, &stats);
+    console_printf("tlsf: %lu ops, %lu failed, avg %lu ns, max %lu us\n",
+                   (unsigned long)TLSF_BENCH_ITERS, (unsigned long)fails,
+                   (unsigned long)((uint64_t)os_cputime_ticks_to_usecs(total) *
+                                   1000 / TLSF_BENCH_ITERS),
+                   (unsigned long)os_cputime_ticks_to_usecs(max));
+    console_printf("tlsf: used %lu peak %lu free %lu largest %lu "
+                   "frag %u%%\n",
+                   (unsigned long)stats.ts_used_bytes,
+                   (unsigned long)stats.ts_peak_used,
+                   (unsigned long)stats.ts_free_bytes,
+                   (unsigned long)stats.ts_largest_free,
+                   stats.ts_frag_pct);
+
+    while (1) {
+        os_eventq_run(os_eventq_dflt_get());
+    }
+
+    return 0;
+}
@@ -21,13 +21,31 @@
 #include <tinycbor/cbor_mbuf_reader.h>
 #include <tinycbor/compilersupport_p.h>
 
+/*
+ * The decoder mostly moves forward through the buffer, so reads go through a
+ * cursor instead of walking the mbuf chain from its head every time.
+ */
+static int
+cbor_mbuf_reader_copy(struct cbor_mbuf_reader *cb, int offset, void *dst,
+                      size_t len)
+{
+    int rc;
+
+    rc = os_mbuf_cursor_seek(&cb->omc, offset + cb->init_off);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return os_mbuf_cursor_peek(&cb->omc, dst, len);
+}
+
 static uint8_t
 cbor_mbuf_reader_get8(struct cbor_decoder_reader *d, int offset)
 {
     uint8_t val;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
 
-    os_mbuf_copydata(cb->m, offset + cb->init_off, sizeof(val), &val);
+    cbor_mbuf_reader_copy(cb, offset, &val, sizeof(val));
     return val;
 }
 
@@ -37,7 +55,7 @@ cbor_mbuf_reader_get16(struct cbor_decoder_reader *d, int offset)
     uint16_t val;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
 
-    os_mbuf_copydata(cb->m, offset + cb->init_off, sizeof(val), &val);
+    cbor_mbuf_reader_copy(cb, offset, &val, sizeof(val));
     return cbor_ntohs(val);
 }
 
@@ -47,7 +65,7 @@ cbor_mbuf_reader_get32(struct cbor_decoder_reader *d, int offset)
     uint32_t val;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
 
-    os_mbuf_copydata(cb->m, offset + cb->init_off, sizeof(val), &val);
+    cbor_mbuf_reader_copy(cb, offset, &val, sizeof(val));
     return cbor_ntohl(val);
 }
 
@@ -57,7 +75,7 @@ cbor_mbuf_reader_get64(struct cbor_decoder_reader *d, int offset)
     uint64_t val;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
 
-    os_mbuf_copydata(cb->m, offset + cb->init_off, sizeof(val), &val);
+    cbor_mbuf_reader_copy(cb, offset, &val, sizeof(val));
     return cbor_ntohll(val);
 }
 
@@ -66,7 +84,11 @@ cbor_mbuf_reader_cmp(struct cbor_decoder_reader *d, char *buf, int offset,
                      size_t len)
 {
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
-    return os_mbuf_cmpf(cb->m, offset + cb->init_off, buf, len) == 0;
+
+    if (os_mbuf_cursor_seek(&cb->omc, offset + cb->init_off) != 0) {
+        return false;
+    }
+    return os_mbuf_cursor_cmp(&cb->omc, buf, len) == 0;
 }
 
 static uintptr_t
@@ -76,7 +98,7 @@ cbor_mbuf_reader_cpy(struct cbor_decoder_reader *d, char *dst, int offset,
     int rc;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
 
-    rc = os_mbuf_copydata(cb->m, offset + cb->init_off, len, dst);
+    rc = cbor_mbuf_reader_copy(cb, offset, dst, len);
     if (rc == 0) {
         return true;
     }
@@ -100,5 +122,6 @@ cbor_mbuf_reader_init(struct cbor_mbuf_reader *cb, struct os_mbuf *m,
     hdr = OS_MBUF_PKTHDR(m);
     cb->m = m;
     cb->init_off = initial_offset;
+    os_mbuf_cursor_init(&cb->omc, m);
     cb->r.message_size = hdr->omp_len - initial_offset;
 }
@@ -70,13 +70,6 @@ fcb_append_to_scratch(struct fcb *fcb)
     return FCB_OK;
 }
 
-static inline int
-fcb_sector_flash_offset(const struct fcb_entry *loc)
-{
-    return (loc->fe_sector - loc->fe_range->fsr_first_sector) *
-        loc->fe_range->fsr_sector_size;
-}
-
 int
 fcb_write_to_sector(struct fcb_entry *loc, int off, const void *buf, int len)
 {
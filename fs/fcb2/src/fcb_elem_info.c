@@ -30,27 +30,16 @@ int
 fcb_elem_crc16(struct fcb_entry *loc, uint16_t *c16p)
 {
     uint8_t tmp_str[FCB_TMP_BUF_SZ];
-    int blk_sz;
     uint16_t crc16;
-    uint32_t off;
-    uint32_t end;
     int rc;
 
     crc16 = 0xFFFF;
 
-    off = loc->fe_data_off;
-    end = loc->fe_data_off + loc->fe_data_len;
-    for (; off < end; off += blk_sz) {
-        blk_sz = end - off;
-        if (blk_sz > sizeof(tmp_str)) {
-            blk_sz = sizeof(tmp_str);
-        }
-
-        rc = fcb_read_from_sector(loc, off, tmp_str, blk_sz);
-        if (rc) {
-            return FCB_ERR_FLASH;
-        }
-        crc16 = crc16_ccitt(crc16, tmp_str, blk_sz);
+    rc = crc16_ccitt_flash(&crc16, &loc->fe_range->fsr_flash_area,
+                           fcb_sector_flash_offset(loc) + loc->fe_data_off,
+                           loc->fe_data_len, tmp_str, sizeof(tmp_str));
+    if (rc) {
+        return FCB_ERR_FLASH;
     }
     *c16p = crc16;
 
@@ -103,6 +103,16 @@ int fcb_get_sector_info(const struct fcb *fcb, int sector,
 int fcb_write_to_sector(struct fcb_entry *loc, int off,
     const void *buf, int len);
 
+/**
+ * @brief Offset of the entry's sector within the range's flash area.
+ */
+static inline int
+fcb_sector_flash_offset(const struct fcb_entry *loc)
+{
+    return (loc->fe_sector - loc->fe_range->fsr_first_sector) *
+        loc->fe_range->fsr_sector_size;
+}
+
 /**
  * @brief Read data from fcb sector.
  *
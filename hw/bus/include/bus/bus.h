@@ -22,6 +22,7 @@
 
 #include <stdint.h>
 #include "os/os_dev.h"
+#include "os/os_mbuf.h"
 #include "os/os_mutex.h"
 #include "os/os_time.h"
 
@@ -103,6 +104,33 @@ int
 bus_node_write(struct os_dev *node, const void *buf, uint16_t length,
                os_time_t timeout, uint16_t flags);
 
+/**
+ * Write scattered data to node
+ *
+ * Writes a list of buffers to node as a single transaction, e.g. a register
+ * address followed by payload, or an mbuf chain described with
+ * os_mbuf_to_iov(), without first copying them into a flat buffer. Bus is
+ * locked automatically for the duration of operation.
+ *
+ * All buffers except the last one are written with BUS_F_NOSTOP, so on SPI
+ * the chip select is kept asserted in between. On I2C each buffer is sent
+ * as a separate write after a repeated start.
+ *
+ * The timeout parameter applies to complete transaction time, including
+ * locking the bus.
+ *
+ * @param node     Node device object
+ * @param iov      Buffers with data to be written
+ * @param iov_cnt  Number of buffers
+ * @param timeout  Operation timeout
+ * @param flags    Flags applied to the last buffer
+ *
+ * @return 0 on success, SYS_xxx on error
+ */
+int
+bus_node_writev(struct os_dev *node, const struct os_mbuf_iov *iov,
+                int iov_cnt, os_time_t timeout, uint16_t flags);
+
 /**
  * Perform write and read transaction on node
  *
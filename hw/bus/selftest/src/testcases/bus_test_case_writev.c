@@ -0,0 +1,147 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include "bus/bus.h"
+#include "bus/bus_driver.h"
+#include "bus_test.h"
+
+/* One call to the driver's write operation */
+struct bus_test_write {
+    uint16_t len;
+    uint16_t flags;
+};
+
+static struct bus_dev bus_test_dev;
+static struct bus_node bus_test_node;
+
+static uint8_t bus_test_data[64];
+static int bus_test_data_len;
+static struct bus_test_write bus_test_writes[8];
+static int bus_test_write_cnt;
+/* Index of the write operation that fails, or -1 */
+static int bus_test_fail_at;
+
+static int
+bus_test_init_node(struct bus_dev *bus, struct bus_node *node, void *arg)
+{
+    return 0;
+}
+
+static int
+bus_test_configure(struct bus_dev *bus, struct bus_node *node)
+{
+    return 0;
+}
+
+static int
+bus_test_write(struct bus_dev *dev, struct bus_node *node, const uint8_t *buf,
+               uint16_t length, os_time_t timeout, uint16_t flags)
+{
+    TEST_ASSERT_FATAL(bus_test_write_cnt < ARRAY_SIZE(bus_test_writes));
+    TEST_ASSERT_FATAL(bus_test_data_len + length <= sizeof bus_test_data);
+
+    /* The transaction runs with the bus locked. */
+    TEST_ASSERT(os_mutex_get_level(&dev->lock) == 1);
+
+    if (bus_test_write_cnt == bus_test_fail_at) {
+        return SYS_EIO;
+    }
+
+    bus_test_writes[bus_test_write_cnt].len = length;
+    bus_test_writes[bus_test_write_cnt].flags = flags;
+    bus_test_write_cnt++;
+    memcpy(bus_test_data + bus_test_data_len, buf, length);
+    bus_test_data_len += length;
+
+    return 0;
+}
+
+static struct bus_dev_ops bus_test_dops = {
+    .init_node = bus_test_init_node,
+    .configure = bus_test_configure,
+    .write = bus_test_write,
+};
+
+static void
+bus_test_reset(int fail_at)
+{
+    bus_test_data_len = 0;
+    bus_test_write_cnt = 0;
+    bus_test_fail_at = fail_at;
+}
+
+TEST_CASE_TASK(bus_test_case_writev)
+{
+    struct bus_node_cfg cfg = {
+        .bus_name = "bustest",
+    };
+    struct os_mbuf_iov iov[3];
+    uint8_t payload[] = { 1, 2, 3, 4, 5, 6 };
+    uint8_t reg = 0xa0;
+    int rc;
+
+    rc = os_dev_create(&bus_test_dev.odev, "bustest", OS_DEV_INIT_PRIMARY, 0,
+                       bus_dev_init_func, &bus_test_dops);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_dev_create(&bus_test_node.odev, "bustest_node",
+                       OS_DEV_INIT_PRIMARY, 1, bus_node_init_func, &cfg);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* Register address, then payload: one write per buffer, no stop between. */
+    iov[0].omi_base = &reg;
+    iov[0].omi_len = 1;
+    iov[1].omi_base = payload;
+    iov[1].omi_len = sizeof payload;
+    bus_test_reset(-1);
+    rc = bus_node_writev(&bus_test_node.odev, iov, 2, OS_TIMEOUT_NEVER,
+                         BUS_F_NONE);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT_FATAL(bus_test_write_cnt == 2);
+    TEST_ASSERT(bus_test_writes[0].len == 1);
+    TEST_ASSERT(bus_test_writes[0].flags == BUS_F_NOSTOP);
+    TEST_ASSERT(bus_test_writes[1].len == sizeof payload);
+    TEST_ASSERT(bus_test_writes[1].flags == BUS_F_NONE);
+    TEST_ASSERT(bus_test_data_len == 1 + sizeof payload);
+    TEST_ASSERT(bus_test_data[0] == reg);
+    TEST_ASSERT(memcmp(bus_test_data + 1, payload, sizeof payload) == 0);
+    TEST_ASSERT(os_mutex_get_level(&bus_test_dev.lock) == 0);
+
+    /* The caller's flags apply to the last buffer only. */
+    iov[2].omi_base = payload + 4;
+    iov[2].omi_len = 2;
+    iov[1].omi_len = 4;
+    bus_test_reset(-1);
+    rc = bus_node_writev(&bus_test_node.odev, iov, 3, OS_TIMEOUT_NEVER,
+                         BUS_F_NOSTOP);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT_FATAL(bus_test_write_cnt == 3);
+    TEST_ASSERT(bus_test_writes[0].flags == BUS_F_NOSTOP);
+    TEST_ASSERT(bus_test_writes[1].flags == BUS_F_NOSTOP);
+    TEST_ASSERT(bus_test_writes[2].flags == BUS_F_NOSTOP);
+    TEST_ASSERT(memcmp(bus_test_data + 1, payload, sizeof payload) == 0);
+
+    /* A failed buffer ends the transaction and releases the bus. */
+    bus_test_reset(1);
+    rc = bus_node_writev(&bus_test_node.odev, iov, 3, OS_TIMEOUT_NEVER,
+                         BUS_F_NONE);
+    TEST_ASSERT(rc == SYS_EIO);
+    TEST_ASSERT(bus_test_write_cnt == 1);
+    TEST_ASSERT(os_mutex_get_level(&bus_test_dev.lock) == 0);
+}
@@ -387,6 +387,49 @@ done:
     return rc;
 }
 
+int
+bus_node_writev(struct os_dev *node, const struct os_mbuf_iov *iov,
+                int iov_cnt, os_time_t timeout, uint16_t flags)
+{
+    struct bus_node *bnode = (struct bus_node *)node;
+    struct bus_dev *bdev = bnode->parent_bus;
+    int rc;
+    int i;
+
+    BUS_DEBUG_VERIFY_DEV(bdev);
+    BUS_DEBUG_VERIFY_NODE(bnode);
+
+    if (!bdev->dops->write) {
+        return SYS_ENOTSUP;
+    }
+
+    rc = bus_node_lock(node, bus_node_get_lock_timeout(node));
+    if (rc) {
+        return rc;
+    }
+
+    if (!bdev->enabled) {
+        rc = SYS_EIO;
+        goto done;
+    }
+
+    BUS_STATS_INC(bdev, bnode, write_ops);
+    for (i = 0; i < iov_cnt; i++) {
+        rc = bdev->dops->write(bdev, bnode, iov[i].omi_base, iov[i].omi_len,
+                               timeout,
+                               i < iov_cnt - 1 ? BUS_F_NOSTOP : flags);
+        if (rc) {
+            BUS_STATS_INC(bdev, bnode, write_errors);
+            break;
+        }
+    }
+
+done:
+    (void)bus_node_unlock(node);
+
+    return rc;
+}
+
 int
 bus_node_write_read_transact(struct os_dev *node, const void *wbuf,
                              uint16_t wlength, void *rbuf, uint16_t rlength,
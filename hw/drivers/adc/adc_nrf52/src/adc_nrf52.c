@@ -385,7 +385,7 @@ nrf52_adc_size_buffer(struct adc_dev *dev, int chans, int samples)
     return (sizeof(nrf_saadc_value_t) * chans * samples);
 }
 
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TRACE_RAM)
 static void
 saadc_irq_handler(void)
 {
@@ -432,7 +432,7 @@ nrf52_adc_dev_init(struct os_dev *odev, void *arg)
 
     dev->ad_funcs = &nrf52_adc_funcs;
 
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TRACE_RAM)
     NVIC_SetVector(SAADC_IRQn, (uint32_t) saadc_irq_handler);
 #else
     NVIC_SetVector(SAADC_IRQn, (uint32_t) nrfx_saadc_irq_handler);
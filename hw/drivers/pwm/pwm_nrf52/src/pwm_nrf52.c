@@ -738,7 +738,7 @@ nrf52_pwm_get_resolution_bits(struct pwm_dev *dev)
     return (-EINVAL);
 }
 
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TRACE_RAM)
 #if MYNEWT_VAL(PWM_0)
 static void
 pwm_0_irq_handler(void)
@@ -897,24 +897,18 @@ bme280_writelen(struct sensor_itf *itf, uint8_t addr, uint8_t *payload,
     int rc;
 
 #if MYNEWT_VAL(BUS_DRIVER_PRESENT)
-    struct os_dev *dev = itf->si_dev;
-
-    rc = bus_node_lock(dev, OS_TIMEOUT_NEVER);
-    if (rc) {
-        return SYS_EINVAL;
-    }
+    struct os_mbuf_iov iov[2];
 
     addr &= ~BME280_SPI_READ_CMD_BIT;
 
-    rc = bus_node_write(dev, &addr, 1, OS_TIMEOUT_NEVER, BUS_F_NOSTOP);
-    if (rc) {
-        goto done;
-    }
-
-    rc = bus_node_simple_write(dev, payload, len);
+    iov[0].omi_base = &addr;
+    iov[0].omi_len = 1;
+    iov[1].omi_base = payload;
+    iov[1].omi_len = len;
 
-done:
-    (void)bus_node_unlock(dev);
+    rc = bus_node_writev(itf->si_dev, iov, 2,
+                         os_time_ms_to_ticks32(MYNEWT_VAL(BUS_DEFAULT_TRANSACTION_TIMEOUT_MS)),
+                         BUS_F_NONE);
 #else
     int i;
 
@@ -35,11 +35,29 @@ struct native_timer {
     struct os_callout callout;
     uint32_t ticks_per_ostick;
     uint32_t cnt;
+#if !MYNEWT_VAL(MCU_NATIVE_VIRTUAL_TIME)
     uint32_t last_ostime;
+#endif
     int num;
     TAILQ_HEAD(hal_timer_qhead, hal_timer) timers;
 } native_timers[1];
 
+/*
+ * Returns the number of OS ticks until the timer reaches 'expiry', rounded
+ * up so that the callout does not fire before the timer expires.
+ */
+static os_time_t
+native_timer_osticks(struct native_timer *nt, uint32_t expiry)
+{
+    int32_t delta;
+
+    delta = (int32_t)(expiry - hal_timer_read(nt->num));
+    if (delta <= 0) {
+        return 0;
+    }
+    return (delta + nt->ticks_per_ostick - 1) / nt->ticks_per_ostick;
+}
+
 /**
  * This is the function called when the timer fires.
  *
@@ -67,7 +85,7 @@ native_timer_cb(struct os_event *ev)
     ht = TAILQ_FIRST(&nt->timers);
     if (ht) {
         os_callout_reset(&nt->callout,
-          (ht->expiry - hal_timer_read(nt->num)) / nt->ticks_per_ostick);
+          native_timer_osticks(nt, ht->expiry));
     }
     OS_EXIT_CRITICAL(sr);
 }
@@ -103,7 +121,9 @@ hal_timer_config(int num, uint32_t clock_freq)
     }
     nt->num = num;
     nt->cnt = 0;
+#if !MYNEWT_VAL(MCU_NATIVE_VIRTUAL_TIME)
     nt->last_ostime = os_time_get();
+#endif
     if (!native_timer_task_started) {
         os_task_init(&native_timer_task_struct, "native_timer",
           native_timer_task, NULL, MYNEWT_VAL(MCU_TIMER_POLLER_PRIO),
@@ -167,14 +187,31 @@ hal_timer_read(int num)
 {
     struct native_timer *nt;
     os_sr_t sr;
+#if MYNEWT_VAL(MCU_NATIVE_VIRTUAL_TIME)
+    uint32_t base;
+#else
     uint32_t ostime;
     uint32_t delta_osticks;
+#endif
+    uint32_t cnt;
 
     if (num != 0) {
         return -1;
     }
     nt = &native_timers[num];
     OS_ENTER_CRITICAL(sr);
+#if MYNEWT_VAL(MCU_NATIVE_VIRTUAL_TIME)
+    /*
+     * Follow OS time, which is virtual.  Between OS ticks count one tick per
+     * read so that busy-waits terminate, but never run backwards.
+     */
+    base = os_time_get() * nt->ticks_per_ostick;
+    if ((int32_t)(base - nt->cnt) > 0) {
+        nt->cnt = base;
+    } else {
+        nt->cnt++;
+    }
+#else
     ostime = os_time_get();
     delta_osticks = (uint32_t)(ostime - nt->last_ostime);
     if (delta_osticks) {
@@ -182,9 +219,11 @@ hal_timer_read(int num)
         nt->cnt += nt->ticks_per_ostick * delta_osticks;
 
     }
+#endif
+    cnt = nt->cnt;
     OS_EXIT_CRITICAL(sr);
 
-    return (uint32_t)nt->cnt;
+    return cnt;
 }
 
 /**
@@ -309,7 +348,7 @@ hal_timer_start_at(struct hal_timer *timer, uint32_t tick)
         os_callout_reset(&nt->callout, 0);
     } else {
         if (timer == TAILQ_FIRST(&nt->timers)) {
-            osticks = (tick - curtime) / nt->ticks_per_ostick;
+            osticks = native_timer_osticks(nt, tick);
             os_callout_reset(&nt->callout, osticks);
         }
     }
@@ -350,8 +389,7 @@ hal_timer_stop(struct hal_timer *timer)
         if (reset_ocmp) {
             if (ht) {
                 os_callout_reset(&nt->callout,
-                  (ht->expiry - hal_timer_read(nt->num)) /
-                    nt->ticks_per_ostick);
+                                 native_timer_osticks(nt, ht->expiry));
             } else {
                 os_callout_stop(&nt->callout);
             }
@@ -21,6 +21,7 @@
 #define _OS_ARCH_COMMON_H
 
 #include <stdint.h>
+#include "syscfg/syscfg.h"
 #include "os/os_error.h"
 
 #ifdef __cplusplus
@@ -58,6 +59,21 @@ struct os_task;
 #define OS_ASSERT_CRITICAL()            (assert(os_arch_in_critical()))
 #endif
 
+#if MYNEWT_VAL(OS_CRIT_PROF)
+/*
+ * Critical sections are timed by os_crit_prof_enter() and
+ * os_crit_prof_exit(), which mask interrupts with os_arch_save_sr() and
+ * os_arch_restore_sr() in place of any architecture specific macros.
+ */
+#undef OS_ENTER_CRITICAL
+#undef OS_EXIT_CRITICAL
+#define OS_ENTER_CRITICAL(__os_sr)      (__os_sr = os_crit_prof_enter())
+#define OS_EXIT_CRITICAL(__os_sr)       (os_crit_prof_exit(__os_sr))
+
+os_sr_t os_crit_prof_enter(void);
+void os_crit_prof_exit(os_sr_t sr);
+#endif
+
 os_stack_t *os_arch_task_stack_init(struct os_task *, os_stack_t *, int);
 void os_arch_ctx_sw(struct os_task *);
 os_sr_t os_arch_save_sr(void);
@@ -37,7 +37,7 @@ typedef uint32_t os_stack_t;
 
 /* Stack sizes for common OS tasks */
 #define OS_SANITY_STACK_SIZE (64)
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TRACE_RAM)
 #define OS_IDLE_STACK_SIZE (80)
 #else
 #define OS_IDLE_STACK_SIZE (64)
@@ -122,14 +122,18 @@ void os_system_reset(void);
 #include "os/os_callout.h"
 #include "os/os_cfg.h"
 #include "os/os_cputime.h"
+#include "os/os_crit_prof.h"
 #include "os/os_dev.h"
 #include "os/os_error.h"
+#include "os/os_event_group.h"
 #include "os/os_eventq.h"
 #include "os/os_fault.h"
 #include "os/os_heap.h"
 #include "os/os_mbuf.h"
 #include "os/os_mempool.h"
+#include "os/os_msgq.h"
 #include "os/os_mutex.h"
+#include "os/os_recip.h"
 #include "os/os_sanity.h"
 #include "os/os_sched.h"
 #include "os/os_sem.h"
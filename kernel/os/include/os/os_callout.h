@@ -45,6 +45,10 @@ struct os_callout {
     struct os_eventq *c_evq;
     /** Number of ticks in the future to expire the callout */
     os_time_t c_ticks;
+#if MYNEWT_VAL(OS_CALLOUT_SLACK)
+    /** Number of ticks the callout is allowed to expire late */
+    os_time_t c_slack;
+#endif
 
 
     TAILQ_ENTRY(os_callout) c_next;
@@ -99,6 +103,25 @@ void os_callout_stop(struct os_callout *);
  */
 int os_callout_reset(struct os_callout *, os_time_t);
 
+#if MYNEWT_VAL(OS_CALLOUT_SLACK)
+/**
+ * Reset the callout to fire off in 'ticks' ticks, allowing it to fire up to
+ * 'slack' ticks late.
+ *
+ * When the system is idle, the OS wakes up as late as the slack of the
+ * pending callouts allows, so that callouts whose windows overlap expire
+ * with a single wakeup.
+ *
+ * @param c The callout to reset
+ * @param ticks The number of ticks to wait before posting an event
+ * @param slack The number of ticks the event may be posted late
+ *
+ * @return 0 on success, non-zero on failure
+ */
+int os_callout_reset_slack(struct os_callout *c, os_time_t ticks,
+                           os_time_t slack);
+#endif
+
 /**
  * Returns the number of ticks which remains to callout.
  *
@@ -75,6 +75,9 @@ extern "C" {
 #endif
 
 #if defined(OS_CPUTIME_FREQ_HIGH)
+/** Number of cputime ticks per usec */
+#define OS_CPUTIME_TICKS_PER_USEC   (MYNEWT_VAL(OS_CPUTIME_FREQ) / 1000000)
+
 /* CPUTIME data. */
 struct os_cputime_data
 {
@@ -0,0 +1,103 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * @addtogroup OSKernel
+ * @{
+ *   @defgroup OSCritProf Critical Section Profiling
+ *   @{
+ */
+
+#ifndef _OS_CRIT_PROF_H_
+#define _OS_CRIT_PROF_H_
+
+#include <stdint.h>
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if MYNEWT_VAL(OS_CRIT_PROF)
+
+#define OS_CRIT_PROF_BUCKETS    MYNEWT_VAL(OS_CRIT_PROF_BUCKETS)
+#define OS_CRIT_PROF_TOP        MYNEWT_VAL(OS_CRIT_PROF_TOP)
+
+/** A place critical sections are entered from, and the longest of them. */
+struct os_crit_prof_site {
+    /** Return address of the OS_ENTER_CRITICAL() call; NULL if unused */
+    void *ocs_caller;
+    /** Longest section entered from here, in usecs */
+    uint32_t ocs_max;
+};
+
+/**
+ * Interrupt-disabled time measured since the OS was initialized, or since
+ * os_crit_prof_clear().  Only the outermost of nested critical sections is
+ * measured.
+ */
+struct os_crit_prof_info {
+    /** Number of critical sections measured */
+    uint32_t ocp_count;
+    /** Longest critical section, in usecs */
+    uint32_t ocp_max;
+    /** Total time spent in critical sections, in usecs */
+    uint64_t ocp_total;
+    /**
+     * Histogram of critical section lengths.  Bucket 0 counts sections
+     * below 2 usecs, bucket n sections from 2^n to 2^(n+1) usecs, and the
+     * last bucket everything longer.
+     */
+    uint32_t ocp_hist[OS_CRIT_PROF_BUCKETS];
+    /**
+     * The call sites which entered the longest sections, longest first, with
+     * at most one entry per call site.
+     */
+    struct os_crit_prof_site ocp_top[OS_CRIT_PROF_TOP];
+};
+
+/**
+ * Gets the critical section profile.
+ *
+ * @param info                  The profile is written here.
+ */
+void os_crit_prof_get(struct os_crit_prof_info *info);
+
+/**
+ * Clears the critical section profile.
+ */
+void os_crit_prof_clear(void);
+
+/** @cond INTERNAL_HIDDEN */
+void os_crit_prof_start(void);
+/** @endcond */
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _OS_CRIT_PROF_H_ */
+
+
+/**
+ *   @} OSCritProf
+ * @} OSKernel
+ */
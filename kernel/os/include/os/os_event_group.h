@@ -0,0 +1,139 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * @addtogroup OSKernel
+ * @{
+ *   @defgroup OSEventGroup Event Groups
+ *   @{
+ */
+
+#ifndef _OS_EVENT_GROUP_H_
+#define _OS_EVENT_GROUP_H_
+
+#include "os/queue.h"
+#include "os/os_error.h"
+#include "os/os_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Wait until all of the requested flags are set, instead of any of them */
+#define OS_EVENT_GROUP_WAIT_ALL     (0x01)
+/** Clear the requested flags when the wait is satisfied */
+#define OS_EVENT_GROUP_CLEAR        (0x02)
+
+struct os_event_group_waiter;
+
+/**
+ * Structure representing a group of 32 event flags.  Any number of tasks can
+ * wait for a combination of flags; setting flags wakes every waiter whose
+ * condition becomes true.
+ */
+struct os_event_group {
+    /** Tasks waiting on the group, in priority order */
+    SLIST_HEAD(, os_event_group_waiter) evg_head;
+    /** Currently set flags */
+    uint32_t evg_flags;
+};
+
+/**
+ * Initialize an event group.
+ *
+ * @param evg Pointer to event group
+ * @param flags Initial value of the flags
+ *
+ * @return os_error_t
+ *      OS_INVALID_PARM     Event group passed in was NULL.
+ *      OS_OK               no error.
+ */
+os_error_t os_event_group_init(struct os_event_group *evg, uint32_t flags);
+
+/**
+ * Set flags in an event group and wake up the tasks whose wait is now
+ * satisfied.  Waiters are checked in priority order; flags cleared by a
+ * waiter using OS_EVENT_GROUP_CLEAR are not seen by the waiters after it.
+ * Can be called from an interrupt.
+ *
+ * @param evg Pointer to event group
+ * @param flags Flags to set
+ *
+ * @return os_error_t
+ *      OS_INVALID_PARM     Event group passed in was NULL.
+ *      OS_OK               no error.
+ */
+os_error_t os_event_group_set(struct os_event_group *evg, uint32_t flags);
+
+/**
+ * Clear flags in an event group.  Can be called from an interrupt.
+ *
+ * @param evg Pointer to event group
+ * @param flags Flags to clear
+ *
+ * @return os_error_t
+ *      OS_INVALID_PARM     Event group passed in was NULL.
+ *      OS_OK               no error.
+ */
+os_error_t os_event_group_clear(struct os_event_group *evg, uint32_t flags);
+
+/**
+ * Wait for flags in an event group.
+ *
+ * @param evg Pointer to event group
+ * @param mask Flags to wait for
+ * @param opts OS_EVENT_GROUP_WAIT_ALL to wait for all flags in mask rather
+ *             than any of them; OS_EVENT_GROUP_CLEAR to clear the flags in
+ *             mask once the wait is satisfied.
+ * @param timeout Timeout, in os ticks.
+ *                A timeout of 0 means do not wait if not satisfied.
+ *                A timeout of OS_TIMEOUT_NEVER means wait forever.
+ * @param out_flags On return, the flags of the group when the wait was
+ *                  satisfied or timed out, before any clearing.  Can be NULL.
+ *
+ * @return os_error_t
+ *      OS_INVALID_PARM     Event group passed in was NULL or mask was 0.
+ *      OS_NOT_STARTED      The wait would block but the OS is not started.
+ *      OS_TIMEOUT          The wait was not satisfied within timeout.
+ *      OS_OK               no error.
+ */
+os_error_t os_event_group_wait(struct os_event_group *evg, uint32_t mask,
+                               uint8_t opts, os_time_t timeout,
+                               uint32_t *out_flags);
+
+/**
+ * Get the current flags of an event group.
+ */
+static inline uint32_t
+os_event_group_get(const struct os_event_group *evg)
+{
+    return evg->evg_flags;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _OS_EVENT_GROUP_H_ */
+
+
+/**
+ *   @} OSEventGroup
+ * @} OSKernel
+ */
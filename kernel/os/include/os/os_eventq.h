@@ -37,6 +37,17 @@
 extern "C" {
 #endif
 
+#define OS_EVENTQ_PRIO_LEVELS   MYNEWT_VAL(OS_EVENTQ_PRIO_LEVELS)
+
+#if OS_EVENTQ_PRIO_LEVELS < 1 || OS_EVENTQ_PRIO_LEVELS > 32
+#error "OS_EVENTQ_PRIO_LEVELS must be between 1 and 32"
+#endif
+
+/** Priority of events which do not set one; the lowest level */
+#define OS_EVENT_PRIO_DEFAULT   (0)
+/** Highest event priority level */
+#define OS_EVENT_PRIO_HIGHEST   (OS_EVENTQ_PRIO_LEVELS - 1)
+
 struct os_event;
 typedef void os_event_fn(struct os_event *ev);
 
@@ -45,8 +56,21 @@ typedef void os_event_fn(struct os_event *ev);
  * event queues and are consumed by tasks.
  */
 struct os_event {
-    /** Whether this OS event is queued on an event queue. */
+    /**
+     * Whether this OS event is queued on an event queue.  This includes
+     * events taken off the queue by os_eventq_run_batch() whose callback
+     * has not been called yet.
+     */
     uint8_t ev_queued;
+    /**
+     * Priority level of the event, from OS_EVENT_PRIO_DEFAULT (lowest) to
+     * OS_EVENT_PRIO_HIGHEST; larger values are clamped.  Events of a higher
+     * level are always taken off an event queue first; events of the same
+     * level are taken off in the order they were queued.  Only used if
+     * OS_EVENTQ_PRIO_LEVELS > 1, and must not be changed while the event is
+     * queued.
+     */
+    uint8_t ev_prio;
     /**
      * Callback to call when the event is taken off of an event queue.
      * APIs, except for os_eventq_run(), assume this callback will be called by
@@ -57,6 +81,10 @@ struct os_event {
     void *ev_arg;
 
     STAILQ_ENTRY(os_event) ev_next;
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    /** os_cputime at which the event was last queued. */
+    uint32_t ev_put_time;
+#endif
 };
 
 /** Return whether or not the given event is queued. */
@@ -78,6 +106,32 @@ struct os_eventq_mon {
 };
 #endif
 
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+struct stats_os_eventq_stats;
+#endif
+
+#if MYNEWT_VAL(OS_EVENTQ_RING)
+/**
+ * Bounded single-producer ring attached to an event queue.  A producer,
+ * typically an interrupt handler, posts events to the ring with
+ * os_eventq_ring_put() without disabling interrupts; the task reading the
+ * event queue moves them onto the queue whenever it looks for events.
+ */
+struct os_eventq_ring {
+    /** Event queue the ring is attached to */
+    struct os_eventq *er_evq;
+    /** Ring storage, er_size entries */
+    struct os_event * volatile *er_buf;
+    /** Number of entries in the ring, a power of 2 */
+    uint16_t er_size;
+    /** Index of the next entry to write; only changed by the producer */
+    volatile uint16_t er_head;
+    /** Index of the next entry to read; only changed by the consumer */
+    volatile uint16_t er_tail;
+    SLIST_ENTRY(os_eventq_ring) er_next;
+};
+#endif
+
 struct os_eventq {
     /** Pointer to task that "owns" this event queue. */
     struct os_task *evq_owner;
@@ -87,7 +141,21 @@ struct os_eventq {
      */
     struct os_task *evq_task;
 
+#if OS_EVENTQ_PRIO_LEVELS > 1
+    /** Queued events, one list per priority level */
+    STAILQ_HEAD(, os_event) evq_list[OS_EVENTQ_PRIO_LEVELS];
+    /** Bit n set if evq_list[n] is not empty */
+    uint32_t evq_prio_map;
+#else
     STAILQ_HEAD(, os_event) evq_list;
+#endif
+#if MYNEWT_VAL(OS_EVENTQ_RING)
+    /** Producer rings attached to this event queue */
+    SLIST_HEAD(, os_eventq_ring) evq_rings;
+#endif
+    /** Events taken off by os_eventq_run_batch() and not run yet */
+    struct os_event **evq_batch;
+    uint8_t evq_batch_cnt;
 
 #if MYNEWT_VAL(OS_EVENTQ_DEBUG)
     /** Most recently processed event. */
@@ -97,6 +165,22 @@ struct os_eventq {
     struct os_eventq_mon *evq_mon;
     int evq_mon_elems;
 #endif
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    /** Number of events currently on the queue */
+    uint16_t evq_depth;
+    /** Largest number of events that were on the queue at once */
+    uint16_t evq_depth_max;
+#if OS_EVENTQ_PRIO_LEVELS > 1
+    /** Number of events currently queued at each priority level */
+    uint16_t evq_prio_depth[OS_EVENTQ_PRIO_LEVELS];
+    /** Largest number of events that were queued at each priority level */
+    uint16_t evq_prio_depth_max[OS_EVENTQ_PRIO_LEVELS];
+#endif
+    /** Longest time an event spent on the queue, in usecs */
+    uint32_t evq_latency_max;
+    /** Statistics of the queue, NULL if not registered */
+    struct stats_os_eventq_stats *evq_stats;
+#endif
 };
 
 /**
@@ -131,7 +215,8 @@ struct os_event *os_eventq_get_no_wait(struct os_eventq *evq);
 
 /**
  * Pull a single item from an event queue.  This function blocks until there
- * is an item on the event queue to read.
+ * is an item on the event queue to read.  With OS_EVENTQ_PRIO_LEVELS > 1,
+ * the oldest event of the highest non-empty priority level is returned.
  *
  * @param evq The event queue to pull an event from
  *
@@ -147,6 +232,34 @@ struct os_event *os_eventq_get(struct os_eventq *);
  */
 void os_eventq_run(struct os_eventq *evq);
 
+/**
+ * Pull a batch of events off the event queue and call their event
+ * callbacks.  This function blocks until there is at least one event on the
+ * queue, then runs events until max_events have been run, the queue is
+ * empty, or max_ticks have elapsed since the call, whichever comes first.
+ * At least one event is always run.
+ *
+ * Events are taken off the queue in groups of up to OS_EVENTQ_BATCH_SIZE,
+ * each group in a single critical section.  Each event is then claimed from
+ * its group in a short critical section of its own just before its callback
+ * is called; the callbacks run with interrupts enabled.  Until its callback
+ * is called, an event of a group still counts as queued: putting it again has
+ * no effect, and removing it (e.g. stopping a callout) from an earlier
+ * callback of the same group keeps it from running.  Events left over when
+ * the time budget runs out are put back at the head of the queue.  With
+ * OS_EVENTQ_PRIO_LEVELS > 1, the same happens to the rest of a group as
+ * soon as an event of a higher level than the next one is queued.
+ *
+ * @param evq        The event queue to pull the events off.
+ * @param max_events The maximum number of events to run; must be > 0.
+ * @param max_ticks  The time budget of the batch in OS ticks, or
+ *                   OS_TIMEOUT_NEVER for no limit.
+ *
+ * @return The number of events run
+ */
+int os_eventq_run_batch(struct os_eventq *evq, int max_events,
+                        os_time_t max_ticks);
+
 
 /**
  * Poll the list of event queues specified by the evq parameter
@@ -207,6 +320,58 @@ static inline void os_eventq_mon_stop(struct os_eventq *evq)
 }
 #endif
 
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+/**
+ * Register statistics for an event queue under the given name.  The queue
+ * depth high-water mark and the latency between an event being queued and
+ * its callback being called by os_eventq_run() or os_eventq_run_batch() are
+ * then exported through the stats package.  Up to OS_EVENTQ_STATS_MAX queues
+ * can be registered; the default event queue is registered as "os_evq_dflt".
+ *
+ * @param evq  The event queue to register
+ * @param name The name of the stats group
+ *
+ * @return 0 on success, OS_ENOMEM if no more queues can be registered, or
+ *         an error from the stats package.
+ */
+int os_eventq_stats_register(struct os_eventq *evq, const char *name);
+#endif
+
+#if MYNEWT_VAL(OS_EVENTQ_RING)
+/**
+ * Attach a producer ring to an event queue.  Events posted to the ring are
+ * delivered by the event queue in the order they were posted; relative to
+ * events posted with os_eventq_put() or to other rings they are delivered
+ * in the order the reading task picks them up.
+ *
+ * Each ring must only be posted to from a single context (e.g. one
+ * interrupt handler); use one ring per producer.  A given event must only
+ * ever be posted to one ring.
+ *
+ * @param evq  The event queue to attach the ring to
+ * @param ring The ring to initialize
+ * @param buf  Storage for the ring, must hold size entries
+ * @param size Number of entries in the ring; must be a power of 2
+ *
+ * @return 0 on success, OS_INVALID_PARM if size is not a power of 2
+ */
+int os_eventq_ring_init(struct os_eventq *evq, struct os_eventq_ring *ring,
+                        struct os_event **buf, uint16_t size);
+
+/**
+ * Post an event to an event queue through a producer ring, without
+ * disabling interrupts.  Interrupts are only disabled to wake up the task
+ * reading the event queue if it is sleeping.  Like os_eventq_put(), posting
+ * an event which is already queued has no effect.
+ *
+ * @param ring The ring to post to
+ * @param ev   The event to post
+ *
+ * @return 0 on success, OS_ENOMEM if the ring is full
+ */
+int os_eventq_ring_put(struct os_eventq_ring *ring, struct os_event *ev);
+#endif
+
 /**
  * @cond INTERNAL_HIDDEN
  * [DEPRECATED]
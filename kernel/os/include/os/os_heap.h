@@ -30,6 +30,8 @@
 #define H_OS_HEAP_
 
 #include <stddef.h>
+#include <inttypes.h>
+#include "syscfg/syscfg.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -70,6 +72,38 @@ void os_free(void *mem);
  */
 void *os_realloc(void *ptr, size_t size);
 
+#if MYNEWT_VAL(OS_MALLOC_SLAB)
+
+/**
+ * Information about an os_malloc() size class; see OS_MALLOC_SLAB.
+ */
+struct os_malloc_slab_info {
+    /** Size of the blocks in the class */
+    uint16_t omsi_block_size;
+    /** Number of blocks in the class */
+    uint16_t omsi_num_blocks;
+    /** Number of free blocks */
+    uint16_t omsi_num_free;
+    /** Minimum number of free blocks ever */
+    uint16_t omsi_min_free;
+    /** Number of allocations served from the class */
+    uint32_t omsi_hits;
+    /** Number of allocations that fell back to the heap */
+    uint32_t omsi_misses;
+};
+
+/**
+ * Retrieves information about an os_malloc() size class.
+ *
+ * @param idx The index of the class, starting from 0.
+ * @param omsi Filled in with information about the class.
+ *
+ * @return 0 on success; OS_ENOENT if there is no such class.
+ */
+int os_malloc_slab_info_get(int idx, struct os_malloc_slab_info *omsi);
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -55,9 +55,51 @@ struct os_mbuf_pool {
     struct os_mempool *omp_pool;
 
     STAILQ_ENTRY(os_mbuf_pool) omp_next;
+
+#if MYNEWT_VAL(MSYS_POOL_STATS)
+    /**
+     * Number of msys allocations that picked this pool as the best fit,
+     * found it exhausted and were served by a larger pool
+     */
+    uint32_t omp_fallback_cnt;
+    /**
+     * Number of msys allocations that picked this pool as the best fit and
+     * failed
+     */
+    uint32_t omp_fail_cnt;
+#endif
 };
 
 
+/**
+ * A read position within an mbuf chain.  Remembers the mbuf containing the
+ * position, so parsing a chain front to back costs O(1) per access instead
+ * of a walk from the head of the chain; see os_mbuf_cursor_init().
+ *
+ * The cursor stays valid as long as the mbufs up to the current position
+ * are neither removed nor resized.  All fields should be considered private.
+ */
+struct os_mbuf_cursor {
+    /** The start of the mbuf chain */
+    struct os_mbuf *omc_head;
+    /** The mbuf containing the current position */
+    struct os_mbuf *omc_cur;
+    /** Absolute offset of the start of omc_cur */
+    int omc_base;
+    /** Offset of the current position within omc_cur */
+    uint16_t omc_off;
+};
+
+/**
+ * A contiguous region of mbuf data; see os_mbuf_to_iov().
+ */
+struct os_mbuf_iov {
+    /** Start of the region */
+    void *omi_base;
+    /** Length of the region, in bytes */
+    uint16_t omi_len;
+};
+
 /**
  * A packet header structure that preceeds the mbuf packet headers.
  */
@@ -102,6 +144,19 @@ struct os_mbuf {
 
     SLIST_ENTRY(os_mbuf) om_next;
 
+#if MYNEWT_VAL(OS_MBUF_SHARE)
+    /**
+     * The mbuf whose buffer holds this mbuf's data, or NULL if the data is
+     * in this mbuf's own buffer; see os_mbuf_share()
+     */
+    struct os_mbuf *om_shared;
+    /**
+     * Number of references to this mbuf's memory block: one while this
+     * header is in use, plus one for every mbuf whose om_shared points here
+     */
+    uint16_t om_refcnt;
+#endif
+
     /**
      * Pointer to the beginning of the data, after this buffer
      */
@@ -132,6 +187,19 @@ struct os_mqueue {
 #define OS_MBUF_IS_PKTHDR(__om) \
     ((__om)->om_pkthdr_len >= sizeof (struct os_mbuf_pkthdr))
 
+/**
+ * Checks whether the data of a given mbuf is shared with other mbufs, and
+ * therefore must not be modified in place; see os_mbuf_share().
+ *
+ * @param __om The mbuf to check
+ */
+#if MYNEWT_VAL(OS_MBUF_SHARE)
+#define OS_MBUF_IS_SHARED(__om)                                 \
+    (((__om)->om_shared != NULL ? (__om)->om_shared : (__om))->om_refcnt > 1)
+#else
+#define OS_MBUF_IS_SHARED(__om) 0
+#endif
+
 /** Get a packet header pointer given an mbuf pointer */
 #define OS_MBUF_PKTHDR(__om) ((struct os_mbuf_pkthdr *)     \
     ((uint8_t *)&(__om)->om_data + sizeof(struct os_mbuf)))
@@ -175,22 +243,49 @@ struct os_mqueue {
 
 /** @cond INTERNAL_HIDDEN */
 
+/*
+ * Returns the mbuf whose buffer holds the data of the specified mbuf, or
+ * NULL if that buffer is shared and must not be written to.
+ */
+static inline struct os_mbuf *
+_os_mbuf_data_owner(struct os_mbuf *om)
+{
+#if MYNEWT_VAL(OS_MBUF_SHARE)
+    struct os_mbuf *owner;
+
+    owner = om->om_shared != NULL ? om->om_shared : om;
+    if (owner->om_refcnt > 1) {
+        return NULL;
+    }
+
+    return owner;
+#else
+    return om;
+#endif
+}
+
 /*
  * Called by OS_MBUF_LEADINGSPACE() macro
  */
 static inline uint16_t
 _os_mbuf_leadingspace(struct os_mbuf *om)
 {
+    struct os_mbuf *owner;
     uint16_t startoff;
     uint16_t leadingspace;
 
+    owner = _os_mbuf_data_owner(om);
+    if (owner == NULL) {
+        return 0;
+    }
+
     startoff = 0;
-    if (OS_MBUF_IS_PKTHDR(om)) {
-        startoff = om->om_pkthdr_len;
+    if (OS_MBUF_IS_PKTHDR(owner)) {
+        startoff = owner->om_pkthdr_len;
     }
 
     leadingspace = (uint16_t) (OS_MBUF_DATA(om, uint8_t *) -
-        ((uint8_t *) &om->om_databuf[0] + startoff));
+        ((uint8_t *) &owner->om_databuf[0] + startoff));
 
     return (leadingspace);
 }
@@ -200,7 +295,8 @@ _os_mbuf_leadingspace(struct os_mbuf *om)
 /**
  * Returns the leading space (space at the beginning) of the mbuf.
  * Works on both packet header, and regular mbufs, as it accounts
- * for the additional space allocated to the packet header.
+ * for the additional space allocated to the packet header.  Data shared
+ * with other mbufs (see os_mbuf_share()) has no leading space.
  *
  * @param __omp Is the mbuf pool (which contains packet header length.)
  * @param __om  Is the mbuf in that pool to get the leadingspace for
@@ -217,10 +313,16 @@ static inline uint16_t
 _os_mbuf_trailingspace(struct os_mbuf *om)
 {
     struct os_mbuf_pool *omp;
+    struct os_mbuf *owner;
+
+    owner = _os_mbuf_data_owner(om);
+    if (owner == NULL) {
+        return 0;
+    }
 
-    omp = om->om_omp;
+    omp = owner->om_omp;
 
-    return (&om->om_databuf[0] + omp->omp_databuf_len) -
+    return (&owner->om_databuf[0] + omp->omp_databuf_len) -
       (om->om_data + om->om_len);
 }
 
@@ -228,7 +330,8 @@ _os_mbuf_trailingspace(struct os_mbuf *om)
 
 /**
  * Returns the trailing space (space at the end) of the mbuf.
- * Works on both packet header and regular mbufs.
+ * Works on both packet header and regular mbufs.  Data shared with other
+ * mbufs (see os_mbuf_share()) has no trailing space.
  *
  * @param __omp The mbuf pool for this mbuf
  * @param __om  Is the mbuf in that pool to get trailing space for
@@ -298,7 +401,9 @@ int os_msys_register(struct os_mbuf_pool *);
 
 /**
  * Allocate a mbuf from msys.  Based upon the data size requested,
- * os_msys_get() will choose the mbuf pool that has the best fit.
+ * os_msys_get() will choose the mbuf pool that has the best fit.  If that
+ * pool is exhausted and MSYS_FALLBACK is enabled, the next larger pool with
+ * free mbufs is used instead.
  *
  * @param dsize The estimated size of the data being stored in the mbuf
  * @param leadingspace The amount of leadingspace to allocate in the mbuf
@@ -337,6 +442,135 @@ int os_msys_count(void);
  */
 int os_msys_num_free(void);
 
+#if MYNEWT_VAL(MSYS_POOL_STATS)
+
+/**
+ * Information about a pool registered with msys; see MSYS_POOL_STATS.
+ */
+struct os_msys_pool_info {
+    /** Length of the data buffer in each mbuf */
+    uint16_t ompi_databuf_len;
+    /** Number of mbufs in the pool */
+    uint16_t ompi_num_blocks;
+    /** Number of free mbufs */
+    uint16_t ompi_num_free;
+    /** Minimum number of free mbufs ever */
+    uint16_t ompi_min_free;
+    /** Number of best-fit allocations served by a larger pool */
+    uint32_t ompi_fallbacks;
+    /** Number of best-fit allocations that failed */
+    uint32_t ompi_failures;
+};
+
+/**
+ * Retrieves information about a pool registered with msys.
+ *
+ * @param idx The index of the pool, starting from 0 for the smallest.
+ * @param ompi Filled in with information about the pool.
+ *
+ * @return 0 on success; OS_ENOENT if there is no such pool.
+ */
+int os_msys_pool_info_get(int idx, struct os_msys_pool_info *ompi);
+
+#endif
+
+/**
+ * Positions a cursor at the start of an mbuf chain.
+ *
+ * @param omc                   The cursor to initialize.
+ * @param om                    The start of the mbuf chain.
+ */
+void os_mbuf_cursor_init(struct os_mbuf_cursor *omc, struct os_mbuf *om);
+
+/**
+ * Returns the absolute offset of a cursor within its mbuf chain.
+ */
+static inline int
+os_mbuf_cursor_tell(const struct os_mbuf_cursor *omc)
+{
+    return omc->omc_base + omc->omc_off;
+}
+
+/**
+ * Moves a cursor to the specified absolute offset.  Seeking forward only
+ * walks the mbufs between the current and the new position; seeking
+ * backwards restarts from the head of the chain.  The offset can be equal
+ * to the total length of the chain, but no greater.
+ *
+ * @param omc                   The cursor to move.
+ * @param off                   The absolute offset to move to.
+ *
+ * @return                      0 on success;
+ *                              OS_EINVAL if the offset is out of bounds, in
+ *                                  which case the cursor is not moved.
+ */
+int os_mbuf_cursor_seek(struct os_mbuf_cursor *omc, int off);
+
+/**
+ * Moves a cursor forward by the specified number of bytes.
+ *
+ * @return                      0 on success;
+ *                              OS_EINVAL if the chain is too short, in which
+ *                                  case the cursor is not moved.
+ */
+int os_mbuf_cursor_advance(struct os_mbuf_cursor *omc, int len);
+
+/**
+ * Copies data at the current position of a cursor into a flat buffer
+ * without moving the cursor.
+ *
+ * @param omc                   The cursor to read at.
+ * @param dst                   The buffer to copy into.
+ * @param len                   The number of bytes to copy.
+ *
+ * @return                      0 on success;
+ *                              OS_EINVAL if the chain is too short.
+ */
+int os_mbuf_cursor_peek(const struct os_mbuf_cursor *omc, void *dst, int len);
+
+/**
+ * Copies data at the current position of a cursor into a flat buffer and
+ * moves the cursor past it.
+ *
+ * @return                      0 on success;
+ *                              OS_EINVAL if the chain is too short, in which
+ *                                  case the cursor is not moved.
+ */
+int os_mbuf_cursor_read(struct os_mbuf_cursor *omc, void *dst, int len);
+
+/**
+ * Performs a memory compare of the data at the current position of a cursor
+ * against a flat buffer.  The cursor is not moved.
+ *
+ * @return                      0 if both memory regions are identical;
+ *                              A memcmp return code if there is a mismatch;
+ *                              INT_MAX if the mbuf chain is too short.
+ */
+int os_mbuf_cursor_cmp(const struct os_mbuf_cursor *omc, const void *data,
+                       int len);
+
+/**
+ * Describes a region of an mbuf chain as an array of contiguous segments,
+ * one per mbuf, without copying any data.  Empty mbufs are skipped.  The
+ * segments point into the chain itself and are only valid until the chain
+ * is modified or freed.
+ *
+ * @param om                    The mbuf chain to describe.
+ * @param off                   The offset of the region within the chain.
+ * @param len                   The length of the region.
+ * @param iov                   Filled with the segments.
+ * @param iov_cnt               On input, the capacity of iov.  On output,
+ *                                  the number of segments filled in.
+ *
+ * @return                      0 on success;
+ *                              OS_EINVAL if the chain is too short;
+ *                              OS_ENOMEM if the region does not fit in
+ *                                  iov.  The segments filled in describe
+ *                                  the start of the region.
+ */
+int os_mbuf_to_iov(const struct os_mbuf *om, int off, int len,
+                   struct os_mbuf_iov *iov, int *iov_cnt);
+
 /**
  * Initialize a pool of mbufs.
  *
@@ -362,6 +596,22 @@ int os_mbuf_pool_init(struct os_mbuf_pool *, struct os_mempool *mp,
  */
 struct os_mbuf *os_mbuf_get(struct os_mbuf_pool *omp, uint16_t);
 
+/**
+ * Get a chain of mbufs from the mbuf pool.  Blocks are taken from the
+ * underlying mempool in batches, so this is cheaper than calling
+ * os_mbuf_get() repeatedly.  Either the whole chain is allocated or nothing
+ * is.
+ *
+ * @param omp The mbuf pool to return the mbufs from
+ * @param leadingspace The amount of leadingspace to put before the data
+ *     section of every mbuf in the chain.
+ * @param count The number of mbufs in the chain
+ *
+ * @return The head of an initialized chain on success, and NULL on failure.
+ */
+struct os_mbuf *os_mbuf_get_chain(struct os_mbuf_pool *omp,
+                                  uint16_t leadingspace, int count);
+
 /**
  * Allocate a new packet header mbuf out of the os_mbuf_pool.
  *
@@ -383,6 +633,39 @@ struct os_mbuf *os_mbuf_get_pkthdr(struct os_mbuf_pool *omp,
  */
 struct os_mbuf *os_mbuf_dup(struct os_mbuf *m);
 
+#if MYNEWT_VAL(OS_MBUF_SHARE)
+/**
+ * Creates a chain that refers to the data of an existing chain instead of
+ * copying it.  Each mbuf of the new chain is allocated from the specified
+ * pool, but only holds a header (and the packet header of the first mbuf);
+ * the data stays in the original buffers, which are released once the last
+ * chain referring to them is freed.
+ *
+ * Shared data is copy-on-write: os_mbuf_prepend(), os_mbuf_extend(),
+ * os_mbuf_append() and the like add new mbufs from the chain's pool rather
+ * than use the free space of a shared buffer, and os_mbuf_copyinto() copies
+ * a shared buffer before modifying it.  Code that writes through om_data
+ * directly must call os_mbuf_unshare() first.
+ *
+ * @param omp The mbuf pool to allocate the new headers out of
+ * @param om  The mbuf chain to share
+ *
+ * @return A pointer to the new chain of mbufs, or NULL on failure
+ */
+struct os_mbuf *os_mbuf_share(struct os_mbuf_pool *omp, struct os_mbuf *om);
+
+/**
+ * Gives every mbuf of a chain whose data is shared a private copy of that
+ * data, so the chain can be modified in place.  Copies are allocated from
+ * the pools the shared data was originally allocated from.
+ *
+ * @param om The mbuf chain to make writable
+ *
+ * @return 0 on success; OS_ENOMEM if a copy could not be allocated
+ */
+int os_mbuf_unshare(struct os_mbuf *om);
+#endif
+
 /**
  * Locates the specified absolute offset within an mbuf chain.  The offset
  * can be one past than the total length of the chain, but no greater.
@@ -468,7 +751,8 @@ int os_mbuf_appendfrom(struct os_mbuf *dst, const struct os_mbuf *src,
 int os_mbuf_free(struct os_mbuf *mb);
 
 /**
- * Free a chain of mbufs
+ * Free a chain of mbufs.  Consecutive mbufs from the same pool are returned
+ * to it in batches.
  *
  * @param omp The mbuf pool to free the chain of mbufs into
  * @param om  The starting mbuf of the chain to free back into the pool
@@ -70,6 +70,10 @@ struct os_mempool {
     SLIST_HEAD(,os_memblock);
     /** Name for memory block */
     char *name;
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+    /** Bitmap of allocated blocks, NULL if none is attached. */
+    uint32_t *mp_alloc_map;
+#endif
 };
 
 /**
@@ -168,6 +172,12 @@ typedef uint64_t os_membuf_t;
 #define OS_MEMPOOL_BYTES(n,blksize)     \
     (sizeof (os_membuf_t) * OS_MEMPOOL_SIZE((n), (blksize)))
 
+/**
+ * Number of uint32_t words of allocation bitmap needed for a pool of n
+ * blocks.
+ */
+#define OS_MEMPOOL_MAP_WORDS(n) (((n) + 31) / 32)
+
 
 /**
  * Initialize a memory pool.
@@ -219,6 +229,23 @@ os_error_t os_mempool_unregister(struct os_mempool *mp);
  */
 os_error_t os_mempool_clear(struct os_mempool *mp);
 
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+/**
+ * Attaches an allocation bitmap to a memory pool, making the duplicate free
+ * check constant time.  Pools without a bitmap fall back to walking the free
+ * list.  Must be called before any block is taken from the pool.  The msys
+ * pools and the os_malloc() size classes have one attached at init.
+ *
+ * @param mp                    The mempool to attach the bitmap to
+ * @param map                   Bitmap storage of at least
+ *                                  OS_MEMPOOL_MAP_WORDS(blocks) words
+ *
+ * @return 0 on success;
+ *         OS_INVALID_PARM if blocks have already been taken from the pool.
+ */
+os_error_t os_mempool_map_attach(struct os_mempool *mp, uint32_t *map);
+#endif
+
 /**
  * Performs an integrity check of the specified mempool.  This function
  * attempts to detect memory corruption in the specified memory pool.
@@ -273,6 +300,35 @@ os_error_t os_memblock_put_from_cb(struct os_mempool *mp, void *block_addr);
  */
 os_error_t os_memblock_put(struct os_mempool *mp, void *block_addr);
 
+/**
+ * Gets several memory blocks from a memory pool in a single critical
+ * section.  Either all requested blocks are allocated or none are.
+ *
+ * @param mp Pointer to the memory pool
+ * @param blocks Array to fill with pointers to the allocated blocks
+ * @param n Number of blocks to allocate
+ *
+ * @return OS_OK on success; OS_ENOMEM if fewer than n blocks are free;
+ *         OS_INVALID_PARM on bad arguments.
+ */
+os_error_t os_memblock_get_n(struct os_mempool *mp, void **blocks,
+                             uint16_t n);
+
+/**
+ * Puts several memory blocks back into a memory pool.  The blocks are linked
+ * into a list up front and spliced onto the free list in a single critical
+ * section.  For an extended mempool with a put callback, the callback is
+ * called once per block, as with os_memblock_put().
+ *
+ * @param mp Pointer to the memory pool
+ * @param blocks Array of pointers to the blocks to free
+ * @param n Number of blocks in the array
+ *
+ * @return os_error_t
+ */
+os_error_t os_memblock_put_n(struct os_mempool *mp, void **blocks,
+                             uint16_t n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,187 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * @addtogroup OSKernel
+ * @{
+ *   @defgroup OSMsgq Message Queues
+ *   @{
+ */
+
+#ifndef _OS_MSGQ_H_
+#define _OS_MSGQ_H_
+
+#include <stdint.h>
+#include "os/queue.h"
+#include "os/os_error.h"
+#include "os/os_task.h"
+#include "os/os_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Size of the buffer needed to hold a queue of msg_count messages of
+ * msg_size bytes each.
+ */
+#define OS_MSGQ_BUF_SIZE(msg_size, msg_count)   ((msg_size) * (msg_count))
+
+/**
+ * Structure representing a bounded queue of fixed-size messages.  Messages
+ * are copied in and out of a ring buffer supplied by the user, so no
+ * allocation is needed per message.  Any number of tasks can send to and
+ * receive from a queue.
+ */
+struct os_msgq {
+    /** Tasks waiting for a message, in priority order */
+    SLIST_HEAD(, os_task) mq_recv_head;
+    /** Tasks waiting for free space, in priority order */
+    struct os_task_obj mq_send_obj;
+    /** Ring buffer holding mq_capacity messages */
+    uint8_t *mq_buf;
+    /** Size of a message, in bytes */
+    uint16_t mq_msg_size;
+    /** Maximum number of queued messages */
+    uint16_t mq_capacity;
+    /** Number of queued messages */
+    uint16_t mq_count;
+    /** Index of the oldest message */
+    uint16_t mq_head;
+    /** Index the next message is written to */
+    uint16_t mq_tail;
+};
+
+/**
+ * Initialize a message queue.
+ *
+ * @param mq Pointer to message queue
+ * @param buf Buffer for the messages; at least
+ *            OS_MSGQ_BUF_SIZE(msg_size, msg_count) bytes.
+ * @param msg_size Size of a message, in bytes
+ * @param msg_count Maximum number of queued messages
+ *
+ * @return os_error_t
+ *      OS_INVALID_PARM     A pointer was NULL or a size was 0.
+ *      OS_OK               no error.
+ */
+os_error_t os_msgq_init(struct os_msgq *mq, void *buf, uint16_t msg_size,
+                        uint16_t msg_count);
+
+/**
+ * Copy a message to the tail of a queue, waiting for free space if the
+ * queue is full.  With a timeout of 0 this never blocks and can be called
+ * from an interrupt or before the OS is started.
+ *
+ * @param mq Pointer to message queue
+ * @param msg Message to send; mq_msg_size bytes are copied.
+ * @param timeout Timeout, in os ticks.
+ *                A timeout of 0 means do not wait if the queue is full.
+ *                A timeout of OS_TIMEOUT_NEVER means wait forever.
+ *
+ * @return os_error_t
+ *      OS_INVALID_PARM     Queue or message passed in was NULL.
+ *      OS_NOT_STARTED      The queue is full and the OS is not started.
+ *      OS_TIMEOUT          The queue stayed full for the timeout.
+ *      OS_OK               no error.
+ */
+os_error_t os_msgq_send(struct os_msgq *mq, const void *msg,
+                        os_time_t timeout);
+
+/**
+ * Send a message without waiting; safe to call from an interrupt.
+ *
+ * @return os_error_t
+ *      OS_INVALID_PARM     Queue or message passed in was NULL.
+ *      OS_TIMEOUT          The queue is full.
+ *      OS_OK               no error.
+ */
+static inline os_error_t
+os_msgq_try_send(struct os_msgq *mq, const void *msg)
+{
+    return os_msgq_send(mq, msg, 0);
+}
+
+/**
+ * Copy the oldest message out of a queue, waiting for one if the queue is
+ * empty.
+ *
+ * @param mq Pointer to message queue
+ * @param msg Buffer receiving mq_msg_size bytes
+ * @param timeout Timeout, in os ticks.
+ *                A timeout of 0 means do not wait if the queue is empty.
+ *                A timeout of OS_TIMEOUT_NEVER means wait forever.
+ *
+ * @return os_error_t
+ *      OS_INVALID_PARM     Queue or buffer passed in was NULL.
+ *      OS_NOT_STARTED      The queue is empty and the OS is not started.
+ *      OS_TIMEOUT          The queue stayed empty for the timeout.
+ *      OS_OK               no error.
+ */
+os_error_t os_msgq_recv(struct os_msgq *mq, void *msg, os_time_t timeout);
+
+/**
+ * Copy up to max_cnt of the oldest messages out of a queue in one go,
+ * waiting for at least one if the queue is empty.
+ *
+ * @param mq Pointer to message queue
+ * @param buf Buffer receiving up to max_cnt messages of mq_msg_size bytes
+ * @param max_cnt Maximum number of messages to receive
+ * @param timeout Timeout, in os ticks; see os_msgq_recv().
+ * @param out_cnt On return, the number of messages received.  Can be NULL.
+ *
+ * @return os_error_t
+ *      OS_INVALID_PARM     Queue or buffer passed in was NULL, or max_cnt
+ *                          was 0.
+ *      OS_NOT_STARTED      The queue is empty and the OS is not started.
+ *      OS_TIMEOUT          The queue stayed empty for the timeout.
+ *      OS_OK               no error.
+ */
+os_error_t os_msgq_recv_multi(struct os_msgq *mq, void *buf, uint16_t max_cnt,
+                              os_time_t timeout, uint16_t *out_cnt);
+
+/**
+ * Get the number of messages currently queued.
+ */
+static inline uint16_t
+os_msgq_count(const struct os_msgq *mq)
+{
+    return mq->mq_count;
+}
+
+/**
+ * Get the number of messages that can be sent without blocking.
+ */
+static inline uint16_t
+os_msgq_space(const struct os_msgq *mq)
+{
+    return mq->mq_capacity - mq->mq_count;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _OS_MSGQ_H_ */
+
+
+/**
+ *   @} OSMsgq
+ * @} OSKernel
+ */
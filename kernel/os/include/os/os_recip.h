@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * @addtogroup OSKernel
+ * @{
+ *   @defgroup OSRecip Division by Constants
+ *   @{
+ */
+
+#ifndef H_OS_RECIP_
+#define H_OS_RECIP_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Unsigned 32-bit division by a constant, done with a multiplication and
+ * shifts (Granlund and Montgomery, "Division by Invariant Integers using
+ * Multiplication", figure 4.1).  For a divisor d with l = ceil(log2(d)):
+ *
+ *     m = floor(2^32 * (2^l - d) / d) + 1
+ *     t = (x * m) >> 32
+ *     x / d = (t + ((x - t) >> min(l, 1))) >> max(l - 1, 0)
+ *
+ * which is exact for every 32-bit x and d.  When d is a compile-time
+ * constant, so are m and both shifts, and only a 32x32->64 multiply remains
+ * at runtime; this matters on cores without a hardware divider, where even
+ * 32-bit divisions are library calls.
+ */
+
+/** ceil(log2(d)), for d >= 1 */
+#define OS_RECIP_LOG2_CEIL(d)                                       \
+    ((d) <= 1 ? 0 : 32 - __builtin_clz((uint32_t)(d) - 1))
+
+/** Multiplier for dividing by d */
+#define OS_RECIP_M(d)                                               \
+    ((uint32_t)((((uint64_t)1 << 32) *                              \
+                 (((uint64_t)1 << OS_RECIP_LOG2_CEIL(d)) - (d))) /  \
+                (d) + 1))
+
+/** First shift for dividing by d */
+#define OS_RECIP_SH1(d)     (OS_RECIP_LOG2_CEIL(d) > 0 ? 1 : 0)
+
+/** Second shift for dividing by d */
+#define OS_RECIP_SH2(d)     (OS_RECIP_LOG2_CEIL(d) > 0 ?            \
+                             OS_RECIP_LOG2_CEIL(d) - 1 : 0)
+
+/**
+ * Divides by a divisor given as its precomputed reciprocal; see
+ * OS_RECIP_DIV().
+ */
+static inline uint32_t
+os_recip_div(uint32_t x, uint32_t m, int sh1, int sh2)
+{
+    uint32_t t;
+
+    t = ((uint64_t)x * m) >> 32;
+    return (t + ((x - t) >> sh1)) >> sh2;
+}
+
+/**
+ * Computes floor(x * num / den), where num / den is given in lowest terms
+ * with den as its precomputed reciprocal; see OS_RECIP_SCALE().
+ * num * den must be less than 2^32.
+ */
+static inline uint64_t
+os_recip_scale(uint32_t x, uint32_t num, uint32_t den, uint32_t m, int sh1,
+               int sh2)
+{
+    uint32_t q;
+    uint32_t r;
+
+    /* x * num / den = q * num + r * num / den, with r * num < den * num */
+    q = os_recip_div(x, m, sh1, sh2);
+    r = x - q * den;
+    return (uint64_t)q * num + os_recip_div(r * num, m, sh1, sh2);
+}
+
+/**
+ * floor(x / d) for a 32-bit x; d should be a compile-time constant.
+ */
+#define OS_RECIP_DIV(x, d)                                          \
+    os_recip_div((x), OS_RECIP_M(d), OS_RECIP_SH1(d), OS_RECIP_SH2(d))
+
+/* Common power of 2 factor of n and d, as a shift */
+#define OS_RECIP_CTZ(n, d)                                          \
+    (__builtin_ctz(n) < __builtin_ctz(d) ? __builtin_ctz(n) : __builtin_ctz(d))
+
+/**
+ * Numerator and denominator of num / den with the common power of 2 factor
+ * removed.
+ */
+#define OS_RECIP_NUM(num, den)  ((num) >> OS_RECIP_CTZ(num, den))
+#define OS_RECIP_DEN(num, den)  ((den) >> OS_RECIP_CTZ(num, den))
+
+/**
+ * floor(x * num / den) for a 32-bit x, as a 64-bit value; num and den should
+ * be compile-time constants.  Once their common power of 2 factor is
+ * removed, the product of num and den must be less than 2^32; see
+ * OS_RECIP_SCALE_OK().
+ */
+#define OS_RECIP_SCALE(x, num, den)                                 \
+    os_recip_scale((x), OS_RECIP_NUM(num, den), OS_RECIP_DEN(num, den), \
+                   OS_RECIP_M(OS_RECIP_DEN(num, den)),              \
+                   OS_RECIP_SH1(OS_RECIP_DEN(num, den)),            \
+                   OS_RECIP_SH2(OS_RECIP_DEN(num, den)))
+
+/** Whether OS_RECIP_SCALE() can be used with num and den. */
+#define OS_RECIP_SCALE_OK(num, den)                                 \
+    ((uint64_t)OS_RECIP_NUM(num, den) * OS_RECIP_DEN(num, den) <    \
+     ((uint64_t)1 << 32))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/**
+ *   @} OSRecip
+ * @} OSKernel
+ */
@@ -75,6 +75,10 @@ typedef enum os_task_state {
 #define OS_TASK_FLAG_MUTEX_WAIT     (0x04U)
 /** Task waiting on a event queue */
 #define OS_TASK_FLAG_EVQ_WAIT       (0x08U)
+/** Task waiting on a message queue */
+#define OS_TASK_FLAG_MSGQ_WAIT      (0x10U)
+/** Task waiting on an event group */
+#define OS_TASK_FLAG_EVG_WAIT       (0x20U)
 
 typedef void (*os_task_func_t)(void *);
 
@@ -100,6 +104,14 @@ struct os_task {
     uint8_t t_flags;
     uint8_t t_lockcnt;
     uint8_t t_pad;
+#if MYNEWT_VAL(OS_SCHED_PRIO_BITMAP)
+    /** Priority the task was queued at in the run list */
+    uint8_t t_run_prio;
+#endif
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+    /** Position of the task in the sleep heap */
+    uint8_t t_sleep_idx;
+#endif
 
     /** Task name */
     const char *t_name;
@@ -123,6 +135,20 @@ struct os_task {
      * execution.
      */
     uint32_t t_ctx_sw_cnt;
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+    /** Total time spent running, in os_cputime ticks */
+    uint64_t t_cpu_time;
+    /** Longest time run without being switched out, in os_cputime ticks */
+    uint32_t t_run_max;
+    /** os_cputime at which the task last became ready to run */
+    uint32_t t_ready_time;
+    /**
+     * Histogram of the time between becoming ready and running.  Bucket 0
+     * counts latencies below 16 usecs, bucket n latencies from 2^(n+3) to
+     * 2^(n+4) usecs, and the last bucket everything longer.
+     */
+    uint32_t t_lat_hist[MYNEWT_VAL(OS_TASK_RUN_STATS_LAT_BUCKETS)];
+#endif
 
     STAILQ_ENTRY(os_task) t_os_task_list;
     TAILQ_ENTRY(os_task) t_os_list;
@@ -195,6 +221,14 @@ struct os_task_info {
     os_time_t oti_last_checkin;
     /** Next time this task is scheduled to check-in with sanity */
     os_time_t oti_next_checkin;
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+    /** Total time spent running, in usecs */
+    uint64_t oti_cpu_time;
+    /** Longest time run without being switched out, in usecs */
+    uint32_t oti_run_max;
+    /** Scheduling latency histogram, see t_lat_hist */
+    uint32_t oti_lat_hist[MYNEWT_VAL(OS_TASK_RUN_STATS_LAT_BUCKETS)];
+#endif
     /** Name of this task */
     char oti_name[OS_TASK_MAX_NAME_LEN];
 };
@@ -63,6 +63,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "os/os_arch.h"
+#include "os/os_recip.h"
 #include "os/queue.h"
 
 #ifdef __cplusplus
@@ -296,7 +297,7 @@ os_time_ms_to_ticks32(uint32_t ms)
 #if OS_TICKS_PER_SEC == 1000
     return ms;
 #else
-    return ((uint64_t)ms * OS_TICKS_PER_SEC) / 1000;
+    return OS_RECIP_SCALE(ms, OS_TICKS_PER_SEC, 1000);
 #endif
 }
 
@@ -316,7 +317,7 @@ os_time_ticks_to_ms32(os_time_t ticks)
 #if OS_TICKS_PER_SEC == 1000
     return ticks;
 #else
-    return ((uint64_t)ticks * 1000) / OS_TICKS_PER_SEC;
+    return OS_RECIP_SCALE(ticks, 1000, OS_TICKS_PER_SEC);
 #endif
 }
 
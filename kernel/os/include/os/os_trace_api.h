@@ -22,9 +22,15 @@
 
 #ifdef __ASSEMBLER__
 
+#if MYNEWT_VAL(OS_TRACE_RAM)
+#define os_trace_isr_enter              trace_ram_isr_enter
+#define os_trace_isr_exit               trace_ram_isr_exit
+#define os_trace_task_start_exec        trace_ram_task_start_exec
+#else
 #define os_trace_isr_enter              SEGGER_SYSVIEW_RecordEnterISR
 #define os_trace_isr_exit               SEGGER_SYSVIEW_RecordExitISR
 #define os_trace_task_start_exec        SEGGER_SYSVIEW_OnTaskStartExec
+#endif
 
 #else
 
@@ -34,6 +40,9 @@
 #if MYNEWT_VAL(OS_SYSVIEW)
 #include "sysview/vendor/SEGGER_SYSVIEW.h"
 #endif
+#if MYNEWT_VAL(OS_TRACE_RAM)
+#include "trace_ram/trace_ram.h"
+#endif
 #include "os/os.h"
 
 #define OS_TRACE_ID_EVENTQ_PUT                  (40)
@@ -55,10 +64,22 @@
 #define OS_TRACE_ID_MEMBLOCK_GET                (80)
 #define OS_TRACE_ID_MEMBLOCK_PUT_FROM_CB        (81)
 #define OS_TRACE_ID_MEMBLOCK_PUT                (82)
+#define OS_TRACE_ID_MEMBLOCK_GET_N              (83)
+#define OS_TRACE_ID_MEMBLOCK_PUT_N              (84)
 #define OS_TRACE_ID_MBUF_GET                    (90)
 #define OS_TRACE_ID_MBUF_GET_PKTHDR             (91)
 #define OS_TRACE_ID_MBUF_FREE                   (92)
 #define OS_TRACE_ID_MBUF_FREE_CHAIN             (93)
+#define OS_TRACE_ID_MBUF_GET_CHAIN              (94)
+#define OS_TRACE_ID_MBUF_SHARE                  (95)
+#define OS_TRACE_ID_EVENT_GROUP_INIT            (100)
+#define OS_TRACE_ID_EVENT_GROUP_SET             (101)
+#define OS_TRACE_ID_EVENT_GROUP_CLEAR           (102)
+#define OS_TRACE_ID_EVENT_GROUP_WAIT            (103)
+#define OS_TRACE_ID_MSGQ_INIT                   (110)
+#define OS_TRACE_ID_MSGQ_SEND                   (111)
+#define OS_TRACE_ID_MSGQ_RECV                   (112)
+#define OS_TRACE_ID_MSGQ_RECV_MULTI             (113)
 
 #if MYNEWT_VAL(OS_SYSVIEW)
 
@@ -204,7 +225,120 @@ os_trace_api_ret_u32(unsigned id, uint32_t ret)
 
 #endif /* MYNEWT_VAL(OS_SYSVIEW) && !defined(OS_TRACE_DISABLE_FILE_API) */
 
-#if !MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_TRACE_RAM)
+
+static inline void
+os_trace_isr_enter(void)
+{
+    trace_ram_isr_enter();
+}
+
+static inline void
+os_trace_isr_exit(void)
+{
+    trace_ram_isr_exit();
+}
+
+static inline void
+os_trace_task_info(const struct os_task *t)
+{
+    /* Task names and priorities are part of the dump, not of the trace. */
+}
+
+static inline void
+os_trace_task_create(const struct os_task *t)
+{
+    trace_ram_record(TRACE_RAM_REC_TASK_CREATE, 0, 2,
+                     (uint32_t)(uintptr_t)t, t->t_prio, 0);
+}
+
+static inline void
+os_trace_task_start_exec(const struct os_task *t)
+{
+    trace_ram_task_start_exec(t);
+}
+
+static inline void
+os_trace_task_stop_exec(void)
+{
+    trace_ram_record(TRACE_RAM_REC_TASK_STOP_EXEC, 0, 0, 0, 0, 0);
+}
+
+static inline void
+os_trace_task_start_ready(const struct os_task *t)
+{
+    trace_ram_record(TRACE_RAM_REC_TASK_START_READY, 0, 1,
+                     (uint32_t)(uintptr_t)t, 0, 0);
+}
+
+static inline void
+os_trace_task_stop_ready(const struct os_task *t, unsigned reason)
+{
+    trace_ram_record(TRACE_RAM_REC_TASK_STOP_READY, 0, 2,
+                     (uint32_t)(uintptr_t)t, reason, 0);
+}
+
+static inline void
+os_trace_idle(void)
+{
+    trace_ram_record(TRACE_RAM_REC_IDLE, 0, 0, 0, 0, 0);
+}
+
+static inline void
+os_trace_user_start(unsigned id)
+{
+    trace_ram_record(TRACE_RAM_REC_USER_START, id, 0, 0, 0, 0);
+}
+
+static inline void
+os_trace_user_stop(unsigned id)
+{
+    trace_ram_record(TRACE_RAM_REC_USER_STOP, id, 0, 0, 0, 0);
+}
+
+#endif /* MYNEWT_VAL(OS_TRACE_RAM) */
+
+#if MYNEWT_VAL(OS_TRACE_RAM) && !defined(OS_TRACE_DISABLE_FILE_API)
+
+static inline void
+os_trace_api_void(unsigned id)
+{
+    trace_ram_record(TRACE_RAM_REC_API_CALL, id, 0, 0, 0, 0);
+}
+
+static inline void
+os_trace_api_u32(unsigned id, uint32_t p0)
+{
+    trace_ram_record(TRACE_RAM_REC_API_CALL, id, 1, p0, 0, 0);
+}
+
+static inline void
+os_trace_api_u32x2(unsigned id, uint32_t p0, uint32_t p1)
+{
+    trace_ram_record(TRACE_RAM_REC_API_CALL, id, 2, p0, p1, 0);
+}
+
+static inline void
+os_trace_api_u32x3(unsigned id, uint32_t p0, uint32_t p1, uint32_t p2)
+{
+    trace_ram_record(TRACE_RAM_REC_API_CALL, id, 3, p0, p1, p2);
+}
+
+static inline void
+os_trace_api_ret(unsigned id)
+{
+    trace_ram_record(TRACE_RAM_REC_API_RET, id, 0, 0, 0, 0);
+}
+
+static inline void
+os_trace_api_ret_u32(unsigned id, uint32_t ret)
+{
+    trace_ram_record(TRACE_RAM_REC_API_RET, id, 1, ret, 0, 0);
+}
+
+#endif /* MYNEWT_VAL(OS_TRACE_RAM) && !defined(OS_TRACE_DISABLE_FILE_API) */
+
+#if !MYNEWT_VAL(OS_SYSVIEW) && !MYNEWT_VAL(OS_TRACE_RAM)
 
 static inline void
 os_trace_isr_enter(void)
@@ -261,9 +395,10 @@ os_trace_user_stop(unsigned id)
 {
 }
 
-#endif /* !MYNEWT_VAL(OS_SYSVIEW) */
+#endif /* !MYNEWT_VAL(OS_SYSVIEW) && !MYNEWT_VAL(OS_TRACE_RAM) */
 
-#if !MYNEWT_VAL(OS_SYSVIEW) || defined(OS_TRACE_DISABLE_FILE_API)
+#if (!MYNEWT_VAL(OS_SYSVIEW) && !MYNEWT_VAL(OS_TRACE_RAM)) || \
+    defined(OS_TRACE_DISABLE_FILE_API)
 
 static inline void
 os_trace_api_void(unsigned id)
@@ -295,7 +430,8 @@ os_trace_api_ret_u32(unsigned id, uint32_t return_value)
 {
 }
 
-#endif /* !MYNEWT_VAL(OS_SYSVIEW) || defined(OS_TRACE_DISABLE_FILE_API) */
+#endif /* (!MYNEWT_VAL(OS_SYSVIEW) && !MYNEWT_VAL(OS_TRACE_RAM)) ||
+          defined(OS_TRACE_DISABLE_FILE_API) */
 
 #endif /* __ASSEMBLER__ */
 
@@ -33,8 +33,12 @@ TEST_SUITE_DECL(os_time_test_suite);
 TEST_SUITE_DECL(os_mbuf_test_suite);
 TEST_SUITE_DECL(os_eventq_test_suite);
 TEST_SUITE_DECL(os_callout_test_suite);
+TEST_SUITE_DECL(os_sched_test_suite);
+TEST_SUITE_DECL(os_event_group_test_suite);
+TEST_SUITE_DECL(os_msgq_test_suite);
 
 TEST_CASE_DECL(os_time_test_change);
+TEST_CASE_DECL(os_time_test_recip);
 
 int os_test_all(void);
 
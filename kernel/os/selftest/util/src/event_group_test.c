@@ -0,0 +1,230 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "os_test_priv.h"
+
+struct os_event_group g_evg1;
+
+/*
+ * TEST NUMBERS:
+ *  1: Two tasks wait on the same group, the higher priority one for all of
+ *  two flags (consuming them), the lower priority one for any of a third
+ *  flag.  The lowest priority task sets the flags one at a time and checks
+ *  that each waiter wakes only once its condition holds.
+ *  2: Two tasks consume the same flag.  Setting it once wakes only the
+ *  higher priority one; the other stays blocked, cannot be removed, and
+ *  wakes on the next set.
+ */
+static int event_group_test_1_woken1;
+static int event_group_test_1_woken2;
+static uint32_t event_group_test_1_flags1;
+static uint32_t event_group_test_1_flags2;
+
+struct os_task *event_group_test_2_task2;
+static int event_group_test_2_woken1;
+static int event_group_test_2_woken2;
+
+void
+event_group_test_basic_handler(void *arg)
+{
+    struct os_event_group *evg;
+    os_time_t start;
+    uint32_t flags;
+    os_error_t err;
+
+    evg = &g_evg1;
+
+    /* Test some error cases */
+    TEST_ASSERT(os_event_group_init(NULL, 0) == OS_INVALID_PARM);
+    TEST_ASSERT(os_event_group_set(NULL, 1) == OS_INVALID_PARM);
+    TEST_ASSERT(os_event_group_clear(NULL, 1) == OS_INVALID_PARM);
+    TEST_ASSERT(os_event_group_wait(NULL, 1, 0, 0, NULL) == OS_INVALID_PARM);
+    TEST_ASSERT(os_event_group_wait(evg, 0, 0, 0, NULL) == OS_INVALID_PARM);
+
+    /* Nothing set; polling fails */
+    err = os_event_group_wait(evg, 0x0f, 0, 0, &flags);
+    TEST_ASSERT(err == OS_TIMEOUT, "err=%d", err);
+    TEST_ASSERT(flags == 0);
+
+    err = os_event_group_set(evg, 0x05);
+    TEST_ASSERT(err == OS_OK);
+    TEST_ASSERT(os_event_group_get(evg) == 0x05);
+
+    /* Any of the mask satisfies a wait-any */
+    err = os_event_group_wait(evg, 0x03, 0, 0, &flags);
+    TEST_ASSERT(err == OS_OK, "err=%d", err);
+    TEST_ASSERT(flags == 0x05);
+
+    /* Wait-all needs every bit */
+    err = os_event_group_wait(evg, 0x03, OS_EVENT_GROUP_WAIT_ALL, 0, &flags);
+    TEST_ASSERT(err == OS_TIMEOUT, "err=%d", err);
+    err = os_event_group_wait(evg, 0x05, OS_EVENT_GROUP_WAIT_ALL, 0, &flags);
+    TEST_ASSERT(err == OS_OK, "err=%d", err);
+    TEST_ASSERT(os_event_group_get(evg) == 0x05);
+
+    /* Clear option consumes only the requested bits */
+    err = os_event_group_wait(evg, 0x0c,
+                              OS_EVENT_GROUP_CLEAR, 0, &flags);
+    TEST_ASSERT(err == OS_OK, "err=%d", err);
+    TEST_ASSERT(flags == 0x05);
+    TEST_ASSERT(os_event_group_get(evg) == 0x01);
+
+    err = os_event_group_clear(evg, 0x01);
+    TEST_ASSERT(err == OS_OK);
+    TEST_ASSERT(os_event_group_get(evg) == 0);
+
+    /* Blocking wait times out and leaves no waiter behind */
+    start = os_time_get();
+    err = os_event_group_wait(evg, 0x01, 0, OS_TICKS_PER_SEC / 10, &flags);
+    TEST_ASSERT(err == OS_TIMEOUT, "err=%d", err);
+    TEST_ASSERT(OS_TIME_TICK_GEQ(os_time_get(), start + OS_TICKS_PER_SEC / 10));
+    TEST_ASSERT(SLIST_EMPTY(&evg->evg_head));
+
+    os_test_restart();
+}
+
+void
+event_group_test_1_task1_handler(void *arg)
+{
+    os_error_t err;
+
+    err = os_event_group_wait(&g_evg1, 0x03,
+                              OS_EVENT_GROUP_WAIT_ALL | OS_EVENT_GROUP_CLEAR,
+                              OS_TIMEOUT_NEVER, &event_group_test_1_flags1);
+    TEST_ASSERT(err == OS_OK, "err=%d", err);
+    event_group_test_1_woken1++;
+
+    while (1) {
+        os_time_delay(OS_TICKS_PER_SEC);
+    }
+}
+
+void
+event_group_test_1_task2_handler(void *arg)
+{
+    os_error_t err;
+
+    err = os_event_group_wait(&g_evg1, 0x04, 0, OS_TIMEOUT_NEVER,
+                              &event_group_test_1_flags2);
+    TEST_ASSERT(err == OS_OK, "err=%d", err);
+    event_group_test_1_woken2++;
+
+    while (1) {
+        os_time_delay(OS_TICKS_PER_SEC);
+    }
+}
+
+void
+event_group_test_1_task3_handler(void *arg)
+{
+    /* Let both waiters block */
+    os_time_delay(OS_TICKS_PER_SEC / 10);
+    TEST_ASSERT(!SLIST_EMPTY(&g_evg1.evg_head));
+
+    os_event_group_set(&g_evg1, 0x01);
+    TEST_ASSERT(event_group_test_1_woken1 == 0);
+    TEST_ASSERT(event_group_test_1_woken2 == 0);
+
+    /* Completes task 1's wait; it runs immediately and consumes its bits */
+    os_event_group_set(&g_evg1, 0x02);
+    TEST_ASSERT(event_group_test_1_woken1 == 1);
+    TEST_ASSERT(event_group_test_1_flags1 == 0x03);
+    TEST_ASSERT(event_group_test_1_woken2 == 0);
+    TEST_ASSERT(os_event_group_get(&g_evg1) == 0);
+
+    os_event_group_set(&g_evg1, 0x04);
+    TEST_ASSERT(event_group_test_1_woken2 == 1);
+    TEST_ASSERT(event_group_test_1_flags2 == 0x04);
+    TEST_ASSERT(os_event_group_get(&g_evg1) == 0x04);
+    TEST_ASSERT(SLIST_EMPTY(&g_evg1.evg_head));
+
+    os_test_restart();
+}
+
+void
+event_group_test_2_task1_handler(void *arg)
+{
+    os_error_t err;
+
+    err = os_event_group_wait(&g_evg1, 0x01, OS_EVENT_GROUP_CLEAR,
+                              OS_TIMEOUT_NEVER, NULL);
+    TEST_ASSERT(err == OS_OK, "err=%d", err);
+    event_group_test_2_woken1++;
+
+    while (1) {
+        os_time_delay(OS_TICKS_PER_SEC);
+    }
+}
+
+void
+event_group_test_2_task2_handler(void *arg)
+{
+    os_error_t err;
+
+    err = os_event_group_wait(&g_evg1, 0x01, OS_EVENT_GROUP_CLEAR,
+                              OS_TIMEOUT_NEVER, NULL);
+    TEST_ASSERT(err == OS_OK, "err=%d", err);
+    event_group_test_2_woken2++;
+
+    while (1) {
+        os_time_delay(OS_TICKS_PER_SEC);
+    }
+}
+
+void
+event_group_test_2_task3_handler(void *arg)
+{
+    os_error_t err;
+
+    /* Let both consumers block */
+    os_time_delay(OS_TICKS_PER_SEC / 10);
+
+    /* Task 1 takes the flag; task 2 must not see it */
+    os_event_group_set(&g_evg1, 0x01);
+    TEST_ASSERT(event_group_test_2_woken1 == 1);
+    TEST_ASSERT(event_group_test_2_woken2 == 0);
+    TEST_ASSERT(os_event_group_get(&g_evg1) == 0);
+    TEST_ASSERT(!SLIST_EMPTY(&g_evg1.evg_head));
+
+    /* Its wait record is on its stack; removing it must be refused */
+    err = os_task_remove(event_group_test_2_task2);
+    TEST_ASSERT(err == OS_EBUSY, "err=%d", err);
+
+    os_event_group_set(&g_evg1, 0x01);
+    TEST_ASSERT(event_group_test_2_woken2 == 1);
+    TEST_ASSERT(os_event_group_get(&g_evg1) == 0);
+    TEST_ASSERT(SLIST_EMPTY(&g_evg1.evg_head));
+
+    os_test_restart();
+}
+
+TEST_CASE_DECL(os_event_group_test_basic)
+TEST_CASE_DECL(os_event_group_test_case_1)
+TEST_CASE_DECL(os_event_group_test_case_2)
+
+TEST_SUITE(os_event_group_test_suite)
+{
+    os_event_group_test_basic();
+    os_event_group_test_case_1();
+    os_event_group_test_case_2();
+}
@@ -76,6 +76,10 @@ TEST_CASE_DECL(event_test_poll_sr)
 TEST_CASE_DECL(event_test_poll_timeout_sr)
 TEST_CASE_DECL(event_test_poll_single_sr)
 TEST_CASE_DECL(event_test_poll_0timo)
+TEST_CASE_DECL(event_test_ring)
+TEST_CASE_DECL(event_test_run_batch)
+TEST_CASE_DECL(event_test_run_batch_cancel)
+TEST_CASE_DECL(event_test_prio)
 
 /* This is the task function  to send data */
 void
@@ -259,4 +263,8 @@ TEST_SUITE(os_eventq_test_suite)
     event_test_poll_timeout_sr();
     event_test_poll_single_sr();
     event_test_poll_0timo();
+    event_test_ring();
+    event_test_run_batch();
+    event_test_run_batch_cancel();
+    event_test_prio();
 }
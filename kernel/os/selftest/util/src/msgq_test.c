@@ -0,0 +1,185 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "os_test_priv.h"
+
+struct os_msgq g_msgq1;
+uint8_t g_msgq1_buf[OS_MSGQ_BUF_SIZE(sizeof(struct msgq_test_msg),
+                                     MSGQ_TEST_MSG_COUNT)];
+
+/*
+ * TEST NUMBERS:
+ *  1: A high priority producer sends several times the queue capacity with
+ *  no timeout, so it blocks whenever the queue fills up.  A lower priority
+ *  consumer drains the queue in batches and checks that every message
+ *  arrives once and in order.
+ */
+#define MSGQ_TEST_1_TOTAL       (MSGQ_TEST_MSG_COUNT * 5 + 1)
+
+static void
+msgq_test_fill(struct msgq_test_msg *msg, uint32_t seq)
+{
+    msg->seq = seq;
+    memset(msg->data, seq, sizeof msg->data);
+}
+
+static void
+msgq_test_check(const struct msgq_test_msg *msg, uint32_t seq)
+{
+    int i;
+
+    TEST_ASSERT(msg->seq == seq, "got seq %u, expected %u",
+                (unsigned)msg->seq, (unsigned)seq);
+    for (i = 0; i < sizeof msg->data; i++) {
+        TEST_ASSERT(msg->data[i] == (uint8_t)seq);
+    }
+}
+
+void
+msgq_test_basic_handler(void *arg)
+{
+    struct msgq_test_msg msgs[MSGQ_TEST_MSG_COUNT + 1];
+    struct msgq_test_msg msg;
+    struct os_msgq *mq;
+    os_time_t start;
+    uint16_t cnt;
+    uint32_t seq;
+    os_error_t err;
+    int i;
+
+    mq = &g_msgq1;
+
+    /* Test some error cases */
+    TEST_ASSERT(os_msgq_init(NULL, g_msgq1_buf, 1, 1) == OS_INVALID_PARM);
+    TEST_ASSERT(os_msgq_init(mq, NULL, 1, 1) == OS_INVALID_PARM);
+    TEST_ASSERT(os_msgq_init(mq, g_msgq1_buf, 0, 1) == OS_INVALID_PARM);
+    TEST_ASSERT(os_msgq_init(mq, g_msgq1_buf, 1, 0) == OS_INVALID_PARM);
+    TEST_ASSERT(os_msgq_send(NULL, &msg, 0) == OS_INVALID_PARM);
+    TEST_ASSERT(os_msgq_send(mq, NULL, 0) == OS_INVALID_PARM);
+    TEST_ASSERT(os_msgq_recv(NULL, &msg, 0) == OS_INVALID_PARM);
+    TEST_ASSERT(os_msgq_recv_multi(mq, msgs, 0, 0, &cnt) == OS_INVALID_PARM);
+    TEST_ASSERT(cnt == 0);
+
+    /* Empty queue */
+    TEST_ASSERT(os_msgq_recv(mq, &msg, 0) == OS_TIMEOUT);
+    TEST_ASSERT(os_msgq_space(mq) == MSGQ_TEST_MSG_COUNT);
+
+    /* Fill it up; one more does not fit */
+    for (i = 0; i < MSGQ_TEST_MSG_COUNT; i++) {
+        msgq_test_fill(&msg, i);
+        err = os_msgq_try_send(mq, &msg);
+        TEST_ASSERT(err == OS_OK, "err=%d", err);
+    }
+    TEST_ASSERT(os_msgq_count(mq) == MSGQ_TEST_MSG_COUNT);
+    TEST_ASSERT(os_msgq_try_send(mq, &msg) == OS_TIMEOUT);
+
+    /* Blocking send times out and leaves no waiter behind */
+    start = os_time_get();
+    err = os_msgq_send(mq, &msg, OS_TICKS_PER_SEC / 10);
+    TEST_ASSERT(err == OS_TIMEOUT, "err=%d", err);
+    TEST_ASSERT(OS_TIME_TICK_GEQ(os_time_get(), start + OS_TICKS_PER_SEC / 10));
+    TEST_ASSERT(SLIST_EMPTY(&mq->mq_send_obj.obj_head));
+
+    /* Drain half, refill so the ring wraps */
+    for (i = 0; i < MSGQ_TEST_MSG_COUNT / 2; i++) {
+        err = os_msgq_recv(mq, &msg, 0);
+        TEST_ASSERT(err == OS_OK, "err=%d", err);
+        msgq_test_check(&msg, i);
+    }
+    for (i = 0; i < MSGQ_TEST_MSG_COUNT / 2; i++) {
+        msgq_test_fill(&msg, MSGQ_TEST_MSG_COUNT + i);
+        TEST_ASSERT(os_msgq_try_send(mq, &msg) == OS_OK);
+    }
+
+    /* Receive everything across the wrap in one call */
+    err = os_msgq_recv_multi(mq, msgs, MSGQ_TEST_MSG_COUNT + 1, 0, &cnt);
+    TEST_ASSERT(err == OS_OK, "err=%d", err);
+    TEST_ASSERT(cnt == MSGQ_TEST_MSG_COUNT);
+    for (i = 0; i < cnt; i++) {
+        seq = MSGQ_TEST_MSG_COUNT / 2 + i;
+        msgq_test_check(&msgs[i], seq);
+    }
+    TEST_ASSERT(os_msgq_count(mq) == 0);
+
+    /* Blocking receive times out */
+    start = os_time_get();
+    err = os_msgq_recv_multi(mq, msgs, 2, OS_TICKS_PER_SEC / 10, &cnt);
+    TEST_ASSERT(err == OS_TIMEOUT, "err=%d", err);
+    TEST_ASSERT(cnt == 0);
+    TEST_ASSERT(OS_TIME_TICK_GEQ(os_time_get(), start + OS_TICKS_PER_SEC / 10));
+    TEST_ASSERT(SLIST_EMPTY(&mq->mq_recv_head));
+
+    os_test_restart();
+}
+
+void
+msgq_test_1_producer_handler(void *arg)
+{
+    struct msgq_test_msg msg;
+    os_error_t err;
+    int i;
+
+    for (i = 0; i < MSGQ_TEST_1_TOTAL; i++) {
+        msgq_test_fill(&msg, i);
+        err = os_msgq_send(&g_msgq1, &msg, OS_TIMEOUT_NEVER);
+        TEST_ASSERT(err == OS_OK, "err=%d", err);
+    }
+
+    while (1) {
+        os_time_delay(OS_TICKS_PER_SEC);
+    }
+}
+
+void
+msgq_test_1_consumer_handler(void *arg)
+{
+    struct msgq_test_msg msgs[3];
+    uint32_t seq;
+    uint16_t cnt;
+    os_error_t err;
+    int i;
+
+    seq = 0;
+    while (seq < MSGQ_TEST_1_TOTAL) {
+        err = os_msgq_recv_multi(&g_msgq1, msgs, 3, OS_TICKS_PER_SEC, &cnt);
+        TEST_ASSERT_FATAL(err == OS_OK, "err=%d", err);
+        TEST_ASSERT(cnt >= 1 && cnt <= 3);
+        for (i = 0; i < cnt; i++) {
+            msgq_test_check(&msgs[i], seq++);
+        }
+    }
+
+    TEST_ASSERT(os_msgq_count(&g_msgq1) == 0);
+    TEST_ASSERT(SLIST_EMPTY(&g_msgq1.mq_send_obj.obj_head));
+
+    os_test_restart();
+}
+
+TEST_CASE_DECL(os_msgq_test_basic)
+TEST_CASE_DECL(os_msgq_test_case_1)
+
+TEST_SUITE(os_msgq_test_suite)
+{
+    os_msgq_test_basic();
+    os_msgq_test_case_1();
+}
@@ -0,0 +1,51 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _MSGQ_TEST_H
+#define _MSGQ_TEST_H
+
+#include <stdio.h>
+#include <string.h>
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "os_test_priv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MSGQ_TEST_MSG_COUNT     4
+
+struct msgq_test_msg {
+    uint32_t seq;
+    uint8_t data[6];
+};
+
+extern struct os_msgq g_msgq1;
+extern uint8_t g_msgq1_buf[];
+
+void msgq_test_basic_handler(void *arg);
+void msgq_test_1_producer_handler(void *arg);
+void msgq_test_1_consumer_handler(void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MSGQ_TEST_H */
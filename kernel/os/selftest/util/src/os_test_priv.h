@@ -27,10 +27,13 @@
 
 #include "callout_test.h"
 
+#include "event_group_test.h"
 #include "eventq_test.h"
 #include "mbuf_test.h"
 #include "mempool_test.h"
+#include "msgq_test.h"
 #include "mutex_test.h"
+#include "sched_test.h"
 #include "sem_test.h"
 
 #ifdef __cplusplus
@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "os_test_priv.h"
+
+struct os_task sched_test_tasks[SCHED_TEST_NUM_TASKS];
+static os_stack_t sched_test_stacks[SCHED_TEST_NUM_TASKS]
+                                   [OS_STACK_ALIGN(SCHED_TEST_STACK_SIZE)];
+
+void
+sched_test_handler(void *arg)
+{
+    while (1) {
+        os_time_delay(OS_TIMEOUT_NEVER);
+    }
+}
+
+/*
+ * Creates all test tasks, in an order which does not match their priorities.
+ * The OS is not started, so none of the tasks get to run.
+ */
+void
+sched_test_init_tasks(void)
+{
+    int rc;
+    int i;
+    int j;
+
+    for (i = 0; i < SCHED_TEST_NUM_TASKS; i++) {
+        j = (i * 7) % SCHED_TEST_NUM_TASKS;
+        rc = os_task_init(&sched_test_tasks[j], "sched_test",
+                          sched_test_handler, NULL, SCHED_TEST_FIRST_PRIO + j,
+                          OS_WAIT_FOREVER, sched_test_stacks[j],
+                          OS_STACK_ALIGN(SCHED_TEST_STACK_SIZE));
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+}
+
+/*
+ * Checks that the run list is ordered by priority.
+ */
+int
+sched_test_run_list_sorted(void)
+{
+    struct os_task *prev;
+    struct os_task *t;
+
+    prev = NULL;
+    TAILQ_FOREACH(t, &g_os_run_list, t_os_list) {
+        if (t->t_state != OS_TASK_READY) {
+            return 0;
+        }
+        if (prev != NULL && prev->t_prio > t->t_prio) {
+            return 0;
+        }
+        prev = t;
+    }
+
+    return 1;
+}
+
+TEST_CASE_DECL(os_sched_test_ready_queue)
+TEST_CASE_DECL(os_sched_test_wakeup_cycle)
+TEST_CASE_DECL(os_sched_test_sleep_stress)
+TEST_CASE_DECL(os_sched_test_run_stats)
+TEST_CASE_DECL(os_sched_test_crit_prof)
+
+TEST_SUITE(os_sched_test_suite)
+{
+    os_sched_test_ready_queue();
+    os_sched_test_wakeup_cycle();
+    os_sched_test_sleep_stress();
+    os_sched_test_run_stats();
+    os_sched_test_crit_prof();
+}
@@ -0,0 +1,122 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os_test_priv.h"
+
+#if OS_EVENTQ_PRIO_LEVELS > 1
+#define EVENT_TEST_PRIO_NUM     (6)
+
+static struct os_event prio_test_ev[EVENT_TEST_PRIO_NUM];
+static struct os_event prio_test_urgent_ev;
+static int prio_test_order[EVENT_TEST_PRIO_NUM + 1];
+static int prio_test_cnt;
+
+static void
+prio_test_cb(struct os_event *ev)
+{
+    prio_test_order[prio_test_cnt++] = ev - prio_test_ev;
+}
+
+static void
+prio_test_urgent_cb(struct os_event *ev)
+{
+    prio_test_order[prio_test_cnt++] = -1;
+}
+
+/* Queues the urgent event from the callback of a low priority event. */
+static void
+prio_test_preempt_cb(struct os_event *ev)
+{
+    prio_test_cb(ev);
+    os_eventq_put(&my_eventq, &prio_test_urgent_ev);
+}
+#endif
+
+/**
+ * Tests strict priority delivery with OS_EVENTQ_PRIO_LEVELS > 1.
+ */
+TEST_CASE_TASK(event_test_prio)
+{
+#if OS_EVENTQ_PRIO_LEVELS > 1
+    static const uint8_t prios[EVENT_TEST_PRIO_NUM] = {
+        0, 2, 0, OS_EVENT_PRIO_HIGHEST, 2, 0xff,
+    };
+    static const int expected[EVENT_TEST_PRIO_NUM] = { 3, 5, 4, 1, 0, 2 };
+    int rc;
+    int i;
+
+    os_eventq_init(&my_eventq);
+
+    for (i = 0; i < EVENT_TEST_PRIO_NUM; i++) {
+        prio_test_ev[i].ev_cb = prio_test_cb;
+        prio_test_ev[i].ev_prio = prios[i];
+        os_eventq_put(&my_eventq, &prio_test_ev[i]);
+    }
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    /* Out of range priorities count as the highest level */
+    TEST_ASSERT(my_eventq.evq_depth == EVENT_TEST_PRIO_NUM);
+    TEST_ASSERT(my_eventq.evq_prio_depth[0] == 2);
+    TEST_ASSERT(my_eventq.evq_prio_depth[2] == 2);
+    TEST_ASSERT(my_eventq.evq_prio_depth[OS_EVENT_PRIO_HIGHEST] == 2);
+#endif
+
+    /* A removed and requeued event goes to the back of its level */
+    os_eventq_remove(&my_eventq, &prio_test_ev[1]);
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    TEST_ASSERT(my_eventq.evq_prio_depth[2] == 1);
+#endif
+    os_eventq_put(&my_eventq, &prio_test_ev[1]);
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    TEST_ASSERT(my_eventq.evq_prio_depth_max[2] == 2);
+#endif
+
+    /* Highest level first, FIFO within a level */
+    for (i = 0; i < EVENT_TEST_PRIO_NUM; i++) {
+        TEST_ASSERT(os_eventq_get_no_wait(&my_eventq) ==
+                    &prio_test_ev[expected[i]]);
+    }
+    TEST_ASSERT(os_eventq_get_no_wait(&my_eventq) == NULL);
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    for (i = 0; i < OS_EVENTQ_PRIO_LEVELS; i++) {
+        TEST_ASSERT(my_eventq.evq_prio_depth[i] == 0);
+    }
+#endif
+
+    /*
+     * A batch of low priority events is interrupted by a high priority event
+     * queued by the first of them.
+     */
+    prio_test_cnt = 0;
+    prio_test_urgent_ev.ev_cb = prio_test_urgent_cb;
+    prio_test_urgent_ev.ev_prio = OS_EVENT_PRIO_HIGHEST;
+    for (i = 0; i < 3; i++) {
+        prio_test_ev[i].ev_cb = i == 0 ? prio_test_preempt_cb : prio_test_cb;
+        prio_test_ev[i].ev_prio = OS_EVENT_PRIO_DEFAULT;
+        os_eventq_put(&my_eventq, &prio_test_ev[i]);
+    }
+
+    rc = os_eventq_run_batch(&my_eventq, 100, OS_TIMEOUT_NEVER);
+    TEST_ASSERT(rc == 4);
+    TEST_ASSERT(prio_test_order[0] == 0);
+    TEST_ASSERT(prio_test_order[1] == -1);
+    TEST_ASSERT(prio_test_order[2] == 1);
+    TEST_ASSERT(prio_test_order[3] == 2);
+#endif
+}
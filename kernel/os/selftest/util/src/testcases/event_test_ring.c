@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#define EVENT_TEST_RING_SIZE    (8)
+
+#if MYNEWT_VAL(OS_EVENTQ_RING)
+static struct os_eventq_ring ring_test_ring;
+static struct os_event *ring_test_buf[EVENT_TEST_RING_SIZE];
+static struct os_event ring_test_ev[EVENT_TEST_RING_SIZE + 1];
+#endif
+
+/**
+ * Tests posting events through a producer ring: ordering against direct
+ * puts, overflow, removal of ring entries and index wrap.
+ */
+TEST_CASE_SELF(event_test_ring)
+{
+#if MYNEWT_VAL(OS_EVENTQ_RING)
+    struct os_event *evp;
+    struct os_event ev;
+    int rc;
+    int i;
+
+    os_eventq_init(&my_eventq);
+
+    rc = os_eventq_ring_init(&my_eventq, &ring_test_ring, ring_test_buf, 6);
+    TEST_ASSERT(rc == OS_INVALID_PARM);
+    rc = os_eventq_ring_init(&my_eventq, &ring_test_ring, ring_test_buf,
+                             EVENT_TEST_RING_SIZE);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    memset(ring_test_ev, 0, sizeof ring_test_ev);
+    memset(&ev, 0, sizeof ev);
+
+    /* Events put directly are queued ahead of those still in the ring. */
+    os_eventq_put(&my_eventq, &ev);
+    for (i = 0; i < EVENT_TEST_RING_SIZE; i++) {
+        rc = os_eventq_ring_put(&ring_test_ring, &ring_test_ev[i]);
+        TEST_ASSERT(rc == 0);
+    }
+
+    /* The ring is full, and posting a queued event is a no-op. */
+    rc = os_eventq_ring_put(&ring_test_ring, &ring_test_ev[i]);
+    TEST_ASSERT(rc == OS_ENOMEM);
+    TEST_ASSERT(!OS_EVENT_QUEUED(&ring_test_ev[i]));
+    rc = os_eventq_ring_put(&ring_test_ring, &ring_test_ev[0]);
+    TEST_ASSERT(rc == 0);
+
+    evp = os_eventq_get_no_wait(&my_eventq);
+    TEST_ASSERT(evp == &ev);
+
+    /* Removing an event still in the ring. */
+    os_eventq_remove(&my_eventq, &ring_test_ev[1]);
+    TEST_ASSERT(!OS_EVENT_QUEUED(&ring_test_ev[1]));
+
+    for (i = 0; i < EVENT_TEST_RING_SIZE; i++) {
+        if (i == 1) {
+            continue;
+        }
+        evp = os_eventq_get_no_wait(&my_eventq);
+        TEST_ASSERT(evp == &ring_test_ev[i]);
+        TEST_ASSERT(!OS_EVENT_QUEUED(evp));
+    }
+    TEST_ASSERT(os_eventq_get_no_wait(&my_eventq) == NULL);
+
+    /* Wrap the ring indices a few times. */
+    for (i = 0; i < EVENT_TEST_RING_SIZE * 3; i++) {
+        rc = os_eventq_ring_put(&ring_test_ring, &ring_test_ev[0]);
+        TEST_ASSERT(rc == 0);
+        evp = os_eventq_poll((struct os_eventq *[]){ &my_eventq }, 1, 0);
+        TEST_ASSERT(evp == &ring_test_ev[0]);
+    }
+#endif
+}
@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#define EVENT_TEST_BATCH_NUM    (12)
+
+static struct os_event batch_test_ev[EVENT_TEST_BATCH_NUM];
+static int batch_test_order[EVENT_TEST_BATCH_NUM];
+static int batch_test_cnt;
+
+static void
+batch_test_cb(struct os_event *ev)
+{
+    batch_test_order[batch_test_cnt++] = ev - batch_test_ev;
+    if (ev->ev_arg != NULL) {
+        os_time_delay((intptr_t)ev->ev_arg);
+    }
+}
+
+static void
+batch_test_put_all(void *arg)
+{
+    int i;
+
+    batch_test_cnt = 0;
+    for (i = 0; i < EVENT_TEST_BATCH_NUM; i++) {
+        batch_test_ev[i].ev_cb = batch_test_cb;
+        batch_test_ev[i].ev_arg = arg;
+        os_eventq_put(&my_eventq, &batch_test_ev[i]);
+    }
+}
+
+/**
+ * Tests os_eventq_run_batch() with event count and time budgets.
+ */
+TEST_CASE_TASK(event_test_run_batch)
+{
+    int rc;
+    int i;
+
+    os_eventq_init(&my_eventq);
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    rc = os_eventq_stats_register(&my_eventq, "os_evq_test");
+    TEST_ASSERT_FATAL(rc == 0);
+#endif
+
+    /* Event count budget; events run in order. */
+    batch_test_put_all(NULL);
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    TEST_ASSERT(my_eventq.evq_depth_max == EVENT_TEST_BATCH_NUM);
+#endif
+
+    rc = os_eventq_run_batch(&my_eventq, 4, OS_TIMEOUT_NEVER);
+    TEST_ASSERT(rc == 4);
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    TEST_ASSERT(my_eventq.evq_depth == EVENT_TEST_BATCH_NUM - 4);
+#endif
+    rc = os_eventq_run_batch(&my_eventq, 100, OS_TIMEOUT_NEVER);
+    TEST_ASSERT(rc == EVENT_TEST_BATCH_NUM - 4);
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    TEST_ASSERT(my_eventq.evq_depth == 0);
+#endif
+    for (i = 0; i < EVENT_TEST_BATCH_NUM; i++) {
+        TEST_ASSERT(batch_test_order[i] == i);
+    }
+
+    /*
+     * Time budget; each callback takes 10 ticks, so the third event is past
+     * the budget and it and the rest go back on the queue in order.
+     */
+    batch_test_put_all((void *)10);
+    rc = os_eventq_run_batch(&my_eventq, 100, 15);
+    TEST_ASSERT(rc == 2);
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    TEST_ASSERT(my_eventq.evq_depth == EVENT_TEST_BATCH_NUM - 2);
+#endif
+    for (i = 2; i < EVENT_TEST_BATCH_NUM; i++) {
+        TEST_ASSERT(os_eventq_get_no_wait(&my_eventq) == &batch_test_ev[i]);
+    }
+    TEST_ASSERT(os_eventq_get_no_wait(&my_eventq) == NULL);
+}
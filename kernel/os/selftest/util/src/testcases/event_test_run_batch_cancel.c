@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+static struct os_event cancel_test_ev[4];
+static struct os_callout cancel_test_co;
+static int cancel_test_order[8];
+static int cancel_test_cnt;
+static int cancel_test_mode;
+
+static void
+cancel_test_cb(struct os_event *ev)
+{
+    cancel_test_order[cancel_test_cnt++] = ev - cancel_test_ev;
+
+    if (ev != &cancel_test_ev[0]) {
+        return;
+    }
+
+    switch (cancel_test_mode) {
+    case 0:
+        /* Put a later event of the batch again and remove another one. */
+        os_eventq_put(&my_eventq, &cancel_test_ev[2]);
+        os_eventq_remove(&my_eventq, &cancel_test_ev[1]);
+        break;
+
+    case 1:
+        /* Re-arm a callout which has already expired. */
+        os_callout_reset(&cancel_test_co, OS_TICKS_PER_SEC);
+        break;
+
+    case 2:
+        os_callout_stop(&cancel_test_co);
+        break;
+    }
+}
+
+static void
+cancel_test_co_cb(struct os_event *ev)
+{
+    cancel_test_order[cancel_test_cnt++] = -1;
+}
+
+static void
+cancel_test_start(int mode, int num_ev)
+{
+    int i;
+
+    cancel_test_mode = mode;
+    cancel_test_cnt = 0;
+    for (i = 0; i < num_ev; i++) {
+        cancel_test_ev[i].ev_cb = cancel_test_cb;
+        os_eventq_put(&my_eventq, &cancel_test_ev[i]);
+    }
+}
+
+/**
+ * Tests that os_eventq_run_batch() does not run an event of a batch twice
+ * when an earlier callback puts it again, and does not run it at all when
+ * an earlier callback removes it.
+ */
+TEST_CASE_TASK(event_test_run_batch_cancel)
+{
+    int rc;
+    int i;
+
+    os_eventq_init(&my_eventq);
+    os_callout_init(&cancel_test_co, &my_eventq, cancel_test_co_cb, NULL);
+
+    /* Events put again or removed by an earlier callback. */
+    cancel_test_start(0, 4);
+    rc = os_eventq_run_batch(&my_eventq, 100, OS_TIMEOUT_NEVER);
+    TEST_ASSERT(rc == 3);
+    TEST_ASSERT(cancel_test_order[0] == 0);
+    TEST_ASSERT(cancel_test_order[1] == 2);
+    TEST_ASSERT(cancel_test_order[2] == 3);
+    TEST_ASSERT(os_eventq_get_no_wait(&my_eventq) == NULL);
+    for (i = 0; i < 4; i++) {
+        TEST_ASSERT(!OS_EVENT_QUEUED(&cancel_test_ev[i]));
+    }
+
+    /* An expired callout re-armed by an earlier callback. */
+    cancel_test_start(1, 1);
+    os_callout_reset(&cancel_test_co, 1);
+    os_time_delay(2);
+    TEST_ASSERT_FATAL(OS_EVENT_QUEUED(&cancel_test_co.c_ev));
+    rc = os_eventq_run_batch(&my_eventq, 100, OS_TIMEOUT_NEVER);
+    TEST_ASSERT(rc == 1);
+    TEST_ASSERT(cancel_test_order[0] == 0);
+    TEST_ASSERT(os_callout_queued(&cancel_test_co));
+    TEST_ASSERT(!OS_EVENT_QUEUED(&cancel_test_co.c_ev));
+
+    /* An expired callout stopped by an earlier callback. */
+    cancel_test_start(2, 1);
+    os_callout_reset(&cancel_test_co, 1);
+    os_time_delay(2);
+    TEST_ASSERT_FATAL(OS_EVENT_QUEUED(&cancel_test_co.c_ev));
+    rc = os_eventq_run_batch(&my_eventq, 100, OS_TIMEOUT_NEVER);
+    TEST_ASSERT(rc == 1);
+    TEST_ASSERT(!os_callout_queued(&cancel_test_co));
+    TEST_ASSERT(!OS_EVENT_QUEUED(&cancel_test_co.c_ev));
+    TEST_ASSERT(os_eventq_get_no_wait(&my_eventq) == NULL);
+}
@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#define CALLOUT_MANY_NUM    (128)
+
+static struct os_callout callout_many[CALLOUT_MANY_NUM];
+
+static os_time_t
+callout_many_wakeup_ticks(void)
+{
+    os_time_t ticks;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    ticks = os_callout_wakeup_ticks(os_time_get());
+    OS_EXIT_CRITICAL(sr);
+
+    return ticks;
+}
+
+/*
+ * Arms a large number of callouts spread across several rounds of the timing
+ * wheel, and checks that they expire in order and that the next expiry is
+ * always computed correctly.
+ */
+TEST_CASE_SELF(callout_test_many)
+{
+    struct os_callout *c;
+    struct os_event *ev;
+    os_time_t last;
+    int num_fired;
+    int rc;
+    int i;
+
+    os_eventq_init(&callout_evq);
+
+    TEST_ASSERT(callout_many_wakeup_ticks() == OS_TIMEOUT_NEVER);
+
+    for (i = 0; i < CALLOUT_MANY_NUM; i++) {
+        os_callout_init(&callout_many[i], &callout_evq, my_callout, NULL);
+        rc = os_callout_reset(&callout_many[i], 10 + (i * 37) % 500);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+
+    /* Callout 0 expires first. */
+    TEST_ASSERT(callout_many_wakeup_ticks() == 10);
+
+    os_callout_stop(&callout_many[0]);
+    TEST_ASSERT(!os_callout_queued(&callout_many[0]));
+    TEST_ASSERT(callout_many_wakeup_ticks() == 10 + (1 * 37) % 500);
+
+    num_fired = 0;
+    last = os_time_get();
+    while (callout_many_wakeup_ticks() != OS_TIMEOUT_NEVER) {
+        os_time_advance(7);
+        os_callout_tick();
+
+        while ((ev = os_eventq_get_no_wait(&callout_evq)) != NULL) {
+            c = CONTAINER_OF(ev, struct os_callout, c_ev);
+            TEST_ASSERT(!os_callout_queued(c));
+            TEST_ASSERT(OS_TIME_TICK_GEQ(os_time_get(), c->c_ticks));
+            TEST_ASSERT(OS_TIME_TICK_GEQ(c->c_ticks, last));
+            last = c->c_ticks;
+            num_fired++;
+        }
+    }
+
+    TEST_ASSERT(num_fired == CALLOUT_MANY_NUM - 1);
+}
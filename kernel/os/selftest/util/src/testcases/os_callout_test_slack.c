@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#if MYNEWT_VAL(OS_CALLOUT_SLACK)
+static struct os_callout callout_slack[3];
+
+static os_time_t
+callout_slack_wakeup_ticks(void)
+{
+    os_time_t ticks;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    ticks = os_callout_wakeup_ticks(os_time_get());
+    OS_EXIT_CRITICAL(sr);
+
+    return ticks;
+}
+
+static int
+callout_slack_num_events(void)
+{
+    int num;
+
+    num = 0;
+    while (os_eventq_get_no_wait(&callout_evq) != NULL) {
+        num++;
+    }
+
+    return num;
+}
+#endif
+
+/*
+ * Verifies that callouts whose slack windows overlap are expired with a
+ * single wakeup.
+ */
+TEST_CASE_SELF(callout_test_slack)
+{
+#if MYNEWT_VAL(OS_CALLOUT_SLACK)
+    int rc;
+    int i;
+
+    os_eventq_init(&callout_evq);
+    for (i = 0; i < 3; i++) {
+        os_callout_init(&callout_slack[i], &callout_evq, my_callout, NULL);
+    }
+
+    /* Windows: [100, 150], [130, 230] and [300, 300]. */
+    rc = os_callout_reset_slack(&callout_slack[0], 100, 50);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_callout_reset_slack(&callout_slack[1], 130, 100);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_callout_reset(&callout_slack[2], 300);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* Invalid slack is rejected. */
+    rc = os_callout_reset_slack(&callout_slack[2], 300, INT32_MAX);
+    TEST_ASSERT(rc == OS_EINVAL);
+
+    /* The first wakeup is at the end of the first window. */
+    TEST_ASSERT(callout_slack_wakeup_ticks() == 150);
+
+    /* Nothing expires early. */
+    os_time_advance(99);
+    os_callout_tick();
+    TEST_ASSERT(callout_slack_num_events() == 0);
+
+    /* Both overlapping callouts expire together. */
+    os_time_advance(51);
+    os_callout_tick();
+    TEST_ASSERT(callout_slack_num_events() == 2);
+    TEST_ASSERT(!os_callout_queued(&callout_slack[0]));
+    TEST_ASSERT(!os_callout_queued(&callout_slack[1]));
+
+    /* The callout without slack expires exactly on time. */
+    TEST_ASSERT(callout_slack_wakeup_ticks() == 150);
+    os_time_advance(150);
+    os_callout_tick();
+    TEST_ASSERT(callout_slack_num_events() == 1);
+    TEST_ASSERT(callout_slack_wakeup_ticks() == OS_TIMEOUT_NEVER);
+#endif
+}
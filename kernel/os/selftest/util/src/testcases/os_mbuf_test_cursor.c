@@ -0,0 +1,172 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <limits.h>
+#include "os_test_priv.h"
+
+#define CURSOR_TEST_BUF_DATA    128
+#define CURSOR_TEST_BUF_SIZE    (CURSOR_TEST_BUF_DATA + sizeof(struct os_mbuf))
+#define CURSOR_TEST_PKT_LEN     4096
+#define CURSOR_TEST_BUF_COUNT   (CURSOR_TEST_PKT_LEN / CURSOR_TEST_BUF_DATA + 2)
+
+static os_membuf_t cursor_test_membuf[
+    OS_MEMPOOL_SIZE(CURSOR_TEST_BUF_COUNT, CURSOR_TEST_BUF_SIZE)];
+static struct os_mempool cursor_test_mempool;
+static struct os_mbuf_pool cursor_test_mbuf_pool;
+
+static void
+os_mbuf_test_cursor_basic(void)
+{
+    struct os_mbuf_cursor omc;
+    struct os_mbuf *om;
+    struct os_mbuf *m;
+    uint8_t buf[64];
+    int rc;
+    int i;
+
+    /* Three mbufs of 20 bytes each, with an empty one after the first. */
+    om = os_mbuf_get_pkthdr(&os_mbuf_pool, 0);
+    TEST_ASSERT_FATAL(om != NULL);
+    rc = os_mbuf_append(om, os_mbuf_test_data, 20);
+    TEST_ASSERT_FATAL(rc == 0);
+    for (i = 0; i < 3; i++) {
+        m = os_mbuf_get(&os_mbuf_pool, 0);
+        TEST_ASSERT_FATAL(m != NULL);
+        if (i > 0) {
+            rc = os_mbuf_append(m, os_mbuf_test_data + i * 20, 20);
+            TEST_ASSERT_FATAL(rc == 0);
+        }
+        os_mbuf_concat(om, m);
+    }
+    TEST_ASSERT_FATAL(OS_MBUF_PKTLEN(om) == 60);
+
+    os_mbuf_cursor_init(&omc, om);
+    TEST_ASSERT(os_mbuf_cursor_tell(&omc) == 0);
+
+    /* Reads crossing mbuf boundaries and the empty mbuf. */
+    rc = os_mbuf_cursor_read(&omc, buf, 15);
+    TEST_ASSERT(rc == 0 && memcmp(buf, os_mbuf_test_data, 15) == 0);
+    rc = os_mbuf_cursor_read(&omc, buf, 10);
+    TEST_ASSERT(rc == 0 && memcmp(buf, os_mbuf_test_data + 15, 10) == 0);
+    TEST_ASSERT(os_mbuf_cursor_tell(&omc) == 25);
+
+    /* Peek does not move the cursor. */
+    rc = os_mbuf_cursor_peek(&omc, buf, 20);
+    TEST_ASSERT(rc == 0 && memcmp(buf, os_mbuf_test_data + 25, 20) == 0);
+    TEST_ASSERT(os_mbuf_cursor_tell(&omc) == 25);
+    TEST_ASSERT(os_mbuf_cursor_cmp(&omc, os_mbuf_test_data + 25, 35) == 0);
+    TEST_ASSERT(os_mbuf_cursor_cmp(&omc, os_mbuf_test_data, 35) != 0);
+    TEST_ASSERT(os_mbuf_cursor_cmp(&omc, os_mbuf_test_data + 25, 36) ==
+                INT_MAX);
+
+    rc = os_mbuf_cursor_advance(&omc, 15);
+    TEST_ASSERT(rc == 0 && os_mbuf_cursor_tell(&omc) == 40);
+
+    /* Failed operations leave the cursor in place. */
+    rc = os_mbuf_cursor_read(&omc, buf, 21);
+    TEST_ASSERT(rc == OS_EINVAL && os_mbuf_cursor_tell(&omc) == 40);
+    rc = os_mbuf_cursor_advance(&omc, 21);
+    TEST_ASSERT(rc == OS_EINVAL && os_mbuf_cursor_tell(&omc) == 40);
+    rc = os_mbuf_cursor_seek(&omc, 61);
+    TEST_ASSERT(rc == OS_EINVAL && os_mbuf_cursor_tell(&omc) == 40);
+
+    /* Seeking to the end is allowed; backwards restarts from the head. */
+    rc = os_mbuf_cursor_seek(&omc, 60);
+    TEST_ASSERT(rc == 0 && os_mbuf_cursor_tell(&omc) == 60);
+    TEST_ASSERT(os_mbuf_cursor_peek(&omc, buf, 1) == OS_EINVAL);
+    TEST_ASSERT(os_mbuf_cursor_peek(&omc, buf, 0) == 0);
+
+    for (i = 59; i >= 0; i -= 7) {
+        rc = os_mbuf_cursor_seek(&omc, i);
+        TEST_ASSERT_FATAL(rc == 0);
+        rc = os_mbuf_cursor_read(&omc, buf, 60 - i);
+        TEST_ASSERT(rc == 0 &&
+                    memcmp(buf, os_mbuf_test_data + i, 60 - i) == 0);
+    }
+
+    os_mbuf_free_chain(om);
+}
+
+/* Sums a packet as a sequence of 4-byte fields. */
+static uint32_t
+os_mbuf_test_cursor_sum_copydata(const struct os_mbuf *om)
+{
+    uint32_t field;
+    uint32_t sum;
+    int off;
+
+    sum = 0;
+    for (off = 0; off < CURSOR_TEST_PKT_LEN; off += sizeof field) {
+        os_mbuf_copydata(om, off, sizeof field, &field);
+        sum += field;
+    }
+
+    return sum;
+}
+
+static uint32_t
+os_mbuf_test_cursor_sum_cursor(struct os_mbuf *om)
+{
+    struct os_mbuf_cursor omc;
+    uint32_t field;
+    uint32_t sum;
+
+    sum = 0;
+    os_mbuf_cursor_init(&omc, om);
+    while (os_mbuf_cursor_read(&omc, &field, sizeof field) == 0) {
+        sum += field;
+    }
+
+    return sum;
+}
+
+TEST_CASE_SELF(os_mbuf_test_cursor)
+{
+    struct os_mbuf *om;
+    uint32_t expected;
+    int rc;
+    int i;
+
+    os_mbuf_test_setup();
+    os_mbuf_test_cursor_basic();
+
+    os_mempool_unregister(&cursor_test_mempool);
+    rc = os_mempool_init(&cursor_test_mempool, CURSOR_TEST_BUF_COUNT,
+                         CURSOR_TEST_BUF_SIZE, cursor_test_membuf,
+                         "cursor_test");
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_mbuf_pool_init(&cursor_test_mbuf_pool, &cursor_test_mempool,
+                           CURSOR_TEST_BUF_SIZE, CURSOR_TEST_BUF_COUNT);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* A 4 KB packet in 128-byte mbufs. */
+    om = os_mbuf_get_pkthdr(&cursor_test_mbuf_pool, 0);
+    TEST_ASSERT_FATAL(om != NULL);
+    for (i = 0; i < CURSOR_TEST_PKT_LEN / MBUF_TEST_DATA_LEN; i++) {
+        rc = os_mbuf_append(om, os_mbuf_test_data, MBUF_TEST_DATA_LEN);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+    TEST_ASSERT_FATAL(OS_MBUF_PKTLEN(om) == CURSOR_TEST_PKT_LEN);
+
+    expected = os_mbuf_test_cursor_sum_copydata(om);
+    TEST_ASSERT(os_mbuf_test_cursor_sum_cursor(om) == expected);
+
+    os_mbuf_free_chain(om);
+    TEST_ASSERT(cursor_test_mempool.mp_num_free == CURSOR_TEST_BUF_COUNT);
+}
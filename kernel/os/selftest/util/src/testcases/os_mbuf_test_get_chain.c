@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os_test_priv.h"
+
+TEST_CASE_SELF(os_mbuf_test_get_chain)
+{
+    struct os_mbuf *om;
+    struct os_mbuf *cur;
+    int count;
+    int rc;
+
+    os_mbuf_test_setup();
+
+    /* Larger than the pool; nothing is allocated. */
+    om = os_mbuf_get_chain(&os_mbuf_pool, 0, MBUF_TEST_POOL_BUF_COUNT + 1);
+    TEST_ASSERT(om == NULL);
+    TEST_ASSERT(os_mbuf_mempool.mp_num_free == MBUF_TEST_POOL_BUF_COUNT);
+
+    om = os_mbuf_get_chain(&os_mbuf_pool, 0, MBUF_TEST_POOL_BUF_SIZE + 1);
+    TEST_ASSERT(om == NULL);
+
+    /* Spans more than one internal batch. */
+    om = os_mbuf_get_chain(&os_mbuf_pool, 16, MBUF_TEST_POOL_BUF_COUNT);
+    TEST_ASSERT_FATAL(om != NULL);
+    TEST_ASSERT(os_mbuf_mempool.mp_num_free == 0);
+
+    count = 0;
+    for (cur = om; cur != NULL; cur = SLIST_NEXT(cur, om_next)) {
+        TEST_ASSERT(cur->om_omp == &os_mbuf_pool);
+        TEST_ASSERT(cur->om_len == 0);
+        TEST_ASSERT(cur->om_pkthdr_len == 0);
+        TEST_ASSERT(OS_MBUF_LEADINGSPACE(cur) == 16);
+        count++;
+    }
+    TEST_ASSERT(count == MBUF_TEST_POOL_BUF_COUNT);
+
+    rc = os_mbuf_free_chain(om);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(os_mbuf_mempool.mp_num_free == MBUF_TEST_POOL_BUF_COUNT);
+    TEST_ASSERT(os_mempool_is_sane(&os_mbuf_mempool));
+}
@@ -0,0 +1,102 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os_test_priv.h"
+
+TEST_CASE_SELF(os_mbuf_test_iov)
+{
+    struct os_mbuf_iov iov[8];
+    struct os_mbuf *om;
+    struct os_mbuf *m;
+    int iov_cnt;
+    int rc;
+    int i;
+
+    os_mbuf_test_setup();
+
+    /* Three mbufs of 20 bytes each, with an empty one after the first. */
+    om = os_mbuf_get_pkthdr(&os_mbuf_pool, 0);
+    TEST_ASSERT_FATAL(om != NULL);
+    rc = os_mbuf_append(om, os_mbuf_test_data, 20);
+    TEST_ASSERT_FATAL(rc == 0);
+    for (i = 0; i < 3; i++) {
+        m = os_mbuf_get(&os_mbuf_pool, 0);
+        TEST_ASSERT_FATAL(m != NULL);
+        if (i > 0) {
+            rc = os_mbuf_append(m, os_mbuf_test_data + i * 20, 20);
+            TEST_ASSERT_FATAL(rc == 0);
+        }
+        os_mbuf_concat(om, m);
+    }
+    TEST_ASSERT_FATAL(OS_MBUF_PKTLEN(om) == 60);
+
+    /*** Whole chain; the empty mbuf is skipped and nothing is copied. */
+    iov_cnt = 8;
+    rc = os_mbuf_to_iov(om, 0, 60, iov, &iov_cnt);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT_FATAL(iov_cnt == 3);
+    m = om;
+    for (i = 0; i < 3; i++) {
+        if (m->om_len == 0) {
+            m = SLIST_NEXT(m, om_next);
+        }
+        TEST_ASSERT(iov[i].omi_base == m->om_data);
+        TEST_ASSERT(iov[i].omi_len == 20);
+        m = SLIST_NEXT(m, om_next);
+    }
+
+    /*** Region starting and ending inside mbufs. */
+    iov_cnt = 8;
+    rc = os_mbuf_to_iov(om, 15, 30, iov, &iov_cnt);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT_FATAL(iov_cnt == 3);
+    TEST_ASSERT(iov[0].omi_base == om->om_data + 15 && iov[0].omi_len == 5);
+    TEST_ASSERT(iov[1].omi_len == 20);
+    TEST_ASSERT(iov[2].omi_len == 5);
+    TEST_ASSERT(memcmp(iov[2].omi_base, os_mbuf_test_data + 40, 5) == 0);
+
+    /*** Region within a single mbuf. */
+    iov_cnt = 8;
+    rc = os_mbuf_to_iov(om, 42, 10, iov, &iov_cnt);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT_FATAL(iov_cnt == 1);
+    TEST_ASSERT(memcmp(iov[0].omi_base, os_mbuf_test_data + 42, 10) == 0);
+
+    /*** Empty region. */
+    iov_cnt = 8;
+    rc = os_mbuf_to_iov(om, 60, 0, iov, &iov_cnt);
+    TEST_ASSERT(rc == 0 && iov_cnt == 0);
+
+    /*** Not enough segments; the start of the region is still described. */
+    iov_cnt = 2;
+    rc = os_mbuf_to_iov(om, 0, 60, iov, &iov_cnt);
+    TEST_ASSERT(rc == OS_ENOMEM);
+    TEST_ASSERT(iov_cnt == 2);
+    TEST_ASSERT(iov[0].omi_base == om->om_data && iov[1].omi_len == 20);
+
+    /*** Chain too short. */
+    iov_cnt = 8;
+    rc = os_mbuf_to_iov(om, 50, 11, iov, &iov_cnt);
+    TEST_ASSERT(rc == OS_EINVAL && iov_cnt == 0);
+    iov_cnt = 8;
+    rc = os_mbuf_to_iov(om, 61, 0, iov, &iov_cnt);
+    TEST_ASSERT(rc == OS_EINVAL);
+
+    os_mbuf_free_chain(om);
+}
@@ -0,0 +1,155 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os_test_priv.h"
+
+#define MSYS_TEST_NUM_POOLS     3
+#define MSYS_TEST_BLOCK_COUNT   2
+#define MSYS_TEST_BLOCK_SIZE(i) \
+    (sizeof(struct os_mbuf) + msys_test_databuf_len[i])
+
+/* Two pools share a 32-byte size class to exercise the lookup step. */
+static const uint16_t msys_test_databuf_len[MSYS_TEST_NUM_POOLS] = {
+    40, 60, 200,
+};
+
+static os_membuf_t msys_test_membuf[MSYS_TEST_NUM_POOLS][
+    OS_MEMPOOL_SIZE(MSYS_TEST_BLOCK_COUNT, sizeof(struct os_mbuf) + 200)];
+static struct os_mempool msys_test_mempool[MSYS_TEST_NUM_POOLS];
+static struct os_mbuf_pool msys_test_mbuf_pool[MSYS_TEST_NUM_POOLS];
+
+static struct os_mbuf_pool *
+msys_test_pool_of(uint16_t dsize)
+{
+    struct os_mbuf_pool *omp;
+    struct os_mbuf *om;
+
+    om = os_msys_get(dsize, 0);
+    TEST_ASSERT_FATAL(om != NULL);
+    omp = om->om_omp;
+    os_mbuf_free(om);
+
+    return omp;
+}
+
+TEST_CASE_SELF(os_mbuf_test_msys)
+{
+#if MYNEWT_VAL(MSYS_POOL_STATS)
+    struct os_msys_pool_info ompi;
+#endif
+    struct os_mbuf *om[MSYS_TEST_NUM_POOLS * MSYS_TEST_BLOCK_COUNT];
+    struct os_mbuf_pool *p40;
+    struct os_mbuf_pool *p60;
+    struct os_mbuf_pool *p200;
+    int rc;
+    int i;
+
+    os_msys_reset();
+
+    /* Register out of order; msys keeps the pools sorted. */
+    for (i = MSYS_TEST_NUM_POOLS - 1; i >= 0; i--) {
+        os_mempool_unregister(&msys_test_mempool[i]);
+        rc = os_mempool_init(&msys_test_mempool[i], MSYS_TEST_BLOCK_COUNT,
+                             MSYS_TEST_BLOCK_SIZE(i), msys_test_membuf[i],
+                             "msys_test");
+        TEST_ASSERT_FATAL(rc == 0);
+
+        rc = os_mbuf_pool_init(&msys_test_mbuf_pool[i], &msys_test_mempool[i],
+                               MSYS_TEST_BLOCK_SIZE(i), MSYS_TEST_BLOCK_COUNT);
+        TEST_ASSERT_FATAL(rc == 0);
+
+        rc = os_msys_register(&msys_test_mbuf_pool[i]);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+    p40 = &msys_test_mbuf_pool[0];
+    p60 = &msys_test_mbuf_pool[1];
+    p200 = &msys_test_mbuf_pool[2];
+
+    /*** Best-fit selection. */
+    TEST_ASSERT(msys_test_pool_of(1) == p40);
+    TEST_ASSERT(msys_test_pool_of(32) == p40);
+    TEST_ASSERT(msys_test_pool_of(40) == p40);
+    TEST_ASSERT(msys_test_pool_of(41) == p60);
+    TEST_ASSERT(msys_test_pool_of(60) == p60);
+    TEST_ASSERT(msys_test_pool_of(61) == p200);
+    TEST_ASSERT(msys_test_pool_of(200) == p200);
+    TEST_ASSERT(msys_test_pool_of(201) == p200);
+    TEST_ASSERT(msys_test_pool_of(60000) == p200);
+    TEST_ASSERT(msys_test_pool_of(0) == p200);
+
+    /* Packet header overhead counts towards the size. */
+    om[0] = os_msys_get_pkthdr(33, 0);
+    TEST_ASSERT_FATAL(om[0] != NULL);
+    TEST_ASSERT(om[0]->om_omp == p60);
+    os_mbuf_free(om[0]);
+
+    /*** Fallback to the next larger non-empty pool. */
+    for (i = 0; i < MSYS_TEST_NUM_POOLS * MSYS_TEST_BLOCK_COUNT; i++) {
+        om[i] = os_msys_get(10, 0);
+    }
+    for (i = 0; i < MSYS_TEST_BLOCK_COUNT; i++) {
+        TEST_ASSERT_FATAL(om[i] != NULL && om[i]->om_omp == p40);
+    }
+#if MYNEWT_VAL(MSYS_FALLBACK)
+    for (i = MSYS_TEST_BLOCK_COUNT; i < 2 * MSYS_TEST_BLOCK_COUNT; i++) {
+        TEST_ASSERT(om[i] != NULL && om[i]->om_omp == p60);
+    }
+    for (; i < MSYS_TEST_NUM_POOLS * MSYS_TEST_BLOCK_COUNT; i++) {
+        TEST_ASSERT(om[i] != NULL && om[i]->om_omp == p200);
+    }
+
+    /* Everything is in use now. */
+    TEST_ASSERT(os_msys_get(10, 0) == NULL);
+#else
+    for (; i < MSYS_TEST_NUM_POOLS * MSYS_TEST_BLOCK_COUNT; i++) {
+        TEST_ASSERT(om[i] == NULL);
+    }
+#endif
+
+#if MYNEWT_VAL(MSYS_POOL_STATS)
+    rc = os_msys_pool_info_get(0, &ompi);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(ompi.ompi_databuf_len == 40);
+    TEST_ASSERT(ompi.ompi_num_blocks == MSYS_TEST_BLOCK_COUNT);
+    TEST_ASSERT(ompi.ompi_num_free == 0);
+#if MYNEWT_VAL(MSYS_FALLBACK)
+    TEST_ASSERT(ompi.ompi_fallbacks == 2 * MSYS_TEST_BLOCK_COUNT);
+    TEST_ASSERT(ompi.ompi_failures == 1);
+#else
+    TEST_ASSERT(ompi.ompi_fallbacks == 0);
+    TEST_ASSERT(ompi.ompi_failures == 2 * MSYS_TEST_BLOCK_COUNT);
+#endif
+
+    rc = os_msys_pool_info_get(1, &ompi);
+    TEST_ASSERT(rc == 0 && ompi.ompi_fallbacks == 0 &&
+                ompi.ompi_failures == 0);
+    rc = os_msys_pool_info_get(MSYS_TEST_NUM_POOLS, &ompi);
+    TEST_ASSERT(rc == OS_ENOENT);
+#endif
+
+    for (i = 0; i < MSYS_TEST_NUM_POOLS * MSYS_TEST_BLOCK_COUNT; i++) {
+        if (om[i] != NULL) {
+            os_mbuf_free(om[i]);
+        }
+    }
+    TEST_ASSERT(os_msys_num_free() ==
+                MSYS_TEST_NUM_POOLS * MSYS_TEST_BLOCK_COUNT);
+
+    os_msys_reset();
+}
@@ -0,0 +1,110 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os_test_priv.h"
+
+#define SHARE_TEST_LEN  400
+
+TEST_CASE_SELF(os_mbuf_test_share)
+{
+#if MYNEWT_VAL(OS_MBUF_SHARE)
+    struct os_mbuf *om;
+    struct os_mbuf *sh;
+    struct os_mbuf *sh2;
+    struct os_mbuf *cur;
+    struct os_mbuf *orig;
+    uint8_t *data;
+    int num_free;
+    int rc;
+
+    os_mbuf_test_setup();
+
+    om = os_mbuf_get_pkthdr(&os_mbuf_pool, 0);
+    TEST_ASSERT_FATAL(om != NULL);
+    rc = os_mbuf_append(om, os_mbuf_test_data, SHARE_TEST_LEN);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT_FATAL(SLIST_NEXT(om, om_next) != NULL);
+    TEST_ASSERT(!OS_MBUF_IS_SHARED(om));
+    num_free = os_mbuf_mempool.mp_num_free;
+
+    /*** Sharing only allocates headers; the data is not copied. */
+    sh = os_mbuf_share(&os_mbuf_pool, om);
+    TEST_ASSERT_FATAL(sh != NULL);
+    TEST_ASSERT(os_mbuf_mempool.mp_num_free == num_free - 2);
+    TEST_ASSERT(OS_MBUF_PKTLEN(sh) == SHARE_TEST_LEN);
+    TEST_ASSERT(os_mbuf_cmpm(sh, 0, om, 0, SHARE_TEST_LEN) == 0);
+    for (cur = sh, orig = om; cur != NULL;
+         cur = SLIST_NEXT(cur, om_next), orig = SLIST_NEXT(orig, om_next)) {
+
+        TEST_ASSERT_FATAL(orig != NULL);
+        TEST_ASSERT(cur->om_data == orig->om_data);
+        TEST_ASSERT(cur->om_len == orig->om_len);
+        TEST_ASSERT(OS_MBUF_IS_SHARED(cur) && OS_MBUF_IS_SHARED(orig));
+        TEST_ASSERT(OS_MBUF_LEADINGSPACE(cur) == 0);
+        TEST_ASSERT(OS_MBUF_TRAILINGSPACE(orig) == 0);
+    }
+
+    /* Sharing a shared chain refers to the same data. */
+    sh2 = os_mbuf_share(&os_mbuf_pool, sh);
+    TEST_ASSERT_FATAL(sh2 != NULL);
+    TEST_ASSERT(sh2->om_data == om->om_data);
+    TEST_ASSERT(sh2->om_shared == om);
+
+    /*** Prepend and extend add private mbufs; the original is untouched. */
+    sh = os_mbuf_prepend(sh, 4);
+    TEST_ASSERT_FATAL(sh != NULL);
+    TEST_ASSERT(!OS_MBUF_IS_SHARED(sh));
+    memset(sh->om_data, 0xaa, 4);
+
+    data = os_mbuf_extend(sh, 4);
+    TEST_ASSERT_FATAL(data != NULL);
+    memset(data, 0xbb, 4);
+
+    TEST_ASSERT(OS_MBUF_PKTLEN(sh) == SHARE_TEST_LEN + 8);
+    TEST_ASSERT(OS_MBUF_PKTLEN(om) == SHARE_TEST_LEN);
+    TEST_ASSERT(os_mbuf_cmpf(om, 0, os_mbuf_test_data, SHARE_TEST_LEN) == 0);
+    TEST_ASSERT(os_mbuf_cmpf(sh, 4, os_mbuf_test_data, SHARE_TEST_LEN) == 0);
+
+    /*** Writing into shared data copies it first. */
+    rc = os_mbuf_copyinto(sh, 4, "\x01\x02", 2);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(os_mbuf_cmpf(sh, 4, "\x01\x02", 2) == 0);
+    TEST_ASSERT(os_mbuf_cmpf(om, 0, os_mbuf_test_data, SHARE_TEST_LEN) == 0);
+    TEST_ASSERT(os_mbuf_cmpf(sh2, 0, os_mbuf_test_data, SHARE_TEST_LEN) == 0);
+    TEST_ASSERT(os_mbuf_cmpf(sh, 6, os_mbuf_test_data + 2,
+                             SHARE_TEST_LEN - 2) == 0);
+
+    /*** The data outlives the chain it was allocated for. */
+    os_mbuf_free_chain(om);
+    TEST_ASSERT(os_mbuf_cmpf(sh2, 0, os_mbuf_test_data, SHARE_TEST_LEN) == 0);
+
+    os_mbuf_free_chain(sh);
+
+    /* sh2 is the last user; its data can be made writable in place. */
+    rc = os_mbuf_unshare(sh2);
+    TEST_ASSERT(rc == 0);
+    for (cur = sh2; cur != NULL; cur = SLIST_NEXT(cur, om_next)) {
+        TEST_ASSERT(!OS_MBUF_IS_SHARED(cur));
+    }
+    os_mbuf_free_chain(sh2);
+
+    TEST_ASSERT(os_mbuf_mempool.mp_num_free == MBUF_TEST_POOL_BUF_COUNT);
+    TEST_ASSERT(os_mempool_is_sane(&os_mbuf_mempool));
+#endif
+}
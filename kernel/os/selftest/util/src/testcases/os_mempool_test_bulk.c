@@ -0,0 +1,79 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os_test_priv.h"
+
+#define BULK_TEST_BLOCKS        32
+#define BULK_TEST_BLOCK_SIZE    32
+
+static os_membuf_t bulk_test_membuf[OS_MEMPOOL_SIZE(BULK_TEST_BLOCKS,
+                                                    BULK_TEST_BLOCK_SIZE)];
+static struct os_mempool bulk_test_pool;
+
+TEST_CASE_SELF(os_mempool_test_bulk)
+{
+    void *blocks[BULK_TEST_BLOCKS + 1];
+    int rc;
+    int i;
+    int j;
+
+    os_mempool_unregister(&bulk_test_pool);
+    rc = os_mempool_init(&bulk_test_pool, BULK_TEST_BLOCKS,
+                         BULK_TEST_BLOCK_SIZE, bulk_test_membuf, "bulk");
+    TEST_ASSERT_FATAL(rc == 0);
+
+    TEST_ASSERT(os_memblock_get_n(NULL, blocks, 1) == OS_INVALID_PARM);
+    TEST_ASSERT(os_memblock_put_n(&bulk_test_pool, NULL, 1) ==
+                OS_INVALID_PARM);
+    TEST_ASSERT(os_memblock_get_n(&bulk_test_pool, blocks, 0) == OS_OK);
+
+    /* All-or-nothing: asking for more than is free takes nothing. */
+    rc = os_memblock_get_n(&bulk_test_pool, blocks, BULK_TEST_BLOCKS + 1);
+    TEST_ASSERT(rc == OS_ENOMEM);
+    TEST_ASSERT(bulk_test_pool.mp_num_free == BULK_TEST_BLOCKS);
+
+    rc = os_memblock_get_n(&bulk_test_pool, blocks, BULK_TEST_BLOCKS);
+    TEST_ASSERT_FATAL(rc == OS_OK);
+    TEST_ASSERT(bulk_test_pool.mp_num_free == 0);
+    TEST_ASSERT(bulk_test_pool.mp_min_free == 0);
+    TEST_ASSERT(os_memblock_get(&bulk_test_pool) == NULL);
+    for (i = 0; i < BULK_TEST_BLOCKS; i++) {
+        TEST_ASSERT(os_memblock_from(&bulk_test_pool, blocks[i]));
+        for (j = 0; j < i; j++) {
+            TEST_ASSERT(blocks[i] != blocks[j]);
+        }
+    }
+
+    /* Return half in bulk, half one at a time; everything is reusable. */
+    rc = os_memblock_put_n(&bulk_test_pool, blocks, BULK_TEST_BLOCKS / 2);
+    TEST_ASSERT_FATAL(rc == OS_OK);
+    for (i = BULK_TEST_BLOCKS / 2; i < BULK_TEST_BLOCKS; i++) {
+        rc = os_memblock_put(&bulk_test_pool, blocks[i]);
+        TEST_ASSERT_FATAL(rc == OS_OK);
+    }
+    TEST_ASSERT(bulk_test_pool.mp_num_free == BULK_TEST_BLOCKS);
+    TEST_ASSERT(os_mempool_is_sane(&bulk_test_pool));
+
+    rc = os_memblock_get_n(&bulk_test_pool, blocks, BULK_TEST_BLOCKS);
+    TEST_ASSERT_FATAL(rc == OS_OK);
+    rc = os_memblock_put_n(&bulk_test_pool, blocks, BULK_TEST_BLOCKS);
+    TEST_ASSERT_FATAL(rc == OS_OK);
+
+    TEST_ASSERT(bulk_test_pool.mp_num_free == BULK_TEST_BLOCKS);
+}
@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os_test_priv.h"
+
+#define CHECK_MAP_TEST_BLOCKS       40
+#define CHECK_MAP_TEST_BLOCK_SIZE   20
+
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+static os_membuf_t check_map_test_membuf[
+    OS_MEMPOOL_SIZE(CHECK_MAP_TEST_BLOCKS, CHECK_MAP_TEST_BLOCK_SIZE)];
+static uint32_t check_map_test_map[
+    OS_MEMPOOL_MAP_WORDS(CHECK_MAP_TEST_BLOCKS)];
+static struct os_mempool check_map_test_pool;
+#endif
+
+TEST_CASE_SELF(os_mempool_test_check_map)
+{
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+    struct os_mempool_info omi;
+    struct os_mempool *mp;
+    void *blocks[CHECK_MAP_TEST_BLOCKS];
+    int rc;
+    int i;
+
+    mp = &check_map_test_pool;
+    os_mempool_unregister(mp);
+    rc = os_mempool_init(mp, CHECK_MAP_TEST_BLOCKS, CHECK_MAP_TEST_BLOCK_SIZE,
+                         check_map_test_membuf, "check_map");
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(mp->mp_alloc_map == NULL);
+
+    /* Without a bitmap the pool falls back to the free list walk. */
+    blocks[0] = os_memblock_get(mp);
+    TEST_ASSERT_FATAL(blocks[0] != NULL);
+    TEST_ASSERT(mp->mp_alloc_map == NULL);
+
+    /* A bitmap can't be attached once blocks have been handed out. */
+    memset(check_map_test_map, 0xa5, sizeof check_map_test_map);
+    rc = os_mempool_map_attach(mp, check_map_test_map);
+    TEST_ASSERT(rc == OS_INVALID_PARM);
+    TEST_ASSERT(mp->mp_alloc_map == NULL);
+
+    rc = os_memblock_put(mp, blocks[0]);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    rc = os_mempool_map_attach(mp, check_map_test_map);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(mp->mp_alloc_map == check_map_test_map);
+    TEST_ASSERT(mp->mp_alloc_map[0] == 0 && mp->mp_alloc_map[1] == 0);
+
+    /* One bit per allocated block, in block order. */
+    rc = os_memblock_get_n(mp, blocks, 33);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(mp->mp_alloc_map[0] == 0xffffffff);
+    TEST_ASSERT(mp->mp_alloc_map[1] == 0x1);
+
+    rc = os_memblock_put(mp, blocks[32]);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(mp->mp_alloc_map[1] == 0);
+
+    rc = os_memblock_put_n(mp, blocks, 32);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(mp->mp_alloc_map[0] == 0);
+    TEST_ASSERT(os_mempool_is_sane(mp));
+
+    /* Clearing the pool releases every block. */
+    for (i = 0; i < CHECK_MAP_TEST_BLOCKS; i++) {
+        blocks[i] = os_memblock_get(mp);
+        TEST_ASSERT_FATAL(blocks[i] != NULL);
+    }
+    TEST_ASSERT(mp->mp_alloc_map[1] == 0xff);
+    rc = os_mempool_clear(mp);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(mp->mp_alloc_map[0] == 0 && mp->mp_alloc_map[1] == 0);
+    TEST_ASSERT(os_mempool_is_sane(mp));
+
+    /* The system mbuf pools get a bitmap at init. */
+    mp = NULL;
+    while ((mp = os_mempool_info_get_next(mp, &omi)) != NULL) {
+        if (strcmp(omi.omi_name, "msys_1") == 0) {
+            break;
+        }
+    }
+    TEST_ASSERT_FATAL(mp != NULL);
+    TEST_ASSERT(mp->mp_alloc_map != NULL);
+#endif
+}
@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os_test_priv.h"
+
+#define MALLOC_SLAB_TEST_SIZE   10
+
+TEST_CASE_SELF(os_mempool_test_malloc_slab)
+{
+#if MYNEWT_VAL(OS_MALLOC_SLAB)
+    struct os_malloc_slab_info base;
+    struct os_malloc_slab_info omsi;
+    struct os_malloc_slab_info next;
+    uint8_t *blocks[MYNEWT_VAL(OS_MALLOC_SLAB_1_BLOCK_COUNT)];
+    uint8_t *heap;
+    uint8_t *p;
+    int num;
+    int rc;
+    int i;
+
+    /* Other packages may already hold blocks; work with deltas. */
+    rc = os_malloc_slab_info_get(0, &base);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(base.omsi_block_size >= MALLOC_SLAB_TEST_SIZE);
+    TEST_ASSERT(base.omsi_num_blocks ==
+                MYNEWT_VAL(OS_MALLOC_SLAB_1_BLOCK_COUNT));
+    TEST_ASSERT(os_malloc_slab_info_get(-1, &next) == OS_ENOENT);
+    num = base.omsi_num_free;
+    TEST_ASSERT_FATAL(num > 0);
+    omsi = base;
+
+    /* Classes are sorted by increasing block size. */
+    for (i = 1; os_malloc_slab_info_get(i, &next) == 0; i++) {
+        TEST_ASSERT(next.omsi_block_size > omsi.omsi_block_size);
+    }
+
+    /* Small requests are served from the smallest class. */
+    for (i = 0; i < num; i++) {
+        blocks[i] = os_malloc(MALLOC_SLAB_TEST_SIZE);
+        TEST_ASSERT_FATAL(blocks[i] != NULL);
+        TEST_ASSERT(((uintptr_t)blocks[i] & 7) == 0);
+        memset(blocks[i], i, MALLOC_SLAB_TEST_SIZE);
+    }
+    rc = os_malloc_slab_info_get(0, &omsi);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(omsi.omsi_num_free == 0);
+    TEST_ASSERT(omsi.omsi_hits == base.omsi_hits + num);
+
+    /* An exhausted class falls back to the heap. */
+    heap = os_malloc(MALLOC_SLAB_TEST_SIZE);
+    TEST_ASSERT_FATAL(heap != NULL);
+    rc = os_malloc_slab_info_get(0, &omsi);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(omsi.omsi_misses == base.omsi_misses + 1);
+    os_free(heap);
+
+    /* Resizing within the block keeps the pointer. */
+    p = os_realloc(blocks[0], omsi.omsi_block_size);
+    TEST_ASSERT(p == blocks[0]);
+
+    /* Growing beyond the class moves the data out. */
+    p = os_realloc(blocks[0], omsi.omsi_block_size + 1);
+    TEST_ASSERT_FATAL(p != NULL && p != blocks[0]);
+    for (i = 0; i < MALLOC_SLAB_TEST_SIZE; i++) {
+        TEST_ASSERT(p[i] == 0);
+    }
+    rc = os_malloc_slab_info_get(0, &omsi);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(omsi.omsi_num_free == 1);
+    blocks[0] = p;
+
+    for (i = 0; i < num; i++) {
+        os_free(blocks[i]);
+    }
+    rc = os_malloc_slab_info_get(0, &omsi);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(omsi.omsi_num_free == num);
+
+    /* Requests too large for any class go straight to the heap. */
+    p = os_malloc(1024);
+    TEST_ASSERT_FATAL(p != NULL);
+    os_free(p);
+#endif
+}
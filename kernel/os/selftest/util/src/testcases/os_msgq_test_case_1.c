@@ -0,0 +1,34 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os/mynewt.h"
+#include "taskpool/taskpool.h"
+#include "os_test_priv.h"
+
+TEST_CASE_SELF(os_msgq_test_case_1)
+{
+    os_error_t err;
+
+    err = os_msgq_init(&g_msgq1, g_msgq1_buf, sizeof(struct msgq_test_msg),
+                       MSGQ_TEST_MSG_COUNT);
+    TEST_ASSERT(err == OS_OK);
+
+    taskpool_alloc_assert(msgq_test_1_producer_handler, TASK1_PRIO);
+    taskpool_alloc_assert(msgq_test_1_consumer_handler, TASK2_PRIO);
+}
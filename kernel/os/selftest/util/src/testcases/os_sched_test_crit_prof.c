@@ -0,0 +1,57 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+/*
+ * Holds interrupts off for 200 usecs inside a nested critical section and
+ * checks that the profiler attributes the time to the outer section.
+ */
+TEST_CASE_SELF(os_sched_test_crit_prof)
+{
+#if MYNEWT_VAL(OS_CRIT_PROF)
+    struct os_crit_prof_info before;
+    struct os_crit_prof_info after;
+    os_sr_t sr1;
+    os_sr_t sr2;
+
+    os_crit_prof_clear();
+    os_crit_prof_get(&before);
+
+    OS_ENTER_CRITICAL(sr1);
+    OS_ENTER_CRITICAL(sr2);
+    os_cputime_delay_usecs(100);
+    OS_EXIT_CRITICAL(sr2);
+    os_cputime_delay_usecs(100);
+    OS_EXIT_CRITICAL(sr1);
+
+    os_crit_prof_get(&after);
+    TEST_ASSERT(after.ocp_count > before.ocp_count);
+    TEST_ASSERT(after.ocp_max >= 200);
+    TEST_ASSERT(after.ocp_total >= before.ocp_total + 200);
+    /* 200 usecs falls in the last bucket, 128 usecs and longer. */
+    TEST_ASSERT(after.ocp_hist[OS_CRIT_PROF_BUCKETS - 1] >
+                before.ocp_hist[OS_CRIT_PROF_BUCKETS - 1]);
+    TEST_ASSERT(after.ocp_top[0].ocs_caller != NULL);
+    TEST_ASSERT(after.ocp_top[0].ocs_max == after.ocp_max);
+
+    os_crit_prof_clear();
+    os_crit_prof_get(&before);
+    TEST_ASSERT(before.ocp_count < after.ocp_count);
+#endif
+}
@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+TEST_CASE_SELF(os_sched_test_ready_queue)
+{
+    struct os_task *t1;
+    struct os_task *t2;
+    os_sr_t sr;
+    int i;
+
+    sched_test_init_tasks();
+    TEST_ASSERT(sched_test_run_list_sorted());
+    TEST_ASSERT(os_sched_next_task() == &sched_test_tasks[0]);
+
+    /* Put every task to sleep and wake them up in reverse order. */
+    OS_ENTER_CRITICAL(sr);
+    for (i = 0; i < SCHED_TEST_NUM_TASKS; i++) {
+        os_sched_sleep(&sched_test_tasks[i], OS_TIMEOUT_NEVER);
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    TEST_ASSERT(sched_test_run_list_sorted());
+    TEST_ASSERT(os_sched_next_task() == &g_idle_task);
+
+    OS_ENTER_CRITICAL(sr);
+    for (i = SCHED_TEST_NUM_TASKS - 1; i >= 0; i--) {
+        os_sched_wakeup(&sched_test_tasks[i]);
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    TEST_ASSERT(sched_test_run_list_sorted());
+    TEST_ASSERT(os_sched_next_task() == &sched_test_tasks[0]);
+
+    /*
+     * Raise the priority of a task to match another one, as priority
+     * inheritance does.  The boosted task must be queued behind the task
+     * which already had that priority.
+     */
+    t1 = &sched_test_tasks[4];
+    t2 = &sched_test_tasks[20];
+
+    OS_ENTER_CRITICAL(sr);
+    t2->t_prio = t1->t_prio;
+    os_sched_resort(t2);
+    OS_EXIT_CRITICAL(sr);
+
+    TEST_ASSERT(sched_test_run_list_sorted());
+    TEST_ASSERT(TAILQ_NEXT(t1, t_os_list) == t2);
+
+    /* Sleeping and waking the first one moves it behind the second. */
+    OS_ENTER_CRITICAL(sr);
+    os_sched_sleep(t1, OS_TIMEOUT_NEVER);
+    os_sched_wakeup(t1);
+    OS_EXIT_CRITICAL(sr);
+
+    TEST_ASSERT(sched_test_run_list_sorted());
+    TEST_ASSERT(TAILQ_NEXT(t2, t_os_list) == t1);
+
+    /* Restore the priority. */
+    OS_ENTER_CRITICAL(sr);
+    t2->t_prio = SCHED_TEST_FIRST_PRIO + 20;
+    os_sched_resort(t2);
+    OS_EXIT_CRITICAL(sr);
+
+    TEST_ASSERT(sched_test_run_list_sorted());
+    TEST_ASSERT(TAILQ_NEXT(t1, t_os_list) == &sched_test_tasks[5]);
+    TEST_ASSERT(TAILQ_NEXT(&sched_test_tasks[19], t_os_list) == t2);
+}
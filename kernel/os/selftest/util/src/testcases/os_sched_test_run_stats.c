@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+static uint32_t
+run_stats_hist_sum(const struct os_task *t)
+{
+    uint32_t sum;
+    int i;
+
+    sum = 0;
+    for (i = 0; i < MYNEWT_VAL(OS_TASK_RUN_STATS_LAT_BUCKETS); i++) {
+        sum += t->t_lat_hist[i];
+    }
+    return sum;
+}
+#endif
+
+/*
+ * Drives the context switch hook by hand and checks the CPU time, longest
+ * run and scheduling latency it records.  The OS is not started and OS time
+ * is advanced by hand; the native cputime follows it.
+ */
+TEST_CASE_SELF(os_sched_test_run_stats)
+{
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+    struct os_task_info oti;
+    struct os_task *prev;
+    struct os_task *t0;
+    struct os_task *t1;
+    os_sr_t sr;
+
+    sched_test_init_tasks();
+    t0 = &sched_test_tasks[0];
+    t1 = &sched_test_tasks[1];
+
+    OS_ENTER_CRITICAL(sr);
+    os_sched_set_current_task(t0);
+    os_sched_sleep(t1, OS_TIMEOUT_NEVER);
+
+    /* t1 is woken up, but t0 keeps running for at least 200 usecs. */
+    os_sched_wakeup(t1);
+    os_time_advance((OS_TICKS_PER_SEC * 200 + 999999) / 1000000);
+    os_sched_ctx_sw_hook(t1);
+    os_sched_set_current_task(t1);
+
+    TEST_ASSERT(os_cputime_ticks_to_usecs(t0->t_cpu_time) >= 200);
+    TEST_ASSERT(os_cputime_ticks_to_usecs(t0->t_run_max) >= 200);
+    TEST_ASSERT(run_stats_hist_sum(t1) == 1);
+    /* Buckets 0 to 3 count latencies below 128 usecs. */
+    TEST_ASSERT(t1->t_lat_hist[0] == 0 && t1->t_lat_hist[1] == 0 &&
+                t1->t_lat_hist[2] == 0 && t1->t_lat_hist[3] == 0);
+
+    /* t1 sleeps right away; t0 was preempted, so it was ready meanwhile. */
+    os_sched_sleep(t1, OS_TIMEOUT_NEVER);
+    os_sched_ctx_sw_hook(t0);
+    os_sched_set_current_task(NULL);
+    OS_EXIT_CRITICAL(sr);
+
+    TEST_ASSERT(run_stats_hist_sum(t0) == 1);
+    TEST_ASSERT(t1->t_run_max <= t0->t_run_max);
+
+    prev = NULL;
+    while ((prev = os_task_info_get_next(prev, &oti)) != NULL) {
+        if (prev == t0) {
+            break;
+        }
+    }
+    TEST_ASSERT_FATAL(prev == t0);
+    TEST_ASSERT(oti.oti_cpu_time >= 200);
+    TEST_ASSERT(oti.oti_run_max >= 200);
+    TEST_ASSERT(oti.oti_lat_hist[0] + oti.oti_lat_hist[1] +
+                oti.oti_lat_hist[2] + oti.oti_lat_hist[3] == 1);
+#endif
+}
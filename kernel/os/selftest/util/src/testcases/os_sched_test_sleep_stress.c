@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#define SCHED_TEST_SLEEP_ITERS      (5000)
+
+static uint32_t sched_test_rand_state;
+
+static uint32_t
+sched_test_rand(void)
+{
+    sched_test_rand_state = sched_test_rand_state * 1103515245 + 12345;
+    return sched_test_rand_state >> 16;
+}
+
+/*
+ * Returns the number of ticks until the earliest wakeup of a sleeping test
+ * task, computed by brute force.
+ */
+static os_time_t
+sched_test_first_wakeup(os_time_t now)
+{
+    struct os_task *t;
+    os_time_t ticks;
+    os_time_t rt;
+    int i;
+
+    rt = OS_TIMEOUT_NEVER;
+    for (i = 0; i < SCHED_TEST_NUM_TASKS; i++) {
+        t = &sched_test_tasks[i];
+        if (t->t_state != OS_TASK_SLEEP ||
+            (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT)) {
+            continue;
+        }
+
+        if (OS_TIME_TICK_GEQ(t->t_next_wakeup, now)) {
+            ticks = t->t_next_wakeup - now;
+        } else {
+            ticks = 0;
+        }
+        if (ticks < rt) {
+            rt = ticks;
+        }
+    }
+
+    return rt;
+}
+
+/*
+ * Puts the test tasks to sleep and wakes them up in random order, both
+ * explicitly (as a semaphore release does) and by letting time pass.
+ */
+TEST_CASE_SELF(os_sched_test_sleep_stress)
+{
+    struct os_task *t;
+    os_time_t now;
+    os_sr_t sr;
+    int i;
+    int j;
+
+    sched_test_rand_state = 1;
+    sched_test_init_tasks();
+
+    for (i = 0; i < SCHED_TEST_SLEEP_ITERS; i++) {
+        t = &sched_test_tasks[sched_test_rand() % SCHED_TEST_NUM_TASKS];
+
+        OS_ENTER_CRITICAL(sr);
+        switch (sched_test_rand() % 4) {
+        case 0:
+            os_time_advance(sched_test_rand() % 50);
+            os_sched_os_timer_exp();
+            break;
+
+        case 1:
+            if (t->t_state == OS_TASK_SLEEP) {
+                os_sched_wakeup(t);
+                break;
+            }
+            /* FALLTHROUGH */
+
+        default:
+            if (t->t_state == OS_TASK_READY) {
+                if (sched_test_rand() % 8 == 0) {
+                    os_sched_sleep(t, OS_TIMEOUT_NEVER);
+                } else {
+                    os_sched_sleep(t, 1 + sched_test_rand() % 2000);
+                }
+            }
+            break;
+        }
+
+        now = os_time_get();
+        TEST_ASSERT_FATAL(os_sched_wakeup_ticks(now) ==
+                          sched_test_first_wakeup(now));
+        OS_EXIT_CRITICAL(sr);
+
+        TEST_ASSERT_FATAL(sched_test_run_list_sorted());
+    }
+
+    /* Let all remaining timeouts expire. */
+    OS_ENTER_CRITICAL(sr);
+    os_time_advance(2000);
+    os_sched_os_timer_exp();
+    TEST_ASSERT(os_sched_wakeup_ticks(os_time_get()) == OS_TIMEOUT_NEVER);
+    OS_EXIT_CRITICAL(sr);
+
+    for (j = 0; j < SCHED_TEST_NUM_TASKS; j++) {
+        t = &sched_test_tasks[j];
+        TEST_ASSERT(t->t_state == OS_TASK_READY ||
+                    (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT));
+    }
+}
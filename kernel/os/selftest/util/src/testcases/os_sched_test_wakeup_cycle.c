@@ -0,0 +1,81 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+static uint32_t sched_test_cycle_state;
+
+static struct os_task *
+sched_test_first_ready(void)
+{
+    int i;
+
+    for (i = 0; i < SCHED_TEST_NUM_TASKS; i++) {
+        if (sched_test_tasks[i].t_state == OS_TASK_READY) {
+            return &sched_test_tasks[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Sleeps and wakes tasks in a pseudo-random order, and checks after every
+ * operation that the run list is sorted and that the highest priority ready
+ * task is the one chosen to run next.
+ */
+TEST_CASE_SELF(os_sched_test_wakeup_cycle)
+{
+    struct os_task *first;
+    struct os_task *t;
+    os_sr_t sr;
+    int i;
+
+    sched_test_cycle_state = 1;
+    sched_test_init_tasks();
+
+    OS_ENTER_CRITICAL(sr);
+    for (i = 0; i < SCHED_TEST_CYCLE_ITERS; i++) {
+        sched_test_cycle_state = sched_test_cycle_state * 1103515245 + 12345;
+        t = &sched_test_tasks[(sched_test_cycle_state >> 16) %
+                              SCHED_TEST_NUM_TASKS];
+
+        if (t->t_state == OS_TASK_READY) {
+            os_sched_sleep(t, OS_TIMEOUT_NEVER);
+        } else {
+            os_sched_wakeup(t);
+        }
+
+        TEST_ASSERT_FATAL(sched_test_run_list_sorted());
+        first = sched_test_first_ready();
+        if (first != NULL) {
+            TEST_ASSERT_FATAL(os_sched_next_task() == first);
+        }
+    }
+
+    for (i = 0; i < SCHED_TEST_NUM_TASKS; i++) {
+        if (sched_test_tasks[i].t_state == OS_TASK_SLEEP) {
+            os_sched_wakeup(&sched_test_tasks[i]);
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    TEST_ASSERT(sched_test_run_list_sorted());
+    TEST_ASSERT(os_sched_next_task() == &sched_test_tasks[0]);
+    TEST_ASSERT(TAILQ_LAST(&g_os_run_list, os_task_list) == &g_idle_task);
+}
@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os_test_priv.h"
+
+/*
+ * Checks the division-free conversions against the 64-bit divisions they
+ * replace.  Every input below 2^20 is checked, the rest of the 32-bit range
+ * with a prime stride.
+ */
+#define OTTR_DENSE_MAX      (1UL << 20)
+#define OTTR_STRIDE         4099
+
+static int
+ottr_next(uint64_t x)
+{
+    return x < OTTR_DENSE_MAX ? 1 : OTTR_STRIDE;
+}
+
+/*
+ * Checks floor(x / d) at both sides of every step of the quotient.  The
+ * computed quotient never decreases as x grows, so this covers every x.
+ */
+static void
+ottr_check_div(uint32_t d)
+{
+    uint32_t m;
+    uint64_t x;
+    int sh1;
+    int sh2;
+
+    m = OS_RECIP_M(d);
+    sh1 = OS_RECIP_SH1(d);
+    sh2 = OS_RECIP_SH2(d);
+
+    for (x = d; x <= UINT32_MAX; x += d) {
+        TEST_ASSERT_FATAL(os_recip_div(x - 1, m, sh1, sh2) == (x - 1) / d,
+                          "d=%lu x=%llu", (unsigned long)d,
+                          (unsigned long long)x - 1);
+        TEST_ASSERT_FATAL(os_recip_div(x, m, sh1, sh2) == x / d,
+                          "d=%lu x=%llu", (unsigned long)d,
+                          (unsigned long long)x);
+    }
+    TEST_ASSERT_FATAL(os_recip_div(UINT32_MAX, m, sh1, sh2) == UINT32_MAX / d);
+}
+
+#define OTTR_CHECK_SCALE(num, den) do {                                     \
+    uint64_t x;                                                             \
+                                                                            \
+    for (x = 0; x <= UINT32_MAX; x += ottr_next(x)) {                       \
+        TEST_ASSERT_FATAL(OS_RECIP_SCALE(x, num, den) == x * (num) / (den), \
+                          #num "/" #den " x=%llu", (unsigned long long)x);  \
+    }                                                                       \
+} while (0)
+
+TEST_CASE_SELF(os_time_test_recip)
+{
+    static const uint32_t divs[] = {
+        4096, 15625, 32768, 1000000, 0x7fffffff, 0x80000001, 0xffffffff,
+    };
+    uint64_t x;
+    uint32_t val;
+    int rc;
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(divs); i++) {
+        ottr_check_div(divs[i]);
+    }
+
+    /* Small divisors have too many steps to check them all. */
+    for (x = 0; x <= UINT32_MAX; x += ottr_next(x)) {
+        TEST_ASSERT_FATAL(OS_RECIP_DIV(x, 1) == x);
+        TEST_ASSERT_FATAL(OS_RECIP_DIV(x, 3) == x / 3);
+        TEST_ASSERT_FATAL(OS_RECIP_DIV(x, 125) == x / 125);
+        TEST_ASSERT_FATAL(OS_RECIP_DIV(x, 1000) == x / 1000);
+    }
+
+    /* Ratios used by the tick and cputime conversions */
+    OTTR_CHECK_SCALE(128, 1000);
+    OTTR_CHECK_SCALE(1000, 128);
+    OTTR_CHECK_SCALE(1024, 1000);
+    OTTR_CHECK_SCALE(1000, 1024);
+    OTTR_CHECK_SCALE(100, 1000);
+    OTTR_CHECK_SCALE(1000, 100);
+    OTTR_CHECK_SCALE(32768, 1000000);
+    OTTR_CHECK_SCALE(1000000, 32768);
+    OTTR_CHECK_SCALE(524288, 1000000);
+    OTTR_CHECK_SCALE(1000000, 524288);
+
+    /* The conversions of this build */
+    for (x = 0; x <= UINT32_MAX; x += ottr_next(x)) {
+        TEST_ASSERT_FATAL(os_time_ms_to_ticks32(x) ==
+                          (os_time_t)(x * OS_TICKS_PER_SEC / 1000));
+        TEST_ASSERT_FATAL(os_time_ticks_to_ms32(x) ==
+                          (uint32_t)(x * 1000 / OS_TICKS_PER_SEC));
+
+        rc = os_time_ms_to_ticks(x, &val);
+        if (x * OS_TICKS_PER_SEC / 1000 > UINT32_MAX) {
+            TEST_ASSERT_FATAL(rc == OS_EINVAL);
+        } else {
+            TEST_ASSERT_FATAL(rc == 0 && val == x * OS_TICKS_PER_SEC / 1000);
+        }
+
+        rc = os_time_ticks_to_ms(x, &val);
+        if (x * 1000 / OS_TICKS_PER_SEC > UINT32_MAX) {
+            TEST_ASSERT_FATAL(rc == OS_EINVAL);
+        } else {
+            TEST_ASSERT_FATAL(rc == 0 && val == x * 1000 / OS_TICKS_PER_SEC);
+        }
+
+        TEST_ASSERT_FATAL(os_cputime_usecs_to_ticks(x) ==
+                          (uint32_t)(x * MYNEWT_VAL(OS_CPUTIME_FREQ) /
+                                     1000000));
+#if !defined(OS_CPUTIME_FREQ_HIGH)
+        TEST_ASSERT_FATAL(os_cputime_ticks_to_usecs(x) ==
+                          (uint32_t)(x * 1000000 /
+                                     MYNEWT_VAL(OS_CPUTIME_FREQ)));
+#endif
+    }
+}
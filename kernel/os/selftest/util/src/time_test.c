@@ -24,4 +24,5 @@
 TEST_SUITE(os_time_test_suite)
 {
     os_time_test_change();
+    os_time_test_recip();
 }
@@ -164,7 +164,7 @@ PendSV_Handler:
         LDMIA   R12!,{R4-R11}           /* Restore New Context */
         MSR     PSP,R12                 /* Write PSP */
 
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TRACE_RAM)
         PUSH    {R4,LR}
         MOV     R0, R2
         BL      os_trace_task_start_exec
@@ -222,7 +222,7 @@ os_init(int (*main_fn)(int argc, char **arg))
     SEGGER_RTT_Init();
 #endif
 
-    TAILQ_INIT(&g_callout_list);
+    os_callout_module_init();
     STAILQ_INIT(&g_os_task_list);
     os_eventq_init(os_eventq_dflt_get());
 
@@ -243,6 +243,11 @@ os_init(int (*main_fn)(int argc, char **arg))
     /* Call bsp related OS initializations */
     hal_bsp_init();
 
+#if MYNEWT_VAL(OS_CRIT_PROF)
+    /* os_cputime is running now; critical sections can be timed. */
+    os_crit_prof_start();
+#endif
+
     err = (os_error_t) os_dev_initialize_all(OS_DEV_INIT_PRIMARY);
     assert(err == OS_OK);
 
@@ -259,6 +264,10 @@ os_start(void)
     /* Enable the watchdog prior to starting the OS */
     hal_watchdog_enable();
 
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+    os_sched_run_stats_start();
+#endif
+
     err = os_arch_os_start();
     assert(err == OS_OK);
 #else
@@ -296,6 +305,9 @@ os_pkg_init(void)
 
     os_mempool_module_init();
     os_msys_init();
+#if MYNEWT_VAL(OS_MALLOC_SLAB)
+    os_malloc_slab_init();
+#endif
 }
 
 /**
@@ -25,9 +25,296 @@
 #endif
 #include "os/mynewt.h"
 #include "os_priv.h"
+#if MYNEWT_VAL(OS_CALLOUT_STATS)
+#include "stats/stats.h"
+#endif
+
+#if MYNEWT_VAL(OS_CALLOUT_STATS)
+STATS_SECT_START(os_callout_stats)
+    STATS_SECT_ENTRY(wakeups)       /* ticks which expired callouts */
+    STATS_SECT_ENTRY(fired)         /* callouts expired */
+    STATS_SECT_ENTRY(coalesced)     /* wakeups saved by timer slack */
+STATS_SECT_END
+
+STATS_NAME_START(os_callout_stats)
+    STATS_NAME(os_callout_stats, wakeups)
+    STATS_NAME(os_callout_stats, fired)
+    STATS_NAME(os_callout_stats, coalesced)
+STATS_NAME_END(os_callout_stats)
+
+static STATS_SECT_DECL(os_callout_stats) os_callout_stats;
+#endif
+
+/*
+ * Returns the latest time at which the callout is allowed to expire.
+ */
+static inline os_time_t
+os_callout_deadline(const struct os_callout *c)
+{
+#if MYNEWT_VAL(OS_CALLOUT_SLACK)
+    return c->c_ticks + c->c_slack;
+#else
+    return c->c_ticks;
+#endif
+}
+
+#if MYNEWT_VAL(OS_CALLOUT_WHEEL)
+#define OS_CALLOUT_WHEEL_SLOTS  MYNEWT_VAL(OS_CALLOUT_WHEEL_SLOTS)
+#define OS_CALLOUT_WHEEL_MASK   (OS_CALLOUT_WHEEL_SLOTS - 1)
+
+#if OS_CALLOUT_WHEEL_SLOTS & OS_CALLOUT_WHEEL_MASK
+#error "OS_CALLOUT_WHEEL_SLOTS must be a power of 2"
+#endif
+
+/*
+ * Hashed timing wheel.  A callout is kept, unsorted, in the slot given by
+ * the low bits of its expiry time, so arming and stopping are O(1).  Slots
+ * hold callouts for all future rounds of the wheel; os_callout_tick() walks
+ * the slots for the ticks which elapsed since it last ran and posts the
+ * callouts that have expired.
+ */
+static struct os_callout_list os_callout_wheel[OS_CALLOUT_WHEEL_SLOTS];
+
+/* Last tick processed by os_callout_tick(). */
+static os_time_t os_callout_wheel_time;
+
+/* Number of callouts in the wheel. */
+static uint32_t os_callout_wheel_cnt;
+
+/*
+ * Earliest deadline of all callouts in the wheel; only meaningful while
+ * os_callout_wheel_next_valid is set.  Recomputed when needed by
+ * os_callout_wakeup_ticks().
+ */
+static os_time_t os_callout_wheel_next;
+static uint8_t os_callout_wheel_next_valid;
+
+static void
+os_callout_list_insert(struct os_callout *c)
+{
+    TAILQ_INSERT_TAIL(&os_callout_wheel[c->c_ticks & OS_CALLOUT_WHEEL_MASK],
+                      c, c_next);
+
+    if (os_callout_wheel_cnt == 0) {
+        os_callout_wheel_next = os_callout_deadline(c);
+        os_callout_wheel_next_valid = 1;
+    } else if (os_callout_wheel_next_valid &&
+               OS_TIME_TICK_LT(os_callout_deadline(c),
+                               os_callout_wheel_next)) {
+        os_callout_wheel_next = os_callout_deadline(c);
+    }
+    os_callout_wheel_cnt++;
+}
+
+static void
+os_callout_list_remove(struct os_callout *c)
+{
+    TAILQ_REMOVE(&os_callout_wheel[c->c_ticks & OS_CALLOUT_WHEEL_MASK],
+                 c, c_next);
+    c->c_next.tqe_prev = NULL;
+
+    if (os_callout_deadline(c) == os_callout_wheel_next) {
+        os_callout_wheel_next_valid = 0;
+    }
+    os_callout_wheel_cnt--;
+}
+
+/*
+ * Removes and returns one callout which has expired by 'now', or NULL if
+ * there are none left.  Must be called with interrupts disabled.
+ */
+static struct os_callout *
+os_callout_list_pop_expired(os_time_t now)
+{
+    struct os_callout *c;
+
+    /* Every slot gets visited at most once per call to os_callout_tick(). */
+    if (now - os_callout_wheel_time >= OS_CALLOUT_WHEEL_SLOTS) {
+        os_callout_wheel_time = now - OS_CALLOUT_WHEEL_MASK;
+    }
+
+    while (1) {
+        TAILQ_FOREACH(c, &os_callout_wheel[os_callout_wheel_time &
+                                           OS_CALLOUT_WHEEL_MASK], c_next) {
+            if (OS_TIME_TICK_GEQ(now, c->c_ticks)) {
+                os_callout_list_remove(c);
+                return c;
+            }
+        }
+
+        if (os_callout_wheel_time == now) {
+            return NULL;
+        }
+        os_callout_wheel_time++;
+    }
+}
+
+/*
+ * Finds the earliest deadline of all callouts in the wheel.  Must be called
+ * with interrupts disabled.
+ */
+static void
+os_callout_wheel_update_next(os_time_t now)
+{
+    struct os_callout *c;
+    os_time_t next;
+    int found;
+    int i;
+
+    found = 0;
+    next = 0;
+
+    /*
+     * If os_callout_tick() is up to date, nothing in the wheel expires at
+     * or before 'now', so the slots can be visited in expiry order.  A
+     * callout's deadline is never before its expiry time; stop as soon as
+     * the slots reach the earliest deadline seen so far.
+     */
+    if (os_callout_wheel_time == now) {
+        for (i = 1; i < OS_CALLOUT_WHEEL_SLOTS; i++) {
+            if (found && OS_TIME_TICK_GT(now + i, next)) {
+                os_callout_wheel_next = next;
+                os_callout_wheel_next_valid = 1;
+                return;
+            }
+            TAILQ_FOREACH(c, &os_callout_wheel[(now + i) &
+                                               OS_CALLOUT_WHEEL_MASK],
+                          c_next) {
+                if (c->c_ticks == now + i &&
+                    (!found ||
+                     OS_TIME_TICK_LT(os_callout_deadline(c), next))) {
+                    next = os_callout_deadline(c);
+                    found = 1;
+                }
+            }
+        }
+    }
+
+    /* Otherwise look at all of them. */
+    for (i = 0; i < OS_CALLOUT_WHEEL_SLOTS; i++) {
+        TAILQ_FOREACH(c, &os_callout_wheel[i], c_next) {
+            if (!found || OS_TIME_TICK_LT(os_callout_deadline(c), next)) {
+                next = os_callout_deadline(c);
+                found = 1;
+            }
+        }
+    }
+    assert(found);
+    os_callout_wheel_next = next;
+    os_callout_wheel_next_valid = 1;
+}
+
+/*
+ * Gets the time by which os_callout_tick() needs to run next.  Returns 0 if
+ * there are no pending callouts.  Must be called with interrupts disabled.
+ */
+static int
+os_callout_list_next(os_time_t now, os_time_t *out_next)
+{
+    if (os_callout_wheel_cnt == 0) {
+        return 0;
+    }
+    if (!os_callout_wheel_next_valid) {
+        os_callout_wheel_update_next(now);
+    }
+
+    *out_next = os_callout_wheel_next;
+    return 1;
+}
 
+void
+os_callout_module_init(void)
+{
+    int i;
+
+    for (i = 0; i < OS_CALLOUT_WHEEL_SLOTS; i++) {
+        TAILQ_INIT(&os_callout_wheel[i]);
+    }
+    os_callout_wheel_time = os_time_get();
+    os_callout_wheel_cnt = 0;
+    os_callout_wheel_next_valid = 0;
+}
+#else
 struct os_callout_list g_callout_list;
 
+static void
+os_callout_list_insert(struct os_callout *c)
+{
+    struct os_callout *entry;
+
+    TAILQ_FOREACH(entry, &g_callout_list, c_next) {
+        if (OS_TIME_TICK_LT(c->c_ticks, entry->c_ticks)) {
+            break;
+        }
+    }
+
+    if (entry) {
+        TAILQ_INSERT_BEFORE(entry, c, c_next);
+    } else {
+        TAILQ_INSERT_TAIL(&g_callout_list, c, c_next);
+    }
+}
+
+static void
+os_callout_list_remove(struct os_callout *c)
+{
+    TAILQ_REMOVE(&g_callout_list, c, c_next);
+    c->c_next.tqe_prev = NULL;
+}
+
+static struct os_callout *
+os_callout_list_pop_expired(os_time_t now)
+{
+    struct os_callout *c;
+
+    c = TAILQ_FIRST(&g_callout_list);
+    if (c) {
+        if (OS_TIME_TICK_GEQ(now, c->c_ticks)) {
+            os_callout_list_remove(c);
+        } else {
+            c = NULL;
+        }
+    }
+
+    return c;
+}
+
+static int
+os_callout_list_next(os_time_t now, os_time_t *out_next)
+{
+    struct os_callout *c;
+    os_time_t next;
+
+    c = TAILQ_FIRST(&g_callout_list);
+    if (c == NULL) {
+        return 0;
+    }
+
+    next = os_callout_deadline(c);
+#if MYNEWT_VAL(OS_CALLOUT_SLACK)
+    /*
+     * A callout expiring later can only have an earlier deadline if it
+     * expires before the earliest deadline found so far.
+     */
+    while ((c = TAILQ_NEXT(c, c_next)) != NULL &&
+           OS_TIME_TICK_LT(c->c_ticks, next)) {
+        if (OS_TIME_TICK_LT(os_callout_deadline(c), next)) {
+            next = os_callout_deadline(c);
+        }
+    }
+#endif
+
+    *out_next = next;
+    return 1;
+}
+
+void
+os_callout_module_init(void)
+{
+    TAILQ_INIT(&g_callout_list);
+}
+#endif
+
 void os_callout_init(struct os_callout *c, struct os_eventq *evq,
                      os_event_fn *ev_cb, void *ev_arg)
 {
@@ -51,8 +338,7 @@ os_callout_stop(struct os_callout *c)
     OS_ENTER_CRITICAL(sr);
 
     if (os_callout_queued(c)) {
-        TAILQ_REMOVE(&g_callout_list, c, c_next);
-        c->c_next.tqe_prev = NULL;
+        os_callout_list_remove(c);
     }
 
     if (c->c_evq) {
@@ -64,10 +350,9 @@ os_callout_stop(struct os_callout *c)
     os_trace_api_ret(OS_TRACE_ID_CALLOUT_STOP);
 }
 
-int
-os_callout_reset(struct os_callout *c, os_time_t ticks)
+static int
+os_callout_arm(struct os_callout *c, os_time_t ticks, os_time_t slack)
 {
-    struct os_callout *entry;
     os_sr_t sr;
     int ret;
 
@@ -90,19 +375,10 @@ os_callout_reset(struct os_callout *c, os_time_t ticks)
     }
 
     c->c_ticks = os_time_get() + ticks;
-
-    entry = NULL;
-    TAILQ_FOREACH(entry, &g_callout_list, c_next) {
-        if (OS_TIME_TICK_LT(c->c_ticks, entry->c_ticks)) {
-            break;
-        }
-    }
-
-    if (entry) {
-        TAILQ_INSERT_BEFORE(entry, c, c_next);
-    } else {
-        TAILQ_INSERT_TAIL(&g_callout_list, c, c_next);
-    }
+#if MYNEWT_VAL(OS_CALLOUT_SLACK)
+    c->c_slack = slack;
+#endif
+    os_callout_list_insert(c);
 
     OS_EXIT_CRITICAL(sr);
 
@@ -113,6 +389,24 @@ err:
     return ret;
 }
 
+int
+os_callout_reset(struct os_callout *c, os_time_t ticks)
+{
+    return os_callout_arm(c, ticks, 0);
+}
+
+#if MYNEWT_VAL(OS_CALLOUT_SLACK)
+int
+os_callout_reset_slack(struct os_callout *c, os_time_t ticks, os_time_t slack)
+{
+    if (slack > INT32_MAX - ticks) {
+        return OS_EINVAL;
+    }
+
+    return os_callout_arm(c, ticks, slack);
+}
+#endif
+
 
 /**
  * This function is called by the OS in the time tick.  It searches the list
@@ -126,25 +420,40 @@ os_callout_tick(void)
     os_sr_t sr;
     struct os_callout *c;
     uint32_t now;
+#if MYNEWT_VAL(OS_CALLOUT_STATS)
+    os_time_t last_ticks;
+    int num_fired;
+#endif
 
     os_trace_api_void(OS_TRACE_ID_CALLOUT_TICK);
 
     now = os_time_get();
+#if MYNEWT_VAL(OS_CALLOUT_STATS)
+    last_ticks = 0;
+    num_fired = 0;
+#endif
 
     while (1) {
         OS_ENTER_CRITICAL(sr);
-        c = TAILQ_FIRST(&g_callout_list);
-        if (c) {
-            if (OS_TIME_TICK_GEQ(now, c->c_ticks)) {
-                TAILQ_REMOVE(&g_callout_list, c, c_next);
-                c->c_next.tqe_prev = NULL;
-            } else {
-                c = NULL;
-            }
-        }
+        c = os_callout_list_pop_expired(now);
         OS_EXIT_CRITICAL(sr);
 
         if (c) {
+#if MYNEWT_VAL(OS_CALLOUT_STATS)
+            /*
+             * Callouts with a different expiry time than the previous one
+             * would have needed a wakeup of their own.
+             */
+            if (num_fired == 0) {
+                STATS_INC(os_callout_stats, wakeups);
+            } else if (c->c_ticks != last_ticks) {
+                STATS_INC(os_callout_stats, coalesced);
+            }
+            STATS_INC(os_callout_stats, fired);
+            last_ticks = c->c_ticks;
+            num_fired++;
+#endif
+
             if (c->c_evq) {
                 os_eventq_put(c->c_evq, &c->c_ev);
             } else {
@@ -162,6 +471,10 @@ os_callout_tick(void)
  * Returns the number of ticks to the first pending callout. If there are no
  * pending callouts then return OS_TIMEOUT_NEVER instead.
  *
+ * Callouts armed with slack may expire late; the wakeup is delayed up to the
+ * earliest deadline, so that all callouts whose windows overlap it expire
+ * together.
+ *
  * @param now The time now
  *
  * @return Number of ticks to first pending callout
@@ -169,15 +482,14 @@ os_callout_tick(void)
 os_time_t
 os_callout_wakeup_ticks(os_time_t now)
 {
+    os_time_t next;
     os_time_t rt;
-    struct os_callout *c;
 
     OS_ASSERT_CRITICAL();
 
-    c = TAILQ_FIRST(&g_callout_list);
-    if (c != NULL) {
-        if (OS_TIME_TICK_GEQ(c->c_ticks, now)) {
-            rt = c->c_ticks - now;
+    if (os_callout_list_next(now, &next)) {
+        if (OS_TIME_TICK_GEQ(next, now)) {
+            rt = next - now;
         } else {
             rt = 0;     /* callout time is in the past */
         }
@@ -208,3 +520,20 @@ os_callout_remaining_ticks(struct os_callout *c, os_time_t now)
     return rt;
 }
 
+#if MYNEWT_VAL(OS_CALLOUT_STATS)
+void
+os_callout_stats_init(void)
+{
+    int rc;
+
+    /* Ensure this function only gets called by sysinit. */
+    SYSINIT_ASSERT_ACTIVE();
+
+    rc = stats_init_and_reg(STATS_HDR(os_callout_stats),
+                            STATS_SIZE_INIT_PARMS(os_callout_stats,
+                                                  STATS_SIZE_32),
+                            STATS_NAME_INIT_PARMS(os_callout_stats),
+                            "os_callout");
+    SYSINIT_PANIC_ASSERT(rc == 0);
+}
+#endif
@@ -45,7 +45,7 @@
 uint32_t
 os_cputime_nsecs_to_ticks(uint32_t nsecs)
 {
-    return (nsecs + 999) / 1000;
+    return OS_RECIP_DIV(nsecs + 999, 1000);
 }
 
 /**
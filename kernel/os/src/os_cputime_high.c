@@ -21,7 +21,9 @@
 
 /**
  * This module implements cputime functionality for timers whose frequency is
- * greater than 1 MHz.
+ * greater than 1 MHz.  The number of ticks per usec is a compile-time
+ * constant, so the divisions below are done as multiplications by its
+ * reciprocal.
  */
 
 #if defined(OS_CPUTIME_FREQ_HIGH)
@@ -45,7 +47,7 @@
 uint32_t
 os_cputime_usecs_to_ticks(uint32_t usecs)
 {
-    return usecs * g_os_cputime.ticks_per_usec;
+    return usecs * OS_CPUTIME_TICKS_PER_USEC;
 }
 
 /**
@@ -60,8 +62,8 @@ os_cputime_usecs_to_ticks(uint32_t usecs)
 uint32_t
 os_cputime_ticks_to_usecs(uint32_t ticks)
 {
-    return (ticks + g_os_cputime.ticks_per_usec - 1) /
-           g_os_cputime.ticks_per_usec;
+    return OS_RECIP_DIV(ticks + OS_CPUTIME_TICKS_PER_USEC - 1,
+                        OS_CPUTIME_TICKS_PER_USEC);
 }
 
 /**
@@ -76,7 +78,7 @@ os_cputime_ticks_to_usecs(uint32_t ticks)
 uint32_t
 os_cputime_nsecs_to_ticks(uint32_t nsecs)
 {
-    return (nsecs * g_os_cputime.ticks_per_usec + 999) / 1000;
+    return OS_RECIP_DIV(nsecs * OS_CPUTIME_TICKS_PER_USEC + 999, 1000);
 }
 
 /**
@@ -91,8 +93,8 @@ os_cputime_nsecs_to_ticks(uint32_t nsecs)
 uint32_t
 os_cputime_ticks_to_nsecs(uint32_t ticks)
 {
-    return (ticks * 1000 + g_os_cputime.ticks_per_usec - 1) /
-           g_os_cputime.ticks_per_usec;
+    return OS_RECIP_DIV(ticks * 1000 + OS_CPUTIME_TICKS_PER_USEC - 1,
+                        OS_CPUTIME_TICKS_PER_USEC);
 }
 
 /**
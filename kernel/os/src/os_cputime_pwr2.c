@@ -17,6 +17,7 @@
  * under the License.
  */
 
+#include <assert.h>
 #include "os/mynewt.h"
 
 /**
@@ -46,19 +47,11 @@
 uint32_t
 os_cputime_usecs_to_ticks(uint32_t usecs)
 {
-    uint64_t ticks;
+    static_assert(OS_RECIP_SCALE_OK(MYNEWT_VAL(OS_CPUTIME_FREQ), 1000000),
+                  "OS_CPUTIME_FREQ too large");
 
-    /*
-     * Faster calculation but could be off 1 full tick since we do not
-     * add residual back. Adding back the residual is commented out below, but
-     * shown.
-     */
-    ticks = (1ULL << 32) * MYNEWT_VAL(OS_CPUTIME_FREQ) / 1000000 * usecs;
-
-    /* Residual for 32768 Hz. */
-    //ticks += ((uint64_t)usecs * (1526122139+1)) >> 32;
-
-    return ticks >> 32;
+    /* Exact: usecs * freq / 1000000, rounded down. */
+    return OS_RECIP_SCALE(usecs, MYNEWT_VAL(OS_CPUTIME_FREQ), 1000000);
 }
 
 /**
@@ -70,35 +63,20 @@ os_cputime_usecs_to_ticks(uint32_t usecs)
  *
  * @return uint32_t The number of microseconds corresponding to 'ticks'
  *
- * NOTE: This calculation will overflow if the value for ticks is greater
- * than 140737488. I am not going to check that here because that many ticks
- * is about 4222 seconds, way more than what this routine should be used for.
+ * NOTE: The result wraps if it does not fit in 32 bits, i.e., if ticks is
+ * more than about 4295 seconds' worth.
  */
 uint32_t
 os_cputime_ticks_to_usecs(uint32_t ticks)
 {
-    uint32_t usecs;
-    uint32_t shift;
-    uint32_t freq;
+    static_assert(OS_RECIP_SCALE_OK(1000000, MYNEWT_VAL(OS_CPUTIME_FREQ)),
+                  "OS_CPUTIME_FREQ too large");
 
-    /* Given: `freq = 2^n`, calculate `n`. */
-    /* Note: this looks like a lot of work, but gcc can optimize it away since
-     * `freq` is known at compile time.
+    /*
+     * Exact: ticks * 1000000 / freq, rounded down.  With freq = 2^n this is
+     * ticks * 15625 / 2^(n - 6), so the division is a shift.
      */
-    freq = MYNEWT_VAL(OS_CPUTIME_FREQ);
-    shift = 0;
-    while (freq != 0) {
-        freq >>= 1;
-        shift++;
-    }
-
-    if (shift <= 7) {
-        return 0;
-    }
-    shift -= 7;
-
-    usecs = ((ticks >> shift) * 15625) + (((ticks & 0x1ff) * 15625) >> shift);
-    return usecs;
+    return OS_RECIP_SCALE(ticks, 1000000, MYNEWT_VAL(OS_CPUTIME_FREQ));
 }
 
 /**
@@ -0,0 +1,210 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include "os/mynewt.h"
+#if MYNEWT_VAL(OS_CRIT_PROF_STATS)
+#include "stats/stats.h"
+#endif
+
+#if MYNEWT_VAL(OS_CRIT_PROF)
+
+#if MYNEWT_VAL(OS_CRIT_PROF_STATS)
+STATS_SECT_START(os_crit_prof_stats)
+    STATS_SECT_ENTRY(sections)      /* critical sections measured */
+    STATS_SECT_ENTRY(max_usecs)     /* longest critical section */
+    STATS_SECT_ENTRY(total_usecs)   /* total time with interrupts masked */
+STATS_SECT_END
+
+STATS_NAME_START(os_crit_prof_stats)
+    STATS_NAME(os_crit_prof_stats, sections)
+    STATS_NAME(os_crit_prof_stats, max_usecs)
+    STATS_NAME(os_crit_prof_stats, total_usecs)
+STATS_NAME_END(os_crit_prof_stats)
+
+static STATS_SECT_DECL(os_crit_prof_stats) os_crit_prof_stats;
+#endif
+
+static struct os_crit_prof_info os_crit_prof;
+
+/* Set once os_cputime can be read. */
+static uint8_t os_crit_prof_active;
+/* Number of nested critical sections currently entered. */
+static uint8_t os_crit_prof_depth;
+/* Whether os_crit_prof_start_time is valid for the current section. */
+static uint8_t os_crit_prof_timing;
+static uint32_t os_crit_prof_start_time;
+static void *os_crit_prof_caller;
+
+/*
+ * Accounts for a critical section which just ended.  Called with interrupts
+ * masked.
+ */
+static void
+os_crit_prof_record(uint32_t usecs, void *caller)
+{
+    struct os_crit_prof_site *site;
+    int bucket;
+    int i;
+
+    os_crit_prof.ocp_count++;
+    os_crit_prof.ocp_total += usecs;
+
+    bucket = (usecs >> 1) ? 32 - __builtin_clz(usecs >> 1) : 0;
+    if (bucket >= OS_CRIT_PROF_BUCKETS) {
+        bucket = OS_CRIT_PROF_BUCKETS - 1;
+    }
+    os_crit_prof.ocp_hist[bucket]++;
+
+#if MYNEWT_VAL(OS_CRIT_PROF_STATS)
+    STATS_INC(os_crit_prof_stats, sections);
+    STATS_INCN(os_crit_prof_stats, total_usecs, usecs);
+    if (usecs > os_crit_prof.ocp_max) {
+        /* The stat tracks ocp_max. */
+        STATS_INCN(os_crit_prof_stats, max_usecs,
+                   usecs - os_crit_prof.ocp_max);
+    }
+#endif
+    if (usecs > os_crit_prof.ocp_max) {
+        os_crit_prof.ocp_max = usecs;
+    }
+
+    /* Most sections are short; skip the table unless this one makes it. */
+    if (usecs <= os_crit_prof.ocp_top[OS_CRIT_PROF_TOP - 1].ocs_max) {
+        return;
+    }
+
+    /*
+     * Find the call site's entry, or else take the last one.  Then move the
+     * entry up to keep the table sorted, longest first.
+     */
+    for (i = 0; i < OS_CRIT_PROF_TOP - 1; i++) {
+        if (os_crit_prof.ocp_top[i].ocs_caller == caller) {
+            break;
+        }
+    }
+    site = &os_crit_prof.ocp_top[i];
+    if (usecs <= site->ocs_max) {
+        return;
+    }
+
+    for (; i > 0 && os_crit_prof.ocp_top[i - 1].ocs_max < usecs; i--) {
+        os_crit_prof.ocp_top[i] = os_crit_prof.ocp_top[i - 1];
+    }
+    site = &os_crit_prof.ocp_top[i];
+    site->ocs_caller = caller;
+    site->ocs_max = usecs;
+}
+
+os_sr_t
+os_crit_prof_enter(void)
+{
+    os_sr_t sr;
+
+    sr = os_arch_save_sr();
+
+    if (os_crit_prof_depth++ == 0 && os_crit_prof_active) {
+        os_crit_prof_caller = os_get_return_addr();
+        os_crit_prof_timing = 1;
+        os_crit_prof_start_time = os_cputime_get32();
+    }
+
+    return sr;
+}
+
+void
+os_crit_prof_exit(os_sr_t sr)
+{
+    uint32_t ticks;
+
+    /*
+     * Read the time while the section still counts as entered; reading
+     * the timer may itself enter a critical section.
+     */
+    if (os_crit_prof_depth == 1 && os_crit_prof_timing) {
+        ticks = os_cputime_get32() - os_crit_prof_start_time;
+        os_crit_prof_timing = 0;
+        os_crit_prof_record(os_cputime_ticks_to_usecs(ticks),
+                            os_crit_prof_caller);
+    }
+
+    /* Sections entered with os_arch_save_sr() directly are not counted. */
+    if (os_crit_prof_depth > 0) {
+        os_crit_prof_depth--;
+    }
+
+    os_arch_restore_sr(sr);
+}
+
+void
+os_crit_prof_get(struct os_crit_prof_info *info)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    *info = os_crit_prof;
+    OS_EXIT_CRITICAL(sr);
+}
+
+void
+os_crit_prof_clear(void)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    memset(&os_crit_prof, 0, sizeof os_crit_prof);
+#if MYNEWT_VAL(OS_CRIT_PROF_STATS)
+    STATS_RESET(os_crit_prof_stats);
+#endif
+    OS_EXIT_CRITICAL(sr);
+}
+
+/*
+ * Called by os_init() once os_cputime is running.  Interrupts are not
+ * masked at this point, whatever sections were left unbalanced before, e.g.
+ * by a test restarting the OS.
+ */
+void
+os_crit_prof_start(void)
+{
+    os_crit_prof_depth = 0;
+    os_crit_prof_timing = 0;
+    os_crit_prof_clear();
+    os_crit_prof_active = 1;
+}
+
+#if MYNEWT_VAL(OS_CRIT_PROF_STATS)
+void
+os_crit_prof_stats_init(void)
+{
+    int rc;
+
+    /* Ensure this function only gets called by sysinit. */
+    SYSINIT_ASSERT_ACTIVE();
+
+    rc = stats_init_and_reg(STATS_HDR(os_crit_prof_stats),
+                            STATS_SIZE_INIT_PARMS(os_crit_prof_stats,
+                                                  STATS_SIZE_32),
+                            STATS_NAME_INIT_PARMS(os_crit_prof_stats),
+                            "os_crit");
+    SYSINIT_PANIC_ASSERT(rc == 0);
+}
+#endif
+
+#endif
@@ -0,0 +1,265 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include "syscfg/syscfg.h"
+#if !MYNEWT_VAL(OS_SYSVIEW_TRACE_EVENT_GROUP)
+#define OS_TRACE_DISABLE_FILE_API
+#endif
+#include "os/mynewt.h"
+
+/*
+ * A waiting task keeps its wait record on its own stack.  The record is
+ * removed from the group either by os_event_group_set() when the wait is
+ * satisfied, or by the waiter itself when it times out.  The task does not
+ * use t_obj, so os_sched_wakeup() leaves the group's list alone.
+ * OS_TASK_FLAG_EVG_WAIT keeps os_task_remove() away from a task whose
+ * record is still linked.
+ */
+struct os_event_group_waiter {
+    struct os_task *w_task;
+    uint32_t w_mask;
+    /* Flags of the group when the wait was satisfied */
+    uint32_t w_flags;
+    uint8_t w_opts;
+    uint8_t w_done;
+    SLIST_ENTRY(os_event_group_waiter) w_next;
+};
+
+static int
+os_event_group_satisfied(uint32_t flags, uint32_t mask, uint8_t opts)
+{
+    if (opts & OS_EVENT_GROUP_WAIT_ALL) {
+        return (flags & mask) == mask;
+    }
+    return (flags & mask) != 0;
+}
+
+os_error_t
+os_event_group_init(struct os_event_group *evg, uint32_t flags)
+{
+    os_error_t ret;
+
+    os_trace_api_u32x2(OS_TRACE_ID_EVENT_GROUP_INIT, (uint32_t)evg, flags);
+
+    if (!evg) {
+        ret = OS_INVALID_PARM;
+        goto done;
+    }
+
+    evg->evg_flags = flags;
+    SLIST_FIRST(&evg->evg_head) = NULL;
+
+    ret = OS_OK;
+
+done:
+    os_trace_api_ret_u32(OS_TRACE_ID_EVENT_GROUP_INIT, (uint32_t)ret);
+    return ret;
+}
+
+os_error_t
+os_event_group_set(struct os_event_group *evg, uint32_t flags)
+{
+    struct os_event_group_waiter *waiter;
+    struct os_event_group_waiter *prev;
+    struct os_event_group_waiter *next;
+    struct os_task *current;
+    int resched;
+    os_sr_t sr;
+    os_error_t ret;
+
+    os_trace_api_u32x2(OS_TRACE_ID_EVENT_GROUP_SET, (uint32_t)evg, flags);
+
+    if (!evg) {
+        ret = OS_INVALID_PARM;
+        goto done;
+    }
+
+    resched = 0;
+    current = os_sched_get_current_task();
+
+    OS_ENTER_CRITICAL(sr);
+
+    evg->evg_flags |= flags;
+
+    /*
+     * Waiters are served in priority order.  A consuming waiter clears its
+     * flags before the next waiter is checked, so the flags it consumed
+     * wake no lower priority waiter.
+     */
+    prev = NULL;
+    waiter = SLIST_FIRST(&evg->evg_head);
+    while (waiter) {
+        next = SLIST_NEXT(waiter, w_next);
+        if (os_event_group_satisfied(evg->evg_flags, waiter->w_mask,
+                                     waiter->w_opts)) {
+            if (prev) {
+                SLIST_NEXT(prev, w_next) = next;
+            } else {
+                SLIST_FIRST(&evg->evg_head) = next;
+            }
+            waiter->w_flags = evg->evg_flags;
+            waiter->w_done = 1;
+            if (waiter->w_opts & OS_EVENT_GROUP_CLEAR) {
+                evg->evg_flags &= ~waiter->w_mask;
+            }
+
+            /* The task may have timed out and be on its way out already */
+            if (waiter->w_task->t_state == OS_TASK_SLEEP) {
+                os_sched_wakeup(waiter->w_task);
+                if (current && current->t_prio > waiter->w_task->t_prio) {
+                    resched = 1;
+                }
+            }
+        } else {
+            prev = waiter;
+        }
+        waiter = next;
+    }
+
+    OS_EXIT_CRITICAL(sr);
+
+    if (resched && g_os_started) {
+        os_sched(NULL);
+    }
+
+    ret = OS_OK;
+
+done:
+    os_trace_api_ret_u32(OS_TRACE_ID_EVENT_GROUP_SET, (uint32_t)ret);
+    return ret;
+}
+
+os_error_t
+os_event_group_clear(struct os_event_group *evg, uint32_t flags)
+{
+    os_sr_t sr;
+    os_error_t ret;
+
+    os_trace_api_u32x2(OS_TRACE_ID_EVENT_GROUP_CLEAR, (uint32_t)evg, flags);
+
+    if (!evg) {
+        ret = OS_INVALID_PARM;
+        goto done;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+    evg->evg_flags &= ~flags;
+    OS_EXIT_CRITICAL(sr);
+
+    ret = OS_OK;
+
+done:
+    os_trace_api_ret_u32(OS_TRACE_ID_EVENT_GROUP_CLEAR, (uint32_t)ret);
+    return ret;
+}
+
+os_error_t
+os_event_group_wait(struct os_event_group *evg, uint32_t mask, uint8_t opts,
+                    os_time_t timeout, uint32_t *out_flags)
+{
+    struct os_event_group_waiter waiter;
+    struct os_event_group_waiter *entry;
+    struct os_event_group_waiter *last;
+    struct os_task *current;
+    uint32_t flags;
+    os_sr_t sr;
+    os_error_t ret;
+
+    os_trace_api_u32x3(OS_TRACE_ID_EVENT_GROUP_WAIT, (uint32_t)evg, mask,
+                       (uint32_t)timeout);
+
+    if (!evg || !mask) {
+        ret = OS_INVALID_PARM;
+        goto done;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+
+    flags = evg->evg_flags;
+    if (os_event_group_satisfied(flags, mask, opts)) {
+        if (opts & OS_EVENT_GROUP_CLEAR) {
+            evg->evg_flags &= ~mask;
+        }
+        OS_EXIT_CRITICAL(sr);
+        ret = OS_OK;
+        goto out;
+    }
+
+    if (timeout == 0) {
+        OS_EXIT_CRITICAL(sr);
+        ret = OS_TIMEOUT;
+        goto out;
+    }
+
+    if (!g_os_started) {
+        OS_EXIT_CRITICAL(sr);
+        ret = OS_NOT_STARTED;
+        goto out;
+    }
+
+    current = os_sched_get_current_task();
+
+    waiter.w_task = current;
+    waiter.w_mask = mask;
+    waiter.w_flags = 0;
+    waiter.w_opts = opts;
+    waiter.w_done = 0;
+
+    /* Insert in priority order so higher priority waiters consume first */
+    last = NULL;
+    SLIST_FOREACH(entry, &evg->evg_head, w_next) {
+        if (current->t_prio < entry->w_task->t_prio) {
+            break;
+        }
+        last = entry;
+    }
+    if (last) {
+        SLIST_INSERT_AFTER(last, &waiter, w_next);
+    } else {
+        SLIST_INSERT_HEAD(&evg->evg_head, &waiter, w_next);
+    }
+
+    current->t_flags |= OS_TASK_FLAG_EVG_WAIT;
+    os_sched_sleep(current, timeout);
+    OS_EXIT_CRITICAL(sr);
+
+    os_sched(NULL);
+
+    OS_ENTER_CRITICAL(sr);
+    current->t_flags &= ~OS_TASK_FLAG_EVG_WAIT;
+    if (waiter.w_done) {
+        flags = waiter.w_flags;
+        ret = OS_OK;
+    } else {
+        SLIST_REMOVE(&evg->evg_head, &waiter, os_event_group_waiter, w_next);
+        flags = evg->evg_flags;
+        ret = OS_TIMEOUT;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+out:
+    if (out_flags) {
+        *out_flags = flags;
+    }
+
+done:
+    os_trace_api_ret_u32(OS_TRACE_ID_EVENT_GROUP_WAIT, (uint32_t)ret);
+    return ret;
+}
@@ -24,20 +24,285 @@
 #define OS_TRACE_DISABLE_FILE_API
 #endif
 #include "os/mynewt.h"
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+#include "stats/stats.h"
+#endif
+
+/* ev_queued of an event taken off by os_eventq_run_batch() and not run yet */
+#define OS_EVENT_QUEUED_BATCH   2
+
+#if MYNEWT_VAL(OS_EVENTQ_BATCH_SIZE) > 255
+#error "OS_EVENTQ_BATCH_SIZE must not exceed 255"
+#endif
 
 static struct os_eventq os_eventq_main;
 
+#if OS_EVENTQ_PRIO_LEVELS > 1
+static inline uint8_t
+os_eventq_level(const struct os_event *ev)
+{
+    return min(ev->ev_prio, OS_EVENTQ_PRIO_LEVELS - 1);
+}
+#endif
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+STATS_SECT_START(os_eventq_stats)
+    STATS_SECT_ENTRY(events)        /* events run */
+    STATS_SECT_ENTRY(batches)       /* calls to os_eventq_run_batch() */
+    STATS_SECT_ENTRY(budget_out)    /* batches cut short by the time budget */
+    STATS_SECT_ENTRY(depth_max)     /* most events queued at once */
+    STATS_SECT_ENTRY(latency_max)   /* longest queueing time, in usecs */
+    STATS_SECT_ENTRY(latency_total) /* total queueing time, in usecs */
+STATS_SECT_END
+
+STATS_NAME_START(os_eventq_stats)
+    STATS_NAME(os_eventq_stats, events)
+    STATS_NAME(os_eventq_stats, batches)
+    STATS_NAME(os_eventq_stats, budget_out)
+    STATS_NAME(os_eventq_stats, depth_max)
+    STATS_NAME(os_eventq_stats, latency_max)
+    STATS_NAME(os_eventq_stats, latency_total)
+STATS_NAME_END(os_eventq_stats)
+
+static STATS_SECT_DECL(os_eventq_stats)
+    os_eventq_stats[MYNEWT_VAL(OS_EVENTQ_STATS_MAX)];
+/* Event queue each entry of os_eventq_stats was registered for. */
+static struct os_eventq *os_eventq_stats_evq[MYNEWT_VAL(OS_EVENTQ_STATS_MAX)];
+static uint8_t os_eventq_stats_cnt;
+
+/*
+ * Accounts for an event being queued.  Must be called with interrupts
+ * disabled.
+ */
+static void
+os_eventq_stats_queued(struct os_eventq *evq, const struct os_event *ev)
+{
+#if OS_EVENTQ_PRIO_LEVELS > 1
+    uint8_t level;
+
+    level = os_eventq_level(ev);
+    evq->evq_prio_depth[level]++;
+    if (evq->evq_prio_depth[level] > evq->evq_prio_depth_max[level]) {
+        evq->evq_prio_depth_max[level] = evq->evq_prio_depth[level];
+    }
+#endif
+
+    evq->evq_depth++;
+    if (evq->evq_depth > evq->evq_depth_max) {
+        evq->evq_depth_max = evq->evq_depth;
+        if (evq->evq_stats != NULL) {
+            STATS_INC(*evq->evq_stats, depth_max);
+        }
+    }
+}
+
+/*
+ * Accounts for an event being taken off the queue.  Must be called with
+ * interrupts disabled.
+ */
+static void
+os_eventq_stats_dequeued(struct os_eventq *evq, const struct os_event *ev)
+{
+#if OS_EVENTQ_PRIO_LEVELS > 1
+    evq->evq_prio_depth[os_eventq_level(ev)]--;
+#endif
+    evq->evq_depth--;
+}
+#else
+#define os_eventq_stats_queued(evq, ev)
+#define os_eventq_stats_dequeued(evq, ev)
+#endif
+
+/*
+ * The os_eventq_list_*() functions manipulate the list of queued events, or
+ * with OS_EVENTQ_PRIO_LEVELS > 1 the list of the event's priority level.
+ * They must be called with interrupts disabled.
+ */
+#if OS_EVENTQ_PRIO_LEVELS > 1
+static void
+os_eventq_list_insert_tail(struct os_eventq *evq, struct os_event *ev)
+{
+    uint8_t level;
+
+    level = os_eventq_level(ev);
+    STAILQ_INSERT_TAIL(&evq->evq_list[level], ev, ev_next);
+    evq->evq_prio_map |= 1U << level;
+}
+
+static void
+os_eventq_list_insert_head(struct os_eventq *evq, struct os_event *ev)
+{
+    uint8_t level;
+
+    level = os_eventq_level(ev);
+    STAILQ_INSERT_HEAD(&evq->evq_list[level], ev, ev_next);
+    evq->evq_prio_map |= 1U << level;
+}
+
+static struct os_event *
+os_eventq_list_remove_first(struct os_eventq *evq)
+{
+    struct os_event *ev;
+    int level;
+
+    if (evq->evq_prio_map == 0) {
+        return NULL;
+    }
+
+    level = 31 - __builtin_clz(evq->evq_prio_map);
+    ev = STAILQ_FIRST(&evq->evq_list[level]);
+    STAILQ_REMOVE_HEAD(&evq->evq_list[level], ev_next);
+    if (STAILQ_EMPTY(&evq->evq_list[level])) {
+        evq->evq_prio_map &= ~(1U << level);
+    }
+
+    return ev;
+}
+
+static void
+os_eventq_list_remove(struct os_eventq *evq, struct os_event *ev)
+{
+    uint8_t level;
+
+    level = os_eventq_level(ev);
+    STAILQ_REMOVE(&evq->evq_list[level], ev, os_event, ev_next);
+    if (STAILQ_EMPTY(&evq->evq_list[level])) {
+        evq->evq_prio_map &= ~(1U << level);
+    }
+}
+
+/*
+ * Whether an event of a higher level than the specified one is queued.
+ * Events still sitting in producer rings are not taken into account.
+ */
+static int
+os_eventq_preempts(const struct os_eventq *evq, const struct os_event *ev)
+{
+    return (evq->evq_prio_map >> os_eventq_level(ev)) > 1;
+}
+#else
+static void
+os_eventq_list_insert_tail(struct os_eventq *evq, struct os_event *ev)
+{
+    STAILQ_INSERT_TAIL(&evq->evq_list, ev, ev_next);
+}
+
+static void
+os_eventq_list_insert_head(struct os_eventq *evq, struct os_event *ev)
+{
+    STAILQ_INSERT_HEAD(&evq->evq_list, ev, ev_next);
+}
+
+static struct os_event *
+os_eventq_list_remove_first(struct os_eventq *evq)
+{
+    struct os_event *ev;
+
+    ev = STAILQ_FIRST(&evq->evq_list);
+    if (ev != NULL) {
+        STAILQ_REMOVE_HEAD(&evq->evq_list, ev_next);
+    }
+
+    return ev;
+}
+
+static void
+os_eventq_list_remove(struct os_eventq *evq, struct os_event *ev)
+{
+    STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
+}
+
+#define os_eventq_preempts(evq, ev) 0
+#endif
+
+#if MYNEWT_VAL(OS_EVENTQ_RING)
+/* Keeps the compiler from reordering memory accesses across this point. */
+#define OS_EVENTQ_BARRIER() __asm__ volatile ("" ::: "memory")
+
+/*
+ * Moves the events posted to the producer rings onto the event list.  Must
+ * be called with interrupts disabled.
+ */
+static void
+os_eventq_ring_drain(struct os_eventq *evq)
+{
+    struct os_eventq_ring *ring;
+    struct os_event *ev;
+    uint16_t tail;
+
+    SLIST_FOREACH(ring, &evq->evq_rings, er_next) {
+        tail = ring->er_tail;
+        while (tail != ring->er_head) {
+            ev = ring->er_buf[tail & (ring->er_size - 1)];
+            os_eventq_list_insert_tail(evq, ev);
+            os_eventq_stats_queued(evq, ev);
+            tail++;
+        }
+        ring->er_tail = tail;
+    }
+}
+#else
+#define os_eventq_ring_drain(evq)
+#endif
+
+/*
+ * Wakes up the task waiting on the event queue, if any.  Must be called with
+ * interrupts disabled.
+ *
+ * @return 1 if a task was woken up and rescheduling is needed, 0 otherwise
+ */
+static int
+os_eventq_wakeup(struct os_eventq *evq)
+{
+    int resched;
+
+    resched = 0;
+    if (evq->evq_task) {
+        /* If task waiting on event, wake it up.
+         * Check if task is sleeping, because another event
+         * queue may have woken this task up beforehand.
+         */
+        if (evq->evq_task->t_state == OS_TASK_SLEEP) {
+            os_sched_wakeup(evq->evq_task);
+            resched = 1;
+        }
+        /* Either way, NULL out the task, because the task will
+         * be awake upon exit of this function.
+         */
+        evq->evq_task = NULL;
+    }
+
+    return resched;
+}
+
 void
 os_eventq_init(struct os_eventq *evq)
 {
+#if OS_EVENTQ_PRIO_LEVELS > 1
+    int i;
+#endif
+
     memset(evq, 0, sizeof(*evq));
+#if OS_EVENTQ_PRIO_LEVELS > 1
+    for (i = 0; i < OS_EVENTQ_PRIO_LEVELS; i++) {
+        STAILQ_INIT(&evq->evq_list[i]);
+    }
+#else
     STAILQ_INIT(&evq->evq_list);
+#endif
+#if MYNEWT_VAL(OS_EVENTQ_RING)
+    SLIST_INIT(&evq->evq_rings);
+#endif
 }
 
 int
 os_eventq_inited(const struct os_eventq *evq)
 {
+#if OS_EVENTQ_PRIO_LEVELS > 1
+    return evq->evq_list[0].stqh_last != NULL;
+#else
     return evq->evq_list.stqh_last != NULL;
+#endif
 }
 
 void
@@ -61,23 +326,13 @@ os_eventq_put(struct os_eventq *evq, struct os_event *ev)
 
     /* Queue the event */
     ev->ev_queued = 1;
-    STAILQ_INSERT_TAIL(&evq->evq_list, ev, ev_next);
+    os_eventq_list_insert_tail(evq, ev);
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    ev->ev_put_time = os_cputime_get32();
+    os_eventq_stats_queued(evq, ev);
+#endif
 
-    resched = 0;
-    if (evq->evq_task) {
-        /* If task waiting on event, wake it up.
-         * Check if task is sleeping, because another event
-         * queue may have woken this task up beforehand.
-         */
-        if (evq->evq_task->t_state == OS_TASK_SLEEP) {
-            os_sched_wakeup(evq->evq_task);
-            resched = 1;
-        }
-        /* Either way, NULL out the task, because the task will
-         * be awake upon exit of this function.
-         */
-        evq->evq_task = NULL;
-    }
+    resched = os_eventq_wakeup(evq);
 
     OS_EXIT_CRITICAL(sr);
 
@@ -88,32 +343,148 @@ os_eventq_put(struct os_eventq *evq, struct os_event *ev)
     os_trace_api_ret(OS_TRACE_ID_EVENTQ_PUT);
 }
 
+#if MYNEWT_VAL(OS_EVENTQ_RING)
+int
+os_eventq_ring_init(struct os_eventq *evq, struct os_eventq_ring *ring,
+                    struct os_event **buf, uint16_t size)
+{
+    os_sr_t sr;
+
+    if (size == 0 || (size & (size - 1)) != 0 || size > 0x8000) {
+        return OS_INVALID_PARM;
+    }
+
+    ring->er_evq = evq;
+    ring->er_buf = buf;
+    ring->er_size = size;
+    ring->er_head = 0;
+    ring->er_tail = 0;
+
+    OS_ENTER_CRITICAL(sr);
+    SLIST_INSERT_HEAD(&evq->evq_rings, ring, er_next);
+    OS_EXIT_CRITICAL(sr);
+
+    return 0;
+}
+
+int
+os_eventq_ring_put(struct os_eventq_ring *ring, struct os_event *ev)
+{
+    struct os_eventq *evq;
+    uint16_t head;
+    int resched;
+    os_sr_t sr;
+
+    /* Do not queue if already queued */
+    if (OS_EVENT_QUEUED(ev)) {
+        return 0;
+    }
+
+    head = ring->er_head;
+    if ((uint16_t)(head - ring->er_tail) >= ring->er_size) {
+        return OS_ENOMEM;
+    }
+
+    /*
+     * The consumer only looks at entries before er_head, so the entry must be
+     * complete before er_head moves past it.
+     */
+    ev->ev_queued = 1;
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    ev->ev_put_time = os_cputime_get32();
+#endif
+    ring->er_buf[head & (ring->er_size - 1)] = ev;
+    OS_EVENTQ_BARRIER();
+    ring->er_head = head + 1;
+    OS_EVENTQ_BARRIER();
+
+    /*
+     * The reading task sets evq_task, and checks the rings again, with
+     * interrupts disabled before it goes to sleep.  Only if it is waiting
+     * does it need to be woken up here.
+     */
+    evq = ring->er_evq;
+    if (evq->evq_task != NULL) {
+        OS_ENTER_CRITICAL(sr);
+        resched = os_eventq_wakeup(evq);
+        OS_EXIT_CRITICAL(sr);
+
+        if (resched) {
+            os_sched(NULL);
+        }
+    }
+
+    return 0;
+}
+#endif
+
+/*
+ * Takes up to max events off the event queue.  Must be called with
+ * interrupts disabled.  If batch is set, the events are recorded as the
+ * batch of os_eventq_run_batch() and still count as queued until they are
+ * run.
+ *
+ * @return The number of events taken off the queue
+ */
+static int
+os_eventq_pull(struct os_eventq *evq, struct os_event **evs, int max,
+               int batch)
+{
+    struct os_event *ev;
+    int cnt;
+
+    os_eventq_ring_drain(evq);
+
+    for (cnt = 0; cnt < max; cnt++) {
+        ev = os_eventq_list_remove_first(evq);
+        if (ev == NULL) {
+            break;
+        }
+        ev->ev_queued = batch ? OS_EVENT_QUEUED_BATCH : 0;
+        os_eventq_stats_dequeued(evq, ev);
+        evs[cnt] = ev;
+    }
+
+    if (batch) {
+        evq->evq_batch = evs;
+        evq->evq_batch_cnt = cnt;
+    }
+
+    return cnt;
+}
+
 struct os_event *
 os_eventq_get_no_wait(struct os_eventq *evq)
 {
     struct os_event *ev;
+    os_sr_t sr;
 
     os_trace_api_u32(OS_TRACE_ID_EVENTQ_GET_NO_WAIT, (uint32_t)evq);
 
-    ev = STAILQ_FIRST(&evq->evq_list);
-    if (ev) {
-        STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
-        ev->ev_queued = 0;
+    OS_ENTER_CRITICAL(sr);
+    if (os_eventq_pull(evq, &ev, 1, 0) == 0) {
+        ev = NULL;
     }
+    OS_EXIT_CRITICAL(sr);
 
     os_trace_api_ret_u32(OS_TRACE_ID_EVENTQ_GET_NO_WAIT, (uint32_t)ev);
 
     return ev;
 }
 
-struct os_event *
-os_eventq_get(struct os_eventq *evq)
+/*
+ * Takes up to max events off the event queue, blocking until there is at
+ * least one.  See os_eventq_pull() for batch.
+ *
+ * @return The number of events taken off the queue
+ */
+static int
+os_eventq_get_n(struct os_eventq *evq, struct os_event **evs, int max,
+                int batch)
 {
-    struct os_event *ev;
     os_sr_t sr;
     struct os_task *t;
-
-    os_trace_api_u32(OS_TRACE_ID_EVENTQ_GET, (uint32_t)evq);
+    int cnt;
 
     t = os_sched_get_current_task();
     if (evq->evq_owner != t) {
@@ -129,10 +500,8 @@ os_eventq_get(struct os_eventq *evq)
     }
     OS_ENTER_CRITICAL(sr);
 pull_one:
-    ev = STAILQ_FIRST(&evq->evq_list);
-    if (ev) {
-        STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
-        ev->ev_queued = 0;
+    cnt = os_eventq_pull(evq, evs, max, batch);
+    if (cnt > 0) {
         t->t_flags &= ~OS_TASK_FLAG_EVQ_WAIT;
     } else {
         evq->evq_task = t;
@@ -148,12 +517,24 @@ pull_one:
     }
     OS_EXIT_CRITICAL(sr);
 
-    os_trace_api_ret_u32(OS_TRACE_ID_EVENTQ_GET, (uint32_t)ev);
-
 #if MYNEWT_VAL(OS_EVENTQ_DEBUG)
-    evq->evq_prev = ev;
+    evq->evq_prev = evs[cnt - 1];
 #endif
 
+    return cnt;
+}
+
+struct os_event *
+os_eventq_get(struct os_eventq *evq)
+{
+    struct os_event *ev;
+
+    os_trace_api_u32(OS_TRACE_ID_EVENTQ_GET, (uint32_t)evq);
+
+    os_eventq_get_n(evq, &ev, 1, 0);
+
+    os_trace_api_ret_u32(OS_TRACE_ID_EVENTQ_GET, (uint32_t)ev);
+
     return (ev);
 }
 
@@ -179,20 +560,37 @@ os_eventq_mon_find(struct os_eventq *evq, struct os_event *ev)
 }
 #endif
 
-void
-os_eventq_run(struct os_eventq *evq)
+/*
+ * Calls the callback of an event taken off the event queue.
+ */
+static void
+os_eventq_dispatch(struct os_eventq *evq, struct os_event *ev)
 {
-    struct os_event *ev;
 #if MYNEWT_VAL(OS_EVENTQ_MONITOR)
     struct os_eventq_mon *mon;
-    uint32_t ticks;
 #endif
+#if MYNEWT_VAL(OS_EVENTQ_MONITOR) || MYNEWT_VAL(OS_EVENTQ_STATS)
+    uint32_t ticks;
 
-    ev = os_eventq_get(evq);
-    assert(ev->ev_cb != NULL);
-#if MYNEWT_VAL(OS_EVENTQ_MONITOR)
     ticks = os_cputime_get32();
 #endif
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    if (evq->evq_stats != NULL) {
+        uint32_t usecs;
+
+        usecs = os_cputime_ticks_to_usecs(ticks - ev->ev_put_time);
+        STATS_INC(*evq->evq_stats, events);
+        STATS_INCN(*evq->evq_stats, latency_total, usecs);
+        if (usecs > evq->evq_latency_max) {
+            /* The stat tracks evq_latency_max. */
+            STATS_INCN(*evq->evq_stats, latency_max,
+                       usecs - evq->evq_latency_max);
+            evq->evq_latency_max = usecs;
+        }
+    }
+#endif
+
+    assert(ev->ev_cb != NULL);
     ev->ev_cb(ev);
 #if MYNEWT_VAL(OS_EVENTQ_MONITOR)
     mon = os_eventq_mon_find(evq, ev);
@@ -215,6 +613,123 @@ os_eventq_run(struct os_eventq *evq)
 #endif
 }
 
+void
+os_eventq_run(struct os_eventq *evq)
+{
+    struct os_event *ev;
+
+    ev = os_eventq_get(evq);
+    os_eventq_dispatch(evq, ev);
+}
+
+/*
+ * Puts the events of a batch which have not been run back at the head of the
+ * event queue, in order.  Events removed in the meantime are left out.  Must
+ * be called with interrupts disabled.
+ */
+static void
+os_eventq_unpull(struct os_eventq *evq, struct os_event **evs, int cnt)
+{
+    while (cnt-- > 0) {
+        if (evs[cnt] != NULL) {
+            evs[cnt]->ev_queued = 1;
+            os_eventq_list_insert_head(evq, evs[cnt]);
+            os_eventq_stats_queued(evq, evs[cnt]);
+            evs[cnt] = NULL;
+        }
+    }
+}
+
+int
+os_eventq_run_batch(struct os_eventq *evq, int max_events,
+                    os_time_t max_ticks)
+{
+    struct os_event *evs[MYNEWT_VAL(OS_EVENTQ_BATCH_SIZE)];
+    struct os_event *ev;
+    os_time_t start;
+    os_sr_t sr;
+    int budget_out;
+    int ran;
+    int cnt;
+    int i;
+
+    assert(max_events > 0);
+
+    start = os_time_get();
+    ran = 0;
+
+    cnt = min(max_events, MYNEWT_VAL(OS_EVENTQ_BATCH_SIZE));
+    cnt = os_eventq_get_n(evq, evs, cnt, 1);
+    while (1) {
+        for (i = 0; i < cnt; i++) {
+            budget_out = ran > 0 && max_ticks != OS_TIMEOUT_NEVER &&
+                         os_time_get() - start >= max_ticks;
+
+            /*
+             * An earlier callback may have removed this event, in which case
+             * os_eventq_remove() cleared its slot.  The slot is claimed with
+             * interrupts disabled: an interrupt removing and putting the
+             * event again between reading the slot and clearing ev_queued
+             * would otherwise leave it on the list marked as not queued.
+             */
+            OS_ENTER_CRITICAL(sr);
+            ev = evs[i];
+            if (ev == NULL) {
+                OS_EXIT_CRITICAL(sr);
+                continue;
+            }
+            if (budget_out) {
+                os_eventq_unpull(evq, &evs[i], cnt - i);
+                OS_EXIT_CRITICAL(sr);
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+                if (evq->evq_stats != NULL) {
+                    STATS_INC(*evq->evq_stats, budget_out);
+                }
+#endif
+                goto done;
+            }
+            if (i > 0 && os_eventq_preempts(evq, ev)) {
+                /* Pick up the higher priority events first */
+                os_eventq_unpull(evq, &evs[i], cnt - i);
+                OS_EXIT_CRITICAL(sr);
+                break;
+            }
+            evs[i] = NULL;
+            ev->ev_queued = 0;
+            OS_EXIT_CRITICAL(sr);
+
+            os_eventq_dispatch(evq, ev);
+            ran++;
+        }
+
+        if (ran >= max_events) {
+            break;
+        }
+
+        cnt = min(max_events - ran, MYNEWT_VAL(OS_EVENTQ_BATCH_SIZE));
+        OS_ENTER_CRITICAL(sr);
+        cnt = os_eventq_pull(evq, evs, cnt, 1);
+        OS_EXIT_CRITICAL(sr);
+        if (cnt == 0) {
+            break;
+        }
+    }
+
+done:
+    OS_ENTER_CRITICAL(sr);
+    evq->evq_batch = NULL;
+    evq->evq_batch_cnt = 0;
+    OS_EXIT_CRITICAL(sr);
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    if (evq->evq_stats != NULL) {
+        STATS_INC(*evq->evq_stats, batches);
+    }
+#endif
+
+    return ran;
+}
+
 static struct os_event *
 os_eventq_poll_0timo(struct os_eventq **evq, int nevqs)
 {
@@ -229,10 +744,7 @@ os_eventq_poll_0timo(struct os_eventq **evq, int nevqs)
 
     OS_ENTER_CRITICAL(sr);
     for (i = 0; i < nevqs; i++) {
-        ev = STAILQ_FIRST(&evq[i]->evq_list);
-        if (ev) {
-            STAILQ_REMOVE(&evq[i]->evq_list, ev, os_event, ev_next);
-            ev->ev_queued = 0;
+        if (os_eventq_pull(evq[i], &ev, 1, 0) > 0) {
             break;
         }
     }
@@ -267,10 +779,7 @@ os_eventq_poll(struct os_eventq **evq, int nevqs, os_time_t timo)
     cur_t = os_sched_get_current_task();
 
     for (i = 0; i < nevqs; i++) {
-        ev = STAILQ_FIRST(&evq[i]->evq_list);
-        if (ev) {
-            STAILQ_REMOVE(&evq[i]->evq_list, ev, os_event, ev_next);
-            ev->ev_queued = 0;
+        if (os_eventq_pull(evq[i], &ev, 1, 0) > 0) {
             /* Reset the items that already have an evq task set. */
             for (j = 0; j < i; j++) {
                 evq[j]->evq_task = NULL;
@@ -298,11 +807,7 @@ os_eventq_poll(struct os_eventq **evq, int nevqs, os_time_t timo)
          * we haven't found one.
          */
         if (!ev) {
-            ev = STAILQ_FIRST(&evq[i]->evq_list);
-            if (ev) {
-                STAILQ_REMOVE(&evq[i]->evq_list, ev, os_event, ev_next);
-                ev->ev_queued = 0;
-            }
+            os_eventq_pull(evq[i], &ev, 1, 0);
         }
         evq[i]->evq_task = NULL;
     }
@@ -318,12 +823,22 @@ void
 os_eventq_remove(struct os_eventq *evq, struct os_event *ev)
 {
     os_sr_t sr;
+    int i;
 
     os_trace_api_u32x2(OS_TRACE_ID_EVENTQ_REMOVE, (uint32_t)evq, (uint32_t)ev);
 
     OS_ENTER_CRITICAL(sr);
-    if (OS_EVENT_QUEUED(ev)) {
-        STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
+    os_eventq_ring_drain(evq);
+    if (ev->ev_queued == OS_EVENT_QUEUED_BATCH) {
+        /* Taken off by os_eventq_run_batch(); keep it from being run. */
+        for (i = 0; i < evq->evq_batch_cnt; i++) {
+            if (evq->evq_batch[i] == ev) {
+                evq->evq_batch[i] = NULL;
+            }
+        }
+    } else if (OS_EVENT_QUEUED(ev)) {
+        os_eventq_list_remove(evq, ev);
+        os_eventq_stats_dequeued(evq, ev);
     }
     ev->ev_queued = 0;
     OS_EXIT_CRITICAL(sr);
@@ -376,3 +891,58 @@ os_eventq_designate(struct os_eventq **cur_evq,
     }
 }
 
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+int
+os_eventq_stats_register(struct os_eventq *evq, const char *name)
+{
+    STATS_SECT_DECL(os_eventq_stats) *stats;
+    int rc;
+    int i;
+
+    /*
+     * A stats group cannot be unregistered; if the event queue was registered
+     * before, e.g. prior to being reinitialized, reuse its group.
+     */
+    for (i = 0; i < os_eventq_stats_cnt; i++) {
+        if (os_eventq_stats_evq[i] == evq) {
+            stats = &os_eventq_stats[i];
+            STATS_RESET(*stats);
+            goto attach;
+        }
+    }
+
+    if (os_eventq_stats_cnt >= MYNEWT_VAL(OS_EVENTQ_STATS_MAX)) {
+        return OS_ENOMEM;
+    }
+    stats = &os_eventq_stats[os_eventq_stats_cnt];
+
+    rc = stats_init_and_reg(STATS_HDR(*stats),
+                            STATS_SIZE_INIT_PARMS((*stats), STATS_SIZE_32),
+                            STATS_NAME_INIT_PARMS(os_eventq_stats), name);
+    if (rc != 0) {
+        return rc;
+    }
+    os_eventq_stats_evq[os_eventq_stats_cnt++] = evq;
+
+attach:
+    /* The stats only track the maxima from here on. */
+    evq->evq_depth_max = evq->evq_depth;
+    evq->evq_latency_max = 0;
+    STATS_INCN(*stats, depth_max, evq->evq_depth_max);
+    evq->evq_stats = stats;
+
+    return 0;
+}
+
+void
+os_eventq_stats_init(void)
+{
+    int rc;
+
+    /* Ensure this function only gets called by sysinit. */
+    SYSINIT_ASSERT_ACTIVE();
+
+    rc = os_eventq_stats_register(os_eventq_dflt_get(), "os_evq_dflt");
+    SYSINIT_PANIC_ASSERT(rc == 0);
+}
+#endif
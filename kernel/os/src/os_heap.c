@@ -18,12 +18,239 @@
  */
 
 #include <assert.h>
+#include <string.h>
 #include "os/mynewt.h"
+#include "os_priv.h"
 
 #if MYNEWT_VAL(OS_SCHEDULING)
 static struct os_mutex os_malloc_mutex;
 #endif
 
+#if MYNEWT_VAL(OS_MALLOC_SLAB)
+
+/*
+ * Small allocations are served from a set of memory pools, one per size
+ * class.  The pools are protected by their own critical sections, so the
+ * heap mutex is only taken when an allocation falls back to the heap.  The
+ * pool buffers are 8-byte
+ * aligned and block sizes are rounded up so that every block stays 8-byte
+ * aligned, matching the alignment malloc() provides.
+ */
+struct os_malloc_slab {
+    struct os_mempool oms_pool;
+    uint16_t oms_block_size;
+    uint32_t oms_hits;
+    uint32_t oms_misses;
+};
+
+#if MYNEWT_VAL(OS_MEMPOOL_GUARD)
+/* Leave room for the guard word after each block within the 8 bytes. */
+#define OS_MALLOC_SLAB_BLOCK_SIZE(n)                                    \
+    (OS_ALIGN(MYNEWT_VAL(OS_MALLOC_SLAB_ ## n ## _BLOCK_SIZE) +         \
+              sizeof(os_membuf_t), 8) - sizeof(os_membuf_t))
+#else
+#define OS_MALLOC_SLAB_BLOCK_SIZE(n)                                    \
+    OS_ALIGN(MYNEWT_VAL(OS_MALLOC_SLAB_ ## n ## _BLOCK_SIZE), 8)
+#endif
+#define OS_MALLOC_SLAB_BUF_LEN(n)                                       \
+    ((OS_MEMPOOL_BYTES(MYNEWT_VAL(OS_MALLOC_SLAB_ ## n ## _BLOCK_COUNT), \
+                       OS_MALLOC_SLAB_BLOCK_SIZE(n)) + 7) / 8)
+
+#if MYNEWT_VAL(OS_MALLOC_SLAB_1_BLOCK_COUNT) > 0
+static uint64_t os_malloc_slab_1_data[OS_MALLOC_SLAB_BUF_LEN(1)];
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+static uint32_t os_malloc_slab_1_map[
+    OS_MEMPOOL_MAP_WORDS(MYNEWT_VAL(OS_MALLOC_SLAB_1_BLOCK_COUNT))];
+#endif
+#endif
+#if MYNEWT_VAL(OS_MALLOC_SLAB_2_BLOCK_COUNT) > 0
+static uint64_t os_malloc_slab_2_data[OS_MALLOC_SLAB_BUF_LEN(2)];
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+static uint32_t os_malloc_slab_2_map[
+    OS_MEMPOOL_MAP_WORDS(MYNEWT_VAL(OS_MALLOC_SLAB_2_BLOCK_COUNT))];
+#endif
+#endif
+#if MYNEWT_VAL(OS_MALLOC_SLAB_3_BLOCK_COUNT) > 0
+static uint64_t os_malloc_slab_3_data[OS_MALLOC_SLAB_BUF_LEN(3)];
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+static uint32_t os_malloc_slab_3_map[
+    OS_MEMPOOL_MAP_WORDS(MYNEWT_VAL(OS_MALLOC_SLAB_3_BLOCK_COUNT))];
+#endif
+#endif
+#if MYNEWT_VAL(OS_MALLOC_SLAB_4_BLOCK_COUNT) > 0
+static uint64_t os_malloc_slab_4_data[OS_MALLOC_SLAB_BUF_LEN(4)];
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+static uint32_t os_malloc_slab_4_map[
+    OS_MEMPOOL_MAP_WORDS(MYNEWT_VAL(OS_MALLOC_SLAB_4_BLOCK_COUNT))];
+#endif
+#endif
+
+/* Allocation bitmap of a size class, for constant time double free checks */
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+#define OS_MALLOC_SLAB_MAP(n)   os_malloc_slab_ ## n ## _map
+#else
+#define OS_MALLOC_SLAB_MAP(n)   NULL
+#endif
+
+#define OS_MALLOC_SLAB_COUNT                                \
+    ((MYNEWT_VAL(OS_MALLOC_SLAB_1_BLOCK_COUNT) > 0) +       \
+     (MYNEWT_VAL(OS_MALLOC_SLAB_2_BLOCK_COUNT) > 0) +       \
+     (MYNEWT_VAL(OS_MALLOC_SLAB_3_BLOCK_COUNT) > 0) +       \
+     (MYNEWT_VAL(OS_MALLOC_SLAB_4_BLOCK_COUNT) > 0))
+
+#if OS_MALLOC_SLAB_COUNT == 0
+#error "OS_MALLOC_SLAB requires at least one size class"
+#endif
+
+/* Sorted by increasing block size. */
+static struct os_malloc_slab os_malloc_slabs[OS_MALLOC_SLAB_COUNT];
+
+static void
+os_malloc_slab_init_once(struct os_malloc_slab **slab, void *data,
+                         uint32_t *map, uint16_t count, uint16_t block_size,
+                         char *name)
+{
+    int rc;
+
+    /* Classes must be configured in increasing block size order. */
+    assert(*slab == os_malloc_slabs ||
+           (*slab)[-1].oms_block_size < block_size);
+
+    rc = os_mempool_init(&(*slab)->oms_pool, count, block_size, data, name);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+    rc = os_mempool_map_attach(&(*slab)->oms_pool, map);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+#endif
+
+    (*slab)->oms_block_size = block_size;
+    (*slab)->oms_hits = 0;
+    (*slab)->oms_misses = 0;
+    (*slab)++;
+}
+
+void
+os_malloc_slab_init(void)
+{
+    struct os_malloc_slab *slab;
+
+    slab = os_malloc_slabs;
+
+#if MYNEWT_VAL(OS_MALLOC_SLAB_1_BLOCK_COUNT) > 0
+    os_malloc_slab_init_once(&slab, os_malloc_slab_1_data,
+                             OS_MALLOC_SLAB_MAP(1),
+                             MYNEWT_VAL(OS_MALLOC_SLAB_1_BLOCK_COUNT),
+                             OS_MALLOC_SLAB_BLOCK_SIZE(1), "os_malloc_1");
+#endif
+#if MYNEWT_VAL(OS_MALLOC_SLAB_2_BLOCK_COUNT) > 0
+    os_malloc_slab_init_once(&slab, os_malloc_slab_2_data,
+                             OS_MALLOC_SLAB_MAP(2),
+                             MYNEWT_VAL(OS_MALLOC_SLAB_2_BLOCK_COUNT),
+                             OS_MALLOC_SLAB_BLOCK_SIZE(2), "os_malloc_2");
+#endif
+#if MYNEWT_VAL(OS_MALLOC_SLAB_3_BLOCK_COUNT) > 0
+    os_malloc_slab_init_once(&slab, os_malloc_slab_3_data,
+                             OS_MALLOC_SLAB_MAP(3),
+                             MYNEWT_VAL(OS_MALLOC_SLAB_3_BLOCK_COUNT),
+                             OS_MALLOC_SLAB_BLOCK_SIZE(3), "os_malloc_3");
+#endif
+#if MYNEWT_VAL(OS_MALLOC_SLAB_4_BLOCK_COUNT) > 0
+    os_malloc_slab_init_once(&slab, os_malloc_slab_4_data,
+                             OS_MALLOC_SLAB_MAP(4),
+                             MYNEWT_VAL(OS_MALLOC_SLAB_4_BLOCK_COUNT),
+                             OS_MALLOC_SLAB_BLOCK_SIZE(4), "os_malloc_4");
+#endif
+}
+
+/**
+ * Returns the smallest size class that fits the specified size, or NULL if
+ * the size is too big for any class.
+ */
+static struct os_malloc_slab *
+os_malloc_slab_find(size_t size)
+{
+    int i;
+
+    for (i = 0; i < OS_MALLOC_SLAB_COUNT; i++) {
+        if (size <= os_malloc_slabs[i].oms_block_size) {
+            return &os_malloc_slabs[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Takes a block from the smallest size class that fits the specified size.
+ *
+ * @return The block, or NULL if the size is too big for any class or the
+ *         class is exhausted.
+ */
+static void *
+os_malloc_slab_get(size_t size)
+{
+    struct os_malloc_slab *slab;
+    os_sr_t sr;
+    void *ptr;
+
+    slab = os_malloc_slab_find(size);
+    if (slab == NULL) {
+        return NULL;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+    ptr = os_memblock_get(&slab->oms_pool);
+    if (ptr != NULL) {
+        slab->oms_hits++;
+    } else {
+        slab->oms_misses++;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    return ptr;
+}
+
+/**
+ * Returns the size class the specified pointer was allocated from, or NULL
+ * if it came from the heap.
+ */
+static struct os_malloc_slab *
+os_malloc_slab_owner(const void *ptr)
+{
+    int i;
+
+    for (i = 0; i < OS_MALLOC_SLAB_COUNT; i++) {
+        if (os_memblock_from(&os_malloc_slabs[i].oms_pool, ptr)) {
+            return &os_malloc_slabs[i];
+        }
+    }
+
+    return NULL;
+}
+
+int
+os_malloc_slab_info_get(int idx, struct os_malloc_slab_info *omsi)
+{
+    struct os_malloc_slab *slab;
+
+    if (idx < 0 || idx >= OS_MALLOC_SLAB_COUNT) {
+        return OS_ENOENT;
+    }
+
+    slab = &os_malloc_slabs[idx];
+    omsi->omsi_block_size = slab->oms_block_size;
+    omsi->omsi_num_blocks = slab->oms_pool.mp_num_blocks;
+    omsi->omsi_num_free = slab->oms_pool.mp_num_free;
+    omsi->omsi_min_free = slab->oms_pool.mp_min_free;
+    omsi->omsi_hits = slab->oms_hits;
+    omsi->omsi_misses = slab->oms_misses;
+
+    return 0;
+}
+
+#endif
+
 static void
 os_malloc_lock(void)
 {
@@ -55,6 +282,15 @@ os_malloc(size_t size)
 {
     void *ptr;
 
+#if MYNEWT_VAL(OS_MALLOC_SLAB)
+    if (size != 0) {
+        ptr = os_malloc_slab_get(size);
+        if (ptr != NULL) {
+            return ptr;
+        }
+    }
+#endif
+
     os_malloc_lock();
     ptr = malloc(size);
     os_malloc_unlock();
@@ -65,6 +301,18 @@ os_malloc(size_t size)
 void
 os_free(void *mem)
 {
+#if MYNEWT_VAL(OS_MALLOC_SLAB)
+    struct os_malloc_slab *slab;
+
+    if (mem != NULL) {
+        slab = os_malloc_slab_owner(mem);
+        if (slab != NULL) {
+            os_memblock_put(&slab->oms_pool, mem);
+            return;
+        }
+    }
+#endif
+
     os_malloc_lock();
     free(mem);
     os_malloc_unlock();
@@ -74,6 +322,31 @@ void *
 os_realloc(void *ptr, size_t size)
 {
     void *new_ptr;
+#if MYNEWT_VAL(OS_MALLOC_SLAB)
+    struct os_malloc_slab *slab;
+
+    if (ptr == NULL) {
+        return os_malloc(size);
+    }
+
+    slab = os_malloc_slab_owner(ptr);
+    if (slab != NULL) {
+        if (size == 0) {
+            os_free(ptr);
+            return NULL;
+        }
+        if (size <= slab->oms_block_size) {
+            return ptr;
+        }
+
+        new_ptr = os_malloc(size);
+        if (new_ptr != NULL) {
+            memcpy(new_ptr, ptr, slab->oms_block_size);
+            os_memblock_put(&slab->oms_pool, ptr);
+        }
+        return new_ptr;
+    }
+#endif
 
     os_malloc_lock();
     new_ptr = realloc(ptr, size);
@@ -42,6 +42,12 @@
 #endif
 #include "os/mynewt.h"
 
+/**
+ * Maximum number of mbufs os_mbuf_get_chain() and os_mbuf_free_chain() move
+ * to or from a mempool at once.
+ */
+#define OS_MBUF_BATCH_SIZE  8
+
 int
 os_mqueue_init(struct os_mqueue *mq, os_event_fn *ev_cb, void *arg)
 {
@@ -115,6 +121,10 @@ os_mbuf_pool_init(struct os_mbuf_pool *omp, struct os_mempool *mp,
 {
     omp->omp_databuf_len = buf_len - sizeof(struct os_mbuf);
     omp->omp_pool = mp;
+#if MYNEWT_VAL(MSYS_POOL_STATS)
+    omp->omp_fallback_cnt = 0;
+    omp->omp_fail_cnt = 0;
+#endif
 
     return (0);
 }
@@ -143,12 +153,75 @@ os_mbuf_get(struct os_mbuf_pool *omp, uint16_t leadingspace)
     om->om_len = 0;
     om->om_data = (&om->om_databuf[0] + leadingspace);
     om->om_omp = omp;
+#if MYNEWT_VAL(OS_MBUF_SHARE)
+    om->om_shared = NULL;
+    om->om_refcnt = 1;
+#endif
 
 done:
     os_trace_api_ret_u32(OS_TRACE_ID_MBUF_GET, (uint32_t)om);
     return om;
 }
 
+struct os_mbuf *
+os_mbuf_get_chain(struct os_mbuf_pool *omp, uint16_t leadingspace, int count)
+{
+    void *blocks[OS_MBUF_BATCH_SIZE];
+    struct os_mbuf *head;
+    struct os_mbuf *tail;
+    struct os_mbuf *om;
+    int batch;
+    int rc;
+    int i;
+
+    os_trace_api_u32x2(OS_TRACE_ID_MBUF_GET_CHAIN, (uint32_t)omp,
+                       (uint32_t)count);
+
+    head = NULL;
+    tail = NULL;
+
+    if (leadingspace > omp->omp_databuf_len) {
+        goto done;
+    }
+
+    while (count > 0) {
+        batch = min(count, OS_MBUF_BATCH_SIZE);
+        rc = os_memblock_get_n(omp->omp_pool, blocks, batch);
+        if (rc != 0) {
+            os_mbuf_free_chain(head);
+            head = NULL;
+            goto done;
+        }
+
+        for (i = 0; i < batch; i++) {
+            om = blocks[i];
+            SLIST_NEXT(om, om_next) = NULL;
+            om->om_flags = 0;
+            om->om_pkthdr_len = 0;
+            om->om_len = 0;
+            om->om_data = (&om->om_databuf[0] + leadingspace);
+            om->om_omp = omp;
+#if MYNEWT_VAL(OS_MBUF_SHARE)
+            om->om_shared = NULL;
+            om->om_refcnt = 1;
+#endif
+
+            if (tail != NULL) {
+                SLIST_NEXT(tail, om_next) = om;
+            } else {
+                head = om;
+            }
+            tail = om;
+        }
+
+        count -= batch;
+    }
+
+done:
+    os_trace_api_ret_u32(OS_TRACE_ID_MBUF_GET_CHAIN, (uint32_t)head);
+    return head;
+}
+
 struct os_mbuf *
 os_mbuf_get_pkthdr(struct os_mbuf_pool *omp, uint8_t user_pkthdr_len)
 {
@@ -182,6 +255,51 @@ done:
     return om;
 }
 
+#if MYNEWT_VAL(OS_MBUF_SHARE)
+/**
+ * Drops a reference to an mbuf's memory block.
+ *
+ * @return                      true if that was the last reference and the
+ *                                  block can be returned to its pool.
+ */
+static bool
+os_mbuf_unref(struct os_mbuf *om)
+{
+    os_sr_t sr;
+    bool last;
+
+    OS_ENTER_CRITICAL(sr);
+    assert(om->om_refcnt > 0);
+    om->om_refcnt--;
+    last = om->om_refcnt == 0;
+    OS_EXIT_CRITICAL(sr);
+
+    return last;
+}
+
+/**
+ * Drops the reference an mbuf holds on the buffer its data lives in, if
+ * that is another mbuf's buffer.
+ */
+static int
+os_mbuf_release_shared(struct os_mbuf *om)
+{
+    struct os_mbuf *owner;
+
+    owner = om->om_shared;
+    if (owner == NULL) {
+        return 0;
+    }
+
+    om->om_shared = NULL;
+    if (os_mbuf_unref(owner) && owner->om_omp != NULL) {
+        return os_memblock_put(owner->om_omp->omp_pool, owner);
+    }
+
+    return 0;
+}
+#endif
+
 int
 os_mbuf_free(struct os_mbuf *om)
 {
@@ -190,6 +308,18 @@ os_mbuf_free(struct os_mbuf *om)
     os_trace_api_u32(OS_TRACE_ID_MBUF_FREE, (uint32_t)om);
 
     if (om->om_omp != NULL) {
+#if MYNEWT_VAL(OS_MBUF_SHARE)
+        rc = os_mbuf_release_shared(om);
+        if (rc != 0) {
+            goto done;
+        }
+
+        /* Other mbufs may still refer to the data in this buffer. */
+        if (!os_mbuf_unref(om)) {
+            rc = 0;
+            goto done;
+        }
+#endif
         rc = os_memblock_put(om->om_omp->omp_pool, om);
         if (rc != 0) {
             goto done;
@@ -206,22 +336,58 @@ done:
 int
 os_mbuf_free_chain(struct os_mbuf *om)
 {
+    void *blocks[OS_MBUF_BATCH_SIZE];
+    struct os_mbuf_pool *omp;
     struct os_mbuf *next;
+    int batch;
     int rc;
 
     os_trace_api_u32(OS_TRACE_ID_MBUF_FREE_CHAIN, (uint32_t)om);
 
+    omp = NULL;
+    batch = 0;
+
     while (om != NULL) {
         next = SLIST_NEXT(om, om_next);
 
-        rc = os_mbuf_free(om);
-        if (rc != 0) {
-            goto done;
+#if MYNEWT_VAL(OS_MBUF_SHARE)
+        /* Shared buffers need their references dropped one at a time. */
+        if (om->om_shared != NULL || om->om_refcnt != 1) {
+            rc = os_mbuf_free(om);
+            if (rc != 0) {
+                goto done;
+            }
+            om = next;
+            continue;
+        }
+#endif
+
+        if (om->om_omp != NULL) {
+            /* Flush the batch when it is full or the pool changes. */
+            if (batch == OS_MBUF_BATCH_SIZE ||
+                (batch > 0 && om->om_omp != omp)) {
+
+                rc = os_memblock_put_n(omp->omp_pool, blocks, batch);
+                if (rc != 0) {
+                    goto done;
+                }
+                batch = 0;
+            }
+
+            omp = om->om_omp;
+            blocks[batch++] = om;
         }
 
         om = next;
     }
 
+    if (batch > 0) {
+        rc = os_memblock_put_n(omp->omp_pool, blocks, batch);
+        if (rc != 0) {
+            goto done;
+        }
+    }
+
     rc = 0;
 
 done:
@@ -408,6 +574,123 @@ err:
     return (NULL);
 }
 
+#if MYNEWT_VAL(OS_MBUF_SHARE)
+struct os_mbuf *
+os_mbuf_share(struct os_mbuf_pool *omp, struct os_mbuf *om)
+{
+    struct os_mbuf *owner;
+    struct os_mbuf *head;
+    struct os_mbuf *copy;
+    struct os_mbuf *prev;
+    os_sr_t sr;
+
+    os_trace_api_u32x2(OS_TRACE_ID_MBUF_SHARE, (uint32_t)omp, (uint32_t)om);
+
+    head = NULL;
+    prev = NULL;
+
+    for (; om != NULL; om = SLIST_NEXT(om, om_next)) {
+        /* Always refer to the buffer that actually holds the data. */
+        owner = om->om_shared != NULL ? om->om_shared : om;
+        if (owner->om_omp == NULL) {
+            goto err;
+        }
+
+        if (head == NULL && om->om_pkthdr_len > omp->omp_databuf_len) {
+            goto err;
+        }
+
+        copy = os_mbuf_get(omp, 0);
+        if (copy == NULL) {
+            goto err;
+        }
+
+        if (head == NULL) {
+            if (OS_MBUF_IS_PKTHDR(om)) {
+                _os_mbuf_copypkthdr(copy, om);
+            }
+            head = copy;
+        } else {
+            SLIST_NEXT(prev, om_next) = copy;
+        }
+        prev = copy;
+
+        OS_ENTER_CRITICAL(sr);
+        owner->om_refcnt++;
+        OS_EXIT_CRITICAL(sr);
+
+        copy->om_shared = owner;
+        copy->om_flags = om->om_flags;
+        copy->om_data = om->om_data;
+        copy->om_len = om->om_len;
+    }
+
+done:
+    os_trace_api_ret_u32(OS_TRACE_ID_MBUF_SHARE, (uint32_t)head);
+    return head;
+
+err:
+    os_mbuf_free_chain(head);
+    head = NULL;
+    goto done;
+}
+
+/**
+ * Gives an mbuf a private copy of its data if the data is shared, so that it
+ * can be modified in place.  The header stays where it is; the data moves to
+ * a fresh buffer from the pool the data was originally allocated from.
+ */
+static int
+os_mbuf_unshare_one(struct os_mbuf *om)
+{
+    struct os_mbuf *owner;
+    struct os_mbuf *copy;
+    uint16_t off;
+    int rc;
+
+    if (!OS_MBUF_IS_SHARED(om)) {
+        return 0;
+    }
+
+    owner = om->om_shared != NULL ? om->om_shared : om;
+    copy = os_mbuf_get(owner->om_omp, 0);
+    if (copy == NULL) {
+        return OS_ENOMEM;
+    }
+
+    /* Keep the same leading and trailing space. */
+    off = om->om_data - owner->om_databuf;
+    memcpy(copy->om_databuf + off, om->om_data, om->om_len);
+
+    rc = os_mbuf_release_shared(om);
+    if (rc != 0) {
+        os_mbuf_free(copy);
+        return rc;
+    }
+
+    /* The copy's header is never used; its reference now belongs to om. */
+    om->om_shared = copy;
+    om->om_data = copy->om_databuf + off;
+
+    return 0;
+}
+
+int
+os_mbuf_unshare(struct os_mbuf *om)
+{
+    int rc;
+
+    for (; om != NULL; om = SLIST_NEXT(om, om_next)) {
+        rc = os_mbuf_unshare_one(om);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    return 0;
+}
+#endif
+
 struct os_mbuf *
 os_mbuf_off(const struct os_mbuf *om, int off, uint16_t *out_off)
 {
@@ -584,6 +867,226 @@ os_mbuf_cmpf(const struct os_mbuf *om, int off, const void *data, int len)
     }
 }
 
+void
+os_mbuf_cursor_init(struct os_mbuf_cursor *omc, struct os_mbuf *om)
+{
+    omc->omc_head = om;
+    omc->omc_cur = om;
+    omc->omc_base = 0;
+    omc->omc_off = 0;
+}
+
+/**
+ * Moves a cursor forward by the specified number of bytes.  The cursor is
+ * only updated on success.
+ */
+static int
+os_mbuf_cursor_fwd(struct os_mbuf_cursor *omc, int len)
+{
+    struct os_mbuf *cur;
+    int base;
+    int off;
+
+    cur = omc->omc_cur;
+    if (cur == NULL) {
+        return len == 0 ? 0 : OS_EINVAL;
+    }
+
+    base = omc->omc_base;
+    off = omc->omc_off + len;
+    while (off > cur->om_len) {
+        off -= cur->om_len;
+        base += cur->om_len;
+        cur = SLIST_NEXT(cur, om_next);
+        if (cur == NULL) {
+            return OS_EINVAL;
+        }
+    }
+
+    omc->omc_cur = cur;
+    omc->omc_base = base;
+    omc->omc_off = off;
+
+    return 0;
+}
+
+int
+os_mbuf_cursor_seek(struct os_mbuf_cursor *omc, int off)
+{
+    struct os_mbuf_cursor tmp;
+    int rc;
+
+    if (off < 0) {
+        return OS_EINVAL;
+    }
+
+    tmp = *omc;
+    if (off < os_mbuf_cursor_tell(&tmp)) {
+        os_mbuf_cursor_init(&tmp, tmp.omc_head);
+    }
+
+    rc = os_mbuf_cursor_fwd(&tmp, off - os_mbuf_cursor_tell(&tmp));
+    if (rc != 0) {
+        return rc;
+    }
+
+    *omc = tmp;
+    return 0;
+}
+
+int
+os_mbuf_cursor_advance(struct os_mbuf_cursor *omc, int len)
+{
+    if (len < 0) {
+        return OS_EINVAL;
+    }
+
+    return os_mbuf_cursor_fwd(omc, len);
+}
+
+/**
+ * Copies data at the cursor position, optionally moving the cursor past it.
+ */
+static int
+os_mbuf_cursor_copy(struct os_mbuf_cursor *omc, void *dst, int len,
+                    int advance)
+{
+    struct os_mbuf *cur;
+    uint8_t *udst;
+    int base;
+    int off;
+    int count;
+
+    if (len < 0) {
+        return OS_EINVAL;
+    }
+
+    udst = dst;
+    cur = omc->omc_cur;
+    base = omc->omc_base;
+    off = omc->omc_off;
+    while (len > 0) {
+        if (cur == NULL) {
+            return OS_EINVAL;
+        }
+
+        count = min(cur->om_len - off, len);
+        memcpy(udst, cur->om_data + off, count);
+        udst += count;
+        len -= count;
+        off += count;
+
+        if (len > 0) {
+            base += cur->om_len;
+            cur = SLIST_NEXT(cur, om_next);
+            off = 0;
+        }
+    }
+
+    if (advance) {
+        omc->omc_cur = cur;
+        omc->omc_base = base;
+        omc->omc_off = off;
+    }
+
+    return 0;
+}
+
+int
+os_mbuf_cursor_peek(const struct os_mbuf_cursor *omc, void *dst, int len)
+{
+    /* Cast away const; the cursor is not modified. */
+    return os_mbuf_cursor_copy((struct os_mbuf_cursor *)omc, dst, len, 0);
+}
+
+int
+os_mbuf_cursor_read(struct os_mbuf_cursor *omc, void *dst, int len)
+{
+    return os_mbuf_cursor_copy(omc, dst, len, 1);
+}
+
+int
+os_mbuf_cursor_cmp(const struct os_mbuf_cursor *omc, const void *data,
+                   int len)
+{
+    const struct os_mbuf *cur;
+    const uint8_t *udata;
+    int count;
+    int off;
+    int rc;
+
+    udata = data;
+    cur = omc->omc_cur;
+    off = omc->omc_off;
+    while (len > 0) {
+        if (cur == NULL) {
+            return INT_MAX;
+        }
+
+        count = min(cur->om_len - off, len);
+        if (count > 0) {
+            rc = memcmp(cur->om_data + off, udata, count);
+            if (rc != 0) {
+                return rc;
+            }
+        }
+        udata += count;
+        len -= count;
+
+        cur = SLIST_NEXT(cur, om_next);
+        off = 0;
+    }
+
+    return 0;
+}
+
+int
+os_mbuf_to_iov(const struct os_mbuf *om, int off, int len,
+               struct os_mbuf_iov *iov, int *iov_cnt)
+{
+    uint16_t cur_off;
+    int count;
+    int max;
+    int cnt;
+
+    max = *iov_cnt;
+    *iov_cnt = 0;
+
+    if (off < 0 || len < 0) {
+        return OS_EINVAL;
+    }
+
+    om = os_mbuf_off(om, off, &cur_off);
+    if (om == NULL) {
+        return OS_EINVAL;
+    }
+
+    cnt = 0;
+    while (len > 0) {
+        if (om == NULL) {
+            return OS_EINVAL;
+        }
+
+        count = min(om->om_len - cur_off, len);
+        if (count > 0) {
+            if (cnt >= max) {
+                *iov_cnt = cnt;
+                return OS_ENOMEM;
+            }
+            iov[cnt].omi_base = om->om_data + cur_off;
+            iov[cnt].omi_len = count;
+            cnt++;
+            len -= count;
+        }
+
+        om = SLIST_NEXT(om, om_next);
+        cur_off = 0;
+    }
+
+    *iov_cnt = cnt;
+    return 0;
+}
+
 int
 os_mbuf_cmpm(const struct os_mbuf *om1, uint16_t offset1,
              const struct os_mbuf *om2, uint16_t offset2,
@@ -730,6 +1233,12 @@ os_mbuf_copyinto(struct os_mbuf *om, int off, const void *src, int len)
     while (1) {
         copylen = min(cur->om_len - cur_off, len);
         if (copylen > 0) {
+#if MYNEWT_VAL(OS_MBUF_SHARE)
+            rc = os_mbuf_unshare_one(cur);
+            if (rc != 0) {
+                return rc;
+            }
+#endif
             memcpy(cur->om_data + cur_off, sptr, copylen);
             sptr += copylen;
             len -= copylen;
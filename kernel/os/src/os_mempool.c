@@ -113,6 +113,93 @@ os_mempool_guard_check(const struct os_mempool *mp, void *start)
 #define os_mempool_guard(mp, start)
 #define os_mempool_guard_check(mp, start)
 #endif
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+#define os_mempool_has_map(mp) ((mp)->mp_alloc_map != NULL)
+
+static void
+os_mempool_map_reset(struct os_mempool *mp)
+{
+    if (mp->mp_alloc_map != NULL) {
+        memset(mp->mp_alloc_map, 0,
+               OS_MEMPOOL_MAP_WORDS(mp->mp_num_blocks) * sizeof(uint32_t));
+    }
+}
+
+static inline uint32_t
+os_mempool_map_idx(const struct os_mempool *mp, const void *block)
+{
+    return ((uint32_t)block - mp->mp_membuf_addr) /
+           OS_MEMPOOL_TRUE_BLOCK_SIZE(mp);
+}
+
+static int
+os_mempool_map_test(const struct os_mempool *mp, const void *block)
+{
+    uint32_t idx;
+
+    idx = os_mempool_map_idx(mp, block);
+    return (mp->mp_alloc_map[idx >> 5] >> (idx & 31)) & 1;
+}
+
+/* Must be called with interrupts disabled. */
+static void
+os_mempool_map_set(struct os_mempool *mp, const void *block)
+{
+    uint32_t idx;
+
+    if (mp->mp_alloc_map == NULL) {
+        return;
+    }
+
+    idx = os_mempool_map_idx(mp, block);
+    assert(!(mp->mp_alloc_map[idx >> 5] & (1UL << (idx & 31))));
+    mp->mp_alloc_map[idx >> 5] |= 1UL << (idx & 31);
+}
+
+/* Must be called with interrupts disabled. */
+static void
+os_mempool_map_clear(struct os_mempool *mp, const void *block)
+{
+    uint32_t idx;
+
+    if (mp->mp_alloc_map == NULL) {
+        return;
+    }
+
+    idx = os_mempool_map_idx(mp, block);
+    assert(mp->mp_alloc_map[idx >> 5] & (1UL << (idx & 31)));
+    mp->mp_alloc_map[idx >> 5] &= ~(1UL << (idx & 31));
+}
+#else
+#define os_mempool_has_map(mp) 0
+#define os_mempool_map_reset(mp)
+#define os_mempool_map_set(mp, block)
+#define os_mempool_map_clear(mp, block)
+#endif
+
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK)
+/*
+ * Asserts that a block being freed is not on the free list already.  This is
+ * constant time if the pool has an allocation bitmap, and walks the free
+ * list otherwise.
+ */
+static void
+os_mempool_check_dup(const struct os_mempool *mp, const void *block_addr)
+{
+    struct os_memblock *block;
+
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+    if (mp->mp_alloc_map != NULL) {
+        assert(os_mempool_map_test(mp, block_addr));
+        return;
+    }
+#endif
+
+    SLIST_FOREACH(block, mp, mb_next) {
+        assert(block != (struct os_memblock *)block_addr);
+    }
+}
+#endif
 
 static os_error_t
 os_mempool_init_internal(struct os_mempool *mp, uint16_t blocks,
@@ -151,6 +238,9 @@ os_mempool_init_internal(struct os_mempool *mp, uint16_t blocks,
     mp->mp_membuf_addr = (uint32_t)membuf;
     mp->name = name;
     SLIST_FIRST(mp) = membuf;
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+    mp->mp_alloc_map = NULL;
+#endif
 
     if (blocks > 0) {
         os_mempool_poison(mp, membuf);
@@ -260,6 +350,7 @@ os_mempool_clear(struct os_mempool *mp)
     os_mempool_poison(mp, (void *)mp->mp_membuf_addr);
     os_mempool_guard(mp, (void *)mp->mp_membuf_addr);
     SLIST_FIRST(mp) = (void *)mp->mp_membuf_addr;
+    os_mempool_map_reset(mp);
 
     /* Chain the memory blocks to the free list */
     block_addr = (uint8_t *)mp->mp_membuf_addr;
@@ -281,6 +372,33 @@ os_mempool_clear(struct os_mempool *mp)
     return OS_OK;
 }
 
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+os_error_t
+os_mempool_map_attach(struct os_mempool *mp, uint32_t *map)
+{
+    os_error_t ret;
+    os_sr_t sr;
+
+    if (mp == NULL || map == NULL) {
+        return OS_INVALID_PARM;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+    /* Blocks already handed out would have no bit set. */
+    if (mp->mp_num_free != mp->mp_num_blocks) {
+        ret = OS_INVALID_PARM;
+    } else {
+        memset(map, 0, OS_MEMPOOL_MAP_WORDS(mp->mp_num_blocks) *
+                       sizeof(uint32_t));
+        mp->mp_alloc_map = map;
+        ret = OS_OK;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    return ret;
+}
+#endif
+
 bool
 os_mempool_is_sane(const struct os_mempool *mp)
 {
@@ -291,6 +409,11 @@ os_mempool_is_sane(const struct os_mempool *mp)
         if (!os_memblock_from(mp, block)) {
             return false;
         }
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+        if (mp->mp_alloc_map != NULL && os_mempool_map_test(mp, block)) {
+            return false;
+        }
+#endif
         os_mempool_poison_check(mp, block);
         os_mempool_guard_check(mp, block);
     }
@@ -344,6 +467,7 @@ os_memblock_get(struct os_mempool *mp)
 
             /* Set new free list head */
             SLIST_FIRST(mp) = SLIST_NEXT(block, mb_next);
+            os_mempool_map_set(mp, block);
 
             /* Decrement number free by 1 */
             mp->mp_num_free--;
@@ -378,6 +502,7 @@ os_memblock_put_from_cb(struct os_mempool *mp, void *block_addr)
 
     block = (struct os_memblock *)block_addr;
     OS_ENTER_CRITICAL(sr);
+    os_mempool_map_clear(mp, block);
 
     /* Chain current free list pointer to this block; make this block head */
     SLIST_NEXT(block, mb_next) = SLIST_FIRST(mp);
@@ -399,9 +524,6 @@ os_memblock_put(struct os_mempool *mp, void *block_addr)
 {
     struct os_mempool_ext *mpe;
     os_error_t ret;
-#if MYNEWT_VAL(OS_MEMPOOL_CHECK)
-    struct os_memblock *block;
-#endif
 
     os_trace_api_u32x2(OS_TRACE_ID_MEMBLOCK_PUT, (uint32_t)mp,
                        (uint32_t)block_addr);
@@ -419,9 +541,7 @@ os_memblock_put(struct os_mempool *mp, void *block_addr)
     /*
      * Check for duplicate free.
      */
-    SLIST_FOREACH(block, mp, mb_next) {
-        assert(block != (struct os_memblock *)block_addr);
-    }
+    os_mempool_check_dup(mp, block_addr);
 #endif
     /* If this is an extended mempool with a put callback, call the callback
      * instead of freeing the block directly.
@@ -442,6 +562,149 @@ done:
     return ret;
 }
 
+os_error_t
+os_memblock_get_n(struct os_mempool *mp, void **blocks, uint16_t n)
+{
+    os_sr_t sr;
+    struct os_memblock *block;
+    os_error_t ret;
+    int i;
+
+    os_trace_api_u32x2(OS_TRACE_ID_MEMBLOCK_GET_N, (uint32_t)mp, n);
+
+    if (mp == NULL || (blocks == NULL && n != 0)) {
+        ret = OS_INVALID_PARM;
+        goto done;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+
+    if (mp->mp_num_free < n) {
+        OS_EXIT_CRITICAL(sr);
+        ret = OS_ENOMEM;
+        goto done;
+    }
+
+    /* Detach the first n blocks of the free list as one segment. */
+    block = SLIST_FIRST(mp);
+    for (i = 0; i < n; i++) {
+        blocks[i] = block;
+        os_mempool_map_set(mp, block);
+        block = SLIST_NEXT(block, mb_next);
+    }
+    SLIST_FIRST(mp) = block;
+
+    mp->mp_num_free -= n;
+    if (mp->mp_min_free > mp->mp_num_free) {
+        mp->mp_min_free = mp->mp_num_free;
+    }
+
+    OS_EXIT_CRITICAL(sr);
+
+    for (i = 0; i < n; i++) {
+        os_mempool_poison_check(mp, blocks[i]);
+        os_mempool_guard_check(mp, blocks[i]);
+    }
+
+    ret = OS_OK;
+
+done:
+    os_trace_api_ret_u32(OS_TRACE_ID_MEMBLOCK_GET_N, (uint32_t)ret);
+    return ret;
+}
+
+os_error_t
+os_memblock_put_n(struct os_mempool *mp, void **blocks, uint16_t n)
+{
+    os_sr_t sr;
+    struct os_memblock *block;
+    struct os_mempool_ext *mpe;
+    os_error_t ret;
+    int i;
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK)
+    int j;
+#endif
+
+    os_trace_api_u32x2(OS_TRACE_ID_MEMBLOCK_PUT_N, (uint32_t)mp, n);
+
+    if (mp == NULL || (blocks == NULL && n != 0)) {
+        ret = OS_INVALID_PARM;
+        goto done;
+    }
+    for (i = 0; i < n; i++) {
+        if (blocks[i] == NULL) {
+            ret = OS_INVALID_PARM;
+            goto done;
+        }
+    }
+
+    if (n == 0) {
+        ret = OS_OK;
+        goto done;
+    }
+
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK)
+    for (i = 0; i < n; i++) {
+        assert(os_memblock_from(mp, blocks[i]));
+
+        /*
+         * Check for duplicate free, both against the pool and the batch.
+         * With an allocation bitmap, duplicates within the batch are caught
+         * when the bits are cleared.
+         */
+        os_mempool_check_dup(mp, blocks[i]);
+        if (!os_mempool_has_map(mp)) {
+            for (j = 0; j < i; j++) {
+                assert(blocks[j] != blocks[i]);
+            }
+        }
+    }
+#endif
+
+    /* Put callbacks expect to see one block at a time. */
+    if (mp->mp_flags & OS_MEMPOOL_F_EXT) {
+        mpe = (struct os_mempool_ext *)mp;
+        if (mpe->mpe_put_cb != NULL) {
+            for (i = 0; i < n; i++) {
+                ret = mpe->mpe_put_cb(mpe, blocks[i], mpe->mpe_put_arg);
+                if (ret != OS_OK) {
+                    goto done;
+                }
+            }
+            ret = OS_OK;
+            goto done;
+        }
+    }
+
+    /* Link the blocks into a segment outside of the critical section. */
+    for (i = 0; i < n; i++) {
+        os_mempool_guard_check(mp, blocks[i]);
+        os_mempool_poison(mp, blocks[i]);
+
+        block = blocks[i];
+        if (i + 1 < n) {
+            SLIST_NEXT(block, mb_next) = blocks[i + 1];
+        }
+    }
+
+    OS_ENTER_CRITICAL(sr);
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+    for (i = 0; i < n; i++) {
+        os_mempool_map_clear(mp, blocks[i]);
+    }
+#endif
+    SLIST_NEXT(block, mb_next) = SLIST_FIRST(mp);
+    SLIST_FIRST(mp) = blocks[0];
+    mp->mp_num_free += n;
+    OS_EXIT_CRITICAL(sr);
+
+    ret = OS_OK;
+
+done:
+    os_trace_api_ret_u32(OS_TRACE_ID_MEMBLOCK_PUT_N, (uint32_t)ret);
+    return ret;
+}
+
 struct os_mempool *
 os_mempool_info_get_next(struct os_mempool *mp, struct os_mempool_info *omi)
 {
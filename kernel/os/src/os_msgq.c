@@ -0,0 +1,334 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "syscfg/syscfg.h"
+#if !MYNEWT_VAL(OS_SYSVIEW_TRACE_MSGQ)
+#define OS_TRACE_DISABLE_FILE_API
+#endif
+#include "os/mynewt.h"
+
+/*
+ * Blocked senders wait on mq_send_obj and blocked receivers on mq_recv_head.
+ * Whoever frees a slot or queues a message wakes the first waiter of the
+ * other kind, which then retries; a higher priority task may have got in
+ * first, in which case the waiter goes back to sleep for whatever is left
+ * of its timeout.  OS_TASK_FLAG_MSGQ_WAIT is cleared by the waker, so a
+ * waiter that still has it set after running again was woken by its timeout.
+ */
+
+os_error_t
+os_msgq_init(struct os_msgq *mq, void *buf, uint16_t msg_size,
+             uint16_t msg_count)
+{
+    os_error_t ret;
+
+    os_trace_api_u32x3(OS_TRACE_ID_MSGQ_INIT, (uint32_t)mq, (uint32_t)msg_size,
+                       (uint32_t)msg_count);
+
+    if (!mq || !buf || !msg_size || !msg_count) {
+        ret = OS_INVALID_PARM;
+        goto done;
+    }
+
+    SLIST_FIRST(&mq->mq_recv_head) = NULL;
+    SLIST_FIRST(&mq->mq_send_obj.obj_head) = NULL;
+    mq->mq_buf = buf;
+    mq->mq_msg_size = msg_size;
+    mq->mq_capacity = msg_count;
+    mq->mq_count = 0;
+    mq->mq_head = 0;
+    mq->mq_tail = 0;
+
+    ret = OS_OK;
+
+done:
+    os_trace_api_ret_u32(OS_TRACE_ID_MSGQ_INIT, (uint32_t)ret);
+    return ret;
+}
+
+/*
+ * Wakes the highest priority task waiting on the specified list, if any.
+ * Returns 1 if that task should preempt the current one.  Must be called
+ * with interrupts disabled.
+ */
+static int
+os_msgq_wake(struct os_task_obj *obj, struct os_task *current)
+{
+    struct os_task *t;
+
+    t = SLIST_FIRST(&obj->obj_head);
+    if (!t) {
+        return 0;
+    }
+
+    t->t_flags &= ~OS_TASK_FLAG_MSGQ_WAIT;
+    os_sched_wakeup(t);
+
+    return current && current->t_prio > t->t_prio;
+}
+
+/*
+ * Puts the current task to sleep on the specified list.  Must be called
+ * with interrupts disabled.
+ */
+static void
+os_msgq_sleep(struct os_task_obj *obj, struct os_task *current,
+              os_time_t timeout)
+{
+    struct os_task *entry;
+    struct os_task *last;
+
+    current->t_obj = obj;
+    current->t_flags |= OS_TASK_FLAG_MSGQ_WAIT;
+
+    /* Insert in priority order */
+    last = NULL;
+    SLIST_FOREACH(entry, &obj->obj_head, t_obj_list) {
+        if (current->t_prio < entry->t_prio) {
+            break;
+        }
+        last = entry;
+    }
+    if (last) {
+        SLIST_INSERT_AFTER(last, current, t_obj_list);
+    } else {
+        SLIST_INSERT_HEAD(&obj->obj_head, current, t_obj_list);
+    }
+
+    os_sched_sleep(current, timeout);
+}
+
+/*
+ * Called after the current task ran again following os_msgq_sleep().
+ * Returns the timeout left for the next attempt, or 0 if the task timed out.
+ */
+static os_time_t
+os_msgq_remaining(struct os_task *current, os_time_t timeout,
+                  os_time_t deadline)
+{
+    os_sr_t sr;
+    os_time_t now;
+
+    if (current->t_flags & OS_TASK_FLAG_MSGQ_WAIT) {
+        OS_ENTER_CRITICAL(sr);
+        current->t_flags &= ~OS_TASK_FLAG_MSGQ_WAIT;
+        OS_EXIT_CRITICAL(sr);
+        return 0;
+    }
+
+    if (timeout == OS_TIMEOUT_NEVER) {
+        return timeout;
+    }
+
+    now = os_time_get();
+    if (OS_TIME_TICK_GEQ(now, deadline)) {
+        return 0;
+    }
+    return deadline - now;
+}
+
+os_error_t
+os_msgq_send(struct os_msgq *mq, const void *msg, os_time_t timeout)
+{
+    struct os_task *current;
+    os_time_t deadline;
+    int resched;
+    os_sr_t sr;
+    os_error_t ret;
+
+    os_trace_api_u32x2(OS_TRACE_ID_MSGQ_SEND, (uint32_t)mq, (uint32_t)timeout);
+
+    if (!mq || !msg) {
+        ret = OS_INVALID_PARM;
+        goto done;
+    }
+
+    current = os_sched_get_current_task();
+    deadline = os_time_get() + timeout;
+
+    while (1) {
+        OS_ENTER_CRITICAL(sr);
+
+        if (mq->mq_count < mq->mq_capacity) {
+            memcpy(mq->mq_buf + mq->mq_tail * mq->mq_msg_size, msg,
+                   mq->mq_msg_size);
+            if (++mq->mq_tail == mq->mq_capacity) {
+                mq->mq_tail = 0;
+            }
+            mq->mq_count++;
+
+            resched = os_msgq_wake((struct os_task_obj *)mq, current);
+            OS_EXIT_CRITICAL(sr);
+
+            if (resched && g_os_started) {
+                os_sched(NULL);
+            }
+            ret = OS_OK;
+            break;
+        }
+
+        if (timeout == 0) {
+            OS_EXIT_CRITICAL(sr);
+            ret = OS_TIMEOUT;
+            break;
+        }
+
+        if (!g_os_started) {
+            OS_EXIT_CRITICAL(sr);
+            ret = OS_NOT_STARTED;
+            break;
+        }
+
+        os_msgq_sleep(&mq->mq_send_obj, current, timeout);
+        OS_EXIT_CRITICAL(sr);
+
+        os_sched(NULL);
+
+        timeout = os_msgq_remaining(current, timeout, deadline);
+    }
+
+done:
+    os_trace_api_ret_u32(OS_TRACE_ID_MSGQ_SEND, (uint32_t)ret);
+    return ret;
+}
+
+static os_error_t
+os_msgq_recv_n(struct os_msgq *mq, uint8_t *buf, uint16_t max_cnt,
+               os_time_t timeout, uint16_t *out_cnt)
+{
+    struct os_task *current;
+    os_time_t deadline;
+    uint16_t first;
+    uint16_t cnt;
+    int resched;
+    int i;
+    os_sr_t sr;
+
+    current = os_sched_get_current_task();
+    deadline = os_time_get() + timeout;
+    cnt = 0;
+
+    while (1) {
+        OS_ENTER_CRITICAL(sr);
+
+        if (mq->mq_count > 0) {
+            cnt = min(max_cnt, mq->mq_count);
+
+            /* At most two copies: up to the end of the ring, then the rest */
+            first = min(cnt, mq->mq_capacity - mq->mq_head);
+            memcpy(buf, mq->mq_buf + mq->mq_head * mq->mq_msg_size,
+                   first * mq->mq_msg_size);
+            if (first < cnt) {
+                memcpy(buf + first * mq->mq_msg_size, mq->mq_buf,
+                       (cnt - first) * mq->mq_msg_size);
+            }
+
+            mq->mq_head += cnt;
+            if (mq->mq_head >= mq->mq_capacity) {
+                mq->mq_head -= mq->mq_capacity;
+            }
+            mq->mq_count -= cnt;
+
+            /* One sender can proceed per freed slot */
+            resched = 0;
+            for (i = 0; i < cnt; i++) {
+                if (SLIST_EMPTY(&mq->mq_send_obj.obj_head)) {
+                    break;
+                }
+                resched |= os_msgq_wake(&mq->mq_send_obj, current);
+            }
+            OS_EXIT_CRITICAL(sr);
+
+            if (resched && g_os_started) {
+                os_sched(NULL);
+            }
+            break;
+        }
+
+        if (timeout == 0) {
+            OS_EXIT_CRITICAL(sr);
+            break;
+        }
+
+        if (!g_os_started) {
+            OS_EXIT_CRITICAL(sr);
+            *out_cnt = 0;
+            return OS_NOT_STARTED;
+        }
+
+        os_msgq_sleep((struct os_task_obj *)mq, current, timeout);
+        OS_EXIT_CRITICAL(sr);
+
+        os_sched(NULL);
+
+        timeout = os_msgq_remaining(current, timeout, deadline);
+    }
+
+    *out_cnt = cnt;
+    return cnt ? OS_OK : OS_TIMEOUT;
+}
+
+os_error_t
+os_msgq_recv(struct os_msgq *mq, void *msg, os_time_t timeout)
+{
+    uint16_t cnt;
+    os_error_t ret;
+
+    os_trace_api_u32x2(OS_TRACE_ID_MSGQ_RECV, (uint32_t)mq, (uint32_t)timeout);
+
+    if (!mq || !msg) {
+        ret = OS_INVALID_PARM;
+        goto done;
+    }
+
+    ret = os_msgq_recv_n(mq, msg, 1, timeout, &cnt);
+
+done:
+    os_trace_api_ret_u32(OS_TRACE_ID_MSGQ_RECV, (uint32_t)ret);
+    return ret;
+}
+
+os_error_t
+os_msgq_recv_multi(struct os_msgq *mq, void *buf, uint16_t max_cnt,
+                   os_time_t timeout, uint16_t *out_cnt)
+{
+    uint16_t cnt;
+    os_error_t ret;
+
+    os_trace_api_u32x3(OS_TRACE_ID_MSGQ_RECV_MULTI, (uint32_t)mq,
+                       (uint32_t)max_cnt, (uint32_t)timeout);
+
+    cnt = 0;
+
+    if (!mq || !buf || !max_cnt) {
+        ret = OS_INVALID_PARM;
+        goto done;
+    }
+
+    ret = os_msgq_recv_n(mq, buf, max_cnt, timeout, &cnt);
+
+done:
+    if (out_cnt) {
+        *out_cnt = cnt;
+    }
+    os_trace_api_ret_u32(OS_TRACE_ID_MSGQ_RECV_MULTI, (uint32_t)ret);
+    return ret;
+}
@@ -18,6 +18,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 #include "os/mynewt.h"
 #include "mem/mem.h"
 #include "os_priv.h"
@@ -25,6 +26,19 @@
 static STAILQ_HEAD(, os_mbuf_pool) g_msys_pool_list =
     STAILQ_HEAD_INITIALIZER(g_msys_pool_list);
 
+#define OS_MSYS_LOOKUP_ENTRIES  MYNEWT_VAL(MSYS_LOOKUP_ENTRIES)
+#define OS_MSYS_LOOKUP_SHIFT    MYNEWT_VAL(MSYS_LOOKUP_SHIFT)
+
+#if OS_MSYS_LOOKUP_ENTRIES > 0
+/*
+ * Size-class table.  Entry n points to the smallest pool whose buffers can
+ * hold (n << OS_MSYS_LOOKUP_SHIFT) + 1 bytes, or is NULL if no pool can.
+ * Requests in the same class only need to skip pools that are smaller than
+ * the request but fall in that class, which is at most a step or two.
+ */
+static struct os_mbuf_pool *g_msys_lookup[OS_MSYS_LOOKUP_ENTRIES];
+#endif
+
 #if MYNEWT_VAL(MSYS_1_BLOCK_COUNT) > 0
 #define SYSINIT_MSYS_1_MEMBLOCK_SIZE                \
     OS_ALIGN(MYNEWT_VAL(MSYS_1_BLOCK_SIZE), 4)
@@ -34,6 +48,10 @@ static STAILQ_HEAD(, os_mbuf_pool) g_msys_pool_list =
 static os_membuf_t os_msys_1_data[SYSINIT_MSYS_1_MEMPOOL_SIZE];
 static struct os_mbuf_pool os_msys_1_mbuf_pool;
 static struct os_mempool os_msys_1_mempool;
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+static uint32_t os_msys_1_map[
+    OS_MEMPOOL_MAP_WORDS(MYNEWT_VAL(MSYS_1_BLOCK_COUNT))];
+#endif
 #endif
 
 #if MYNEWT_VAL(MSYS_2_BLOCK_COUNT) > 0
@@ -45,6 +63,17 @@ static struct os_mempool os_msys_1_mempool;
 static os_membuf_t os_msys_2_data[SYSINIT_MSYS_2_MEMPOOL_SIZE];
 static struct os_mbuf_pool os_msys_2_mbuf_pool;
 static struct os_mempool os_msys_2_mempool;
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+static uint32_t os_msys_2_map[
+    OS_MEMPOOL_MAP_WORDS(MYNEWT_VAL(MSYS_2_BLOCK_COUNT))];
+#endif
+#endif
+
+/* Allocation bitmap of an msys pool, for constant time double free checks */
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+#define OS_MSYS_MAP(n)  os_msys_ ## n ## _map
+#else
+#define OS_MSYS_MAP(n)  NULL
 #endif
 
 #define OS_MSYS_SANITY_ENABLED                  \
@@ -55,6 +84,25 @@ static struct os_mempool os_msys_2_mempool;
 static struct os_sanity_check os_msys_sc;
 #endif
 
+#if OS_MSYS_LOOKUP_ENTRIES > 0
+static void
+os_msys_lookup_build(void)
+{
+    struct os_mbuf_pool *pool;
+    uint32_t min_size;
+    int i;
+
+    pool = STAILQ_FIRST(&g_msys_pool_list);
+    for (i = 0; i < OS_MSYS_LOOKUP_ENTRIES; i++) {
+        min_size = ((uint32_t)i << OS_MSYS_LOOKUP_SHIFT) + 1;
+        while (pool != NULL && pool->omp_databuf_len < min_size) {
+            pool = STAILQ_NEXT(pool, omp_next);
+        }
+        g_msys_lookup[i] = pool;
+    }
+}
+#endif
+
 int
 os_msys_register(struct os_mbuf_pool *new_pool)
 {
@@ -77,6 +125,10 @@ os_msys_register(struct os_mbuf_pool *new_pool)
         STAILQ_INSERT_HEAD(&g_msys_pool_list, new_pool, omp_next);
     }
 
+#if OS_MSYS_LOOKUP_ENTRIES > 0
+    os_msys_lookup_build();
+#endif
+
     return (0);
 }
 
@@ -84,6 +136,9 @@ void
 os_msys_reset(void)
 {
     STAILQ_INIT(&g_msys_pool_list);
+#if OS_MSYS_LOOKUP_ENTRIES > 0
+    memset(g_msys_lookup, 0, sizeof g_msys_lookup);
+#endif
 }
 
 static struct os_mbuf_pool *
@@ -94,15 +149,23 @@ os_msys_find_biggest_pool(void)
 }
 
 static struct os_mbuf_pool *
-os_msys_find_pool(uint16_t dsize)
+os_msys_find_pool(uint32_t dsize)
 {
     struct os_mbuf_pool *pool;
+#if OS_MSYS_LOOKUP_ENTRIES > 0
+    uint32_t idx;
 
-    pool = NULL;
-    STAILQ_FOREACH(pool, &g_msys_pool_list, omp_next) {
-        if (dsize <= pool->omp_databuf_len) {
-            break;
-        }
+    idx = (dsize - 1) >> OS_MSYS_LOOKUP_SHIFT;
+    if (idx >= OS_MSYS_LOOKUP_ENTRIES) {
+        idx = OS_MSYS_LOOKUP_ENTRIES - 1;
+    }
+    pool = g_msys_lookup[idx];
+#else
+    pool = STAILQ_FIRST(&g_msys_pool_list);
+#endif
+
+    while (pool != NULL && dsize > pool->omp_databuf_len) {
+        pool = STAILQ_NEXT(pool, omp_next);
     }
 
     if (!pool) {
@@ -112,6 +175,57 @@ os_msys_find_pool(uint16_t dsize)
     return (pool);
 }
 
+/**
+ * Allocates an mbuf from the specified best-fit pool.  If the pool is
+ * exhausted and MSYS_FALLBACK is enabled, the next larger pool with free
+ * blocks is tried instead.
+ */
+static struct os_mbuf *
+os_msys_alloc(struct os_mbuf_pool *pool, uint16_t len, int pkthdr)
+{
+    struct os_mbuf *m;
+#if MYNEWT_VAL(MSYS_FALLBACK)
+    struct os_mbuf_pool *next;
+#endif
+
+    if (pkthdr) {
+        m = os_mbuf_get_pkthdr(pool, len);
+    } else {
+        m = os_mbuf_get(pool, len);
+    }
+    if (m != NULL) {
+        return (m);
+    }
+
+#if MYNEWT_VAL(MSYS_FALLBACK)
+    for (next = STAILQ_NEXT(pool, omp_next);
+         next != NULL;
+         next = STAILQ_NEXT(next, omp_next)) {
+
+        if (next->omp_pool->mp_num_free == 0) {
+            continue;
+        }
+
+        if (pkthdr) {
+            m = os_mbuf_get_pkthdr(next, len);
+        } else {
+            m = os_mbuf_get(next, len);
+        }
+        if (m != NULL) {
+#if MYNEWT_VAL(MSYS_POOL_STATS)
+            pool->omp_fallback_cnt++;
+#endif
+            return (m);
+        }
+    }
+#endif
+
+#if MYNEWT_VAL(MSYS_POOL_STATS)
+    pool->omp_fail_cnt++;
+#endif
+
+    return (NULL);
+}
 
 struct os_mbuf *
 os_msys_get(uint16_t dsize, uint16_t leadingspace)
@@ -132,7 +246,7 @@ os_msys_get(uint16_t dsize, uint16_t leadingspace)
         goto err;
     }
 
-    m = os_mbuf_get(pool, leadingspace);
+    m = os_msys_alloc(pool, leadingspace, 0);
     return (m);
 err:
     return (NULL);
@@ -153,14 +267,14 @@ os_msys_get_pkthdr(uint16_t dsize, uint16_t user_hdr_len)
     if (dsize == 0) {
         pool = os_msys_find_biggest_pool();
     } else {
-        pool = os_msys_find_pool(dsize + total_pkthdr_len);
+        pool = os_msys_find_pool((uint32_t)dsize + total_pkthdr_len);
     }
 
     if (!pool) {
         goto err;
     }
 
-    m = os_mbuf_get_pkthdr(pool, user_hdr_len);
+    m = os_msys_alloc(pool, user_hdr_len, 1);
     return (m);
 err:
     return (NULL);
@@ -194,6 +308,28 @@ os_msys_num_free(void)
     return total;
 }
 
+#if MYNEWT_VAL(MSYS_POOL_STATS)
+int
+os_msys_pool_info_get(int idx, struct os_msys_pool_info *ompi)
+{
+    const struct os_mbuf_pool *omp;
+
+    STAILQ_FOREACH(omp, &g_msys_pool_list, omp_next) {
+        if (idx-- == 0) {
+            ompi->ompi_databuf_len = omp->omp_databuf_len;
+            ompi->ompi_num_blocks = omp->omp_pool->mp_num_blocks;
+            ompi->ompi_num_free = omp->omp_pool->mp_num_free;
+            ompi->ompi_min_free = omp->omp_pool->mp_min_free;
+            ompi->ompi_fallbacks = omp->omp_fallback_cnt;
+            ompi->ompi_failures = omp->omp_fail_cnt;
+            return 0;
+        }
+    }
+
+    return OS_ENOENT;
+}
+#endif
+
 #if OS_MSYS_SANITY_ENABLED
 
 /**
@@ -243,7 +379,7 @@ os_msys_sanity(struct os_sanity_check *sc, void *arg)
 #endif
 
 static void
-os_msys_init_once(void *data, struct os_mempool *mempool,
+os_msys_init_once(void *data, uint32_t *map, struct os_mempool *mempool,
                   struct os_mbuf_pool *mbuf_pool,
                   int block_count, int block_size, char *name)
 {
@@ -253,6 +389,11 @@ os_msys_init_once(void *data, struct os_mempool *mempool,
                             name);
     SYSINIT_PANIC_ASSERT(rc == 0);
 
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK_MAP)
+    rc = os_mempool_map_attach(mempool, map);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+#endif
+
     rc = os_msys_register(mbuf_pool);
     SYSINIT_PANIC_ASSERT(rc == 0);
 }
@@ -269,6 +410,7 @@ os_msys_init(void)
 
 #if MYNEWT_VAL(MSYS_1_BLOCK_COUNT) > 0
     os_msys_init_once(os_msys_1_data,
+                      OS_MSYS_MAP(1),
                       &os_msys_1_mempool,
                       &os_msys_1_mbuf_pool,
                       MYNEWT_VAL(MSYS_1_BLOCK_COUNT),
@@ -278,6 +420,7 @@ os_msys_init(void)
 
 #if MYNEWT_VAL(MSYS_2_BLOCK_COUNT) > 0
     os_msys_init_once(os_msys_2_data,
+                      OS_MSYS_MAP(2),
                       &os_msys_2_mempool,
                       &os_msys_2_mbuf_pool,
                       MYNEWT_VAL(MSYS_2_BLOCK_COUNT),
@@ -38,7 +38,14 @@ extern struct os_task_stailq g_os_task_list;
 extern struct os_callout_list g_callout_list;
 
 void os_mempool_module_init(void);
+void os_callout_module_init(void);
 void os_msys_init(void);
+#if MYNEWT_VAL(OS_MALLOC_SLAB)
+void os_malloc_slab_init(void);
+#endif
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+void os_sched_run_stats_start(void);
+#endif
 
 /**
  * Prints information about a crash to the console.  This functionality is
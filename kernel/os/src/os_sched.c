@@ -18,6 +18,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 #include "os/mynewt.h"
 #include "os_priv.h"
 
@@ -29,6 +30,293 @@ struct os_task *g_current_task;
 extern os_time_t g_os_time;
 os_time_t g_os_last_ctx_sw_time;
 
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+#define OS_SCHED_LAT_BUCKETS    MYNEWT_VAL(OS_TASK_RUN_STATS_LAT_BUCKETS)
+
+/* os_cputime of the last context switch. */
+static uint32_t os_sched_last_ctx_sw_cputime;
+#endif
+
+#if MYNEWT_VAL(OS_SCHED_PRIO_BITMAP)
+#define OS_SCHED_NUM_PRIOS      (OS_TASK_PRI_LOWEST + 1)
+
+/*
+ * The run list is kept sorted by priority.  To avoid walking it on every
+ * insert, keep a bitmap of the priorities that have at least one ready task,
+ * and a pointer to the last ready task queued at each of those priorities.
+ * A new task goes right after the last task of the closest priority that is
+ * equal to or higher than its own; this keeps tasks of the same priority in
+ * FIFO order, just like the linear insert does.
+ */
+static uint32_t os_sched_prio_map[OS_SCHED_NUM_PRIOS / 32];
+static struct os_task *os_sched_prio_last[OS_SCHED_NUM_PRIOS];
+
+/*
+ * Returns the numerically highest priority which has ready tasks and is
+ * not lower (i.e. numerically not greater) than 'prio', or -1 if there is no
+ * such priority.
+ */
+static int
+os_sched_prio_map_find(uint8_t prio)
+{
+    uint32_t word;
+    int idx;
+
+    idx = prio / 32;
+    word = os_sched_prio_map[idx] & (0xffffffffU >> (31 - (prio % 32)));
+    while (!word) {
+        if (idx == 0) {
+            return -1;
+        }
+        word = os_sched_prio_map[--idx];
+    }
+
+    return idx * 32 + 31 - __builtin_clz(word);
+}
+
+static void
+os_sched_run_list_insert(struct os_task *t)
+{
+    int prio;
+
+    prio = os_sched_prio_map_find(t->t_prio);
+    if (prio < 0) {
+        TAILQ_INSERT_HEAD(&g_os_run_list, t, t_os_list);
+    } else {
+        TAILQ_INSERT_AFTER(&g_os_run_list, os_sched_prio_last[prio], t,
+                           t_os_list);
+    }
+
+    t->t_run_prio = t->t_prio;
+    os_sched_prio_last[t->t_prio] = t;
+    os_sched_prio_map[t->t_prio / 32] |= 1U << (t->t_prio % 32);
+}
+
+static void
+os_sched_run_list_remove(struct os_task *t)
+{
+    struct os_task *prev;
+    uint8_t prio;
+
+    /*
+     * Use the priority the task was queued at; t_prio may have been changed
+     * already by the caller of os_sched_resort().
+     */
+    prio = t->t_run_prio;
+    if (os_sched_prio_last[prio] == t) {
+        prev = TAILQ_PREV(t, os_task_list, t_os_list);
+        if (prev != NULL && prev->t_run_prio == prio) {
+            os_sched_prio_last[prio] = prev;
+        } else {
+            os_sched_prio_last[prio] = NULL;
+            os_sched_prio_map[prio / 32] &= ~(1U << (prio % 32));
+        }
+    }
+
+    TAILQ_REMOVE(&g_os_run_list, t, t_os_list);
+}
+#else
+static void
+os_sched_run_list_insert(struct os_task *t)
+{
+    struct os_task *entry;
+
+    TAILQ_FOREACH(entry, &g_os_run_list, t_os_list) {
+        if (t->t_prio < entry->t_prio) {
+            break;
+        }
+    }
+    if (entry) {
+        TAILQ_INSERT_BEFORE(entry, t, t_os_list);
+    } else {
+        TAILQ_INSERT_TAIL(&g_os_run_list, t, t_os_list);
+    }
+}
+
+static void
+os_sched_run_list_remove(struct os_task *t)
+{
+    TAILQ_REMOVE(&g_os_run_list, t, t_os_list);
+}
+#endif
+
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+#define OS_SCHED_SLEEP_HEAP_SIZE    MYNEWT_VAL(OS_SCHED_SLEEP_HEAP_SIZE)
+
+#if OS_SCHED_SLEEP_HEAP_SIZE > 255
+#error "OS_SCHED_SLEEP_HEAP_SIZE must not exceed 255"
+#endif
+
+/*
+ * Tasks sleeping with a timeout are kept in a binary min-heap ordered by
+ * wakeup time, which makes putting a task to sleep and waking it up
+ * O(log n).  Tasks sleeping forever are kept unordered in g_os_sleep_list.
+ */
+static struct os_task *os_sched_sleep_heap[OS_SCHED_SLEEP_HEAP_SIZE];
+static uint8_t os_sched_sleep_heap_cnt;
+
+static void
+os_sched_sleep_heap_set(int idx, struct os_task *t)
+{
+    os_sched_sleep_heap[idx] = t;
+    t->t_sleep_idx = idx;
+}
+
+static void
+os_sched_sleep_heap_up(int idx)
+{
+    struct os_task *t;
+    int parent;
+
+    t = os_sched_sleep_heap[idx];
+    while (idx > 0) {
+        parent = (idx - 1) / 2;
+        if (!OS_TIME_TICK_LT(t->t_next_wakeup,
+                             os_sched_sleep_heap[parent]->t_next_wakeup)) {
+            break;
+        }
+        os_sched_sleep_heap_set(idx, os_sched_sleep_heap[parent]);
+        idx = parent;
+    }
+    os_sched_sleep_heap_set(idx, t);
+}
+
+static void
+os_sched_sleep_heap_down(int idx)
+{
+    struct os_task *t;
+    int child;
+
+    t = os_sched_sleep_heap[idx];
+    while (1) {
+        child = 2 * idx + 1;
+        if (child >= os_sched_sleep_heap_cnt) {
+            break;
+        }
+        if (child + 1 < os_sched_sleep_heap_cnt &&
+            OS_TIME_TICK_LT(os_sched_sleep_heap[child + 1]->t_next_wakeup,
+                            os_sched_sleep_heap[child]->t_next_wakeup)) {
+            child++;
+        }
+        if (!OS_TIME_TICK_LT(os_sched_sleep_heap[child]->t_next_wakeup,
+                             t->t_next_wakeup)) {
+            break;
+        }
+        os_sched_sleep_heap_set(idx, os_sched_sleep_heap[child]);
+        idx = child;
+    }
+    os_sched_sleep_heap_set(idx, t);
+}
+
+static void
+os_sched_sleep_list_insert(struct os_task *t)
+{
+    assert(os_sched_sleep_heap_cnt < OS_SCHED_SLEEP_HEAP_SIZE);
+
+    os_sched_sleep_heap_set(os_sched_sleep_heap_cnt, t);
+    os_sched_sleep_heap_cnt++;
+    os_sched_sleep_heap_up(t->t_sleep_idx);
+}
+
+static void
+os_sched_sleep_list_remove(struct os_task *t)
+{
+    struct os_task *last;
+    int idx;
+
+    if (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT) {
+        TAILQ_REMOVE(&g_os_sleep_list, t, t_os_list);
+        return;
+    }
+
+    idx = t->t_sleep_idx;
+    os_sched_sleep_heap_cnt--;
+    if (idx == os_sched_sleep_heap_cnt) {
+        return;
+    }
+
+    /* Fill the hole with the last entry and restore the heap order. */
+    last = os_sched_sleep_heap[os_sched_sleep_heap_cnt];
+    os_sched_sleep_heap_set(idx, last);
+    if (idx > 0 &&
+        OS_TIME_TICK_LT(last->t_next_wakeup,
+                        os_sched_sleep_heap[(idx - 1) / 2]->t_next_wakeup)) {
+        os_sched_sleep_heap_up(idx);
+    } else {
+        os_sched_sleep_heap_down(idx);
+    }
+}
+
+static struct os_task *
+os_sched_sleep_list_first(void)
+{
+    if (os_sched_sleep_heap_cnt == 0) {
+        return NULL;
+    }
+    return os_sched_sleep_heap[0];
+}
+#else
+/*
+ * Tasks sleeping with a timeout are at the head of the sleep list, sorted by
+ * wakeup time.  Tasks sleeping forever are at the tail.
+ */
+static void
+os_sched_sleep_list_insert(struct os_task *t)
+{
+    struct os_task *entry;
+
+    TAILQ_FOREACH(entry, &g_os_sleep_list, t_os_list) {
+        if ((entry->t_flags & OS_TASK_FLAG_NO_TIMEOUT) ||
+                OS_TIME_TICK_GT(entry->t_next_wakeup, t->t_next_wakeup)) {
+            break;
+        }
+    }
+    if (entry) {
+        TAILQ_INSERT_BEFORE(entry, t, t_os_list);
+    } else {
+        TAILQ_INSERT_TAIL(&g_os_sleep_list, t, t_os_list);
+    }
+}
+
+static void
+os_sched_sleep_list_remove(struct os_task *t)
+{
+    TAILQ_REMOVE(&g_os_sleep_list, t, t_os_list);
+}
+
+static struct os_task *
+os_sched_sleep_list_first(void)
+{
+    struct os_task *t;
+
+    t = TAILQ_FIRST(&g_os_sleep_list);
+    if (t == NULL || (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT)) {
+        return NULL;
+    }
+    return t;
+}
+#endif
+
+/**
+ * os sched reset
+ *
+ * Empties the run and sleep lists. Used by the simulator when the OS gets
+ * reinitialized.
+ */
+void
+os_sched_reset(void)
+{
+    TAILQ_INIT(&g_os_run_list);
+    TAILQ_INIT(&g_os_sleep_list);
+#if MYNEWT_VAL(OS_SCHED_PRIO_BITMAP)
+    memset(os_sched_prio_map, 0, sizeof(os_sched_prio_map));
+    memset(os_sched_prio_last, 0, sizeof(os_sched_prio_last));
+#endif
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+    os_sched_sleep_heap_cnt = 0;
+#endif
+}
+
 /**
  * os sched insert
  *
@@ -43,7 +331,6 @@ os_time_t g_os_last_ctx_sw_time;
 os_error_t
 os_sched_insert(struct os_task *t)
 {
-    struct os_task *entry;
     os_sr_t sr;
     os_error_t rc;
 
@@ -52,18 +339,8 @@ os_sched_insert(struct os_task *t)
         goto err;
     }
 
-    entry = NULL;
     OS_ENTER_CRITICAL(sr);
-    TAILQ_FOREACH(entry, &g_os_run_list, t_os_list) {
-        if (t->t_prio < entry->t_prio) {
-            break;
-        }
-    }
-    if (entry) {
-        TAILQ_INSERT_BEFORE(entry, (struct os_task *) t, t_os_list);
-    } else {
-        TAILQ_INSERT_TAIL(&g_os_run_list, (struct os_task *) t, t_os_list);
-    }
+    os_sched_run_list_insert(t);
     OS_EXIT_CRITICAL(sr);
 
     return (0);
@@ -71,6 +348,58 @@ err:
     return (rc);
 }
 
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+void
+os_sched_run_stats_start(void)
+{
+    struct os_task *t;
+    uint32_t now;
+
+    now = os_cputime_get32();
+    STAILQ_FOREACH(t, &g_os_task_list, t_os_task_list) {
+        t->t_ready_time = now;
+    }
+    os_sched_last_ctx_sw_cputime = now;
+}
+
+/*
+ * Charges the time since the last context switch to the current task, and
+ * records how long the next task was kept waiting to run.
+ */
+static void
+os_sched_run_stats_ctx_sw(struct os_task *next_t)
+{
+    struct os_task *t;
+    uint32_t now;
+    uint32_t ticks;
+    uint32_t lat;
+    int bucket;
+
+    t = g_current_task;
+    now = os_cputime_get32();
+
+    ticks = now - os_sched_last_ctx_sw_cputime;
+    os_sched_last_ctx_sw_cputime = now;
+    if (t != NULL) {
+        t->t_cpu_time += ticks;
+        if (ticks > t->t_run_max) {
+            t->t_run_max = ticks;
+        }
+        if (t->t_state == OS_TASK_READY) {
+            /* Preempted; it is ready to run again right away. */
+            t->t_ready_time = now;
+        }
+    }
+
+    lat = os_cputime_ticks_to_usecs(now - next_t->t_ready_time) >> 4;
+    bucket = lat ? 32 - __builtin_clz(lat) : 0;
+    if (bucket >= OS_SCHED_LAT_BUCKETS) {
+        bucket = OS_SCHED_LAT_BUCKETS - 1;
+    }
+    next_t->t_lat_hist[bucket]++;
+}
+#endif
+
 void
 os_sched_ctx_sw_hook(struct os_task *next_t)
 {
@@ -82,6 +411,9 @@ os_sched_ctx_sw_hook(struct os_task *next_t)
     for (i = 0; i < MYNEWT_VAL(OS_CTX_SW_STACK_GUARD); i++) {
         assert(top[i] == OS_STACK_PATTERN);
     }
+#endif
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+    os_sched_run_stats_ctx_sw(next_t);
 #endif
     next_t->t_ctx_sw_cnt++;
     g_current_task->t_run_time += g_os_time - g_os_last_ctx_sw_time;
@@ -141,28 +473,14 @@ os_sched(struct os_task *next_t)
 int
 os_sched_sleep(struct os_task *t, os_time_t nticks)
 {
-    struct os_task *entry;
-
-    entry = NULL;
-
-    TAILQ_REMOVE(&g_os_run_list, t, t_os_list);
+    os_sched_run_list_remove(t);
     t->t_state = OS_TASK_SLEEP;
     t->t_next_wakeup = os_time_get() + nticks;
     if (nticks == OS_TIMEOUT_NEVER) {
         t->t_flags |= OS_TASK_FLAG_NO_TIMEOUT;
         TAILQ_INSERT_TAIL(&g_os_sleep_list, t, t_os_list);
     } else {
-        TAILQ_FOREACH(entry, &g_os_sleep_list, t_os_list) {
-            if ((entry->t_flags & OS_TASK_FLAG_NO_TIMEOUT) ||
-                    OS_TIME_TICK_GT(entry->t_next_wakeup, t->t_next_wakeup)) {
-                break;
-            }
-        }
-        if (entry) {
-            TAILQ_INSERT_BEFORE(entry, t, t_os_list);
-        } else {
-            TAILQ_INSERT_TAIL(&g_os_sleep_list, t, t_os_list);
-        }
+        os_sched_sleep_list_insert(t);
     }
 
     os_trace_task_stop_ready(t, OS_TASK_SLEEP);
@@ -187,9 +505,9 @@ os_sched_remove(struct os_task *t)
 {
 
     if (t->t_state == OS_TASK_SLEEP) {
-        TAILQ_REMOVE(&g_os_sleep_list, t, t_os_list);
+        os_sched_sleep_list_remove(t);
     } else if (t->t_state == OS_TASK_READY) {
-        TAILQ_REMOVE(&g_os_run_list, t, t_os_list);
+        os_sched_run_list_remove(t);
     }
     t->t_next_wakeup = 0;
     t->t_flags |= OS_TASK_FLAG_NO_TIMEOUT;
@@ -229,10 +547,13 @@ os_sched_wakeup(struct os_task *t)
     }
 
     /* Remove task from sleep list */
+    os_sched_sleep_list_remove(t);
     t->t_state = OS_TASK_READY;
     t->t_next_wakeup = 0;
     t->t_flags &= ~OS_TASK_FLAG_NO_TIMEOUT;
-    TAILQ_REMOVE(&g_os_sleep_list, t, t_os_list);
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+    t->t_ready_time = os_cputime_get32();
+#endif
     os_sched_insert(t);
 
     os_trace_task_start_ready(t);
@@ -253,7 +574,6 @@ void
 os_sched_os_timer_exp(void)
 {
     struct os_task *t;
-    struct os_task *next;
     os_time_t now;
     os_sr_t sr;
 
@@ -264,19 +584,12 @@ os_sched_os_timer_exp(void)
     /*
      * Wakeup any tasks that have their sleep timer expired
      */
-    t = TAILQ_FIRST(&g_os_sleep_list);
-    while (t) {
-        /* If task waiting forever, do not check next wakeup time */
-        if (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT) {
+    while (1) {
+        t = os_sched_sleep_list_first();
+        if (t == NULL || !OS_TIME_TICK_GEQ(now, t->t_next_wakeup)) {
             break;
         }
-        next = TAILQ_NEXT(t, t_os_list);
-        if (OS_TIME_TICK_GEQ(now, t->t_next_wakeup)) {
-            os_sched_wakeup(t);
-        } else {
-            break;
-        }
-        t = next;
+        os_sched_wakeup(t);
     }
 
     OS_EXIT_CRITICAL(sr);
@@ -294,8 +607,8 @@ os_sched_wakeup_ticks(os_time_t now)
 
     OS_ASSERT_CRITICAL();
 
-    t = TAILQ_FIRST(&g_os_sleep_list);
-    if (t == NULL || (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT)) {
+    t = os_sched_sleep_list_first();
+    if (t == NULL) {
         rt = OS_TIMEOUT_NEVER;
     } else if (OS_TIME_TICK_GEQ(t->t_next_wakeup, now)) {
         rt = t->t_next_wakeup - now;
@@ -339,7 +652,7 @@ void
 os_sched_resort(struct os_task *t)
 {
     if (t->t_state == OS_TASK_READY) {
-        TAILQ_REMOVE(&g_os_run_list, t, t_os_list);
+        os_sched_run_list_remove(t);
         os_sched_insert(t);
     }
 }
@@ -36,6 +36,17 @@ _clear_stack(os_stack_t *stack_bottom, int size)
     }
 }
 
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+static uint64_t
+os_task_cputime_to_usecs(uint64_t ticks)
+{
+    const uint32_t freq = MYNEWT_VAL(OS_CPUTIME_FREQ);
+
+    /* Split the conversion so that the multiplication cannot overflow. */
+    return (ticks / freq) * 1000000 + (ticks % freq) * 1000000 / freq;
+}
+#endif
+
 static inline uint8_t
 os_task_next_id(void)
 {
@@ -76,6 +87,12 @@ os_task_init(struct os_task *t, const char *name, os_task_func_t func,
     t->t_state = OS_TASK_READY;
     t->t_name = name;
     t->t_next_wakeup = 0;
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+    /* Tasks created before the OS starts are stamped in os_start(). */
+    if (os_started()) {
+        t->t_ready_time = os_cputime_get32();
+    }
+#endif
 
     rc = os_sanity_check_init(&t->t_sanity_check);
     if (rc != OS_OK) {
@@ -151,7 +168,8 @@ os_task_remove(struct os_task *t)
      * Disallow suspending tasks which are waiting on a lock
      */
     if (t->t_flags & (OS_TASK_FLAG_SEM_WAIT | OS_TASK_FLAG_MUTEX_WAIT |
-                                               OS_TASK_FLAG_EVQ_WAIT)) {
+                      OS_TASK_FLAG_EVQ_WAIT | OS_TASK_FLAG_MSGQ_WAIT |
+                      OS_TASK_FLAG_EVG_WAIT)) {
         return OS_EBUSY;
     }
 
@@ -209,6 +227,11 @@ os_task_info_get_next(const struct os_task *prev, struct os_task_info *oti)
     oti->oti_last_checkin = next->t_sanity_check.sc_checkin_last;
     oti->oti_next_checkin = next->t_sanity_check.sc_checkin_last +
         next->t_sanity_check.sc_checkin_itvl;
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+    oti->oti_cpu_time = os_task_cputime_to_usecs(next->t_cpu_time);
+    oti->oti_run_max = os_cputime_ticks_to_usecs(next->t_run_max);
+    memcpy(oti->oti_lat_hist, next->t_lat_hist, sizeof(oti->oti_lat_hist));
+#endif
     strncpy(oti->oti_name, next->t_name, sizeof(oti->oti_name));
 
     return (next);
@@ -335,8 +335,10 @@ os_time_ms_to_ticks(uint32_t ms, os_time_t *out_ticks)
 
     static_assert(OS_TICKS_PER_SEC <= UINT32_MAX,
                   "OS_TICKS_PER_SEC must be <= UINT32_MAX");
+    static_assert(OS_RECIP_SCALE_OK(OS_TICKS_PER_SEC, 1000),
+                  "OS_TICKS_PER_SEC too large");
 
-    ticks = ((uint64_t)ms * OS_TICKS_PER_SEC) / 1000;
+    ticks = OS_RECIP_SCALE(ms, OS_TICKS_PER_SEC, 1000);
     if (ticks > UINT32_MAX) {
         return OS_EINVAL;
     }
@@ -355,7 +357,7 @@ os_time_ticks_to_ms(os_time_t ticks, uint32_t *out_ms)
     return 0;
 #endif
 
-    ms = ((uint64_t)ticks * 1000) / OS_TICKS_PER_SEC;
+    ms = OS_RECIP_SCALE(ticks, 1000, OS_TICKS_PER_SEC);
     if (ms > UINT32_MAX) {
         return OS_EINVAL;
     }
@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "sim_test.h"
+
+/*
+ * The virtual time hal_timer counts one tick per read between OS ticks and
+ * catches up with OS time after a sleep.  It must never run backwards, and
+ * busy-waits on it must terminate.
+ */
+TEST_CASE_TASK(sim_test_case_cputime)
+{
+    uint32_t prev;
+    uint32_t now;
+    int i;
+
+    prev = os_cputime_get32();
+    for (i = 0; i < SIM_TEST_CPUTIME_ITERS; i++) {
+        switch (i % 4) {
+        case 1:
+            os_time_delay(i % 7);
+            break;
+        case 2:
+            os_cputime_delay_ticks(i % 50);
+            break;
+        case 3:
+            os_cputime_delay_usecs(100);
+            break;
+        default:
+            break;
+        }
+
+        now = os_cputime_get32();
+        TEST_ASSERT_FATAL(CPUTIME_GEQ(now, prev), "cputime went back %u -> %u",
+                          (unsigned)prev, (unsigned)now);
+        prev = now;
+    }
+}
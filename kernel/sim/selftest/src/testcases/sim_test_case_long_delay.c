@@ -0,0 +1,46 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <sys/time.h>
+#include "sim_test.h"
+
+/*
+ * With virtual time, the idle task jumps the OS clock to the next wakeup, so
+ * a long sleep finishes without waiting for the host clock.
+ */
+TEST_CASE_TASK(sim_test_case_long_delay)
+{
+    struct timeval start;
+    struct timeval end;
+    os_time_t t0;
+    os_time_t t1;
+
+    gettimeofday(&start, NULL);
+    t0 = os_time_get();
+
+    os_time_delay(SIM_TEST_LONG_DELAY);
+
+    t1 = os_time_get();
+    gettimeofday(&end, NULL);
+
+    TEST_ASSERT(t1 - t0 >= SIM_TEST_LONG_DELAY, "slept %u ticks",
+                (unsigned)(t1 - t0));
+    TEST_ASSERT(end.tv_sec - start.tv_sec < SIM_TEST_MAX_WALL_SECS,
+                "took %ld host seconds", (long)(end.tv_sec - start.tv_sec));
+}
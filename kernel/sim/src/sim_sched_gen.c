@@ -76,6 +76,7 @@ sim_switch_tasks(void)
     os_sched_ctx_sw_hook(next_t);
 
     os_sched_set_current_task(next_t);
+    os_trace_task_start_exec(next_t);
 
     sf = (struct stack_frame *) next_t->t_stackptr;
     sim_longjmp(sf->sf_jb, 1);
@@ -92,6 +93,9 @@ sim_tick(void)
 
     OS_ASSERT_CRITICAL();
 
+    /* The tick signal plays the part of the timer interrupt. */
+    os_trace_isr_enter();
+
     if (!time_inited) {
         gettimeofday(&time_last, NULL);
         time_inited = 1;
@@ -119,8 +123,26 @@ sim_tick(void)
 
         os_time_advance(ticks);
     }
+
+    os_trace_isr_exit();
 }
 
+#if MYNEWT_VAL(MCU_NATIVE_VIRTUAL_TIME)
+/*
+ * In virtual time the tick timer is never started; OS time only moves here.
+ * Only the idle task is runnable, so nothing can happen before the next
+ * scheduled wakeup: jump straight to it.
+ */
+void
+sim_tick_idle(os_time_t ticks)
+{
+    OS_ASSERT_CRITICAL();
+
+    os_trace_isr_enter();
+    os_time_advance(ticks > 0 ? ticks : 1);
+    os_trace_isr_exit();
+}
+#else
 static void
 sim_start_timer(void)
 {
@@ -136,6 +158,7 @@ sim_start_timer(void)
     rc = setitimer(ITIMER_REAL, &it, NULL);
     assert(rc == 0);
 }
+#endif
 
 static void
 sim_stop_timer(void)
@@ -203,10 +226,13 @@ sim_os_start(void)
     assert(sr == 0);
 
     /* Enable the interrupt sources */
+#if !MYNEWT_VAL(MCU_NATIVE_VIRTUAL_TIME)
     sim_start_timer();
+#endif
 
     t = os_sched_next_task();
     os_sched_set_current_task(t);
+    os_trace_task_start_exec(t);
 
     g_os_started = 1;
 
@@ -235,8 +261,7 @@ sim_os_init(void)
     g_current_task = NULL;
 
     STAILQ_INIT(&g_os_task_list);
-    TAILQ_INIT(&g_os_run_list);
-    TAILQ_INIT(&g_os_sleep_list);
+    os_sched_reset();
 
     sim_signals_init();
 
@@ -112,6 +112,7 @@ sim_in_critical(void)
     return !interrupts_enabled;
 }
 
+#if !MYNEWT_VAL(MCU_NATIVE_VIRTUAL_TIME)
 /**
  * Unblocks the SIGALRM signal that is delivered by the OS tick timer.
  */
@@ -127,6 +128,7 @@ unblock_timer(void)
     rc = sigprocmask(SIG_UNBLOCK, &sigs, NULL);
     assert(rc == 0);
 }
+#endif
 
 /**
  * Blocks the SIGALRM signal that is delivered by the OS tick timer.
@@ -151,6 +153,7 @@ sig_handler_alrm(int sig)
     sigaddset(&suspsigs, sig);
 }
 
+#if !MYNEWT_VAL(MCU_NATIVE_VIRTUAL_TIME)
 void
 sim_tick_idle(os_time_t ticks)
 {
@@ -200,6 +203,7 @@ sim_tick_idle(os_time_t ticks)
         assert(rc == 0);
     }
 }
+#endif
 
 void
 sim_signals_init(void)
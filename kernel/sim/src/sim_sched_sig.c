@@ -162,6 +162,7 @@ static struct {
 
 #define NUMSIGS     (sizeof(signals)/sizeof(signals[0]))
 
+#if !MYNEWT_VAL(MCU_NATIVE_VIRTUAL_TIME)
 void
 sim_tick_idle(os_time_t ticks)
 {
@@ -217,6 +218,7 @@ sim_tick_idle(os_time_t ticks)
         assert(rc == 0);
     }
 }
+#endif
 
 void
 sim_signals_init(void)
@@ -45,6 +45,10 @@ __extern void *realloc(void *, size_t);
 __extern void add_malloc_block(void *, size_t);
 __extern void get_malloc_memory_status(size_t *, size_t *);
 
+/* Only available with the TLSF allocator (BASELIBC_MALLOC_TLSF). */
+struct tlsf_stats;
+__extern void get_malloc_tlsf_stats(struct tlsf_stats *);
+
 /* Malloc locking
  * Until the callbacks are set, malloc doesn't do any locking.
  * malloc_lock() *may* timeout, in which case malloc() will return NULL.
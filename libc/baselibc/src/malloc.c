@@ -4,6 +4,10 @@
  * Very simple linked-list based malloc()/free().
  */
 
+#include "syscfg/syscfg.h"
+
+#if !MYNEWT_VAL(BASELIBC_MALLOC_TLSF)
+
 #include <stdbool.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -274,3 +278,5 @@ void set_malloc_locking(malloc_lock_t lock, malloc_unlock_t unlock)
     else
         malloc_unlock = &malloc_unlock_nop;
 }
+
+#endif
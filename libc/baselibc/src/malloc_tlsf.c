@@ -0,0 +1,168 @@
+/*
+ * malloc_tlsf.c
+ *
+ * malloc()/free() backed by the TLSF allocator in util/tlsf; selected with
+ * BASELIBC_MALLOC_TLSF.  Unlike the first-fit allocator in malloc.c, the
+ * cost of every operation is bounded regardless of heap age.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(BASELIBC_MALLOC_TLSF)
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tlsf/tlsf.h"
+
+static struct tlsf malloc_tlsf;
+static bool malloc_tlsf_ready;
+
+static bool malloc_lock_nop() {return true;}
+static void malloc_unlock_nop() {}
+
+static malloc_lock_t malloc_lock = &malloc_lock_nop;
+static malloc_unlock_t malloc_unlock = &malloc_unlock_nop;
+
+static void malloc_tlsf_init(void)
+{
+    if (!malloc_tlsf_ready) {
+        tlsf_init(&malloc_tlsf);
+        malloc_tlsf_ready = true;
+    }
+}
+
+/* Grows the heap with _sbrk() so that an allocation of size can succeed.
+   Consecutive _sbrk() regions are joined by tlsf_add_pool(). */
+static bool malloc_tlsf_grow(size_t size)
+{
+    extern void *_sbrk(int incr);
+    void *more_mem;
+    size_t incr;
+
+    incr = tlsf_pool_size_for(size);
+    if (incr == 0 || incr > INT32_MAX)
+        return false;
+
+    more_mem = _sbrk(incr);
+    if (more_mem == (void *)-1)
+        return false;
+
+    return tlsf_add_pool(&malloc_tlsf, more_mem, incr) == 0;
+}
+
+void *malloc(size_t size)
+{
+    void *result;
+
+    if (size == 0)
+        return NULL;
+
+    if (!malloc_lock())
+        return NULL;
+
+    malloc_tlsf_init();
+    result = tlsf_malloc(&malloc_tlsf, size);
+    if (result == NULL && malloc_tlsf_grow(size))
+        result = tlsf_malloc(&malloc_tlsf, size);
+
+    malloc_unlock();
+    return result;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    void *newptr;
+
+    if (!ptr)
+        return malloc(size);
+
+    if (size == 0) {
+        free(ptr);
+        return NULL;
+    }
+
+    if (!malloc_lock())
+        return NULL;
+
+    newptr = tlsf_realloc(&malloc_tlsf, ptr, size);
+    malloc_unlock();
+
+    if (newptr == NULL) {
+        /* Out of memory in place; let malloc() grow the heap. */
+        newptr = malloc(size);
+        if (newptr) {
+            memcpy(newptr, ptr, tlsf_block_size(ptr));
+            free(ptr);
+        }
+    }
+    return newptr;
+}
+
+void free(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    if (!malloc_lock())
+        return;
+
+    tlsf_free(&malloc_tlsf, ptr);
+    malloc_unlock();
+}
+
+/* Call this to give malloc some memory to allocate from */
+void add_malloc_block(void *buf, size_t size)
+{
+    if (!malloc_lock())
+        return;
+
+    malloc_tlsf_init();
+    tlsf_add_pool(&malloc_tlsf, buf, size);
+    malloc_unlock();
+}
+
+void get_malloc_memory_status(size_t *free_bytes, size_t *largest_block)
+{
+    struct tlsf_stats stats;
+
+    *free_bytes = 0;
+    *largest_block = 0;
+
+    if (!malloc_lock())
+        return;
+
+    malloc_tlsf_init();
+    tlsf_stats(&malloc_tlsf, &stats);
+    malloc_unlock();
+
+    *free_bytes = stats.ts_free_bytes;
+    *largest_block = stats.ts_largest_free;
+}
+
+void get_malloc_tlsf_stats(struct tlsf_stats *stats)
+{
+    memset(stats, 0, sizeof *stats);
+
+    if (!malloc_lock())
+        return;
+
+    malloc_tlsf_init();
+    tlsf_stats(&malloc_tlsf, stats);
+    malloc_unlock();
+}
+
+void set_malloc_locking(malloc_lock_t lock, malloc_unlock_t unlock)
+{
+    if (lock)
+        malloc_lock = lock;
+    else
+        malloc_lock = &malloc_lock_nop;
+
+    if (unlock)
+        malloc_unlock = unlock;
+    else
+        malloc_unlock = &malloc_unlock_nop;
+}
+
+#endif
@@ -2,6 +2,10 @@
  * realloc.c
  */
 
+#include "syscfg/syscfg.h"
+
+#if !MYNEWT_VAL(BASELIBC_MALLOC_TLSF)
+
 #include <stdlib.h>
 #include <string.h>
 
@@ -49,3 +53,5 @@ void *realloc(void *ptr, size_t size)
 		return newptr;
 	}
 }
+
+#endif
@@ -147,6 +147,10 @@ nmgr_def_taskstat_read(struct mgmt_cbuf *cb)
     CborError g_err = CborNoError;
     CborEncoder tasks;
     CborEncoder task;
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+    CborEncoder hist;
+    int i;
+#endif
 
     g_err |= cbor_encode_text_stringz(&cb->encoder, "rc");
     g_err |= cbor_encode_int(&cb->encoder, MGMT_ERR_EOK);
@@ -181,6 +185,19 @@ nmgr_def_taskstat_read(struct mgmt_cbuf *cb)
         g_err |= cbor_encode_uint(&task, oti.oti_last_checkin);
         g_err |= cbor_encode_text_stringz(&task, "next_checkin");
         g_err |= cbor_encode_uint(&task, oti.oti_next_checkin);
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+        g_err |= cbor_encode_text_stringz(&task, "cputime");
+        g_err |= cbor_encode_uint(&task, oti.oti_cpu_time);
+        g_err |= cbor_encode_text_stringz(&task, "runmax");
+        g_err |= cbor_encode_uint(&task, oti.oti_run_max);
+        g_err |= cbor_encode_text_stringz(&task, "latency");
+        g_err |= cbor_encoder_create_array(
+            &task, &hist, MYNEWT_VAL(OS_TASK_RUN_STATS_LAT_BUCKETS));
+        for (i = 0; i < MYNEWT_VAL(OS_TASK_RUN_STATS_LAT_BUCKETS); i++) {
+            g_err |= cbor_encode_uint(&hist, oti.oti_lat_hist[i]);
+        }
+        g_err |= cbor_encoder_close_container(&task, &hist);
+#endif
         g_err |= cbor_encoder_close_container(&tasks, &task);
     }
     g_err |= cbor_encoder_close_container(&cb->encoder, &tasks);
@@ -76,6 +76,7 @@ nmgr_uart_out(struct nmgr_transport *nt, struct os_mbuf *m)
 {
     struct nmgr_uart_state *nus = (struct nmgr_uart_state *)nt;
     struct os_mbuf_pkthdr *mpkt;
+    struct os_mbuf_cursor omc;
     struct os_mbuf *n;
     uint16_t tmp_buf[6];
     char *dst;
@@ -95,15 +96,14 @@ nmgr_uart_out(struct nmgr_transport *nt, struct os_mbuf *m)
      */
     off = 0;
     tmp_buf[0] = CRC16_INITIAL_CRC;
-    for (n = m; n; n = SLIST_NEXT(n, om_next)) {
-        tmp_buf[0] = crc16_ccitt(tmp_buf[0], n->om_data, n->om_len);
-    }
+    crc16_ccitt_mbuf(&tmp_buf[0], m, 0, mpkt->omp_len);
     tmp_buf[0] = htons(tmp_buf[0]);
     dst = os_mbuf_extend(m, sizeof(uint16_t));
     if (!dst) {
         goto err;
     }
     memcpy(dst, tmp_buf, sizeof(uint16_t));
+    os_mbuf_cursor_init(&omc, m);
 
     /*
      * Create another mbuf chain with base64 encoded data.
@@ -146,7 +146,7 @@ nmgr_uart_out(struct nmgr_transport *nt, struct os_mbuf *m)
             if (tx_sz + BASE64_ENCODE_SIZE(slen + boff) >= 124) {
                 break;
             }
-            rc = os_mbuf_copydata(m, off, slen, (uint8_t *)tmp_buf + boff);
+            rc = os_mbuf_cursor_read(&omc, (uint8_t *)tmp_buf + boff, slen);
             assert(rc == 0);
 
             off += slen;
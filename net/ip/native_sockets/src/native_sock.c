@@ -18,6 +18,7 @@
  */
 
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <errno.h>
 #include <netinet/in.h>
@@ -446,27 +447,45 @@ static int
 native_sock_stream_tx(struct native_sock *ns, int notify)
 {
     struct native_sock_state *nss = &native_sock_state;
+    struct os_mbuf_iov omi[MYNEWT_VAL(NATIVE_SOCKETS_MAX_IOV)];
+    struct iovec iov[MYNEWT_VAL(NATIVE_SOCKETS_MAX_IOV)];
     struct os_mbuf *m;
     struct os_mbuf *n;
+    int iov_cnt;
+    int i;
     int rc;
 
     rc = 0;
 
     os_mutex_pend(&nss->mtx, OS_TIMEOUT_NEVER);
     while (ns->ns_tx && rc == 0) {
-        m = ns->ns_tx;
-        n = SLIST_NEXT(m, om_next);
+        /* Hand as many mbufs as possible to the host in one call.  If the
+         * chain is longer than the iovec array, the rest goes out on the
+         * next iteration.
+         */
+        iov_cnt = MYNEWT_VAL(NATIVE_SOCKETS_MAX_IOV);
+        os_mbuf_to_iov(ns->ns_tx, 0, os_mbuf_len(ns->ns_tx), omi, &iov_cnt);
+        for (i = 0; i < iov_cnt; i++) {
+            iov[i].iov_base = omi[i].omi_base;
+            iov[i].iov_len = omi[i].omi_len;
+        }
 
         errno = 0;
-        rc = write(ns->ns_fd, m->om_data, m->om_len);
-        if (rc == m->om_len) {
-            /* Complete write. */
-            ns->ns_tx = n;
-            os_mbuf_free(m);
-            rc = 0;
-        } else if (rc != -1) {
-            /* Partial write. */
-            os_mbuf_adj(m, m->om_len - rc);
+        rc = writev(ns->ns_fd, iov, iov_cnt);
+        if (rc != -1) {
+            /* Free the mbufs that were written completely and trim the
+             * partially written one, if any.
+             */
+            while (ns->ns_tx && ns->ns_tx->om_len <= rc) {
+                m = ns->ns_tx;
+                n = SLIST_NEXT(m, om_next);
+                rc -= m->om_len;
+                ns->ns_tx = n;
+                os_mbuf_free(m);
+            }
+            if (rc > 0) {
+                os_mbuf_adj(ns->ns_tx, rc);
+            }
             rc = 0;
         } else {
             /* Error. */
@@ -517,9 +536,13 @@ native_sock_sendto(struct mn_socket *s, struct os_mbuf *m,
     struct sockaddr_storage ss;
     struct sockaddr *sa = (struct sockaddr *)&ss;
     uint8_t tmpbuf[MYNEWT_VAL(NATIVE_SOCKETS_MAX_UDP)];
-    struct os_mbuf *o;
+    struct os_mbuf_iov omi[MYNEWT_VAL(NATIVE_SOCKETS_MAX_IOV)];
+    struct iovec iov[MYNEWT_VAL(NATIVE_SOCKETS_MAX_IOV)];
+    struct msghdr msg;
+    int iov_cnt;
     int sa_len;
-    int off;
+    int len;
+    int i;
     int rc;
 
     if (ns->ns_type == SOCK_DGRAM) {
@@ -527,16 +550,35 @@ native_sock_sendto(struct mn_socket *s, struct os_mbuf *m,
         if (rc) {
             return rc;
         }
-        off = 0;
-        for (o = m; o; o = SLIST_NEXT(o, om_next)) {
-            if (off + o->om_len > sizeof(tmpbuf)) {
-                return MN_ENOBUFS;
+        len = os_mbuf_len(m);
+        if (len > sizeof(tmpbuf)) {
+            return MN_ENOBUFS;
+        }
+
+        /* Send straight out of the mbufs; only a datagram scattered over
+         * more mbufs than fit in the iovec array needs to be flattened.
+         */
+        iov_cnt = MYNEWT_VAL(NATIVE_SOCKETS_MAX_IOV);
+        rc = os_mbuf_to_iov(m, 0, len, omi, &iov_cnt);
+        if (rc == 0) {
+            for (i = 0; i < iov_cnt; i++) {
+                iov[i].iov_base = omi[i].omi_base;
+                iov[i].iov_len = omi[i].omi_len;
             }
-            os_mbuf_copydata(o, 0, o->om_len, &tmpbuf[off]);
-            off += o->om_len;
+        } else {
+            os_mbuf_copydata(m, 0, len, tmpbuf);
+            iov[0].iov_base = tmpbuf;
+            iov[0].iov_len = len;
+            iov_cnt = 1;
         }
-        rc = sendto(ns->ns_fd, tmpbuf, off, 0, sa, sa_len);
-        if (rc != off) {
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = sa;
+        msg.msg_namelen = sa_len;
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iov_cnt;
+        rc = sendmsg(ns->ns_fd, &msg, 0);
+        if (rc != len) {
             return native_sock_err_to_mn_err(errno);
         }
         os_mbuf_free_chain(m);
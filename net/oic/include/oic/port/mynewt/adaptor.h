@@ -20,6 +20,8 @@
 #ifndef ADAPTOR_H
 #define ADAPTOR_H
 
+#include "os/mynewt.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -28,6 +30,21 @@ struct os_eventq *oc_evq_get(void);
 
 void oc_conn_init(void);
 
+/*
+ * Returns a copy of an outgoing message, used to send the same message on
+ * several interfaces or transports.  With OS_MBUF_SHARE the copy refers to
+ * the original data instead of duplicating it.
+ */
+static inline struct os_mbuf *
+oc_mbuf_fanout_copy(struct os_mbuf *m)
+{
+#if MYNEWT_VAL(OS_MBUF_SHARE)
+    return os_mbuf_share(m->om_omp, m);
+#else
+    return os_mbuf_dup(m);
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -81,7 +81,7 @@ coap_log_2(uint16_t value)
 }
 /*---------------------------------------------------------------------------*/
 static uint32_t
-coap_parse_int_option(struct os_mbuf *m, uint16_t off, size_t length)
+coap_parse_int_option(const struct os_mbuf_cursor *omc, size_t length)
 {
     uint8_t bytes[4];
     uint32_t var = 0;
@@ -90,7 +90,7 @@ coap_parse_int_option(struct os_mbuf *m, uint16_t off, size_t length)
     if (length >= 4) {
         return -1;
     }
-    if (os_mbuf_copydata(m, off, length, bytes)) {
+    if (os_mbuf_cursor_peek(omc, bytes, length)) {
         return -1;
     }
     while (i < length) {
@@ -560,6 +560,7 @@ coap_parse_message(struct coap_packet_rx *pkt, struct os_mbuf **mp)
         struct coap_tcp_hdr16 c16;
         struct coap_tcp_hdr32 c32;
     } cth;
+    struct os_mbuf_cursor omc;
     uint8_t tmp[4];
     uint16_t cur_opt;
     unsigned int opt_num = 0;
@@ -663,7 +664,13 @@ err_short:
         return BAD_REQUEST_4_00;
     }
 
-    if (os_mbuf_copydata(m, cur_opt, pkt->token_len, pkt->token)) {
+    /*
+     * Options are parsed front to back; the cursor tracks cur_opt so that
+     * long packets are not walked from the head for every option.
+     */
+    os_mbuf_cursor_init(&omc, m);
+    if (os_mbuf_cursor_seek(&omc, cur_opt) ||
+        os_mbuf_cursor_read(&omc, pkt->token, pkt->token_len)) {
         goto err_short;
     }
     cur_opt += pkt->token_len;
@@ -677,7 +684,7 @@ err_short:
     while (cur_opt < OS_MBUF_PKTLEN(m)) {
         /* payload marker 0xFF, currently only checking for 0xF* because rest is
          * reserved */
-        if (os_mbuf_copydata(m, cur_opt, 1, tmp)) {
+        if (os_mbuf_cursor_read(&omc, tmp, 1)) {
             goto err_short;
         }
         if ((tmp[0] & 0xF0) == 0xF0) {
@@ -696,13 +703,13 @@ err_short:
         ++cur_opt;
 
         if (opt_delta == 13) {
-            if (os_mbuf_copydata(m, cur_opt, 1, tmp)) {
+            if (os_mbuf_cursor_read(&omc, tmp, 1)) {
                 goto err_short;
             }
             opt_delta += tmp[0];
             ++cur_opt;
         } else if (opt_delta == 14) {
-            if (os_mbuf_copydata(m, cur_opt, 2, tmp)) {
+            if (os_mbuf_cursor_read(&omc, tmp, 2)) {
                 goto err_short;
             }
             opt_delta += (255 + (tmp[0] << 8) + tmp[1]);
@@ -710,13 +717,13 @@ err_short:
         }
 
         if (opt_len == 13) {
-            if (os_mbuf_copydata(m, cur_opt, 1, tmp)) {
+            if (os_mbuf_cursor_read(&omc, tmp, 1)) {
                 goto err_short;
             }
             opt_len += tmp[0];
             ++cur_opt;
         } else if (opt_len == 14) {
-            if (os_mbuf_copydata(m, cur_opt, 2, tmp)) {
+            if (os_mbuf_cursor_read(&omc, tmp, 2)) {
                 goto err_short;
             }
             opt_len += (255 + (tmp[0] << 8) + tmp[1]);
@@ -733,11 +740,11 @@ err_short:
 
         switch (opt_num) {
         case COAP_OPTION_CONTENT_FORMAT:
-            pkt->content_format = coap_parse_int_option(m, cur_opt, opt_len);
+            pkt->content_format = coap_parse_int_option(&omc, opt_len);
             OC_LOG(DEBUG, "Content-Format [%u]\n", pkt->content_format);
             break;
         case COAP_OPTION_MAX_AGE:
-            pkt->max_age = coap_parse_int_option(m, cur_opt, opt_len);
+            pkt->max_age = coap_parse_int_option(&omc, opt_len);
             OC_LOG(DEBUG, "Max-Age [%lu]\n", (unsigned long)pkt->max_age);
             break;
 #if 0
@@ -751,7 +758,7 @@ err_short:
             break;
 #endif
         case COAP_OPTION_ACCEPT:
-            pkt->accept = coap_parse_int_option(m, cur_opt, opt_len);
+            pkt->accept = coap_parse_int_option(&omc, opt_len);
             OC_LOG(DEBUG, "Accept [%u]\n", pkt->accept);
             break;
 #if 0
@@ -801,7 +808,7 @@ err_short:
                             pkt->uri_host_len);
             break;
         case COAP_OPTION_URI_PORT:
-            pkt->uri_port = coap_parse_int_option(m, cur_opt, opt_len);
+            pkt->uri_port = coap_parse_int_option(&omc, opt_len);
             OC_LOG(DEBUG, "Uri-Port [%u]\n", pkt->uri_port);
             break;
 #endif
@@ -840,11 +847,11 @@ err_short:
             break;
 #endif
         case COAP_OPTION_OBSERVE:
-            pkt->observe = coap_parse_int_option(m, cur_opt, opt_len);
+            pkt->observe = coap_parse_int_option(&omc, opt_len);
             OC_LOG(DEBUG, "Observe [%lu]\n", (unsigned long)pkt->observe);
             break;
         case COAP_OPTION_BLOCK2:
-            pkt->block2_num = coap_parse_int_option(m, cur_opt, opt_len);
+            pkt->block2_num = coap_parse_int_option(&omc, opt_len);
             pkt->block2_more = (pkt->block2_num & 0x08) >> 3;
             pkt->block2_size = 16 << (pkt->block2_num & 0x07);
             pkt->block2_offset =
@@ -855,7 +862,7 @@ err_short:
                          pkt->block2_more ? "+" : "", pkt->block2_size);
             break;
         case COAP_OPTION_BLOCK1:
-            pkt->block1_num = coap_parse_int_option(m, cur_opt, opt_len);
+            pkt->block1_num = coap_parse_int_option(&omc, opt_len);
             pkt->block1_more = (pkt->block1_num & 0x08) >> 3;
             pkt->block1_size = 16 << (pkt->block1_num & 0x07);
             pkt->block1_offset =
@@ -866,11 +873,11 @@ err_short:
                          pkt->block1_more ? "+" : "", pkt->block1_size);
             break;
         case COAP_OPTION_SIZE2:
-            pkt->size2 = coap_parse_int_option(m, cur_opt, opt_len);
+            pkt->size2 = coap_parse_int_option(&omc, opt_len);
             OC_LOG(DEBUG, "Size2 [%lu]\n", (unsigned long)pkt->size2);
             break;
         case COAP_OPTION_SIZE1:
-            pkt->size1 = coap_parse_int_option(m, cur_opt, opt_len);
+            pkt->size1 = coap_parse_int_option(&omc, opt_len);
             OC_LOG(DEBUG, "Size1 [%lu]\n", (unsigned long)pkt->size1);
             break;
         default:
@@ -882,6 +889,10 @@ err_short:
                 return BAD_OPTION_4_02;
             }
         }
+        if (os_mbuf_cursor_advance(&omc, opt_len)) {
+            /* Option runs past the end of the packet; nothing left. */
+            break;
+        }
         cur_opt += opt_len;
     } /* for */
 
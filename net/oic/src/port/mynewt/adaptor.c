@@ -120,7 +120,7 @@ oc_send_multicast_message(struct os_mbuf *m)
 
         ot = oc_transports[i];
         if (prev) {
-            n = os_mbuf_dup(m);
+            n = oc_mbuf_fanout_copy(m);
             prev->ot_tx_mcast(m);
             if (!n) {
                 return;
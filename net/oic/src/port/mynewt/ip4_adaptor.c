@@ -156,7 +156,7 @@ oc_send_buffer_ip4_int(struct os_mbuf *m, int is_mcast)
                 STATS_INC(oc_ip4_stats, oerr);
                 continue;
             }
-            n = os_mbuf_dup(m);
+            n = oc_mbuf_fanout_copy(m);
             if (!n) {
                 STATS_INC(oc_ip4_stats, oerr);
                 break;
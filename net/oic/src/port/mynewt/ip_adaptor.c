@@ -157,7 +157,7 @@ oc_send_buffer_ip6_int(struct os_mbuf *m, int is_mcast)
                 continue;
             }
 
-            n = os_mbuf_dup(m);
+            n = oc_mbuf_fanout_copy(m);
             if (!n) {
                 STATS_INC(oc_ip_stats, oerr);
                 break;
@@ -87,6 +87,22 @@ int flash_area_write(const struct flash_area *, uint32_t off, const void *src,
   uint32_t len);
 int flash_area_erase(const struct flash_area *, uint32_t off, uint32_t len);
 
+/*
+ * Writes a list of buffers, e.g. an mbuf chain described with
+ * os_mbuf_to_iov(), to consecutive locations starting at off.  Data is
+ * written directly from the buffers; only bytes straddling a buffer boundary
+ * within one flash write unit are gathered into a small bounce buffer, so
+ * the buffers need not be multiples of flash_area_align().
+ *
+ * Returns SYS_ENOTSUP if the flash write unit exceeds
+ * FLASH_AREA_WRITEV_MAX_ALIGN.
+ */
+#define FLASH_AREA_WRITEV_MAX_ALIGN     32
+
+struct os_mbuf_iov;
+int flash_area_writev(const struct flash_area *, uint32_t off,
+  const struct os_mbuf_iov *iov, int iov_cnt);
+
 /*
  * Whether the whole area is empty.
  */
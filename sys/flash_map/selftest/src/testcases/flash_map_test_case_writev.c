@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "flash_map_test.h"
+
+/* Segment lengths of one flash_area_writev() call */
+struct flash_map_test_writev {
+    int cnt;
+    int lens[8];
+};
+
+/*
+ * Splits chosen around the flash write unit: segments shorter than a unit,
+ * segments completing a unit gathered from several buffers, whole units,
+ * empty segments and a partial unit at the end.
+ */
+#define A   MYNEWT_VAL(MCU_FLASH_MIN_WRITE_SIZE)
+static const struct flash_map_test_writev flash_map_test_writevs[] = {
+    { 1, { 1 } },
+    { 1, { A } },
+    { 2, { A - 1, 1 } },
+    { 3, { A - 1, 2, A - 1 } },
+    { 5, { 1, 1, 1, A, 3 } },
+    { 3, { A + 1, A - 1, 2 * A } },
+    { 5, { 3, 0, A, 0, 5 } },
+    { 3, { 2 * A + 3, A / 2, A / 2 + 1 } },
+};
+#undef A
+
+static uint8_t flash_map_test_src[256];
+
+/*
+ * Test flash_area_writev()
+ */
+TEST_CASE_SELF(flash_map_test_case_writev)
+{
+    const struct flash_map_test_writev *w;
+    struct os_mbuf_iov iov[8];
+    const struct flash_area *fa;
+    uint8_t rd[sizeof flash_map_test_src + FLASH_AREA_WRITEV_MAX_ALIGN];
+    uint8_t align;
+    uint32_t total;
+    uint32_t off;
+    int rc;
+    int i;
+    int j;
+
+    rc = flash_area_open(FLASH_AREA_IMAGE_1, &fa);
+    TEST_ASSERT_FATAL(rc == 0, "flash_area_open() fail");
+
+    align = flash_area_align(fa);
+    TEST_ASSERT_FATAL(align <= FLASH_AREA_WRITEV_MAX_ALIGN);
+
+    rc = flash_area_erase(fa, 0, fa->fa_size);
+    TEST_ASSERT_FATAL(rc == 0, "flash_area_erase() fail");
+
+    for (i = 0; i < sizeof flash_map_test_src; i++) {
+        flash_map_test_src[i] = i;
+    }
+
+    off = 0;
+    for (i = 0; i < ARRAY_SIZE(flash_map_test_writevs); i++) {
+        w = &flash_map_test_writevs[i];
+
+        total = 0;
+        for (j = 0; j < w->cnt; j++) {
+            iov[j].omi_base = flash_map_test_src + total;
+            iov[j].omi_len = w->lens[j];
+            total += w->lens[j];
+        }
+        TEST_ASSERT_FATAL(total <= sizeof flash_map_test_src);
+
+        rc = flash_area_writev(fa, off, iov, w->cnt);
+        TEST_ASSERT_FATAL(rc == 0, "flash_area_writev() fail, case %d", i);
+
+        /* The data, then erased flash up to the next write unit. */
+        rc = flash_area_read(fa, off, rd, total + align);
+        TEST_ASSERT_FATAL(rc == 0, "flash_area_read() fail");
+        TEST_ASSERT(memcmp(rd, flash_map_test_src, total) == 0,
+                    "read data != write data, case %d", i);
+        for (j = total; j < total + align; j++) {
+            TEST_ASSERT(rd[j] == flash_area_erased_val(fa));
+        }
+
+        off += (total + align - 1) / align * align + align;
+    }
+
+    /* Writes past the end of the area are rejected. */
+    iov[0].omi_base = flash_map_test_src;
+    iov[0].omi_len = align;
+    rc = flash_area_writev(fa, fa->fa_size - align + 1, iov, 1);
+    TEST_ASSERT(rc != 0);
+}
@@ -0,0 +1,66 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "flash_map/flash_map.h"
+
+/*
+ * Test flash_area_writev() with a write unit larger than its bounce buffer
+ */
+TEST_CASE_SELF(flash_map_test_case_writev_align)
+{
+    const struct flash_area *fa;
+    struct os_mbuf_iov iov;
+    uint8_t wd[16];
+    uint8_t rd[16];
+    int rc;
+
+    rc = flash_area_open(FLASH_AREA_IMAGE_1, &fa);
+    TEST_ASSERT_FATAL(rc == 0, "flash_area_open() fail");
+    TEST_ASSERT_FATAL(flash_area_align(fa) > FLASH_AREA_WRITEV_MAX_ALIGN);
+
+    rc = flash_area_erase(fa, 0, fa->fa_size);
+    TEST_ASSERT_FATAL(rc == 0, "flash_area_erase() fail");
+
+    memset(wd, 0xa5, sizeof wd);
+    iov.omi_base = wd;
+    iov.omi_len = sizeof wd;
+    rc = flash_area_writev(fa, 0, &iov, 1);
+    TEST_ASSERT(rc == SYS_ENOTSUP);
+
+    /* Nothing was written. */
+    rc = flash_area_read(fa, 0, rd, sizeof rd);
+    TEST_ASSERT_FATAL(rc == 0, "flash_area_read() fail");
+    TEST_ASSERT(rd[0] == flash_area_erased_val(fa));
+}
+
+TEST_SUITE(flash_map_test_suite_unsupported_align)
+{
+    flash_map_test_case_writev_align();
+}
+
+int
+main(int argc, char **argv)
+{
+    flash_map_test_suite_unsupported_align();
+
+    return tu_any_failed;
+}
@@ -233,6 +233,85 @@ flash_area_write(const struct flash_area *fa, uint32_t off, const void *src,
                            (void *)src, len);
 }
 
+int
+flash_area_writev(const struct flash_area *fa, uint32_t off,
+    const struct os_mbuf_iov *iov, int iov_cnt)
+{
+    uint8_t buf[FLASH_AREA_WRITEV_MAX_ALIGN];
+    const uint8_t *src;
+    uint32_t total;
+    uint32_t chunk;
+    uint32_t len;
+    uint32_t addr;
+    uint8_t align;
+    int buf_len;
+    int rc;
+    int i;
+
+    total = 0;
+    for (i = 0; i < iov_cnt; i++) {
+        total += iov[i].omi_len;
+    }
+    if (off > fa->fa_size || off + total > fa->fa_size) {
+        return -1;
+    }
+
+    align = flash_area_align(fa);
+    if (align > sizeof(buf)) {
+        return SYS_ENOTSUP;
+    }
+    if (align == 0) {
+        align = 1;
+    }
+
+    addr = fa->fa_off + off;
+    buf_len = 0;
+    for (i = 0; i < iov_cnt; i++) {
+        src = iov[i].omi_base;
+        len = iov[i].omi_len;
+
+        /* Complete the write unit started by the previous buffers. */
+        if (buf_len > 0) {
+            chunk = min(len, align - buf_len);
+            memcpy(buf + buf_len, src, chunk);
+            buf_len += chunk;
+            src += chunk;
+            len -= chunk;
+            if (buf_len < align) {
+                continue;
+            }
+
+            rc = hal_flash_write(fa->fa_device_id, addr, buf, align);
+            if (rc != 0) {
+                return rc;
+            }
+            addr += align;
+            buf_len = 0;
+        }
+
+        /* Whole write units go straight from the buffer. */
+        chunk = len - len % align;
+        if (chunk > 0) {
+            rc = hal_flash_write(fa->fa_device_id, addr, src, chunk);
+            if (rc != 0) {
+                return rc;
+            }
+            addr += chunk;
+            src += chunk;
+            len -= chunk;
+        }
+
+        memcpy(buf, src, len);
+        buf_len = len;
+    }
+
+    if (buf_len > 0) {
+        return hal_flash_write(fa->fa_device_id, addr, buf, buf_len);
+    }
+
+    return 0;
+}
+
 int
 flash_area_erase(const struct flash_area *fa, uint32_t off, uint32_t len)
 {
@@ -30,6 +30,11 @@
 /* Assume the flash alignment requirement is no stricter than 8. */
 #define LOG_FCB_MAX_ALIGN   8
 
+/* Number of segments handed to flash at a time when writing an mbuf chain;
+ * must exceed LOG_FCB_MAX_ALIGN.
+ */
+#define LOG_FCB_MBUF_IOV_CNT    (LOG_FCB_MAX_ALIGN + 1)
+
 static struct flash_area sector;
 
 static int log_fcb_rtr_erase(struct log *log, void *arg);
@@ -305,20 +310,78 @@ log_fcb_append_body(struct log *log, const struct log_entry_hdr *hdr,
     return 0;
 }
 
+/**
+ * Writes an optional header followed by an mbuf chain to a log entry.  The
+ * chain is handed to flash in batches of segments without being flattened;
+ * every batch but the last ends on a flash write unit boundary so the next
+ * one starts aligned.
+ */
 static int
-log_fcb_write_mbuf(struct fcb_entry *loc, const struct os_mbuf *om)
+log_fcb_write_mbuf(struct fcb_entry *loc, const void *hdr, int hdr_len,
+                   const struct os_mbuf *om)
 {
+    struct os_mbuf_iov iov[LOG_FCB_MBUF_IOV_CNT];
+    uint8_t align;
+    int batch_hdr;
+    int iov_off;
+    int iov_cnt;
+    int excess;
+    int chunk;
+    int off;
+    int len;
     int rc;
+    int i;
+
+    align = flash_area_align(loc->fe_area);
+    off = 0;
+    len = os_mbuf_len(om);
+    while (hdr_len > 0 || len > 0) {
+        batch_hdr = hdr_len;
+        iov_off = 0;
+        if (hdr_len > 0) {
+            iov[0].omi_base = (void *)hdr;
+            iov[0].omi_len = hdr_len;
+            iov_off = 1;
+            hdr_len = 0;
+        }
+
+        iov_cnt = LOG_FCB_MBUF_IOV_CNT - iov_off;
+        rc = os_mbuf_to_iov(om, off, len, iov + iov_off, &iov_cnt);
+        if (rc != 0 && rc != OS_ENOMEM) {
+            return SYS_EIO;
+        }
+        iov_cnt += iov_off;
+
+        chunk = 0;
+        for (i = iov_off; i < iov_cnt; i++) {
+            chunk += iov[i].omi_len;
+        }
+
+        if (rc == OS_ENOMEM && align > 1) {
+            /* Each segment holds at least one byte and there are more
+             * segments than the alignment, so something is left.
+             */
+            excess = (batch_hdr + chunk) % align;
+            chunk -= excess;
+            while (excess > 0) {
+                if (iov[iov_cnt - 1].omi_len > excess) {
+                    iov[iov_cnt - 1].omi_len -= excess;
+                    excess = 0;
+                } else {
+                    excess -= iov[iov_cnt - 1].omi_len;
+                    iov_cnt--;
+                }
+            }
+        }
 
-    while (om) {
-        rc = flash_area_write(loc->fe_area, loc->fe_data_off,
-                              om->om_data, om->om_len);
+        rc = flash_area_writev(loc->fe_area, loc->fe_data_off, iov, iov_cnt);
         if (rc != 0) {
             return SYS_EIO;
         }
 
-        loc->fe_data_off += om->om_len;
-        om = SLIST_NEXT(om, om_next);
+        loc->fe_data_off += batch_hdr + chunk;
+        off += chunk;
+        len -= chunk;
     }
 
     return 0;
@@ -336,11 +399,7 @@ log_fcb_append_mbuf(struct log *log, const struct os_mbuf *om)
     fcb_log = (struct fcb_log *)log->l_arg;
     fcb = &fcb_log->fl_fcb;
 
-    /* This function expects to be able to write each mbuf without any
-     * buffering.
-     */
-    /* XXX: Fix this; buffer mbuf writes to satisfy flash alignment. */
-    if (fcb->f_align != 1) {
+    if (fcb->f_align > LOG_FCB_MAX_ALIGN) {
         return SYS_ENOTSUP;
     }
 
@@ -350,7 +409,7 @@ log_fcb_append_mbuf(struct log *log, const struct os_mbuf *om)
         return rc;
     }
 
-    rc = log_fcb_write_mbuf(&loc, om);
+    rc = log_fcb_write_mbuf(&loc, NULL, 0, om);
     if (rc != 0) {
         return rc;
     }
@@ -376,10 +435,7 @@ log_fcb_append_mbuf_body(struct log *log, const struct log_entry_hdr *hdr,
     fcb_log = (struct fcb_log *)log->l_arg;
     fcb = &fcb_log->fl_fcb;
 
-    /* This function expects to be able to write each mbuf without any
-     * buffering.
-     */
-    if (fcb->f_align != 1) {
+    if (fcb->f_align > LOG_FCB_MAX_ALIGN) {
         return SYS_ENOTSUP;
     }
 
@@ -389,13 +445,7 @@ log_fcb_append_mbuf_body(struct log *log, const struct log_entry_hdr *hdr,
         return rc;
     }
 
-    rc = flash_area_write(loc.fe_area, loc.fe_data_off, hdr, sizeof *hdr);
-    if (rc != 0) {
-        return rc;
-    }
-    loc.fe_data_off += sizeof *hdr;
-
-    rc = log_fcb_write_mbuf(&loc, om);
+    rc = log_fcb_write_mbuf(&loc, hdr, sizeof *hdr, om);
     if (rc != 0) {
         return rc;
     }
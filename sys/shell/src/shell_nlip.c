@@ -49,7 +49,6 @@ shell_nlip_process(char *data, int len)
 {
     uint16_t copy_len;
     int rc;
-    struct os_mbuf *m;
     uint16_t crc;
 
     rc = base64_decode(data, data);
@@ -87,9 +86,8 @@ shell_nlip_process(char *data, int len)
     if (OS_MBUF_PKTHDR(g_nlip_mbuf)->omp_len == g_nlip_expected_len) {
         if (g_shell_nlip_in_func) {
             crc = CRC16_INITIAL_CRC;
-            for (m = g_nlip_mbuf; m; m = SLIST_NEXT(m, om_next)) {
-                crc = crc16_ccitt(crc, m->om_data, m->om_len);
-            }
+            crc16_ccitt_mbuf(&crc, g_nlip_mbuf, 0,
+                             OS_MBUF_PKTHDR(g_nlip_mbuf)->omp_len);
             if (crc == 0 && g_nlip_expected_len >= sizeof(crc)) {
                 os_mbuf_adj(g_nlip_mbuf, -sizeof(crc));
                 g_shell_nlip_in_func(g_nlip_mbuf, g_shell_nlip_in_arg);
@@ -118,14 +116,13 @@ shell_nlip_mtx(struct os_mbuf *m)
     char esc_seq[2] = { SHELL_NLIP_DATA_START1, SHELL_NLIP_DATA_START2 };
     uint16_t totlen;
     uint16_t dlen;
-    uint16_t off;
+    struct os_mbuf_cursor omc;
     uint16_t crc;
     int rb_off;
     int elen;
     uint16_t bodylen;
     uint16_t newbodylen;
     int rc;
-    struct os_mbuf *tmp;
     void *ptr;
 
     /* Convert the mbuf into a packet.
@@ -142,9 +139,7 @@ shell_nlip_mtx(struct os_mbuf *m)
      * buffer has been sent.
      */
     crc = CRC16_INITIAL_CRC;
-    for (tmp = m; tmp; tmp = SLIST_NEXT(tmp, om_next)) {
-        crc = crc16_ccitt(crc, tmp->om_data, tmp->om_len);
-    }
+    crc16_ccitt_mbuf(&crc, m, 0, OS_MBUF_PKTLEN(m));
     crc = htons(crc);
     ptr = os_mbuf_extend(m, sizeof(crc));
     if (!ptr) {
@@ -154,7 +149,7 @@ shell_nlip_mtx(struct os_mbuf *m)
     memcpy(ptr, &crc, sizeof(crc));
 
     totlen = OS_MBUF_PKTHDR(m)->omp_len;
-    off = 0;
+    os_mbuf_cursor_init(&omc, m);
     bodylen = 0;
     rb_off = 0;
 
@@ -196,7 +191,7 @@ shell_nlip_mtx(struct os_mbuf *m)
             bodylen = 0;
         } else {
             /* The chunk will fit.  Emit it. */
-            rc = os_mbuf_copydata(m, off, dlen, readbuf + rb_off);
+            rc = os_mbuf_cursor_read(&omc, readbuf + rb_off, dlen);
             if (rc != 0) {
                 goto end;
             }
@@ -205,7 +200,6 @@ shell_nlip_mtx(struct os_mbuf *m)
             console_write(encodebuf, elen);
             bodylen += elen;
             totlen -= dlen;
-            off += dlen;
         }
 
         rb_off = 0;
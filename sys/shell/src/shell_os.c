@@ -18,6 +18,7 @@
  */
 
 #include <assert.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "os/mynewt.h"
@@ -32,6 +33,55 @@
 
 #define SHELL_OS "os"
 
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+static void
+shell_os_tasks_run_stats(struct streamer *streamer, const char *name)
+{
+    struct os_task *prev_task;
+    struct os_task_info oti;
+    uint64_t total;
+    char hdr[12];
+    int i;
+
+    total = 0;
+    prev_task = NULL;
+    while ((prev_task = os_task_info_get_next(prev_task, &oti)) != NULL) {
+        total += oti.oti_cpu_time;
+    }
+    if (total == 0) {
+        total = 1;
+    }
+
+    /* Latency histogram buckets are labeled with their bounds in usecs. */
+    streamer_printf(streamer, "Run stats: \n");
+    streamer_printf(streamer, "%8s %10s %5s %10s",
+                    "task", "cpu(ms)", "cpu%", "runmax(us)");
+    for (i = 0; i < MYNEWT_VAL(OS_TASK_RUN_STATS_LAT_BUCKETS) - 1; i++) {
+        snprintf(hdr, sizeof(hdr), "<%lu", 16UL << i);
+        streamer_printf(streamer, " %8s", hdr);
+    }
+    snprintf(hdr, sizeof(hdr), ">=%lu", 8UL << i);
+    streamer_printf(streamer, " %8s\n", hdr);
+
+    prev_task = NULL;
+    while ((prev_task = os_task_info_get_next(prev_task, &oti)) != NULL) {
+        if (name && strcmp(name, oti.oti_name)) {
+            continue;
+        }
+
+        streamer_printf(streamer, "%8s %10lu %5u %10lu",
+                oti.oti_name, (unsigned long)(oti.oti_cpu_time / 1000),
+                (unsigned int)(oti.oti_cpu_time * 100 / total),
+                (unsigned long)oti.oti_run_max);
+        for (i = 0; i < MYNEWT_VAL(OS_TASK_RUN_STATS_LAT_BUCKETS); i++) {
+            streamer_printf(streamer, " %8lu",
+                            (unsigned long)oti.oti_lat_hist[i]);
+        }
+        streamer_printf(streamer, "\n");
+    }
+}
+#endif
+
 static int
 shell_os_tasks_display_cmd(const struct shell_cmd *cmd, int argc, char **argv,
                            struct streamer *streamer)
@@ -80,9 +130,55 @@ shell_os_tasks_display_cmd(const struct shell_cmd *cmd, int argc, char **argv,
         streamer_printf(streamer, "Couldn't find task with name %s\n", name);
     }
 
+#if MYNEWT_VAL(OS_TASK_RUN_STATS)
+    if (!name || found) {
+        shell_os_tasks_run_stats(streamer, name);
+    }
+#endif
+
     return 0;
 }
 
+#if MYNEWT_VAL(OS_MALLOC_SLAB)
+static void
+shell_os_malloc_slab_display(struct streamer *streamer)
+{
+    struct os_malloc_slab_info omsi;
+    int i;
+
+    streamer_printf(streamer, "Malloc size classes: \n");
+    streamer_printf(streamer, "%5s %4s %4s %4s %10s %10s\n",
+                    "blksz", "cnt", "free", "min", "hits", "misses");
+    for (i = 0; os_malloc_slab_info_get(i, &omsi) == 0; i++) {
+        streamer_printf(streamer, "%5u %4u %4u %4u %10lu %10lu\n",
+                        omsi.omsi_block_size, omsi.omsi_num_blocks,
+                        omsi.omsi_num_free, omsi.omsi_min_free,
+                        (unsigned long)omsi.omsi_hits,
+                        (unsigned long)omsi.omsi_misses);
+    }
+}
+#endif
+
+#if MYNEWT_VAL(MSYS_POOL_STATS)
+static void
+shell_os_msys_display(struct streamer *streamer)
+{
+    struct os_msys_pool_info ompi;
+    int i;
+
+    streamer_printf(streamer, "Msys pools: \n");
+    streamer_printf(streamer, "%5s %4s %4s %4s %10s %10s\n",
+                    "dlen", "cnt", "free", "min", "fallbacks", "failures");
+    for (i = 0; os_msys_pool_info_get(i, &ompi) == 0; i++) {
+        streamer_printf(streamer, "%5u %4u %4u %4u %10lu %10lu\n",
+                        ompi.ompi_databuf_len, ompi.ompi_num_blocks,
+                        ompi.ompi_num_free, ompi.ompi_min_free,
+                        (unsigned long)ompi.ompi_fallbacks,
+                        (unsigned long)ompi.ompi_failures);
+    }
+}
+#endif
+
 int
 shell_os_mpool_display_cmd(const struct shell_cmd *cmd, int argc, char **argv,
                            struct streamer *streamer)
@@ -127,9 +223,68 @@ shell_os_mpool_display_cmd(const struct shell_cmd *cmd, int argc, char **argv,
                 name);
     }
 
+#if MYNEWT_VAL(OS_MALLOC_SLAB)
+    if (!name) {
+        shell_os_malloc_slab_display(streamer);
+    }
+#endif
+#if MYNEWT_VAL(MSYS_POOL_STATS)
+    if (!name) {
+        shell_os_msys_display(streamer);
+    }
+#endif
+
     return 0;
 }
 
+#if MYNEWT_VAL(OS_CRIT_PROF)
+static int
+shell_os_crit_display_cmd(const struct shell_cmd *cmd, int argc, char **argv,
+                          struct streamer *streamer)
+{
+    struct os_crit_prof_info info;
+    char hdr[12];
+    int i;
+
+    if (argc > 1 && strcmp(argv[1], "clear") == 0) {
+        os_crit_prof_clear();
+        return 0;
+    }
+
+    os_crit_prof_get(&info);
+
+    streamer_printf(streamer, "Critical sections: %lu, max %lu us, "
+                    "avg %lu us\n",
+                    (unsigned long)info.ocp_count,
+                    (unsigned long)info.ocp_max,
+                    (unsigned long)(info.ocp_total / max(info.ocp_count, 1)));
+
+    /* Bucket n holds sections of at least 2^n and less than 2^(n+1) us. */
+    for (i = 0; i < OS_CRIT_PROF_BUCKETS - 1; i++) {
+        snprintf(hdr, sizeof(hdr), "<%lu", 2UL << i);
+        streamer_printf(streamer, " %7s", hdr);
+    }
+    snprintf(hdr, sizeof(hdr), ">=%lu", 1UL << i);
+    streamer_printf(streamer, " %7s\n", hdr);
+    for (i = 0; i < OS_CRIT_PROF_BUCKETS; i++) {
+        streamer_printf(streamer, " %7lu", (unsigned long)info.ocp_hist[i]);
+    }
+    streamer_printf(streamer, "\n");
+
+    streamer_printf(streamer, "Longest: \n");
+    streamer_printf(streamer, "%12s %8s\n", "caller", "max(us)");
+    for (i = 0; i < OS_CRIT_PROF_TOP; i++) {
+        if (info.ocp_top[i].ocs_caller == NULL) {
+            break;
+        }
+        streamer_printf(streamer, "%12p %8lu\n", info.ocp_top[i].ocs_caller,
+                        (unsigned long)info.ocp_top[i].ocs_max);
+    }
+
+    return 0;
+}
+#endif
+
 int
 shell_os_date_cmd(const struct shell_cmd *cmd, int argc, char **argv,
                   struct streamer *streamer)
@@ -259,6 +414,19 @@ static const struct shell_cmd_help reset_help = {
 static const struct shell_cmd_help ls_dev_help = {
     .summary = "list OS devices"
 };
+
+#if MYNEWT_VAL(OS_CRIT_PROF)
+static const struct shell_param crit_params[] = {
+    {"clear", "reset the profile"},
+    {NULL, NULL}
+};
+
+static const struct shell_cmd_help crit_help = {
+    .summary = "show interrupt-disabled time profile",
+    .usage = NULL,
+    .params = crit_params,
+};
+#endif
 #endif
 
 static const struct shell_cmd os_commands[] = {
@@ -267,6 +435,9 @@ static const struct shell_cmd os_commands[] = {
     SHELL_CMD_EXT("date", shell_os_date_cmd, &date_help),
     SHELL_CMD_EXT("reset", shell_os_reset_cmd, &reset_help),
     SHELL_CMD_EXT("lsdev", shell_os_ls_dev_cmd, &ls_dev_help),
+#if MYNEWT_VAL(OS_CRIT_PROF)
+    SHELL_CMD_EXT("crit", shell_os_crit_display_cmd, &crit_help),
+#endif
     { 0 },
 };
 
@@ -0,0 +1,188 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_TRACE_RAM_
+#define H_TRACE_RAM_
+
+#include <stdint.h>
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief RAM trace backend for the os_trace_*() hooks.
+ *
+ * Trace events are appended to a ring buffer as records of 32-bit words:
+ *     [0] type in bits 0-7, argument count in bits 8-9, id in bits 16-31
+ *     [1] os_cputime timestamp
+ *     [2..4] arguments
+ *
+ * A dump of the trace is a trace_ram_dump_hdr, followed by tdh_task_cnt
+ * trace_ram_dump_task entries, followed by tdh_rec_len bytes of records,
+ * oldest first.  All fields are in the target's byte order; the magic
+ * number tells which.  tools/trace_ram2json.py converts a dump to the
+ * Chrome trace event format.
+ */
+
+#define TRACE_RAM_REC_TASK_CREATE       (1)     /* task, prio */
+#define TRACE_RAM_REC_TASK_START_EXEC   (2)     /* task */
+#define TRACE_RAM_REC_TASK_STOP_EXEC    (3)
+#define TRACE_RAM_REC_TASK_START_READY  (4)     /* task */
+#define TRACE_RAM_REC_TASK_STOP_READY   (5)     /* task, reason */
+#define TRACE_RAM_REC_ISR_ENTER         (6)
+#define TRACE_RAM_REC_ISR_EXIT          (7)
+#define TRACE_RAM_REC_IDLE              (8)
+#define TRACE_RAM_REC_USER_START        (9)     /* id: user id */
+#define TRACE_RAM_REC_USER_STOP         (10)    /* id: user id */
+#define TRACE_RAM_REC_API_CALL          (11)    /* id: OS_TRACE_ID_*, args */
+#define TRACE_RAM_REC_API_RET           (12)    /* id: OS_TRACE_ID_*, [ret] */
+
+#define TRACE_RAM_REC_HDR(type, id, nargs)                              \
+    ((uint32_t)(type) | ((uint32_t)(nargs) << 8) | ((uint32_t)(id) << 16))
+#define TRACE_RAM_REC_TYPE(hdr)         ((hdr) & 0xff)
+#define TRACE_RAM_REC_NARGS(hdr)        (((hdr) >> 8) & 0x3)
+#define TRACE_RAM_REC_ID(hdr)           ((hdr) >> 16)
+/** Length of a record in words */
+#define TRACE_RAM_REC_LEN(hdr)          (TRACE_RAM_REC_NARGS(hdr) + 2)
+
+/** "TRAM" in the target's byte order */
+#define TRACE_RAM_DUMP_MAGIC            (0x4d415254)
+#define TRACE_RAM_DUMP_VERSION          (1)
+
+#if MYNEWT_VAL(TRACE_RAM_TASK_NAME_LEN) % 4 != 0
+#error "TRACE_RAM_TASK_NAME_LEN must be a multiple of 4"
+#endif
+
+struct trace_ram_dump_hdr {
+    uint32_t tdh_magic;
+    uint8_t tdh_version;
+    /** Size of the tdt_name field */
+    uint8_t tdh_name_len;
+    uint16_t tdh_task_cnt;
+    /** Timestamp frequency, in Hz */
+    uint32_t tdh_cputime_freq;
+    /** Number of records lost because the buffer was full */
+    uint32_t tdh_dropped;
+    /** Size of the records following the task table, in bytes */
+    uint32_t tdh_rec_len;
+};
+
+struct trace_ram_dump_task {
+    /** Task as it appears in trace records */
+    uint32_t tdt_id;
+    uint8_t tdt_prio;
+    uint8_t tdt_pad[3];
+    /** Task name, not NUL-terminated if it fills the field */
+    char tdt_name[MYNEWT_VAL(TRACE_RAM_TASK_NAME_LEN)];
+};
+
+struct os_task;
+
+/**
+ * Appends a record to the trace.  Does nothing while recording is stopped.
+ *
+ * @param type                  One of the TRACE_RAM_REC_* types.
+ * @param id                    Record id; meaning depends on type.
+ * @param nargs                 Number of arguments to record, 0 to 3.
+ * @param a0, a1, a2            Arguments.
+ */
+void trace_ram_record(unsigned type, unsigned id, unsigned nargs,
+                      uint32_t a0, uint32_t a1, uint32_t a2);
+
+/*
+ * Hooks with a fixed record, also called from assembly (see
+ * os/os_trace_api.h).
+ */
+void trace_ram_isr_enter(void);
+void trace_ram_isr_exit(void);
+void trace_ram_task_start_exec(const struct os_task *t);
+
+/**
+ * Starts recording.  Records are appended to those already in the buffer.
+ */
+void trace_ram_start(void);
+
+/**
+ * Stops recording, e.g. to read a consistent dump.
+ */
+void trace_ram_stop(void);
+
+/**
+ * @return                      1 if recording, 0 if stopped.
+ */
+int trace_ram_running(void);
+
+/**
+ * Empties the buffer and resets the dropped record count.
+ */
+void trace_ram_clear(void);
+
+/**
+ * Returns the size of a dump of the trace.  Only valid while recording is
+ * stopped.
+ */
+uint32_t trace_ram_dump_len(void);
+
+/**
+ * Reads part of a dump of the trace.  Recording must be stopped.
+ *
+ * @param off                   Offset into the dump.
+ * @param buf                   Buffer to read into.
+ * @param len                   Size of the buffer.
+ * @param out_len               On success, the number of bytes read; less
+ *                                  than len at the end of the dump.
+ *
+ * @return                      0 on success;
+ *                              SYS_EBUSY if recording is running.
+ */
+int trace_ram_dump_read(uint32_t off, void *buf, uint32_t len,
+                        uint32_t *out_len);
+
+#ifdef ARCH_sim
+/**
+ * Writes a dump of the trace to a host file.  Recording is stopped while
+ * the file is written, and then resumed if it was running.
+ *
+ * @param path                  Path of the file to create.
+ *
+ * @return                      0 on success;
+ *                              SYS_EIO if the file cannot be written.
+ */
+int trace_ram_dump_file(const char *path);
+#endif
+
+#if MYNEWT_VAL(TRACE_RAM_NEWTMGR)
+/** Newtmgr command ids within TRACE_RAM_NEWTMGR_GROUP */
+
+/**
+ * Read: {"off": N} -> {"off", "data", "rc", and at offset 0 "len"}.
+ * Reading offset 0 stops recording; reading the last chunk resumes it.
+ */
+#define TRACE_RAM_NMGR_ID_DUMP          (0)
+/** Write: {"op": "start" | "stop" | "clear"} -> {"rc"} */
+#define TRACE_RAM_NMGR_ID_CTRL          (1)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "trace_ram_test.h"
+
+/*
+ * Records an eventq API call and a user span, and finds them in a dump read
+ * in small, unaligned chunks.
+ */
+TEST_CASE_SELF(trace_ram_test_case_record)
+{
+    const struct trace_ram_dump_hdr *hdr;
+    const struct trace_ram_dump_task *tdt;
+    struct os_eventq evq;
+    struct os_event ev = { 0 };
+    struct os_task *cur;
+    const uint32_t *rec;
+    uint32_t prev_ts;
+    uint32_t len;
+    int found_task;
+    int step;
+    int i;
+    int rc;
+
+    trace_ram_stop();
+    trace_ram_clear();
+    trace_ram_start();
+    TEST_ASSERT(trace_ram_running());
+
+    /* A dump cannot be read while recording. */
+    rc = trace_ram_dump_read(0, &prev_ts, sizeof(prev_ts), &len);
+    TEST_ASSERT(rc == SYS_EBUSY);
+
+    os_eventq_init(&evq);
+    os_eventq_put(&evq, &ev);
+    os_trace_user_start(5);
+    os_trace_user_stop(5);
+
+    trace_ram_test_dump(7);
+    TEST_ASSERT(!trace_ram_running());
+
+    hdr = (const struct trace_ram_dump_hdr *)trace_ram_test_dump_buf;
+    TEST_ASSERT(hdr->tdh_dropped == 0);
+
+    /* The running task is in the task table. */
+    cur = os_sched_get_current_task();
+    found_task = 0;
+    tdt = (const struct trace_ram_dump_task *)(hdr + 1);
+    for (i = 0; i < hdr->tdh_task_cnt; i++) {
+        if (tdt[i].tdt_id == (uint32_t)(uintptr_t)cur) {
+            TEST_ASSERT(tdt[i].tdt_prio == cur->t_prio);
+            found_task = 1;
+        }
+    }
+    TEST_ASSERT(found_task);
+
+    /* Expect put call, put return, user start, user stop; in order. */
+    step = 0;
+    prev_ts = 0;
+    rec = NULL;
+    while ((rec = trace_ram_test_next_rec(rec)) != NULL) {
+        if (rec != trace_ram_test_next_rec(NULL)) {
+            TEST_ASSERT(rec[1] - prev_ts < 0x80000000);
+        }
+        prev_ts = rec[1];
+
+        switch (TRACE_RAM_REC_TYPE(rec[0])) {
+        case TRACE_RAM_REC_API_CALL:
+            if (step == 0 &&
+                TRACE_RAM_REC_ID(rec[0]) == OS_TRACE_ID_EVENTQ_PUT &&
+                TRACE_RAM_REC_NARGS(rec[0]) == 2 &&
+                rec[2] == (uint32_t)(uintptr_t)&evq &&
+                rec[3] == (uint32_t)(uintptr_t)&ev) {
+                step = 1;
+            }
+            break;
+        case TRACE_RAM_REC_API_RET:
+            if (step == 1 &&
+                TRACE_RAM_REC_ID(rec[0]) == OS_TRACE_ID_EVENTQ_PUT) {
+                step = 2;
+            }
+            break;
+        case TRACE_RAM_REC_USER_START:
+            if (step == 2 && TRACE_RAM_REC_ID(rec[0]) == 5) {
+                step = 3;
+            }
+            break;
+        case TRACE_RAM_REC_USER_STOP:
+            if (step == 3 && TRACE_RAM_REC_ID(rec[0]) == 5) {
+                step = 4;
+            }
+            break;
+        }
+    }
+    TEST_ASSERT(step == 4);
+
+    trace_ram_start();
+}
@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "trace_ram_test.h"
+
+#define TRACE_RAM_TEST_WRAP_CNT     (MYNEWT_VAL(TRACE_RAM_SIZE) / 4)
+
+/*
+ * Records twice as many user events as fit in the buffer, and checks that
+ * the oldest were dropped whole and the newest kept in order.
+ */
+TEST_CASE_SELF(trace_ram_test_case_wrap)
+{
+    const struct trace_ram_dump_hdr *hdr;
+    const uint32_t *rec;
+    int expected;
+    int i;
+
+    trace_ram_stop();
+    trace_ram_clear();
+    trace_ram_start();
+
+    for (i = 0; i < TRACE_RAM_TEST_WRAP_CNT; i++) {
+        os_trace_user_start(i);
+    }
+
+    /* Read in one go this time. */
+    trace_ram_test_dump(TRACE_RAM_TEST_DUMP_MAX);
+
+    hdr = (const struct trace_ram_dump_hdr *)trace_ram_test_dump_buf;
+    TEST_ASSERT(hdr->tdh_dropped >= TRACE_RAM_TEST_WRAP_CNT / 2);
+    /* At most one partial record's worth of the buffer is unused. */
+    TEST_ASSERT(hdr->tdh_rec_len > MYNEWT_VAL(TRACE_RAM_SIZE) - 5 * 4);
+
+    expected = -1;
+    rec = NULL;
+    while ((rec = trace_ram_test_next_rec(rec)) != NULL) {
+        if (TRACE_RAM_REC_TYPE(rec[0]) != TRACE_RAM_REC_USER_START) {
+            continue;
+        }
+        if (expected >= 0) {
+            TEST_ASSERT(TRACE_RAM_REC_ID(rec[0]) == expected);
+        }
+        expected = TRACE_RAM_REC_ID(rec[0]) + 1;
+    }
+    TEST_ASSERT(expected == TRACE_RAM_TEST_WRAP_CNT);
+
+    trace_ram_clear();
+    trace_ram_test_dump(16);
+    TEST_ASSERT(hdr->tdh_rec_len == 0);
+    TEST_ASSERT(hdr->tdh_dropped == 0);
+
+    trace_ram_start();
+}
@@ -0,0 +1,117 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "trace_ram_test.h"
+
+uint32_t trace_ram_test_dump_buf[TRACE_RAM_TEST_DUMP_MAX / 4];
+uint32_t trace_ram_test_dump_len;
+
+static const struct trace_ram_dump_hdr *
+trace_ram_test_hdr(void)
+{
+    return (const struct trace_ram_dump_hdr *)trace_ram_test_dump_buf;
+}
+
+static uint32_t
+trace_ram_test_recs_off(void)
+{
+    return sizeof(struct trace_ram_dump_hdr) +
+           trace_ram_test_hdr()->tdh_task_cnt *
+           sizeof(struct trace_ram_dump_task);
+}
+
+void
+trace_ram_test_dump(uint32_t chunk)
+{
+    const struct trace_ram_dump_hdr *hdr;
+    const uint32_t *rec;
+    uint8_t *buf;
+    uint32_t words;
+    uint32_t off;
+    uint32_t len;
+    int rc;
+
+    trace_ram_stop();
+
+    trace_ram_test_dump_len = trace_ram_dump_len();
+    TEST_ASSERT_FATAL(trace_ram_test_dump_len <= TRACE_RAM_TEST_DUMP_MAX);
+
+    buf = (uint8_t *)trace_ram_test_dump_buf;
+    for (off = 0; off < trace_ram_test_dump_len; off += len) {
+        rc = trace_ram_dump_read(off, buf + off,
+                                 min(chunk, TRACE_RAM_TEST_DUMP_MAX - off),
+                                 &len);
+        TEST_ASSERT_FATAL(rc == 0);
+        TEST_ASSERT_FATAL(len > 0);
+    }
+    TEST_ASSERT_FATAL(off == trace_ram_test_dump_len);
+
+    /* Nothing past the end. */
+    rc = trace_ram_dump_read(off, buf, 4, &len);
+    TEST_ASSERT(rc == 0 && len == 0);
+
+    hdr = trace_ram_test_hdr();
+    TEST_ASSERT_FATAL(hdr->tdh_magic == TRACE_RAM_DUMP_MAGIC);
+    TEST_ASSERT_FATAL(hdr->tdh_version == TRACE_RAM_DUMP_VERSION);
+    TEST_ASSERT(hdr->tdh_name_len == MYNEWT_VAL(TRACE_RAM_TASK_NAME_LEN));
+    TEST_ASSERT(hdr->tdh_cputime_freq == MYNEWT_VAL(OS_CPUTIME_FREQ));
+    TEST_ASSERT_FATAL(trace_ram_test_recs_off() + hdr->tdh_rec_len ==
+                      trace_ram_test_dump_len);
+
+    words = 0;
+    rec = NULL;
+    while ((rec = trace_ram_test_next_rec(rec)) != NULL) {
+        TEST_ASSERT_FATAL(TRACE_RAM_REC_TYPE(rec[0]) >= 1 &&
+                          TRACE_RAM_REC_TYPE(rec[0]) <= 12);
+        words += TRACE_RAM_REC_LEN(rec[0]);
+    }
+    TEST_ASSERT_FATAL(words * 4 == hdr->tdh_rec_len);
+}
+
+const uint32_t *
+trace_ram_test_next_rec(const uint32_t *rec)
+{
+    const uint32_t *end;
+
+    end = trace_ram_test_dump_buf + trace_ram_test_dump_len / 4;
+    if (rec == NULL) {
+        rec = trace_ram_test_dump_buf + trace_ram_test_recs_off() / 4;
+    } else {
+        rec += TRACE_RAM_REC_LEN(rec[0]);
+    }
+
+    if (rec >= end) {
+        return NULL;
+    }
+    TEST_ASSERT_FATAL(rec + TRACE_RAM_REC_LEN(rec[0]) <= end);
+    return rec;
+}
+
+TEST_SUITE(trace_ram_test_suite)
+{
+    trace_ram_test_case_record();
+    trace_ram_test_case_wrap();
+}
+
+int
+main(int argc, char **argv)
+{
+    trace_ram_test_suite();
+    return tu_any_failed;
+}
@@ -0,0 +1,51 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_TRACE_RAM_TEST_H
+#define H_TRACE_RAM_TEST_H
+
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "trace_ram/trace_ram.h"
+
+#define TRACE_RAM_TEST_DUMP_MAX                                         \
+    (MYNEWT_VAL(TRACE_RAM_SIZE) + 1024)
+
+/** Dump read by trace_ram_test_dump() */
+extern uint32_t trace_ram_test_dump_buf[TRACE_RAM_TEST_DUMP_MAX / 4];
+extern uint32_t trace_ram_test_dump_len;
+
+/**
+ * Stops recording and reads the dump into trace_ram_test_dump_buf, chunk
+ * bytes at a time.  Checks the dump header and that the records fill the
+ * rest of the dump exactly.
+ */
+void trace_ram_test_dump(uint32_t chunk);
+
+/**
+ * Returns the first word of the next record in the dump, or NULL at the
+ * end.  Pass NULL to get the first record.
+ */
+const uint32_t *trace_ram_test_next_rec(const uint32_t *rec);
+
+TEST_SUITE_DECL(trace_ram_test_suite);
+TEST_CASE_DECL(trace_ram_test_case_record);
+TEST_CASE_DECL(trace_ram_test_case_wrap);
+
+#endif
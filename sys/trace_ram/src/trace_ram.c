@@ -0,0 +1,335 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include "os/mynewt.h"
+#include "trace_ram/trace_ram.h"
+#include "trace_ram_priv.h"
+#ifdef ARCH_sim
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+#define TRACE_RAM_WORDS     (MYNEWT_VAL(TRACE_RAM_SIZE) / 4)
+
+static uint32_t trace_ram_buf[TRACE_RAM_WORDS];
+
+static struct {
+    /* Index of the first word of the oldest record. */
+    uint32_t tail;
+    /* Number of words holding records. */
+    uint32_t used;
+    uint32_t dropped;
+    /* Number of tasks when recording was last stopped. */
+    uint16_t task_cnt;
+    uint8_t running;
+} trace_ram;
+
+/* Wraps a word index which is at most one buffer length past the end. */
+static inline uint32_t
+trace_ram_idx(uint32_t idx)
+{
+    return idx >= TRACE_RAM_WORDS ? idx - TRACE_RAM_WORDS : idx;
+}
+
+void
+trace_ram_record(unsigned type, unsigned id, unsigned nargs,
+                 uint32_t a0, uint32_t a1, uint32_t a2)
+{
+    uint32_t rec[5];
+    uint32_t len;
+    uint32_t idx;
+    uint32_t i;
+    os_sr_t sr;
+
+    rec[0] = TRACE_RAM_REC_HDR(type, id, nargs);
+    rec[2] = a0;
+    rec[3] = a1;
+    rec[4] = a2;
+    len = TRACE_RAM_REC_LEN(rec[0]);
+
+    OS_ENTER_CRITICAL(sr);
+
+    if (!trace_ram.running) {
+        goto done;
+    }
+
+    while (TRACE_RAM_WORDS - trace_ram.used < len) {
+#if MYNEWT_VAL(TRACE_RAM_OVERWRITE)
+        i = TRACE_RAM_REC_LEN(trace_ram_buf[trace_ram.tail]);
+        trace_ram.tail = trace_ram_idx(trace_ram.tail + i);
+        trace_ram.used -= i;
+        trace_ram.dropped++;
+#else
+        trace_ram.dropped++;
+        goto done;
+#endif
+    }
+
+    /* Timestamp under the lock, so records are in time order. */
+    rec[1] = os_cputime_get32();
+
+    idx = trace_ram_idx(trace_ram.tail + trace_ram.used);
+    for (i = 0; i < len; i++) {
+        trace_ram_buf[idx] = rec[i];
+        idx = trace_ram_idx(idx + 1);
+    }
+    trace_ram.used += len;
+
+done:
+    OS_EXIT_CRITICAL(sr);
+}
+
+void
+trace_ram_isr_enter(void)
+{
+    trace_ram_record(TRACE_RAM_REC_ISR_ENTER, 0, 0, 0, 0, 0);
+}
+
+void
+trace_ram_isr_exit(void)
+{
+    trace_ram_record(TRACE_RAM_REC_ISR_EXIT, 0, 0, 0, 0, 0);
+}
+
+void
+trace_ram_task_start_exec(const struct os_task *t)
+{
+    trace_ram_record(TRACE_RAM_REC_TASK_START_EXEC, 0, 1,
+                     (uint32_t)(uintptr_t)t, 0, 0);
+}
+
+void
+trace_ram_start(void)
+{
+    trace_ram.running = 1;
+}
+
+void
+trace_ram_stop(void)
+{
+    struct os_task_info oti;
+    struct os_task *t;
+    uint16_t cnt;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    trace_ram.running = 0;
+    OS_EXIT_CRITICAL(sr);
+
+    /* Fix the size of the task table for the dump. */
+    cnt = 0;
+    t = NULL;
+    while ((t = os_task_info_get_next(t, &oti)) != NULL) {
+        cnt++;
+    }
+    trace_ram.task_cnt = cnt;
+}
+
+int
+trace_ram_running(void)
+{
+    return trace_ram.running;
+}
+
+void
+trace_ram_clear(void)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    trace_ram.tail = 0;
+    trace_ram.used = 0;
+    trace_ram.dropped = 0;
+    OS_EXIT_CRITICAL(sr);
+}
+
+static void
+trace_ram_dump_hdr_fill(struct trace_ram_dump_hdr *hdr)
+{
+    memset(hdr, 0, sizeof *hdr);
+    hdr->tdh_magic = TRACE_RAM_DUMP_MAGIC;
+    hdr->tdh_version = TRACE_RAM_DUMP_VERSION;
+    hdr->tdh_name_len = MYNEWT_VAL(TRACE_RAM_TASK_NAME_LEN);
+    hdr->tdh_task_cnt = trace_ram.task_cnt;
+    hdr->tdh_cputime_freq = MYNEWT_VAL(OS_CPUTIME_FREQ);
+    hdr->tdh_dropped = trace_ram.dropped;
+    hdr->tdh_rec_len = trace_ram.used * 4;
+}
+
+/*
+ * Fills in the entry for the idx'th task.  Left empty if the task has gone
+ * away since recording was stopped.
+ */
+static void
+trace_ram_dump_task_fill(int idx, struct trace_ram_dump_task *tdt)
+{
+    struct os_task_info oti;
+    struct os_task *t;
+
+    memset(tdt, 0, sizeof *tdt);
+
+    t = NULL;
+    do {
+        t = os_task_info_get_next(t, &oti);
+    } while (t != NULL && idx-- > 0);
+
+    if (t != NULL) {
+        tdt->tdt_id = (uint32_t)(uintptr_t)t;
+        tdt->tdt_prio = oti.oti_prio;
+        strncpy(tdt->tdt_name, oti.oti_name, sizeof tdt->tdt_name);
+    }
+}
+
+uint32_t
+trace_ram_dump_len(void)
+{
+    return sizeof(struct trace_ram_dump_hdr) +
+           trace_ram.task_cnt * sizeof(struct trace_ram_dump_task) +
+           trace_ram.used * 4;
+}
+
+int
+trace_ram_dump_read(uint32_t off, void *buf, uint32_t len, uint32_t *out_len)
+{
+    union {
+        struct trace_ram_dump_hdr hdr;
+        struct trace_ram_dump_task task;
+    } u;
+    const uint8_t *src;
+    uint8_t *dst;
+    uint32_t tasks_off;
+    uint32_t recs_off;
+    uint32_t end;
+    uint32_t avail;
+    uint32_t rel;
+
+    if (trace_ram.running) {
+        return SYS_EBUSY;
+    }
+
+    tasks_off = sizeof u.hdr;
+    recs_off = tasks_off + trace_ram.task_cnt * sizeof u.task;
+    end = recs_off + trace_ram.used * 4;
+
+    dst = buf;
+    while (len > 0 && off < end) {
+        if (off < tasks_off) {
+            trace_ram_dump_hdr_fill(&u.hdr);
+            src = (uint8_t *)&u.hdr + off;
+            avail = tasks_off - off;
+        } else if (off < recs_off) {
+            rel = off - tasks_off;
+            trace_ram_dump_task_fill(rel / sizeof u.task, &u.task);
+            src = (uint8_t *)&u.task + rel % sizeof u.task;
+            avail = sizeof u.task - rel % sizeof u.task;
+        } else {
+            /* Records are read oldest first, across the end of the ring. */
+            rel = off - recs_off;
+            src = (uint8_t *)&trace_ram_buf[trace_ram_idx(trace_ram.tail +
+                                                          rel / 4)] +
+                  rel % 4;
+            avail = 4 - rel % 4;
+        }
+
+        avail = min(avail, len);
+        memcpy(dst, src, avail);
+        dst += avail;
+        off += avail;
+        len -= avail;
+    }
+
+    *out_len = dst - (uint8_t *)buf;
+    return 0;
+}
+
+#ifdef ARCH_sim
+int
+trace_ram_dump_file(const char *path)
+{
+    uint8_t buf[64];
+    uint32_t off;
+    uint32_t len;
+    FILE *fp;
+    int running;
+    int rc;
+
+    running = trace_ram.running;
+    trace_ram_stop();
+
+    fp = fopen(path, "wb");
+    if (fp == NULL) {
+        rc = SYS_EIO;
+        goto done;
+    }
+
+    rc = 0;
+    off = 0;
+    while (trace_ram_dump_read(off, buf, sizeof buf, &len) == 0 && len > 0) {
+        if (fwrite(buf, 1, len, fp) != len) {
+            rc = SYS_EIO;
+            break;
+        }
+        off += len;
+    }
+
+    if (fclose(fp) != 0 && rc == 0) {
+        rc = SYS_EIO;
+    }
+
+done:
+    if (running) {
+        trace_ram_start();
+    }
+    return rc;
+}
+
+static void
+trace_ram_native_exit(void)
+{
+    trace_ram_dump_file(MYNEWT_VAL(TRACE_RAM_NATIVE_FILE));
+}
+#endif
+
+void
+trace_ram_init(void)
+{
+    int rc;
+
+    /* Ensure this function only gets called by sysinit. */
+    SYSINIT_ASSERT_ACTIVE();
+
+#if MYNEWT_VAL(TRACE_RAM_NEWTMGR)
+    rc = trace_ram_nmgr_init();
+    SYSINIT_PANIC_ASSERT(rc == 0);
+#endif
+
+#ifdef ARCH_sim
+    if (MYNEWT_VAL(TRACE_RAM_NATIVE_FILE)[0] != '\0') {
+        rc = atexit(trace_ram_native_exit);
+        SYSINIT_PANIC_ASSERT(rc == 0);
+    }
+#endif
+
+#if MYNEWT_VAL(TRACE_RAM_AUTOSTART)
+    trace_ram_start();
+#endif
+
+    (void)rc;
+}
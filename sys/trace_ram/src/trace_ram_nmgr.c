@@ -0,0 +1,165 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os/mynewt.h"
+
+#if MYNEWT_VAL(TRACE_RAM_NEWTMGR)
+
+#include <limits.h>
+#include <string.h>
+
+#include "mgmt/mgmt.h"
+#include "cborattr/cborattr.h"
+#include "trace_ram/trace_ram.h"
+#include "trace_ram_priv.h"
+
+/* Set if a download stopped recording and should restart it when done. */
+static uint8_t trace_ram_nmgr_resume;
+
+static int trace_ram_nmgr_dump(struct mgmt_cbuf *cb);
+static int trace_ram_nmgr_ctrl(struct mgmt_cbuf *cb);
+
+static const struct mgmt_handler trace_ram_nmgr_handlers[] = {
+    [TRACE_RAM_NMGR_ID_DUMP] = {
+        .mh_read = trace_ram_nmgr_dump,
+        .mh_write = NULL
+    },
+    [TRACE_RAM_NMGR_ID_CTRL] = {
+        .mh_read = NULL,
+        .mh_write = trace_ram_nmgr_ctrl
+    },
+};
+
+#define TRACE_RAM_NMGR_HANDLER_CNT                                      \
+    sizeof(trace_ram_nmgr_handlers) / sizeof(trace_ram_nmgr_handlers[0])
+
+static struct mgmt_group trace_ram_nmgr_group = {
+    .mg_handlers = trace_ram_nmgr_handlers,
+    .mg_handlers_count = TRACE_RAM_NMGR_HANDLER_CNT,
+    .mg_group_id = MYNEWT_VAL(TRACE_RAM_NEWTMGR_GROUP),
+};
+
+static int
+trace_ram_nmgr_dump(struct mgmt_cbuf *cb)
+{
+    long long unsigned int off = UINT_MAX;
+    uint8_t data[MYNEWT_VAL(TRACE_RAM_NEWTMGR_CHUNK_SIZE)];
+    const struct cbor_attr_t attrs[2] = {
+        [0] = {
+            .attribute = "off",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &off
+        },
+        [1] = { 0 },
+    };
+    CborError g_err = CborNoError;
+    uint32_t dump_len;
+    uint32_t len;
+    int rc;
+
+    rc = cbor_read_object(&cb->it, attrs);
+    if (rc || off == UINT_MAX) {
+        return MGMT_ERR_EINVAL;
+    }
+
+    if (off == 0 && trace_ram_running()) {
+        /* Hold the trace still until the last chunk has been read. */
+        trace_ram_stop();
+        trace_ram_nmgr_resume = 1;
+    }
+
+    rc = trace_ram_dump_read(off, data, sizeof(data), &len);
+    if (rc) {
+        return MGMT_ERR_EBADSTATE;
+    }
+    dump_len = trace_ram_dump_len();
+
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "off");
+    g_err |= cbor_encode_uint(&cb->encoder, off);
+
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "data");
+    g_err |= cbor_encode_byte_string(&cb->encoder, data, len);
+
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "rc");
+    g_err |= cbor_encode_int(&cb->encoder, MGMT_ERR_EOK);
+    if (off == 0) {
+        g_err |= cbor_encode_text_stringz(&cb->encoder, "len");
+        g_err |= cbor_encode_uint(&cb->encoder, dump_len);
+    }
+
+    if (off + len >= dump_len && trace_ram_nmgr_resume) {
+        trace_ram_nmgr_resume = 0;
+        trace_ram_start();
+    }
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return 0;
+}
+
+static int
+trace_ram_nmgr_ctrl(struct mgmt_cbuf *cb)
+{
+    char op[8];
+    const struct cbor_attr_t attrs[2] = {
+        [0] = {
+            .attribute = "op",
+            .type = CborAttrTextStringType,
+            .addr.string = op,
+            .len = sizeof(op)
+        },
+        [1] = { 0 },
+    };
+    CborError g_err = CborNoError;
+    int rc;
+
+    op[0] = '\0';
+    rc = cbor_read_object(&cb->it, attrs);
+    if (rc) {
+        return MGMT_ERR_EINVAL;
+    }
+
+    if (!strcmp(op, "start")) {
+        trace_ram_start();
+    } else if (!strcmp(op, "stop")) {
+        trace_ram_stop();
+    } else if (!strcmp(op, "clear")) {
+        trace_ram_clear();
+    } else {
+        return MGMT_ERR_EINVAL;
+    }
+    /* An explicit command overrides an unfinished download. */
+    trace_ram_nmgr_resume = 0;
+
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "rc");
+    g_err |= cbor_encode_int(&cb->encoder, MGMT_ERR_EOK);
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return 0;
+}
+
+int
+trace_ram_nmgr_init(void)
+{
+    return mgmt_group_register(&trace_ram_nmgr_group);
+}
+
+#endif
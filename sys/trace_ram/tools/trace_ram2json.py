@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#  http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""
+Converts a sys/trace_ram dump to the Chrome trace event format, which
+chrome://tracing and https://ui.perfetto.dev can display.
+
+The "CPU" track shows which task was running, the "ISR" track interrupt
+handlers, and each task has a track with its traced API calls and the
+times it was made ready or blocked.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+DUMP_MAGIC = 0x4d415254
+
+REC_TASK_CREATE = 1
+REC_TASK_START_EXEC = 2
+REC_TASK_STOP_EXEC = 3
+REC_TASK_START_READY = 4
+REC_TASK_STOP_READY = 5
+REC_ISR_ENTER = 6
+REC_ISR_EXIT = 7
+REC_IDLE = 8
+REC_USER_START = 9
+REC_USER_STOP = 10
+REC_API_CALL = 11
+REC_API_RET = 12
+
+# OS_TRACE_ID_* from kernel/os/include/os/os_trace_api.h.
+API_NAMES = {
+    40: "os_eventq_put",
+    41: "os_eventq_get_no_wait",
+    42: "os_eventq_get",
+    43: "os_eventq_remove",
+    44: "os_eventq_poll_0timo",
+    45: "os_eventq_poll",
+    50: "os_mutex_init",
+    51: "os_mutex_release",
+    52: "os_mutex_pend",
+    60: "os_sem_init",
+    61: "os_sem_release",
+    62: "os_sem_pend",
+    70: "os_callout_init",
+    71: "os_callout_stop",
+    72: "os_callout_reset",
+    73: "os_callout_tick",
+    80: "os_memblock_get",
+    81: "os_memblock_put_from_cb",
+    82: "os_memblock_put",
+    83: "os_memblock_get_n",
+    84: "os_memblock_put_n",
+    90: "os_mbuf_get",
+    91: "os_mbuf_get_pkthdr",
+    92: "os_mbuf_free",
+    93: "os_mbuf_free_chain",
+    94: "os_mbuf_get_chain",
+    95: "os_mbuf_share",
+    100: "os_event_group_init",
+    101: "os_event_group_set",
+    102: "os_event_group_clear",
+    103: "os_event_group_wait",
+    110: "os_msgq_init",
+    111: "os_msgq_send",
+    112: "os_msgq_recv",
+    113: "os_msgq_recv_multi",
+}
+
+PID = 1
+TID_CPU = 0
+TID_ISR = 1
+
+
+class Dump:
+    def __init__(self, data):
+        if len(data) < 20:
+            raise ValueError("dump too short")
+
+        for endian in "<>":
+            if struct.unpack_from(endian + "I", data, 0)[0] == DUMP_MAGIC:
+                break
+        else:
+            raise ValueError("bad magic")
+        self.endian = endian
+
+        (_, version, name_len, task_cnt, self.freq, self.dropped,
+         rec_len) = struct.unpack_from(endian + "IBBHIII", data, 0)
+        if version != 1:
+            raise ValueError("unsupported dump version %d" % version)
+
+        self.tasks = {}
+        off = 20
+        for _ in range(task_cnt):
+            tid, prio = struct.unpack_from(endian + "IB", data, off)
+            name = data[off + 8:off + 8 + name_len].split(b"\0")[0]
+            if tid != 0:
+                self.tasks[tid] = (name.decode("ascii", "replace"), prio)
+            off += 8 + name_len
+
+        self.records = []
+        end = off + rec_len
+        if end > len(data):
+            raise ValueError("dump truncated")
+        while off < end:
+            hdr, ts = struct.unpack_from(endian + "II", data, off)
+            nargs = (hdr >> 8) & 0x3
+            args = struct.unpack_from(endian + "I" * nargs, data, off + 8)
+            self.records.append((hdr & 0xff, hdr >> 16, ts, args))
+            off += 8 + 4 * nargs
+
+
+class Converter:
+    def __init__(self, dump):
+        self.dump = dump
+        self.events = []
+        self.time = 0
+        self.last_ts = None
+        self.running = None
+        self.run_start = None
+        self.isr_depth = 0
+        # Open API calls and user spans, per track.
+        self.stacks = {}
+
+    def usecs(self, ts):
+        # Timestamps are 32-bit and wrap; accumulate the deltas.
+        if self.last_ts is not None:
+            self.time += (ts - self.last_ts) & 0xffffffff
+        self.last_ts = ts
+        return self.time * 1000000.0 / self.dump.freq
+
+    def task_name(self, task):
+        if task in self.dump.tasks:
+            return self.dump.tasks[task][0]
+        return "task 0x%08x" % task
+
+    def track(self):
+        if self.isr_depth > 0 or self.running is None:
+            return TID_ISR
+        return self.running
+
+    def instant(self, tid, name, t, args=None):
+        ev = {"ph": "i", "s": "t", "pid": PID, "tid": tid, "name": name,
+              "ts": t}
+        if args:
+            ev["args"] = args
+        self.events.append(ev)
+
+    def span(self, tid, name, start, end, args=None):
+        ev = {"ph": "X", "pid": PID, "tid": tid, "name": name, "ts": start,
+              "dur": end - start}
+        if args:
+            ev["args"] = args
+        self.events.append(ev)
+
+    def switch_to(self, task, t):
+        if self.running is not None:
+            self.span(TID_CPU, self.task_name(self.running), self.run_start,
+                      t, {"task": "0x%08x" % self.running})
+        self.running = task
+        self.run_start = t
+
+    def begin(self, name, t, args):
+        self.stacks.setdefault(self.track(), []).append((name, t, args))
+
+    def end(self, name, t, ret):
+        stack = self.stacks.get(self.track(), [])
+        # The call may predate the oldest record in the buffer.
+        if not stack or stack[-1][0] != name:
+            return
+        _, start, args = stack.pop()
+        if ret is not None:
+            args = dict(args, ret="0x%x" % ret)
+        self.span(self.track(), name, start, t, args)
+
+    def convert(self):
+        meta = [
+            (TID_CPU, "CPU", -2),
+            (TID_ISR, "ISR", -1),
+        ]
+        for task, (name, prio) in self.dump.tasks.items():
+            meta.append((task, "%s (prio %d)" % (name, prio), prio))
+        for tid, name, order in meta:
+            self.events.append({"ph": "M", "pid": PID, "tid": tid,
+                                "name": "thread_name",
+                                "args": {"name": name}})
+            self.events.append({"ph": "M", "pid": PID, "tid": tid,
+                                "name": "thread_sort_index",
+                                "args": {"sort_index": order}})
+
+        t = 0
+        for rtype, rid, ts, args in self.dump.records:
+            t = self.usecs(ts)
+            if rtype == REC_TASK_START_EXEC:
+                self.switch_to(args[0], t)
+            elif rtype == REC_TASK_STOP_EXEC:
+                self.switch_to(None, t)
+            elif rtype == REC_TASK_START_READY:
+                self.instant(args[0], "ready", t)
+            elif rtype == REC_TASK_STOP_READY:
+                self.instant(args[0], "blocked", t, {"reason": args[1]})
+            elif rtype == REC_TASK_CREATE:
+                self.instant(args[0], "created", t, {"prio": args[1]})
+            elif rtype == REC_ISR_ENTER:
+                self.isr_depth += 1
+                self.begin("isr", t, {})
+            elif rtype == REC_ISR_EXIT:
+                self.end("isr", t, None)
+                self.isr_depth = max(self.isr_depth - 1, 0)
+            elif rtype == REC_IDLE:
+                self.instant(self.track(), "idle", t)
+            elif rtype == REC_USER_START:
+                self.begin("user %d" % rid, t, {})
+            elif rtype == REC_USER_STOP:
+                self.end("user %d" % rid, t, None)
+            elif rtype == REC_API_CALL:
+                name = API_NAMES.get(rid, "api %d" % rid)
+                self.begin(name, t, {"arg%d" % i: "0x%x" % a
+                                     for i, a in enumerate(args)})
+            elif rtype == REC_API_RET:
+                name = API_NAMES.get(rid, "api %d" % rid)
+                self.end(name, t, args[0] if args else None)
+
+        # Close whatever is still open at the end of the trace.
+        self.switch_to(None, t)
+        for tid, stack in self.stacks.items():
+            for name, start, args in stack:
+                self.span(tid, name, start, t, args)
+
+        return {
+            "traceEvents": self.events,
+            "displayTimeUnit": "ns",
+            "otherData": {"dropped_records": self.dump.dropped},
+        }
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert a trace_ram dump to Chrome trace JSON.")
+    parser.add_argument("dump", help="binary trace dump")
+    parser.add_argument("-o", "--output", help="output file (default stdout)")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        dump = Dump(f.read())
+
+    trace = Converter(dump).convert()
+    if dump.dropped:
+        print("warning: %d records were dropped" % dump.dropped,
+              file=sys.stderr)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
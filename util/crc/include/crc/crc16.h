@@ -34,9 +34,37 @@
 extern "C" {
 #endif
 
+struct os_mbuf;
+struct flash_area;
+
 #define CRC16_INITIAL_CRC       0       /* what to seed crc16 with */
 unsigned short crc16_ccitt(uint16_t initial_crc, const void *buf, int len);
 
+/*
+ * Same as crc16_ccitt(), but processing 1, 4 or 8 bytes per table lookup
+ * round.  Values above CRC16_SLICE are limited to CRC16_SLICE.  Meant for
+ * comparing the variants; use crc16_ccitt() otherwise.
+ */
+uint16_t crc16_ccitt_sliced(uint16_t initial_crc, const void *buf, int len,
+                            int slices);
+
+/*
+ * Continues *crc over len bytes of an mbuf chain, starting at off.
+ * Requires CRC_MBUF.
+ * Returns 0 on success, SYS_EINVAL if the chain is too short.
+ */
+int crc16_ccitt_mbuf(uint16_t *crc, const struct os_mbuf *om, int off,
+                     int len);
+
+/*
+ * Continues *crc over len bytes of a flash area, starting at off.  Data is
+ * read in chunks into buf; if buf is NULL, a CRC_FLASH_BUF_SIZE byte stack
+ * buffer is used instead.  Requires CRC_FLASH.
+ * Returns 0 on success, SYS_EIO if reading fails.
+ */
+int crc16_ccitt_flash(uint16_t *crc, const struct flash_area *fa, uint32_t off,
+                      uint32_t len, void *buf, int buf_len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * CRC32 with reflected polynomials: IEEE 802.3 (0x04c11db7, as in zlib and
+ * Ethernet) and Castagnoli (0x1edc6f41, as in iSCSI and ext4).
+ *
+ * The value is inverted on entry and exit, so a CRC is started with
+ * CRC32_INITIAL_CRC and continued by passing the previous result.
+ */
+
+#ifndef _UTIL_CRC32_H_
+#define _UTIL_CRC32_H_
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct os_mbuf;
+struct flash_area;
+
+#define CRC32_INITIAL_CRC       0
+
+uint32_t crc32_ieee(uint32_t crc, const void *buf, int len);
+uint32_t crc32c(uint32_t crc, const void *buf, int len);
+
+/*
+ * Same as above, but processing 1, 4 or 8 bytes per table lookup round.
+ * Values above CRC32_SLICE are limited to CRC32_SLICE.  Meant for comparing
+ * the variants.
+ */
+uint32_t crc32_ieee_sliced(uint32_t crc, const void *buf, int len, int slices);
+uint32_t crc32c_sliced(uint32_t crc, const void *buf, int len, int slices);
+
+/*
+ * Continues *crc over len bytes of an mbuf chain, starting at off.
+ * Requires CRC_MBUF.
+ * Returns 0 on success, SYS_EINVAL if the chain is too short.
+ */
+int crc32_ieee_mbuf(uint32_t *crc, const struct os_mbuf *om, int off, int len);
+int crc32c_mbuf(uint32_t *crc, const struct os_mbuf *om, int off, int len);
+
+/*
+ * Continues *crc over len bytes of a flash area, starting at off.  Data is
+ * read in chunks into buf; if buf is NULL, a CRC_FLASH_BUF_SIZE byte stack
+ * buffer is used instead.  Requires CRC_FLASH.
+ * Returns 0 on success, SYS_EIO if reading fails.
+ */
+int crc32_ieee_flash(uint32_t *crc, const struct flash_area *fa, uint32_t off,
+                     uint32_t len, void *buf, int buf_len);
+int crc32c_flash(uint32_t *crc, const struct flash_area *fa, uint32_t off,
+                 uint32_t len, void *buf, int buf_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
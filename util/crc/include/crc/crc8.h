@@ -30,9 +30,35 @@
 extern "C" {
 #endif
 
+struct os_mbuf;
+struct flash_area;
+
 uint8_t crc8_init(void);
 uint8_t crc8_calc(uint8_t val, void *buf, int cnt);
 
+/*
+ * Same as crc8_calc(), but processing 1, 4 or 8 bytes per table lookup
+ * round.  Values above CRC8_SLICE are limited to CRC8_SLICE.  Meant for
+ * comparing the variants; use crc8_calc() otherwise.
+ */
+uint8_t crc8_calc_sliced(uint8_t val, const void *buf, int cnt, int slices);
+
+/*
+ * Continues *val over len bytes of an mbuf chain, starting at off.
+ * Requires CRC_MBUF.
+ * Returns 0 on success, SYS_EINVAL if the chain is too short.
+ */
+int crc8_mbuf(uint8_t *val, const struct os_mbuf *om, int off, int len);
+
+/*
+ * Continues *val over len bytes of a flash area, starting at off.  Data is
+ * read in chunks into buf; if buf is NULL, a CRC_FLASH_BUF_SIZE byte stack
+ * buffer is used instead.  Requires CRC_FLASH.
+ * Returns 0 on success, SYS_EIO if reading fails.
+ */
+int crc8_flash(uint8_t *val, const struct flash_area *fa, uint32_t off,
+               uint32_t len, void *buf, int buf_len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,50 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "crc_test.h"
+
+static const char crc_test_check[] = "123456789";
+
+TEST_CASE_SELF(crc_test_case_known)
+{
+    uint32_t crc32;
+    uint16_t crc16;
+    uint8_t crc8;
+
+    /* Standard check values over "123456789". */
+    crc8 = crc8_calc(0, (void *)crc_test_check, 9);
+    TEST_ASSERT(crc8 == 0xf4);
+
+    crc16 = crc16_ccitt(CRC16_INITIAL_CRC, crc_test_check, 9);
+    TEST_ASSERT(crc16 == 0x31c3);
+
+    crc32 = crc32_ieee(CRC32_INITIAL_CRC, crc_test_check, 9);
+    TEST_ASSERT(crc32 == 0xcbf43926);
+
+    crc32 = crc32c(CRC32_INITIAL_CRC, crc_test_check, 9);
+    TEST_ASSERT(crc32 == 0xe3069283);
+
+    /* Continuing a CRC gives the same result as a single pass. */
+    crc32 = crc32_ieee(CRC32_INITIAL_CRC, crc_test_check, 4);
+    crc32 = crc32_ieee(crc32, crc_test_check + 4, 5);
+    TEST_ASSERT(crc32 == 0xcbf43926);
+
+    crc32 = crc32c(CRC32_INITIAL_CRC, crc_test_check, 0);
+    TEST_ASSERT(crc32 == CRC32_INITIAL_CRC);
+}
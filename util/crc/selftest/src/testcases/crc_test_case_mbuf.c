@@ -0,0 +1,80 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "crc_test.h"
+
+#define CRC_TEST_MBUF_SIZE      (32 + sizeof(struct os_mbuf))
+#define CRC_TEST_MBUF_COUNT     16
+
+static os_membuf_t crc_test_membuf[
+    OS_MEMPOOL_SIZE(CRC_TEST_MBUF_COUNT, CRC_TEST_MBUF_SIZE)];
+static struct os_mempool crc_test_mempool;
+static struct os_mbuf_pool crc_test_mbuf_pool;
+
+TEST_CASE_SELF(crc_test_case_mbuf)
+{
+    struct os_mbuf *om;
+    uint32_t crc32;
+    uint16_t crc16;
+    uint8_t crc8;
+    int rc;
+
+    rc = os_mempool_init(&crc_test_mempool, CRC_TEST_MBUF_COUNT,
+                         CRC_TEST_MBUF_SIZE, crc_test_membuf, "crc_test");
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_mbuf_pool_init(&crc_test_mbuf_pool, &crc_test_mempool,
+                           CRC_TEST_MBUF_SIZE, CRC_TEST_MBUF_COUNT);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* 200 bytes spread over several small mbufs. */
+    om = os_mbuf_get(&crc_test_mbuf_pool, 0);
+    TEST_ASSERT_FATAL(om != NULL);
+    rc = os_mbuf_append(om, crc_test_buf, 200);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT_FATAL(SLIST_NEXT(om, om_next) != NULL);
+
+    crc8 = 0xff;
+    rc = crc8_mbuf(&crc8, om, 0, 200);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(crc8 == crc8_calc(0xff, crc_test_buf, 200));
+
+    crc16 = CRC16_INITIAL_CRC;
+    rc = crc16_ccitt_mbuf(&crc16, om, 13, 150);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(crc16 == crc16_ccitt(CRC16_INITIAL_CRC, crc_test_buf + 13,
+                                     150));
+
+    crc32 = CRC32_INITIAL_CRC;
+    rc = crc32_ieee_mbuf(&crc32, om, 50, 150);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(crc32 == crc32_ieee(CRC32_INITIAL_CRC, crc_test_buf + 50,
+                                    150));
+
+    crc32 = CRC32_INITIAL_CRC;
+    rc = crc32c_mbuf(&crc32, om, 0, 0);
+    TEST_ASSERT(rc == 0 && crc32 == CRC32_INITIAL_CRC);
+
+    /* Chain too short; the CRC is left alone. */
+    crc32 = 0x1234;
+    rc = crc32c_mbuf(&crc32, om, 100, 101);
+    TEST_ASSERT(rc == SYS_EINVAL);
+    TEST_ASSERT(crc32 == 0x1234);
+
+    os_mbuf_free_chain(om);
+}
@@ -0,0 +1,60 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "crc_test.h"
+
+/*
+ * All slice widths must agree with the byte-at-a-time variant for every
+ * length and alignment, including the tails shorter than a slice.
+ */
+TEST_CASE_SELF(crc_test_case_sliced)
+{
+    static const int slices[] = { 4, 8 };
+    const uint8_t *p;
+    uint32_t crc32;
+    uint16_t crc16;
+    uint8_t crc8;
+    int len;
+    int off;
+    int i;
+
+    for (off = 0; off < 8; off++) {
+        p = crc_test_buf + off;
+        for (len = 0; len < CRC_TEST_BUF_SIZE - 8; len += 7) {
+            crc8 = crc8_calc_sliced(0xff, p, len, 1);
+            crc16 = crc16_ccitt_sliced(0xffff, p, len, 1);
+            crc32 = crc32_ieee_sliced(CRC32_INITIAL_CRC, p, len, 1);
+
+            TEST_ASSERT(crc8_calc(0xff, (void *)p, len) == crc8);
+            TEST_ASSERT(crc16_ccitt(0xffff, p, len) == crc16);
+            TEST_ASSERT(crc32_ieee(CRC32_INITIAL_CRC, p, len) == crc32);
+
+            for (i = 0; i < sizeof slices / sizeof slices[0]; i++) {
+                TEST_ASSERT(crc8_calc_sliced(0xff, p, len, slices[i]) == crc8);
+                TEST_ASSERT(crc16_ccitt_sliced(0xffff, p, len, slices[i]) ==
+                            crc16);
+                TEST_ASSERT(crc32_ieee_sliced(CRC32_INITIAL_CRC, p, len,
+                                              slices[i]) == crc32);
+                TEST_ASSERT(crc32c_sliced(CRC32_INITIAL_CRC, p, len,
+                                          slices[i]) ==
+                            crc32c_sliced(CRC32_INITIAL_CRC, p, len, 1));
+            }
+        }
+    }
+}
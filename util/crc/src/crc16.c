@@ -26,10 +26,12 @@
  */
 
 #include <inttypes.h>
+#include "syscfg/syscfg.h"
 #include "crc/crc16.h"
 
 /* CRC16 implementation acording to CCITT standards */
 
+#if MYNEWT_VAL(CRC16_SLICE) == 1
 static const uint16_t crc16tab[256]= {
     0x0000,0x1021,0x2042,0x3063,0x4084,0x50a5,0x60c6,0x70e7,
     0x8108,0x9129,0xa14a,0xb16b,0xc18c,0xd1ad,0xe1ce,0xf1ef,
@@ -64,10 +66,14 @@ static const uint16_t crc16tab[256]= {
     0xef1f,0xff3e,0xcf5d,0xdf7c,0xaf9b,0xbfba,0x8fd9,0x9ff8,
     0x6e17,0x7e36,0x4e55,0x5e74,0x2e93,0x3eb2,0x0ed1,0x1ef0
 };
+#endif
 
 uint16_t
 crc16_ccitt(uint16_t initial_crc, const void *buf, int len)
 {
+#if MYNEWT_VAL(CRC16_SLICE) > 1
+    return crc16_ccitt_sliced(initial_crc, buf, len, MYNEWT_VAL(CRC16_SLICE));
+#else
     const uint8_t *ptr;
     uint16_t crc;
     int counter;
@@ -80,4 +86,5 @@ crc16_ccitt(uint16_t initial_crc, const void *buf, int len)
     }
 
     return crc;
+#endif
 }
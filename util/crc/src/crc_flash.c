@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(CRC_FLASH)
+
+#include "os/mynewt.h"
+#include "flash_map/flash_map.h"
+#include "crc_priv.h"
+
+static int
+crc_flash(crc_update_fn *fn, uint32_t *crc, const struct flash_area *fa,
+          uint32_t off, uint32_t len, void *buf, int buf_len)
+{
+    uint8_t stack_buf[MYNEWT_VAL(CRC_FLASH_BUF_SIZE)];
+    uint32_t val;
+    uint32_t chunk;
+    int rc;
+
+    if (buf == NULL) {
+        buf = stack_buf;
+        buf_len = sizeof(stack_buf);
+    }
+
+    val = *crc;
+    while (len > 0) {
+        chunk = min(len, buf_len);
+        rc = flash_area_read(fa, off, buf, chunk);
+        if (rc != 0) {
+            return SYS_EIO;
+        }
+
+        val = fn(val, buf, chunk);
+        off += chunk;
+        len -= chunk;
+    }
+
+    *crc = val;
+    return 0;
+}
+
+int
+crc8_flash(uint8_t *val, const struct flash_area *fa, uint32_t off,
+           uint32_t len, void *buf, int buf_len)
+{
+    uint32_t crc;
+    int rc;
+
+    crc = *val;
+    rc = crc_flash(crc_update_crc8, &crc, fa, off, len, buf, buf_len);
+    *val = crc;
+
+    return rc;
+}
+
+int
+crc16_ccitt_flash(uint16_t *crc, const struct flash_area *fa, uint32_t off,
+                  uint32_t len, void *buf, int buf_len)
+{
+    uint32_t val;
+    int rc;
+
+    val = *crc;
+    rc = crc_flash(crc_update_crc16_ccitt, &val, fa, off, len, buf, buf_len);
+    *crc = val;
+
+    return rc;
+}
+
+int
+crc32_ieee_flash(uint32_t *crc, const struct flash_area *fa, uint32_t off,
+                 uint32_t len, void *buf, int buf_len)
+{
+    return crc_flash(crc32_ieee, crc, fa, off, len, buf, buf_len);
+}
+
+int
+crc32c_flash(uint32_t *crc, const struct flash_area *fa, uint32_t off,
+             uint32_t len, void *buf, int buf_len)
+{
+    return crc_flash(crc32c, crc, fa, off, len, buf, buf_len);
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(CRC_MBUF)
+
+#include "os/mynewt.h"
+#include "crc_priv.h"
+
+static int
+crc_mbuf(crc_update_fn *fn, uint32_t *crc, const struct os_mbuf *om,
+         int off, int len)
+{
+    uint16_t cur_off;
+    uint32_t val;
+    int count;
+
+    if (off < 0 || len < 0) {
+        return SYS_EINVAL;
+    }
+
+    om = os_mbuf_off(om, off, &cur_off);
+    if (om == NULL) {
+        return SYS_EINVAL;
+    }
+
+    val = *crc;
+    while (len > 0) {
+        if (om == NULL) {
+            return SYS_EINVAL;
+        }
+
+        count = min(om->om_len - cur_off, len);
+        val = fn(val, om->om_data + cur_off, count);
+        len -= count;
+
+        om = SLIST_NEXT(om, om_next);
+        cur_off = 0;
+    }
+
+    *crc = val;
+    return 0;
+}
+
+int
+crc8_mbuf(uint8_t *val, const struct os_mbuf *om, int off, int len)
+{
+    uint32_t crc;
+    int rc;
+
+    crc = *val;
+    rc = crc_mbuf(crc_update_crc8, &crc, om, off, len);
+    *val = crc;
+
+    return rc;
+}
+
+int
+crc16_ccitt_mbuf(uint16_t *crc, const struct os_mbuf *om, int off, int len)
+{
+    uint32_t val;
+    int rc;
+
+    val = *crc;
+    rc = crc_mbuf(crc_update_crc16_ccitt, &val, om, off, len);
+    *crc = val;
+
+    return rc;
+}
+
+int
+crc32_ieee_mbuf(uint32_t *crc, const struct os_mbuf *om, int off, int len)
+{
+    return crc_mbuf(crc32_ieee, crc, om, off, len);
+}
+
+int
+crc32c_mbuf(uint32_t *crc, const struct os_mbuf *om, int off, int len)
+{
+    return crc_mbuf(crc32c, crc, om, off, len);
+}
+
+#endif
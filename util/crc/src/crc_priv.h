@@ -0,0 +1,51 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_CRC_PRIV_
+#define H_CRC_PRIV_
+
+#include <inttypes.h>
+#include "crc/crc8.h"
+#include "crc/crc16.h"
+#include "crc/crc32.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Common signature for the CRCs, used by the mbuf and flash helpers. */
+typedef uint32_t crc_update_fn(uint32_t crc, const void *buf, int len);
+
+static inline uint32_t
+crc_update_crc8(uint32_t crc, const void *buf, int len)
+{
+    return crc8_calc(crc, (void *)buf, len);
+}
+
+static inline uint32_t
+crc_update_crc16_ccitt(uint32_t crc, const void *buf, int len)
+{
+    return crc16_ccitt(crc, buf, len);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
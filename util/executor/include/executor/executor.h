@@ -0,0 +1,210 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_EXECUTOR_
+#define H_EXECUTOR_
+
+#include <stdbool.h>
+#include "os/mynewt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file executor.h
+ * @brief Worker pool running jobs from a shared queue.
+ *
+ * An executor is a queue of jobs shared by one or more worker tasks.  Each
+ * idle worker takes the next job off the queue, so a long job holds up one
+ * worker rather than everything queued behind it.  A job doubles as its own
+ * future: the submitter can join it to wait for its completion and collect
+ * its result.  executor_parallel_for() splits a range of indices across the
+ * workers and the calling task.
+ *
+ * Task priorities must be unique, so the workers of an executor run at
+ * different priorities; a job runs on whichever worker is idle first.
+ *
+ * If EXECUTOR_SYS_WORKERS is nonzero, a system executor with that many
+ * workers is created at startup.
+ */
+
+/**
+ * Job callback.
+ *
+ * @param arg                   The argument given to executor_job_init().
+ *
+ * @return                      The job's result, reported by
+ *                                  executor_join().
+ */
+typedef int executor_job_fn(void *arg);
+
+/**
+ * executor_parallel_for() callback; processes the indices in [start, end).
+ */
+typedef void executor_range_fn(uint32_t start, uint32_t end, void *arg);
+
+struct executor_job {
+    STAILQ_ENTRY(executor_job) ej_next;
+    executor_job_fn *ej_fn;
+    void *ej_arg;
+    /** Released once the job completes. */
+    struct os_sem ej_done;
+    /** Value returned by ej_fn. */
+    int ej_result;
+    /** One of the EXECUTOR_JOB_STATE_[...] values. */
+    uint8_t ej_state;
+};
+
+#define EXECUTOR_JOB_STATE_IDLE     0
+#define EXECUTOR_JOB_STATE_QUEUED   1
+#define EXECUTOR_JOB_STATE_RUNNING  2
+#define EXECUTOR_JOB_STATE_DONE     3
+
+struct executor {
+    STAILQ_HEAD(, executor_job) ex_jobs;
+    /** Counts queued jobs; idle workers wait on it. */
+    struct os_sem ex_pending;
+    uint8_t ex_num_workers;
+};
+
+struct executor_worker {
+    struct os_task ew_task;
+    struct executor *ew_ex;
+};
+
+/**
+ * Initializes an executor without any workers.  Workers are added with
+ * executor_add_worker().
+ *
+ * @param ex                    The executor to initialize.
+ *
+ * @return                      0 on success; OS_[...] error code on failure.
+ */
+int executor_init(struct executor *ex);
+
+/**
+ * Adds a worker task to an executor.
+ *
+ * @param ex                    The executor to add the worker to.
+ * @param worker                The worker to initialize.
+ * @param name                  Name of the worker task.
+ * @param prio                  Priority of the worker task.
+ * @param stack                 Stack of the worker task.
+ * @param stack_size            Size of the stack, in os_stack_t units.
+ *
+ * @return                      0 on success; OS_[...] error code on failure.
+ */
+int executor_add_worker(struct executor *ex, struct executor_worker *worker,
+                        const char *name, uint8_t prio, os_stack_t *stack,
+                        uint16_t stack_size);
+
+/**
+ * Returns the system executor, or NULL if EXECUTOR_SYS_WORKERS is 0.
+ */
+struct executor *executor_sys_get(void);
+
+/**
+ * Initializes a job.  Must not be called while the job is queued or
+ * running.
+ *
+ * @param job                   The job to initialize.
+ * @param fn                    Callback run by a worker task.
+ * @param arg                   Argument passed to the callback.
+ */
+void executor_job_init(struct executor_job *job, executor_job_fn *fn,
+                       void *arg);
+
+/**
+ * Queues a job.  A job which has completed can be submitted again.  May be
+ * called from interrupt context.
+ *
+ * @param ex                    The executor to run the job on.
+ * @param job                   The job to submit.
+ *
+ * @return                      0 on success;
+ *                              SYS_EALREADY if the job is queued or running;
+ *                              OS_NOT_STARTED if the OS has not started.
+ */
+int executor_submit(struct executor *ex, struct executor_job *job);
+
+/**
+ * Removes a job from the queue before a worker has taken it.
+ *
+ * @param ex                    The executor the job was submitted to.
+ * @param job                   The job to cancel.
+ *
+ * @return                      0 if the job was queued and is canceled;
+ *                              SYS_ENOENT if the job was not queued.
+ */
+int executor_cancel(struct executor *ex, struct executor_job *job);
+
+/**
+ * Waits for a job to complete.  Any number of tasks may join a job.
+ *
+ * @param job                   The job to wait for.
+ * @param timeout               The maximum duration to wait, in OS ticks.
+ * @param out_result            On success, the job's result is written
+ *                                  here.  Pass NULL if you don't require
+ *                                  this information.
+ *
+ * @return                      0 on success;
+ *                              OS_TIMEOUT on timeout;
+ *                              SYS_EINVAL if the job was not submitted or
+ *                                  was canceled.
+ */
+int executor_join(struct executor_job *job, os_time_t timeout,
+                  int *out_result);
+
+/**
+ * Returns whether a job has completed.  Its worker may still be signaling
+ * completion; join the job before reusing or freeing it.
+ */
+static inline bool
+executor_job_done(const struct executor_job *job)
+{
+    return job->ej_state == EXECUTOR_JOB_STATE_DONE;
+}
+
+/**
+ * Calls a function for the whole range [0, count), in chunks of up to
+ * 'grain' indices, spread over the workers of an executor and the calling
+ * task.  Returns once every chunk has been processed.  Chunks may be
+ * processed in any order, and concurrently.
+ *
+ * The calling task takes part, so this may be called from one of the
+ * executor's own workers.  Before the OS has started, the calling task
+ * processes the whole range itself.
+ *
+ * @param ex                    The executor to run the chunks on.
+ * @param count                 Number of indices.
+ * @param grain                 Maximum number of indices per chunk; 0 to
+ *                                  split the range evenly across the
+ *                                  workers and the calling task.
+ * @param fn                    Function to call for each chunk.
+ * @param arg                   Argument passed to the function.
+ */
+void executor_parallel_for(struct executor *ex, uint32_t count,
+                           uint32_t grain, executor_range_fn *fn, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "executor_test.h"
+
+static struct executor_job etcb_job_a;
+static struct executor_job etcb_job_b;
+static struct executor_job etcb_job_c;
+static struct executor_job etcb_job_block1;
+static struct executor_job etcb_job_block2;
+
+static struct os_sem etcb_gate;
+static int etcb_num_blocked;
+
+static int
+etcb_double(void *arg)
+{
+    return (intptr_t)arg * 2;
+}
+
+static int
+etcb_block(void *arg)
+{
+    int rc;
+
+    etcb_num_blocked++;
+    rc = os_sem_pend(&etcb_gate, OS_TIMEOUT_NEVER);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    return 0;
+}
+
+TEST_CASE_TASK(executor_test_case_basic)
+{
+    struct executor *ex;
+    int result;
+    int rc;
+
+    ex = executor_sys_get();
+    TEST_ASSERT_FATAL(ex != NULL);
+    TEST_ASSERT_FATAL(ex->ex_num_workers == 2);
+
+    rc = os_sem_init(&etcb_gate, 0);
+    TEST_ASSERT_FATAL(rc == 0);
+    etcb_num_blocked = 0;
+
+    executor_job_init(&etcb_job_a, etcb_double, (void *)21);
+    rc = executor_join(&etcb_job_a, 0, NULL);
+    TEST_ASSERT(rc == SYS_EINVAL);
+
+    /* The workers have lower priority than the test task. */
+    rc = executor_submit(ex, &etcb_job_a);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = executor_submit(ex, &etcb_job_a);
+    TEST_ASSERT(rc == SYS_EALREADY);
+    TEST_ASSERT(!executor_job_done(&etcb_job_a));
+
+    /* Joining lets a worker run the job. */
+    result = 0;
+    rc = executor_join(&etcb_job_a, OS_TICKS_PER_SEC, &result);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(result == 42);
+    TEST_ASSERT(executor_job_done(&etcb_job_a));
+
+    /* A completed job can be joined again, and submitted again. */
+    result = 0;
+    rc = executor_join(&etcb_job_a, 0, &result);
+    TEST_ASSERT(rc == 0 && result == 42);
+
+    rc = executor_submit(ex, &etcb_job_a);
+    TEST_ASSERT_FATAL(rc == 0);
+    result = 0;
+    rc = executor_join(&etcb_job_a, OS_TICKS_PER_SEC, &result);
+    TEST_ASSERT(rc == 0 && result == 42);
+
+    /* Cancel a queued job. */
+    executor_job_init(&etcb_job_b, etcb_double, (void *)1);
+    executor_job_init(&etcb_job_c, etcb_double, (void *)2);
+    rc = executor_submit(ex, &etcb_job_b);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = executor_submit(ex, &etcb_job_c);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    rc = executor_cancel(ex, &etcb_job_c);
+    TEST_ASSERT(rc == 0);
+    rc = executor_cancel(ex, &etcb_job_c);
+    TEST_ASSERT(rc == SYS_ENOENT);
+    rc = executor_join(&etcb_job_c, 0, NULL);
+    TEST_ASSERT(rc == SYS_EINVAL);
+
+    rc = executor_join(&etcb_job_b, OS_TICKS_PER_SEC, &result);
+    TEST_ASSERT(rc == 0 && result == 2);
+    TEST_ASSERT(!executor_job_done(&etcb_job_c));
+
+    /* A blocked job holds up one worker; the other takes the next job. */
+    executor_job_init(&etcb_job_block1, etcb_block, NULL);
+    executor_job_init(&etcb_job_block2, etcb_block, NULL);
+    rc = executor_submit(ex, &etcb_job_block1);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = executor_submit(ex, &etcb_job_block2);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    os_time_delay(1);
+    TEST_ASSERT_FATAL(etcb_num_blocked == 2);
+
+    rc = executor_join(&etcb_job_block1, 1, NULL);
+    TEST_ASSERT(rc == OS_TIMEOUT);
+
+    os_sem_release(&etcb_gate);
+    os_sem_release(&etcb_gate);
+    rc = executor_join(&etcb_job_block1, OS_TICKS_PER_SEC, NULL);
+    TEST_ASSERT(rc == 0);
+    rc = executor_join(&etcb_job_block2, OS_TICKS_PER_SEC, NULL);
+    TEST_ASSERT(rc == 0);
+}
@@ -0,0 +1,139 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include "executor_test.h"
+
+#define ETCP_COUNT      1000
+
+static uint8_t etcp_hits[ETCP_COUNT];
+static uint32_t etcp_num_chunks;
+static uint32_t etcp_max_chunk;
+
+/* Tasks which processed chunks, for the run with sleeping chunks. */
+static struct os_task *etcp_tasks[4];
+static int etcp_num_tasks;
+
+static struct executor_job etcp_job_nested;
+
+static void
+etcp_reset(void)
+{
+    memset(etcp_hits, 0, sizeof etcp_hits);
+    etcp_num_chunks = 0;
+    etcp_max_chunk = 0;
+    etcp_num_tasks = 0;
+}
+
+static void
+etcp_verify(uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0; i < ETCP_COUNT; i++) {
+        TEST_ASSERT_FATAL(etcp_hits[i] == (i < count));
+    }
+}
+
+static void
+etcp_range(uint32_t start, uint32_t end, void *arg)
+{
+    struct os_task *t;
+    uint32_t i;
+    int j;
+
+    TEST_ASSERT_FATAL(start < end && end <= ETCP_COUNT);
+
+    for (i = start; i < end; i++) {
+        etcp_hits[i]++;
+    }
+    etcp_num_chunks++;
+    etcp_max_chunk = max(etcp_max_chunk, end - start);
+
+    if (arg != NULL) {
+        /* Give the workers a chance to take chunks. */
+        t = os_sched_get_current_task();
+        for (j = 0; j < etcp_num_tasks; j++) {
+            if (etcp_tasks[j] == t) {
+                break;
+            }
+        }
+        if (j == etcp_num_tasks && j < ARRAY_SIZE(etcp_tasks)) {
+            etcp_tasks[etcp_num_tasks++] = t;
+        }
+
+        os_time_delay(1);
+    }
+}
+
+static int
+etcp_nested(void *arg)
+{
+    executor_parallel_for(arg, ETCP_COUNT, 10, etcp_range, NULL);
+    return 0;
+}
+
+TEST_CASE_TASK(executor_test_case_parallel_for)
+{
+    struct executor *ex;
+    int rc;
+
+    ex = executor_sys_get();
+    TEST_ASSERT_FATAL(ex != NULL);
+
+    /* Fixed chunk size; the last chunk is short. */
+    etcp_reset();
+    executor_parallel_for(ex, ETCP_COUNT, 7, etcp_range, NULL);
+    etcp_verify(ETCP_COUNT);
+    TEST_ASSERT(etcp_num_chunks == (ETCP_COUNT + 6) / 7);
+    TEST_ASSERT(etcp_max_chunk == 7);
+
+    /* Even split across the two workers and the calling task. */
+    etcp_reset();
+    executor_parallel_for(ex, ETCP_COUNT, 0, etcp_range, NULL);
+    etcp_verify(ETCP_COUNT);
+    TEST_ASSERT(etcp_num_chunks == 3);
+    TEST_ASSERT(etcp_max_chunk == (ETCP_COUNT + 2) / 3);
+
+    /* Degenerate ranges. */
+    etcp_reset();
+    executor_parallel_for(ex, 0, 0, etcp_range, NULL);
+    TEST_ASSERT(etcp_num_chunks == 0);
+
+    etcp_reset();
+    executor_parallel_for(ex, 1, 0, etcp_range, NULL);
+    etcp_verify(1);
+    TEST_ASSERT(etcp_num_chunks == 1);
+
+    /* Chunks which sleep get spread across the workers. */
+    etcp_reset();
+    executor_parallel_for(ex, 64, 4, etcp_range, ex);
+    etcp_verify(64);
+    TEST_ASSERT(etcp_num_chunks == 16);
+    TEST_ASSERT(etcp_num_tasks == 3);
+
+    /* Called from a worker, with the other worker idle. */
+    etcp_reset();
+    executor_job_init(&etcp_job_nested, etcp_nested, ex);
+    rc = executor_submit(ex, &etcp_job_nested);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = executor_join(&etcp_job_nested, OS_TICKS_PER_SEC, NULL);
+    TEST_ASSERT(rc == 0);
+    etcp_verify(ETCP_COUNT);
+}
@@ -0,0 +1,89 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include "executor_test.h"
+
+#define ETCS_COUNT      16
+#define ETCS_ITERS      200
+
+static uint8_t etcs_hits[ETCS_COUNT];
+
+static void
+etcs_range(uint32_t start, uint32_t end, void *arg)
+{
+    uint32_t i;
+
+    for (i = start; i < end; i++) {
+        etcs_hits[i]++;
+
+        /* Let the calling task sleep through workers finishing their jobs. */
+        if (i % 5 == (uintptr_t)arg % 5) {
+            os_time_delay(1);
+        }
+    }
+}
+
+/*
+ * Keeps the stack frame executor_parallel_for() used busy with a pattern
+ * while the workers run, so that a worker still touching its job after the
+ * call returned shows up.
+ */
+static void
+etcs_frame_check(void)
+{
+    uint8_t frame[256];
+    int i;
+
+    memset(frame, 0x5a, sizeof frame);
+    os_time_delay(1);
+    for (i = 0; i < sizeof frame; i++) {
+        TEST_ASSERT_FATAL(frame[i] == 0x5a);
+    }
+}
+
+/*
+ * Runs many short parallel_for calls, so that jobs complete in every order
+ * relative to the calling task joining them.
+ */
+TEST_CASE_TASK(executor_test_case_stress)
+{
+    struct executor *ex;
+    uint32_t i;
+    int iter;
+
+    ex = executor_sys_get();
+    TEST_ASSERT_FATAL(ex != NULL);
+
+    for (iter = 0; iter < ETCS_ITERS; iter++) {
+        memset(etcs_hits, 0, sizeof etcs_hits);
+        executor_parallel_for(ex, ETCS_COUNT, 1 + iter % 3, etcs_range,
+                              (void *)(uintptr_t)iter);
+        etcs_frame_check();
+
+        /* No chunk ran twice, and none was still running on return. */
+        for (i = 0; i < ETCS_COUNT; i++) {
+            TEST_ASSERT_FATAL(etcs_hits[i] == 1, "iter %d index %d", iter,
+                              (int)i);
+        }
+    }
+
+    /* Tokens of canceled jobs were taken back or consumed. */
+    TEST_ASSERT(os_sem_get_count(&ex->ex_pending) == 0);
+}
@@ -0,0 +1,330 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "os/mynewt.h"
+#include "executor/executor.h"
+
+#define EXECUTOR_SYS_WORKERS    MYNEWT_VAL(EXECUTOR_SYS_WORKERS)
+#define EXECUTOR_FOR_MAX_JOBS   MYNEWT_VAL(EXECUTOR_PARALLEL_FOR_MAX_JOBS)
+
+#if EXECUTOR_SYS_WORKERS > 0
+#if MYNEWT_VAL(EXECUTOR_SYS_PRIO) + EXECUTOR_SYS_WORKERS - 1 > OS_TASK_PRI_LOWEST
+#error "EXECUTOR_SYS_PRIO + EXECUTOR_SYS_WORKERS exceeds the lowest task priority"
+#endif
+
+/** Represents a single worker of the system executor. */
+struct executor_sys_entry {
+    OS_TASK_STACK_DEFINE_NOSTATIC(stack, MYNEWT_VAL(EXECUTOR_SYS_STACK_SIZE));
+    struct executor_worker worker;
+    char name[sizeof "execXX"];
+};
+
+static struct executor executor_sys;
+static struct executor_sys_entry executor_sys_entries[EXECUTOR_SYS_WORKERS];
+#endif
+
+/** State shared by the jobs of one executor_parallel_for() call. */
+struct executor_for {
+    executor_range_fn *fn;
+    void *arg;
+    uint32_t count;
+    uint32_t grain;
+    /** First index not yet handed out. */
+    uint32_t next;
+};
+
+static void
+executor_worker_handler(void *arg)
+{
+    struct executor_worker *worker;
+    struct executor_job *job;
+    struct executor *ex;
+    os_sr_t sr;
+
+    worker = arg;
+    ex = worker->ew_ex;
+
+    while (1) {
+        os_sem_pend(&ex->ex_pending, OS_TIMEOUT_NEVER);
+
+        OS_ENTER_CRITICAL(sr);
+        job = STAILQ_FIRST(&ex->ex_jobs);
+        if (job != NULL) {
+            STAILQ_REMOVE_HEAD(&ex->ex_jobs, ej_next);
+            job->ej_state = EXECUTOR_JOB_STATE_RUNNING;
+        }
+        OS_EXIT_CRITICAL(sr);
+
+        /* The job this token was for may have been canceled. */
+        if (job == NULL) {
+            continue;
+        }
+
+        job->ej_result = job->ej_fn(job->ej_arg);
+
+        job->ej_state = EXECUTOR_JOB_STATE_DONE;
+        os_sem_release(&job->ej_done);
+    }
+}
+
+int
+executor_init(struct executor *ex)
+{
+    memset(ex, 0, sizeof *ex);
+    STAILQ_INIT(&ex->ex_jobs);
+
+    return os_sem_init(&ex->ex_pending, 0);
+}
+
+int
+executor_add_worker(struct executor *ex, struct executor_worker *worker,
+                    const char *name, uint8_t prio, os_stack_t *stack,
+                    uint16_t stack_size)
+{
+    int rc;
+
+    worker->ew_ex = ex;
+
+    rc = os_task_init(&worker->ew_task, name, executor_worker_handler, worker,
+                      prio, OS_WAIT_FOREVER, stack, stack_size);
+    if (rc != 0) {
+        return rc;
+    }
+
+    ex->ex_num_workers++;
+
+    return 0;
+}
+
+struct executor *
+executor_sys_get(void)
+{
+#if EXECUTOR_SYS_WORKERS > 0
+    return &executor_sys;
+#else
+    return NULL;
+#endif
+}
+
+void
+executor_job_init(struct executor_job *job, executor_job_fn *fn, void *arg)
+{
+    memset(job, 0, sizeof *job);
+    job->ej_fn = fn;
+    job->ej_arg = arg;
+}
+
+int
+executor_submit(struct executor *ex, struct executor_job *job)
+{
+    os_sr_t sr;
+
+    /* Semaphores cannot be released before the OS has started. */
+    if (!os_started()) {
+        return OS_NOT_STARTED;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+
+    if (job->ej_state == EXECUTOR_JOB_STATE_QUEUED ||
+        job->ej_state == EXECUTOR_JOB_STATE_RUNNING) {
+
+        OS_EXIT_CRITICAL(sr);
+        return SYS_EALREADY;
+    }
+
+    os_sem_init(&job->ej_done, 0);
+    job->ej_state = EXECUTOR_JOB_STATE_QUEUED;
+    STAILQ_INSERT_TAIL(&ex->ex_jobs, job, ej_next);
+
+    OS_EXIT_CRITICAL(sr);
+
+    os_sem_release(&ex->ex_pending);
+
+    return 0;
+}
+
+int
+executor_cancel(struct executor *ex, struct executor_job *job)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+
+    if (job->ej_state != EXECUTOR_JOB_STATE_QUEUED) {
+        OS_EXIT_CRITICAL(sr);
+        return SYS_ENOENT;
+    }
+
+    STAILQ_REMOVE(&ex->ex_jobs, job, executor_job, ej_next);
+    job->ej_state = EXECUTOR_JOB_STATE_IDLE;
+
+    OS_EXIT_CRITICAL(sr);
+
+    /*
+     * Take back the job's token unless a worker already has it; that worker
+     * then finds nothing to do.
+     */
+    os_sem_pend(&ex->ex_pending, 0);
+
+    return 0;
+}
+
+int
+executor_join(struct executor_job *job, os_time_t timeout, int *out_result)
+{
+    int rc;
+
+    if (job->ej_state == EXECUTOR_JOB_STATE_IDLE) {
+        return SYS_EINVAL;
+    }
+
+    /*
+     * Pend even if the job is already marked done: its worker sets the state
+     * before releasing ej_done, and the job must not be reused or freed until
+     * that release is over.
+     */
+    rc = os_sem_pend(&job->ej_done, timeout);
+    if (rc != 0) {
+        return rc;
+    }
+
+    /* Pass completion on to any other task joining the job. */
+    os_sem_release(&job->ej_done);
+
+    if (out_result != NULL) {
+        *out_result = job->ej_result;
+    }
+
+    return 0;
+}
+
+static int
+executor_for_run(void *arg)
+{
+    struct executor_for *f;
+    uint32_t start;
+    uint32_t end;
+    os_sr_t sr;
+
+    f = arg;
+
+    while (1) {
+        OS_ENTER_CRITICAL(sr);
+        start = f->next;
+        end = start + min(f->grain, f->count - start);
+        f->next = end;
+        OS_EXIT_CRITICAL(sr);
+
+        if (start == end) {
+            return 0;
+        }
+
+        f->fn(start, end, f->arg);
+    }
+}
+
+void
+executor_parallel_for(struct executor *ex, uint32_t count, uint32_t grain,
+                      executor_range_fn *fn, void *arg)
+{
+    struct executor_job jobs[EXECUTOR_FOR_MAX_JOBS];
+    struct executor_for f;
+    uint32_t num_chunks;
+    int num_jobs;
+    int rc;
+    int i;
+
+    if (count == 0) {
+        return;
+    }
+
+    if (os_started()) {
+        num_jobs = min(ex->ex_num_workers, EXECUTOR_FOR_MAX_JOBS);
+    } else {
+        num_jobs = 0;
+    }
+
+    if (grain == 0) {
+        grain = count / (num_jobs + 1) + (count % (num_jobs + 1) != 0);
+    }
+
+    /* The calling task handles one chunk; no need for more jobs than that. */
+    num_chunks = (count - 1) / grain + 1;
+    if (num_chunks - 1 < (uint32_t)num_jobs) {
+        num_jobs = num_chunks - 1;
+    }
+
+    f.fn = fn;
+    f.arg = arg;
+    f.count = count;
+    f.grain = grain;
+    f.next = 0;
+
+    for (i = 0; i < num_jobs; i++) {
+        executor_job_init(&jobs[i], executor_for_run, &f);
+        rc = executor_submit(ex, &jobs[i]);
+        assert(rc == 0);
+    }
+
+    executor_for_run(&f);
+
+    /*
+     * Every chunk has been handed out.  Jobs still queued have nothing left
+     * to do; jobs already taken by a worker may still be processing a chunk.
+     * The jobs live on this stack, so wait for those before returning.
+     */
+    for (i = 0; i < num_jobs; i++) {
+        if (executor_cancel(ex, &jobs[i]) != 0) {
+            rc = executor_join(&jobs[i], OS_TIMEOUT_NEVER, NULL);
+            assert(rc == 0);
+        }
+    }
+}
+
+void
+executor_pkg_init(void)
+{
+#if EXECUTOR_SYS_WORKERS > 0
+    struct executor_sys_entry *entry;
+    int rc;
+    int i;
+
+    /* Ensure this function only gets called by sysinit. */
+    SYSINIT_ASSERT_ACTIVE();
+
+    rc = executor_init(&executor_sys);
+    SYSINIT_PANIC_ASSERT(rc == 0);
+
+    for (i = 0; i < EXECUTOR_SYS_WORKERS; i++) {
+        entry = &executor_sys_entries[i];
+        snprintf(entry->name, sizeof entry->name, "exec%d", i);
+
+        rc = executor_add_worker(&executor_sys, &entry->worker, entry->name,
+                                 MYNEWT_VAL(EXECUTOR_SYS_PRIO) + i,
+                                 entry->stack,
+                                 MYNEWT_VAL(EXECUTOR_SYS_STACK_SIZE));
+        SYSINIT_PANIC_ASSERT(rc == 0);
+    }
+#endif
+}
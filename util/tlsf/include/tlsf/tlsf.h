@@ -0,0 +1,169 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_TLSF_
+#define H_TLSF_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Two-level segregated fit (TLSF) allocator.
+ *
+ * Free blocks are kept in a two-level array of segregated lists: the first
+ * level splits sizes by power of two, the second level splits each power of
+ * two range into TLSF_SL_COUNT linear sub-ranges.  A pair of bitmaps records
+ * which lists are non-empty, so malloc and free run in constant time
+ * regardless of heap size or fragmentation.  Adjacent free blocks are always
+ * coalesced.
+ *
+ * A TLSF instance is not thread safe; callers must provide their own
+ * locking.  All struct fields should be considered private.
+ */
+
+#if UINTPTR_MAX > 0xffffffffu
+#define TLSF_ALIGN_LOG2     4
+#else
+#define TLSF_ALIGN_LOG2     3
+#endif
+
+/** Alignment of every pointer returned by the allocator. */
+#define TLSF_ALIGN          (1 << TLSF_ALIGN_LOG2)
+
+#define TLSF_SL_LOG2        MYNEWT_VAL(TLSF_SL_LOG2)
+#define TLSF_SL_COUNT       (1 << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT       (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_COUNT       (MYNEWT_VAL(TLSF_MAX_BLOCK_LOG2) - \
+                             TLSF_FL_SHIFT + 1)
+
+/** Largest block a single allocation can return. */
+#define TLSF_BLOCK_MAX      (((size_t)1 << MYNEWT_VAL(TLSF_MAX_BLOCK_LOG2)) - \
+                             TLSF_ALIGN)
+
+#if TLSF_SL_LOG2 > 5
+#error "TLSF_SL_LOG2 must not exceed 5"
+#endif
+#if TLSF_FL_COUNT < 1 || TLSF_FL_COUNT > 32
+#error "TLSF_MAX_BLOCK_LOG2 out of range"
+#endif
+
+struct tlsf_block;
+
+struct tlsf {
+    /** Bit n set if any second level list of first level n is non-empty. */
+    uint32_t fl_bitmap;
+    /** Bit n set if free[fl][n] is non-empty. */
+    uint32_t sl_bitmap[TLSF_FL_COUNT];
+    struct tlsf_block *free[TLSF_FL_COUNT][TLSF_SL_COUNT];
+
+    /** End-of-pool marker of the most recently added pool. */
+    struct tlsf_block *last_sentinel;
+    /** Unaligned end of the most recently added pool. */
+    uintptr_t pool_end;
+
+    size_t pool_bytes;
+    size_t free_bytes;
+    size_t used_bytes;
+    size_t peak_used;
+    uint32_t free_blocks;
+    uint32_t used_blocks;
+};
+
+struct tlsf_stats {
+    /** Total bytes handed to tlsf_add_pool(), including overhead. */
+    size_t ts_pool_bytes;
+    /** Bytes available in free blocks. */
+    size_t ts_free_bytes;
+    /** Bytes held by allocated blocks, excluding headers. */
+    size_t ts_used_bytes;
+    /** Highest value ts_used_bytes has reached. */
+    size_t ts_peak_used;
+    /** Size of the largest free block. */
+    size_t ts_largest_free;
+    uint32_t ts_free_blocks;
+    uint32_t ts_used_blocks;
+    /**
+     * External fragmentation in percent: how much of the free memory is
+     * unusable for a single allocation of ts_largest_free bytes.
+     */
+    uint8_t ts_frag_pct;
+};
+
+/**
+ * Initializes an empty TLSF instance.  Memory must be given to it with
+ * tlsf_add_pool() before anything can be allocated.
+ */
+void tlsf_init(struct tlsf *tlsf);
+
+/**
+ * Adds a memory region to a TLSF instance.  The region needs no particular
+ * alignment.  If the region starts immediately after the end of the
+ * previously added region (e.g., consecutive sbrk() results), the two are
+ * joined so blocks can span both.  Regions larger than TLSF_BLOCK_MAX are
+ * split into several blocks.
+ *
+ * @param tlsf                  The TLSF instance.
+ * @param mem                   Start of the region.
+ * @param size                  Size of the region, in bytes.
+ *
+ * @return                      0 on success;
+ *                              SYS_EINVAL if the region is too small.
+ */
+int tlsf_add_pool(struct tlsf *tlsf, void *mem, size_t size);
+
+/**
+ * Returns the size of a region that, given to tlsf_add_pool(), is
+ * guaranteed to satisfy a subsequent tlsf_malloc() of the specified size.
+ * Returns 0 if such an allocation cannot be satisfied at all.
+ */
+size_t tlsf_pool_size_for(size_t size);
+
+void *tlsf_malloc(struct tlsf *tlsf, size_t size);
+void tlsf_free(struct tlsf *tlsf, void *ptr);
+
+/**
+ * Resizes an allocation.  Shrinks in place, and grows in place when the
+ * physically following block is free and large enough; otherwise falls back
+ * to allocate, copy and free.  Semantics otherwise match realloc().
+ */
+void *tlsf_realloc(struct tlsf *tlsf, void *ptr, size_t size);
+
+/** Returns the usable size of an allocated block. */
+size_t tlsf_block_size(const void *ptr);
+
+void tlsf_stats(const struct tlsf *tlsf, struct tlsf_stats *stats);
+
+/**
+ * Verifies the consistency of the free lists and bitmaps.
+ *
+ * @return                      0 if the instance is consistent;
+ *                              SYS_EUNKNOWN on corruption.
+ */
+int tlsf_check(const struct tlsf *tlsf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
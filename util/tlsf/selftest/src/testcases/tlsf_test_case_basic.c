@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include "tlsf_test.h"
+
+TEST_CASE_SELF(tlsf_test_case_basic)
+{
+    struct tlsf_stats stats;
+    struct tlsf *t;
+    uint8_t *p[4];
+    size_t free_bytes;
+    int i;
+
+    t = &tlsf_test_tlsf;
+
+    tlsf_stats(t, &stats);
+    TEST_ASSERT(stats.ts_free_blocks == 1);
+    TEST_ASSERT(stats.ts_used_blocks == 0);
+    TEST_ASSERT(stats.ts_largest_free == stats.ts_free_bytes);
+    TEST_ASSERT(stats.ts_frag_pct == 0);
+    free_bytes = stats.ts_free_bytes;
+
+    TEST_ASSERT(tlsf_malloc(t, 0) == NULL);
+    TEST_ASSERT(tlsf_malloc(t, TLSF_TEST_HEAP_SIZE) == NULL);
+
+    for (i = 0; i < 4; i++) {
+        p[i] = tlsf_malloc(t, 100);
+        TEST_ASSERT_FATAL(p[i] != NULL);
+        TEST_ASSERT(((uintptr_t)p[i] & (TLSF_ALIGN - 1)) == 0);
+        TEST_ASSERT(tlsf_block_size(p[i]) >= 100);
+        memset(p[i], i, 100);
+    }
+    TEST_ASSERT(tlsf_check(t) == 0);
+
+    tlsf_stats(t, &stats);
+    TEST_ASSERT(stats.ts_used_blocks == 4);
+    TEST_ASSERT(stats.ts_used_bytes >= 400);
+    TEST_ASSERT(stats.ts_peak_used == stats.ts_used_bytes);
+
+    /* Freeing every other block leaves holes that cannot coalesce. */
+    tlsf_free(t, p[0]);
+    tlsf_free(t, p[2]);
+    TEST_ASSERT(tlsf_check(t) == 0);
+    tlsf_stats(t, &stats);
+    TEST_ASSERT(stats.ts_free_blocks == 3);
+    TEST_ASSERT(stats.ts_frag_pct > 0);
+
+    /* A same-sized request is served from one of the holes. */
+    p[0] = tlsf_malloc(t, 100);
+    TEST_ASSERT(p[0] == p[2] || p[0] < p[1]);
+    tlsf_free(t, p[0]);
+
+    /* Freeing the rest coalesces back into a single block. */
+    tlsf_free(t, p[1]);
+    tlsf_free(t, p[3]);
+    TEST_ASSERT(tlsf_check(t) == 0);
+
+    tlsf_stats(t, &stats);
+    TEST_ASSERT(stats.ts_free_blocks == 1);
+    TEST_ASSERT(stats.ts_used_blocks == 0);
+    TEST_ASSERT(stats.ts_used_bytes == 0);
+    TEST_ASSERT(stats.ts_free_bytes == free_bytes);
+
+    /* Large allocations are served from the coalesced block. */
+    p[0] = tlsf_malloc(t, stats.ts_largest_free / 2);
+    TEST_ASSERT(p[0] != NULL);
+    tlsf_free(t, p[0]);
+    TEST_ASSERT(tlsf_check(t) == 0);
+}
@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "tlsf_test.h"
+
+TEST_CASE_SELF(tlsf_test_case_pool)
+{
+    struct tlsf_stats stats;
+    struct tlsf t;
+    size_t half;
+    size_t need;
+    void *p;
+    int rc;
+
+    half = TLSF_TEST_HEAP_SIZE / 2;
+
+    tlsf_init(&t);
+    TEST_ASSERT(tlsf_malloc(&t, 1) == NULL);
+    TEST_ASSERT(tlsf_add_pool(&t, tlsf_test_heap, 4) == SYS_EINVAL);
+
+    /* Unaligned, contiguous regions are joined into a single free block. */
+    rc = tlsf_add_pool(&t, tlsf_test_heap + 1, half - 1);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = tlsf_add_pool(&t, tlsf_test_heap + half, half);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(tlsf_check(&t) == 0);
+
+    tlsf_stats(&t, &stats);
+    TEST_ASSERT(stats.ts_pool_bytes == TLSF_TEST_HEAP_SIZE - 1);
+    TEST_ASSERT(stats.ts_free_blocks == 1);
+    TEST_ASSERT(stats.ts_free_bytes > half);
+
+    p = tlsf_malloc(&t, half);
+    TEST_ASSERT(p != NULL);
+    tlsf_free(&t, p);
+
+    /* A region of tlsf_pool_size_for() bytes always fits the request. */
+    for (need = 1; need < half; need = need * 3 + 1) {
+        tlsf_init(&t);
+        rc = tlsf_add_pool(&t, tlsf_test_heap + (need & 7),
+                           tlsf_pool_size_for(need));
+        TEST_ASSERT_FATAL(rc == 0);
+        TEST_ASSERT(tlsf_malloc(&t, need) != NULL);
+    }
+    TEST_ASSERT(tlsf_pool_size_for(TLSF_BLOCK_MAX + 1) == 0);
+}
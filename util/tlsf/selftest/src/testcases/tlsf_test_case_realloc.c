@@ -0,0 +1,90 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "tlsf_test.h"
+
+static void
+tlsf_test_fill(uint8_t *p, size_t len, uint8_t seed)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        p[i] = seed + i;
+    }
+}
+
+static int
+tlsf_test_verify(const uint8_t *p, size_t len, uint8_t seed)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        if (p[i] != (uint8_t)(seed + i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+TEST_CASE_SELF(tlsf_test_case_realloc)
+{
+    struct tlsf *t;
+    uint8_t *p;
+    uint8_t *q;
+    uint8_t *r;
+
+    t = &tlsf_test_tlsf;
+
+    /* NULL pointer behaves like malloc, zero size like free. */
+    p = tlsf_realloc(t, NULL, 64);
+    TEST_ASSERT_FATAL(p != NULL);
+    tlsf_test_fill(p, 64, 1);
+
+    /* Growing into the free space that follows happens in place. */
+    q = tlsf_realloc(t, p, 1024);
+    TEST_ASSERT_FATAL(q == p);
+    TEST_ASSERT(tlsf_test_verify(q, 64, 1));
+    tlsf_test_fill(q, 1024, 2);
+
+    /* Shrinking always happens in place. */
+    q = tlsf_realloc(t, p, 32);
+    TEST_ASSERT_FATAL(q == p);
+    TEST_ASSERT(tlsf_test_verify(q, 32, 2));
+    TEST_ASSERT(tlsf_check(t) == 0);
+
+    /* With the following block in use, growing must move the data. */
+    r = tlsf_malloc(t, 16);
+    TEST_ASSERT_FATAL(r != NULL);
+    TEST_ASSERT_FATAL(r == p + tlsf_block_size(p) + 2 * sizeof(void *));
+    q = tlsf_realloc(t, p, 512);
+    TEST_ASSERT_FATAL(q != NULL && q != p);
+    TEST_ASSERT(tlsf_test_verify(q, 32, 2));
+    TEST_ASSERT(tlsf_check(t) == 0);
+
+    /* A failed realloc leaves the original allocation intact. */
+    p = tlsf_realloc(t, q, TLSF_TEST_HEAP_SIZE);
+    TEST_ASSERT(p == NULL);
+    TEST_ASSERT(tlsf_test_verify(q, 32, 2));
+
+    TEST_ASSERT(tlsf_realloc(t, q, 0) == NULL);
+    tlsf_free(t, r);
+    TEST_ASSERT(tlsf_check(t) == 0);
+    TEST_ASSERT(tlsf_test_tlsf.used_blocks == 0);
+    TEST_ASSERT(tlsf_test_tlsf.free_blocks == 1);
+}
@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include "tlsf_test.h"
+
+#define TLSF_TEST_STRESS_SLOTS      128
+#define TLSF_TEST_STRESS_ITERS      20000
+
+struct tlsf_test_slot {
+    uint8_t *p;
+    uint16_t len;
+};
+
+static struct tlsf_test_slot tlsf_test_slots[TLSF_TEST_STRESS_SLOTS];
+
+/** Mostly small requests with an occasional large one. */
+static uint16_t
+tlsf_test_rand_len(void)
+{
+    if (rand() % 8 == 0) {
+        return 1 + rand() % 2048;
+    }
+    return 1 + rand() % 128;
+}
+
+static void
+tlsf_test_slot_fill(int idx)
+{
+    struct tlsf_test_slot *slot;
+    int i;
+
+    slot = &tlsf_test_slots[idx];
+    for (i = 0; i < slot->len; i++) {
+        slot->p[i] = idx + i;
+    }
+}
+
+static int
+tlsf_test_slot_ok(int idx)
+{
+    struct tlsf_test_slot *slot;
+    int i;
+
+    slot = &tlsf_test_slots[idx];
+    for (i = 0; i < slot->len; i++) {
+        if (slot->p[i] != (uint8_t)(idx + i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+TEST_CASE_SELF(tlsf_test_case_stress)
+{
+    struct tlsf_test_slot *slot;
+    struct tlsf_stats stats;
+    struct tlsf *t;
+    uint8_t *p;
+    uint16_t len;
+    int idx;
+    int i;
+
+    t = &tlsf_test_tlsf;
+    srand(1);
+
+    for (i = 0; i < TLSF_TEST_STRESS_ITERS; i++) {
+        idx = rand() % TLSF_TEST_STRESS_SLOTS;
+        slot = &tlsf_test_slots[idx];
+
+        if (slot->p == NULL) {
+            len = tlsf_test_rand_len();
+            p = tlsf_malloc(t, len);
+            if (p == NULL) {
+                continue;
+            }
+            slot->p = p;
+            slot->len = len;
+            tlsf_test_slot_fill(idx);
+        } else {
+            TEST_ASSERT_FATAL(tlsf_test_slot_ok(idx), "slot %d corrupt", idx);
+            if (rand() % 4 == 0) {
+                len = tlsf_test_rand_len();
+                p = tlsf_realloc(t, slot->p, len);
+                if (p == NULL) {
+                    continue;
+                }
+                slot->p = p;
+                if (len < slot->len) {
+                    slot->len = len;
+                }
+                TEST_ASSERT_FATAL(tlsf_test_slot_ok(idx));
+                slot->len = len;
+                tlsf_test_slot_fill(idx);
+            } else {
+                tlsf_free(t, slot->p);
+                slot->p = NULL;
+            }
+        }
+
+        if (i % 256 == 0) {
+            TEST_ASSERT_FATAL(tlsf_check(t) == 0);
+        }
+    }
+
+    for (i = 0; i < TLSF_TEST_STRESS_SLOTS; i++) {
+        slot = &tlsf_test_slots[i];
+        if (slot->p != NULL) {
+            TEST_ASSERT_FATAL(tlsf_test_slot_ok(i));
+            tlsf_free(t, slot->p);
+            slot->p = NULL;
+        }
+    }
+
+    TEST_ASSERT(tlsf_check(t) == 0);
+    tlsf_stats(t, &stats);
+    TEST_ASSERT(stats.ts_used_blocks == 0);
+    TEST_ASSERT(stats.ts_free_blocks == 1);
+    TEST_ASSERT(stats.ts_frag_pct == 0);
+}
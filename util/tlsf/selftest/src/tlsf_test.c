@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include "tlsf_test.h"
+
+struct tlsf tlsf_test_tlsf;
+uint8_t tlsf_test_heap[TLSF_TEST_HEAP_SIZE];
+
+void
+tlsf_test_setup(void *arg)
+{
+    int rc;
+
+    memset(tlsf_test_heap, 0, sizeof tlsf_test_heap);
+
+    tlsf_init(&tlsf_test_tlsf);
+    rc = tlsf_add_pool(&tlsf_test_tlsf, tlsf_test_heap,
+                       sizeof tlsf_test_heap);
+    TEST_ASSERT_FATAL(rc == 0);
+}
+
+TEST_SUITE(tlsf_test_suite)
+{
+    tu_suite_set_pre_test_cb(tlsf_test_setup, NULL);
+
+    tlsf_test_case_basic();
+    tlsf_test_case_realloc();
+    tlsf_test_case_pool();
+    tlsf_test_case_stress();
+}
+
+int
+main(int argc, char **argv)
+{
+    tlsf_test_suite();
+    return tu_any_failed;
+}
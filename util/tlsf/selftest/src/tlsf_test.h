@@ -0,0 +1,40 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_TLSF_TEST_H
+#define H_TLSF_TEST_H
+
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "tlsf/tlsf.h"
+
+#define TLSF_TEST_HEAP_SIZE     (64 * 1024)
+
+extern struct tlsf tlsf_test_tlsf;
+extern uint8_t tlsf_test_heap[TLSF_TEST_HEAP_SIZE];
+
+void tlsf_test_setup(void *arg);
+
+TEST_SUITE_DECL(tlsf_test_suite);
+TEST_CASE_DECL(tlsf_test_case_basic);
+TEST_CASE_DECL(tlsf_test_case_realloc);
+TEST_CASE_DECL(tlsf_test_case_pool);
+TEST_CASE_DECL(tlsf_test_case_stress);
+
+#endif
@@ -0,0 +1,589 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include "defs/error.h"
+#include "tlsf/tlsf.h"
+
+/*
+ * Every block starts with a two word header.  The data area follows the
+ * header and tb_size is its length; the low bit of tb_size flags a free
+ * block.  Free blocks keep their free list links in the first two words of
+ * the data area, which is why no block is smaller than TLSF_ALIGN.
+ *
+ * Each pool ends with a zero-sized, allocated sentinel block so that the
+ * physical successor of any real block always exists.
+ */
+struct tlsf_block {
+    struct tlsf_block *tb_prev_phys;
+    size_t tb_size;
+
+    /* Only valid while the block is free. */
+    struct tlsf_block *tb_next_free;
+    struct tlsf_block *tb_prev_free;
+};
+
+#define TLSF_BLOCK_FREE     ((size_t)1)
+#define TLSF_HDR_SIZE       offsetof(struct tlsf_block, tb_next_free)
+#define TLSF_BLOCK_MIN      (sizeof(struct tlsf_block) - TLSF_HDR_SIZE)
+#define TLSF_SMALL_SIZE     ((size_t)1 << TLSF_FL_SHIFT)
+
+#define TLSF_ALIGN_UP(x)    (((x) + (TLSF_ALIGN - 1)) & ~(size_t)(TLSF_ALIGN - 1))
+#define TLSF_ALIGN_DOWN(x)  ((x) & ~(size_t)(TLSF_ALIGN - 1))
+
+static inline size_t
+tlsf_block_get_size(const struct tlsf_block *block)
+{
+    return block->tb_size & ~TLSF_BLOCK_FREE;
+}
+
+static inline int
+tlsf_block_is_free(const struct tlsf_block *block)
+{
+    return block->tb_size & TLSF_BLOCK_FREE;
+}
+
+static inline void *
+tlsf_block_to_ptr(const struct tlsf_block *block)
+{
+    return (uint8_t *)block + TLSF_HDR_SIZE;
+}
+
+static inline struct tlsf_block *
+tlsf_ptr_to_block(const void *ptr)
+{
+    return (struct tlsf_block *)((uint8_t *)ptr - TLSF_HDR_SIZE);
+}
+
+static inline struct tlsf_block *
+tlsf_block_next(const struct tlsf_block *block)
+{
+    return (struct tlsf_block *)((uint8_t *)tlsf_block_to_ptr(block) +
+                                 tlsf_block_get_size(block));
+}
+
+/** Index of the most significant set bit. */
+static inline int
+tlsf_fls(size_t size)
+{
+    return (int)(sizeof(unsigned long) * 8 - 1) -
+           __builtin_clzl((unsigned long)size);
+}
+
+/** Maps a block size to the list the block belongs to. */
+static inline void
+tlsf_mapping_insert(size_t size, int *fl, int *sl)
+{
+    int f;
+
+    if (size < TLSF_SMALL_SIZE) {
+        *fl = 0;
+        *sl = (int)(size >> TLSF_ALIGN_LOG2);
+    } else {
+        f = tlsf_fls(size);
+        *sl = (int)(size >> (f - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = f - TLSF_FL_SHIFT + 1;
+    }
+}
+
+/**
+ * Rounds a request up to the next list boundary, so any block in the list
+ * it maps to is large enough.
+ */
+static inline size_t
+tlsf_search_size(size_t size)
+{
+    if (size >= TLSF_SMALL_SIZE) {
+        size += ((size_t)1 << (tlsf_fls(size) - TLSF_SL_LOG2)) - 1;
+    }
+    return size;
+}
+
+/**
+ * Converts a user request to a block size; returns 0 if it is too large to
+ * ever be satisfied.
+ */
+static inline size_t
+tlsf_adjust_size(size_t size)
+{
+    if (size > TLSF_BLOCK_MAX) {
+        return 0;
+    }
+    size = TLSF_ALIGN_UP(size);
+    if (size < TLSF_BLOCK_MIN) {
+        size = TLSF_BLOCK_MIN;
+    }
+    return size;
+}
+
+static void
+tlsf_insert_free(struct tlsf *tlsf, struct tlsf_block *block)
+{
+    struct tlsf_block *head;
+    int fl;
+    int sl;
+
+    tlsf_mapping_insert(tlsf_block_get_size(block), &fl, &sl);
+
+    head = tlsf->free[fl][sl];
+    block->tb_next_free = head;
+    block->tb_prev_free = NULL;
+    if (head != NULL) {
+        head->tb_prev_free = block;
+    }
+    tlsf->free[fl][sl] = block;
+    tlsf->fl_bitmap |= 1UL << fl;
+    tlsf->sl_bitmap[fl] |= 1UL << sl;
+
+    block->tb_size |= TLSF_BLOCK_FREE;
+    tlsf->free_bytes += tlsf_block_get_size(block);
+    tlsf->free_blocks++;
+}
+
+static void
+tlsf_remove_free(struct tlsf *tlsf, struct tlsf_block *block)
+{
+    int fl;
+    int sl;
+
+    tlsf_mapping_insert(tlsf_block_get_size(block), &fl, &sl);
+
+    if (block->tb_next_free != NULL) {
+        block->tb_next_free->tb_prev_free = block->tb_prev_free;
+    }
+    if (block->tb_prev_free != NULL) {
+        block->tb_prev_free->tb_next_free = block->tb_next_free;
+    } else {
+        tlsf->free[fl][sl] = block->tb_next_free;
+        if (block->tb_next_free == NULL) {
+            tlsf->sl_bitmap[fl] &= ~(1UL << sl);
+            if (tlsf->sl_bitmap[fl] == 0) {
+                tlsf->fl_bitmap &= ~(1UL << fl);
+            }
+        }
+    }
+
+    block->tb_size &= ~TLSF_BLOCK_FREE;
+    tlsf->free_bytes -= tlsf_block_get_size(block);
+    tlsf->free_blocks--;
+}
+
+/**
+ * Finds the head of the first non-empty list at or above (fl, sl).
+ */
+static struct tlsf_block *
+tlsf_find_suitable(struct tlsf *tlsf, int fl, int sl)
+{
+    uint32_t fl_map;
+    uint32_t sl_map;
+
+    if (fl >= TLSF_FL_COUNT) {
+        return NULL;
+    }
+
+    sl_map = tlsf->sl_bitmap[fl] & (~0UL << sl);
+    if (sl_map == 0) {
+        if (fl + 1 >= TLSF_FL_COUNT) {
+            return NULL;
+        }
+        fl_map = tlsf->fl_bitmap & (~0UL << (fl + 1));
+        if (fl_map == 0) {
+            return NULL;
+        }
+        fl = __builtin_ctz(fl_map);
+        sl_map = tlsf->sl_bitmap[fl];
+    }
+    sl = __builtin_ctz(sl_map);
+
+    return tlsf->free[fl][sl];
+}
+
+/**
+ * Trims an allocated block to the specified size, returning the remainder
+ * to the free lists if it is big enough to form a block of its own.
+ */
+static void
+tlsf_block_trim(struct tlsf *tlsf, struct tlsf_block *block, size_t size)
+{
+    struct tlsf_block *rem;
+    struct tlsf_block *next;
+    size_t cur;
+
+    cur = tlsf_block_get_size(block);
+    if (cur < size + TLSF_HDR_SIZE + TLSF_BLOCK_MIN) {
+        return;
+    }
+
+    rem = (struct tlsf_block *)((uint8_t *)tlsf_block_to_ptr(block) + size);
+    rem->tb_prev_phys = block;
+    rem->tb_size = cur - size - TLSF_HDR_SIZE;
+    block->tb_size = size;
+
+    next = tlsf_block_next(rem);
+    next->tb_prev_phys = rem;
+
+    /* The block after the remainder may itself be free. */
+    if (tlsf_block_is_free(next) &&
+        tlsf_block_get_size(rem) + TLSF_HDR_SIZE +
+        tlsf_block_get_size(next) <= TLSF_BLOCK_MAX) {
+
+        tlsf_remove_free(tlsf, next);
+        rem->tb_size += TLSF_HDR_SIZE + next->tb_size;
+        tlsf_block_next(rem)->tb_prev_phys = rem;
+    }
+    tlsf_insert_free(tlsf, rem);
+}
+
+/**
+ * Coalesces a block that is not on any free list with its free neighbours
+ * and puts the result on the free lists.
+ */
+static void
+tlsf_block_release(struct tlsf *tlsf, struct tlsf_block *block)
+{
+    struct tlsf_block *prev;
+    struct tlsf_block *next;
+
+    prev = block->tb_prev_phys;
+    if (prev != NULL && tlsf_block_is_free(prev) &&
+        tlsf_block_get_size(prev) + TLSF_HDR_SIZE +
+        tlsf_block_get_size(block) <= TLSF_BLOCK_MAX) {
+
+        tlsf_remove_free(tlsf, prev);
+        prev->tb_size += TLSF_HDR_SIZE + block->tb_size;
+        block = prev;
+        tlsf_block_next(block)->tb_prev_phys = block;
+    }
+
+    next = tlsf_block_next(block);
+    if (tlsf_block_is_free(next) &&
+        tlsf_block_get_size(block) + TLSF_HDR_SIZE +
+        tlsf_block_get_size(next) <= TLSF_BLOCK_MAX) {
+
+        tlsf_remove_free(tlsf, next);
+        block->tb_size += TLSF_HDR_SIZE + next->tb_size;
+        tlsf_block_next(block)->tb_prev_phys = block;
+    }
+
+    tlsf_insert_free(tlsf, block);
+}
+
+static void
+tlsf_used_add(struct tlsf *tlsf, size_t size)
+{
+    tlsf->used_bytes += size;
+    if (tlsf->used_bytes > tlsf->peak_used) {
+        tlsf->peak_used = tlsf->used_bytes;
+    }
+}
+
+void
+tlsf_init(struct tlsf *tlsf)
+{
+    memset(tlsf, 0, sizeof *tlsf);
+}
+
+int
+tlsf_add_pool(struct tlsf *tlsf, void *mem, size_t size)
+{
+    struct tlsf_block *first;
+    struct tlsf_block *block;
+    struct tlsf_block *prev;
+    uintptr_t start;
+    uintptr_t end;
+    size_t left;
+    size_t data;
+
+    start = TLSF_ALIGN_UP((uintptr_t)mem);
+    end = TLSF_ALIGN_DOWN((uintptr_t)mem + size);
+    if (end <= start) {
+        return SYS_EINVAL;
+    }
+
+    prev = NULL;
+    if (tlsf->last_sentinel != NULL && (uintptr_t)mem == tlsf->pool_end) {
+        /* Contiguous with the previous pool; reuse its sentinel header. */
+        start = (uintptr_t)tlsf->last_sentinel;
+        prev = tlsf->last_sentinel->tb_prev_phys;
+    }
+
+    if (end - start < 2 * TLSF_HDR_SIZE + TLSF_BLOCK_MIN) {
+        return SYS_EINVAL;
+    }
+
+    /* Lay out the region as allocated blocks of at most TLSF_BLOCK_MAX
+     * bytes followed by the sentinel, then release them in order.
+     */
+    first = (struct tlsf_block *)start;
+    block = first;
+    left = end - start - TLSF_HDR_SIZE;
+    while (left != 0) {
+        data = left - TLSF_HDR_SIZE;
+        if (data > TLSF_BLOCK_MAX) {
+            data = TLSF_BLOCK_MAX;
+            if (left - TLSF_HDR_SIZE - data < TLSF_HDR_SIZE + TLSF_BLOCK_MIN) {
+                data -= TLSF_HDR_SIZE + TLSF_BLOCK_MIN;
+            }
+        }
+        block->tb_prev_phys = prev;
+        block->tb_size = data;
+        left -= TLSF_HDR_SIZE + data;
+
+        prev = block;
+        block = tlsf_block_next(block);
+    }
+
+    block->tb_prev_phys = prev;
+    block->tb_size = 0;
+    tlsf->last_sentinel = block;
+    tlsf->pool_end = (uintptr_t)mem + size;
+    tlsf->pool_bytes += size;
+
+    for (block = first; block != tlsf->last_sentinel; block = prev) {
+        prev = tlsf_block_next(block);
+        tlsf_block_release(tlsf, block);
+    }
+
+    return 0;
+}
+
+size_t
+tlsf_pool_size_for(size_t size)
+{
+    size = tlsf_adjust_size(size);
+    if (size == 0) {
+        return 0;
+    }
+    size = TLSF_ALIGN_DOWN(tlsf_search_size(size));
+    if (size > TLSF_BLOCK_MAX) {
+        return 0;
+    }
+
+    /* Alignment slack, block header, sentinel. */
+    return (TLSF_ALIGN - 1) + TLSF_HDR_SIZE + size + TLSF_HDR_SIZE;
+}
+
+void *
+tlsf_malloc(struct tlsf *tlsf, size_t size)
+{
+    struct tlsf_block *block;
+    int fl;
+    int sl;
+
+    if (size == 0) {
+        return NULL;
+    }
+    size = tlsf_adjust_size(size);
+    if (size == 0) {
+        return NULL;
+    }
+
+    tlsf_mapping_insert(tlsf_search_size(size), &fl, &sl);
+    block = tlsf_find_suitable(tlsf, fl, sl);
+    if (block == NULL) {
+        return NULL;
+    }
+
+    tlsf_remove_free(tlsf, block);
+    tlsf_block_trim(tlsf, block, size);
+
+    tlsf_used_add(tlsf, tlsf_block_get_size(block));
+    tlsf->used_blocks++;
+
+    return tlsf_block_to_ptr(block);
+}
+
+void
+tlsf_free(struct tlsf *tlsf, void *ptr)
+{
+    struct tlsf_block *block;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    block = tlsf_ptr_to_block(ptr);
+    tlsf->used_bytes -= tlsf_block_get_size(block);
+    tlsf->used_blocks--;
+
+    tlsf_block_release(tlsf, block);
+}
+
+void *
+tlsf_realloc(struct tlsf *tlsf, void *ptr, size_t size)
+{
+    struct tlsf_block *block;
+    struct tlsf_block *next;
+    size_t adjusted;
+    size_t cur;
+    void *newptr;
+
+    if (ptr == NULL) {
+        return tlsf_malloc(tlsf, size);
+    }
+    if (size == 0) {
+        tlsf_free(tlsf, ptr);
+        return NULL;
+    }
+
+    adjusted = tlsf_adjust_size(size);
+    if (adjusted == 0) {
+        return NULL;
+    }
+
+    block = tlsf_ptr_to_block(ptr);
+    cur = tlsf_block_get_size(block);
+
+    if (adjusted > cur) {
+        next = tlsf_block_next(block);
+        if (!tlsf_block_is_free(next) ||
+            cur + TLSF_HDR_SIZE + tlsf_block_get_size(next) < adjusted ||
+            cur + TLSF_HDR_SIZE + tlsf_block_get_size(next) > TLSF_BLOCK_MAX) {
+
+            newptr = tlsf_malloc(tlsf, size);
+            if (newptr != NULL) {
+                memcpy(newptr, ptr, cur);
+                tlsf_free(tlsf, ptr);
+            }
+            return newptr;
+        }
+
+        /* Absorb the following free block. */
+        tlsf_remove_free(tlsf, next);
+        block->tb_size += TLSF_HDR_SIZE + next->tb_size;
+        tlsf_block_next(block)->tb_prev_phys = block;
+    }
+
+    tlsf_block_trim(tlsf, block, adjusted);
+
+    tlsf->used_bytes -= cur;
+    tlsf_used_add(tlsf, tlsf_block_get_size(block));
+
+    return ptr;
+}
+
+size_t
+tlsf_block_size(const void *ptr)
+{
+    return tlsf_block_get_size(tlsf_ptr_to_block(ptr));
+}
+
+void
+tlsf_stats(const struct tlsf *tlsf, struct tlsf_stats *stats)
+{
+    const struct tlsf_block *block;
+    size_t largest;
+    int fl;
+    int sl;
+
+    largest = 0;
+    if (tlsf->fl_bitmap != 0) {
+        /* The largest block is on the highest non-empty list. */
+        fl = 31 - __builtin_clz(tlsf->fl_bitmap);
+        sl = 31 - __builtin_clz(tlsf->sl_bitmap[fl]);
+        for (block = tlsf->free[fl][sl];
+             block != NULL;
+             block = block->tb_next_free) {
+
+            if (tlsf_block_get_size(block) > largest) {
+                largest = tlsf_block_get_size(block);
+            }
+        }
+    }
+
+    stats->ts_pool_bytes = tlsf->pool_bytes;
+    stats->ts_free_bytes = tlsf->free_bytes;
+    stats->ts_used_bytes = tlsf->used_bytes;
+    stats->ts_peak_used = tlsf->peak_used;
+    stats->ts_largest_free = largest;
+    stats->ts_free_blocks = tlsf->free_blocks;
+    stats->ts_used_blocks = tlsf->used_blocks;
+    if (tlsf->free_bytes == 0) {
+        stats->ts_frag_pct = 0;
+    } else {
+        stats->ts_frag_pct = 100 - (uint8_t)((uint64_t)largest * 100 /
+                                             tlsf->free_bytes);
+    }
+}
+
+int
+tlsf_check(const struct tlsf *tlsf)
+{
+    const struct tlsf_block *block;
+    const struct tlsf_block *prev;
+    const struct tlsf_block *next;
+    size_t free_bytes;
+    uint32_t free_blocks;
+    int fl;
+    int sl;
+    int bfl;
+    int bsl;
+
+    free_bytes = 0;
+    free_blocks = 0;
+
+    for (fl = 0; fl < TLSF_FL_COUNT; fl++) {
+        if (!!(tlsf->fl_bitmap & (1UL << fl)) != !!tlsf->sl_bitmap[fl]) {
+            return SYS_EUNKNOWN;
+        }
+
+        for (sl = 0; sl < TLSF_SL_COUNT; sl++) {
+            block = tlsf->free[fl][sl];
+            if (!!(tlsf->sl_bitmap[fl] & (1UL << sl)) != (block != NULL)) {
+                return SYS_EUNKNOWN;
+            }
+
+            prev = NULL;
+            for (; block != NULL; block = block->tb_next_free) {
+                if (!tlsf_block_is_free(block) ||
+                    block->tb_prev_free != prev) {
+                    return SYS_EUNKNOWN;
+                }
+
+                tlsf_mapping_insert(tlsf_block_get_size(block), &bfl, &bsl);
+                if (bfl != fl || bsl != sl) {
+                    return SYS_EUNKNOWN;
+                }
+
+                /* Neighbours must be linked back, and already coalesced
+                 * unless the merged block would exceed the size limit.
+                 */
+                next = tlsf_block_next(block);
+                if (next->tb_prev_phys != block) {
+                    return SYS_EUNKNOWN;
+                }
+                if (tlsf_block_is_free(next) &&
+                    tlsf_block_get_size(block) + TLSF_HDR_SIZE +
+                    tlsf_block_get_size(next) <= TLSF_BLOCK_MAX) {
+                    return SYS_EUNKNOWN;
+                }
+
+                free_bytes += tlsf_block_get_size(block);
+                free_blocks++;
+                prev = block;
+            }
+        }
+    }
+
+    if (free_bytes != tlsf->free_bytes || free_blocks != tlsf->free_blocks) {
+        return SYS_EUNKNOWN;
+    }
+
+    return 0;
+}
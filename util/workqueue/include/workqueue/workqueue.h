@@ -0,0 +1,212 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_WORKQUEUE_
+#define H_WORKQUEUE_
+
+#include <stdbool.h>
+#include "os/mynewt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file workqueue.h
+ * @brief Worker tasks for deferred (bottom half) processing.
+ *
+ * A workqueue is an event queue served by a dedicated task.  Interrupt
+ * handlers and other tasks submit work items to it, and the worker runs the
+ * work item callbacks one at a time, in the order they were submitted.
+ * Several workqueues at different task priorities let time critical work
+ * preempt long running handlers instead of queueing behind them.
+ *
+ * WORKQUEUE_SYS_COUNT system workqueues are created at startup; system
+ * workqueue 0 has the highest priority.  Further workqueues can be created
+ * with workqueue_init().
+ *
+ * If OS_EVENTQ_STATS is enabled, each workqueue's queue depth and queueing
+ * latency are exported through the stats package under the name of its
+ * worker task.
+ */
+
+struct workqueue {
+    /** Queue of pending work items. */
+    struct os_eventq wq_evq;
+    /** Task which runs the work items. */
+    struct os_task wq_task;
+};
+
+struct workqueue_work {
+    /**
+     * Event run by the worker.  Its ev_cb and ev_arg are set by
+     * workqueue_work_init(); ev_prio may be set while the work is not
+     * pending.
+     */
+    struct os_event ww_ev;
+    /** Workqueue the work was last submitted to. */
+    struct workqueue *ww_wq;
+};
+
+struct workqueue_delayed_work {
+    /**
+     * Timer which posts its event to the workqueue on expiry.  The event is
+     * set up by workqueue_delayed_work_init().
+     */
+    struct os_callout dw_callout;
+};
+
+/**
+ * Creates a workqueue and its worker task.
+ *
+ * @param wq                    The workqueue to initialize.
+ * @param name                  Name of the worker task.
+ * @param prio                  Priority of the worker task.
+ * @param stack                 Stack of the worker task.
+ * @param stack_size            Size of the stack, in os_stack_t units.
+ *
+ * @return                      0 on success; OS_[...] error code on failure.
+ */
+int workqueue_init(struct workqueue *wq, const char *name, uint8_t prio,
+                   os_stack_t *stack, uint16_t stack_size);
+
+/**
+ * Returns a system workqueue.
+ *
+ * @param idx                   Index of the system workqueue, from 0
+ *                                  (highest priority) to
+ *                                  WORKQUEUE_SYS_COUNT - 1.
+ *
+ * @return                      The workqueue; NULL if there is no such
+ *                                  system workqueue.
+ */
+struct workqueue *workqueue_sys_get(int idx);
+
+/**
+ * Initializes a work item.  Must not be called while the work is pending.
+ *
+ * @param work                  The work item to initialize.
+ * @param fn                    Callback run by the worker task.
+ * @param arg                   Argument found in the ev_arg field of the
+ *                                  event passed to the callback.
+ */
+void workqueue_work_init(struct workqueue_work *work, os_event_fn *fn,
+                         void *arg);
+
+/**
+ * Submits a work item to a workqueue.  May be called from interrupt context.
+ * A work item which is pending on one workqueue must not be submitted to
+ * another one.
+ *
+ * @param wq                    The workqueue to run the work on.
+ * @param work                  The work item to submit.
+ *
+ * @return                      0 on success;
+ *                              SYS_EALREADY if the work is already pending.
+ */
+int workqueue_submit(struct workqueue *wq, struct workqueue_work *work);
+
+/**
+ * Cancels a pending work item.  The callback may still be running when this
+ * function returns; use workqueue_flush() to wait for it to complete.
+ *
+ * @param work                  The work item to cancel.
+ *
+ * @return                      0 if the work was pending and is canceled;
+ *                              SYS_ENOENT if the work was not pending.
+ */
+int workqueue_cancel(struct workqueue_work *work);
+
+/** Returns whether a work item is waiting to be run. */
+static inline bool
+workqueue_work_pending(const struct workqueue_work *work)
+{
+    return OS_EVENT_QUEUED(&work->ww_ev);
+}
+
+/**
+ * Initializes a delayed work item.  Must not be called while the work is
+ * pending.
+ *
+ * @param dwork                 The delayed work item to initialize.
+ * @param fn                    Callback run by the worker task.
+ * @param arg                   Argument found in the ev_arg field of the
+ *                                  event passed to the callback.
+ */
+void workqueue_delayed_work_init(struct workqueue_delayed_work *dwork,
+                                 os_event_fn *fn, void *arg);
+
+/**
+ * Submits a delayed work item to a workqueue.  The work is queued once the
+ * specified number of ticks has elapsed, and runs after the work submitted
+ * before then.  May be called from interrupt context.
+ *
+ * @param wq                    The workqueue to run the work on.
+ * @param dwork                 The delayed work item to submit.
+ * @param ticks                 Delay, in OS ticks.  With 0, the work is
+ *                                  queued immediately.
+ *
+ * @return                      0 on success;
+ *                              SYS_EALREADY if the work is already pending;
+ *                              SYS_EINVAL if the delay is too long.
+ */
+int workqueue_submit_delayed(struct workqueue *wq,
+                             struct workqueue_delayed_work *dwork,
+                             os_time_t ticks);
+
+/**
+ * Cancels a pending delayed work item, whether its delay has expired or
+ * not.  The callback may still be running when this function returns.
+ *
+ * @param dwork                 The delayed work item to cancel.
+ *
+ * @return                      0 if the work was pending and is canceled;
+ *                              SYS_ENOENT if the work was not pending.
+ */
+int workqueue_cancel_delayed(struct workqueue_delayed_work *dwork);
+
+/**
+ * Returns whether a delayed work item is waiting for its delay to expire or
+ * to be run.
+ */
+static inline bool
+workqueue_delayed_work_pending(struct workqueue_delayed_work *dwork)
+{
+    return os_callout_queued(&dwork->dw_callout) ||
+           OS_EVENT_QUEUED(&dwork->dw_callout.c_ev);
+}
+
+/**
+ * Waits until all work queued on a workqueue before this call has run.
+ * Must not be called from the worker task of the workqueue.
+ *
+ * @param wq                    The workqueue to flush.
+ * @param timeout               The maximum duration to wait, in OS ticks.
+ *
+ * @return                      0 on success;
+ *                              OS_TIMEOUT on timeout;
+ *                              SYS_EINVAL if called from the worker task.
+ */
+int workqueue_flush(struct workqueue *wq, os_time_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
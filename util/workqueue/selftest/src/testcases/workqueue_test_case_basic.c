@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "workqueue_test.h"
+
+static struct workqueue_work wtcb_work_block;
+static struct workqueue_work wtcb_work_a;
+static struct workqueue_work wtcb_work_b;
+static struct workqueue_work wtcb_work_c;
+static struct workqueue_work wtcb_work_flush;
+
+static int wtcb_flush_rc;
+
+static void
+wtcb_flush_self(struct os_event *ev)
+{
+    wtcb_flush_rc = workqueue_flush(ev->ev_arg, 0);
+}
+
+TEST_CASE_TASK(workqueue_test_case_basic)
+{
+    struct workqueue *hi;
+    struct workqueue *lo;
+    int rc;
+
+    workqueue_test_reset();
+
+    hi = workqueue_sys_get(0);
+    lo = workqueue_sys_get(1);
+    TEST_ASSERT_FATAL(hi != NULL && lo != NULL);
+    TEST_ASSERT(workqueue_sys_get(-1) == NULL);
+    TEST_ASSERT(workqueue_sys_get(MYNEWT_VAL(WORKQUEUE_SYS_COUNT)) == NULL);
+    TEST_ASSERT(hi->wq_task.t_prio < lo->wq_task.t_prio);
+
+    workqueue_work_init(&wtcb_work_block, workqueue_test_block, (void *)1);
+    workqueue_work_init(&wtcb_work_a, workqueue_test_record, (void *)2);
+    workqueue_work_init(&wtcb_work_b, workqueue_test_record, (void *)3);
+    workqueue_work_init(&wtcb_work_c, workqueue_test_record, (void *)4);
+
+    /* Workers outrank the test task; work runs as soon as it is submitted. */
+    rc = workqueue_submit(lo, &wtcb_work_block);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT_FATAL(workqueue_test_num_runs == 1);
+    TEST_ASSERT(!workqueue_work_pending(&wtcb_work_block));
+
+    /* The low priority worker is blocked; work queues up behind it. */
+    rc = workqueue_submit(lo, &wtcb_work_a);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(workqueue_work_pending(&wtcb_work_a));
+    rc = workqueue_submit(lo, &wtcb_work_a);
+    TEST_ASSERT(rc == SYS_EALREADY);
+
+    rc = workqueue_submit(lo, &wtcb_work_b);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT_FATAL(workqueue_test_num_runs == 1);
+
+    /* Cancel pending work. */
+    rc = workqueue_cancel(&wtcb_work_b);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(!workqueue_work_pending(&wtcb_work_b));
+    rc = workqueue_cancel(&wtcb_work_b);
+    TEST_ASSERT(rc == SYS_ENOENT);
+
+    /* The high priority worker is not held up by the blocked one. */
+    rc = workqueue_submit(hi, &wtcb_work_c);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT_FATAL(workqueue_test_num_runs == 2);
+
+    /* Flushing times out while the low priority worker is blocked. */
+    rc = workqueue_flush(lo, 1);
+    TEST_ASSERT(rc == OS_TIMEOUT);
+    TEST_ASSERT(workqueue_work_pending(&wtcb_work_a));
+
+    /* Unblock the low priority worker; the remaining work runs. */
+    os_sem_release(&workqueue_test_gate);
+    rc = workqueue_flush(lo, OS_TICKS_PER_SEC);
+    TEST_ASSERT(rc == 0);
+
+    TEST_ASSERT_FATAL(workqueue_test_num_runs == 3);
+    TEST_ASSERT(workqueue_test_runs[0] == 1);
+    TEST_ASSERT(workqueue_test_runs[1] == 4);
+    TEST_ASSERT(workqueue_test_runs[2] == 2);
+
+    /* Flushing a workqueue from its own worker would never complete. */
+    wtcb_flush_rc = 0;
+    workqueue_work_init(&wtcb_work_flush, wtcb_flush_self, hi);
+    rc = workqueue_submit(hi, &wtcb_work_flush);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(wtcb_flush_rc == SYS_EINVAL);
+}
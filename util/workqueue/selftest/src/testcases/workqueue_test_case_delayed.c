@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "workqueue_test.h"
+
+#define WTCD_DELAY_TICKS    10
+
+static struct workqueue_work wtcd_work_block;
+static struct workqueue_delayed_work wtcd_dwork;
+
+TEST_CASE_TASK(workqueue_test_case_delayed)
+{
+    struct workqueue *hi;
+    struct workqueue *lo;
+    int rc;
+
+    workqueue_test_reset();
+
+    hi = workqueue_sys_get(0);
+    lo = workqueue_sys_get(1);
+    TEST_ASSERT_FATAL(hi != NULL && lo != NULL);
+
+    workqueue_delayed_work_init(&wtcd_dwork, workqueue_test_record,
+                                (void *)1);
+
+    /* Delayed work runs once the delay has elapsed. */
+    rc = workqueue_submit_delayed(hi, &wtcd_dwork, WTCD_DELAY_TICKS);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(workqueue_delayed_work_pending(&wtcd_dwork));
+    rc = workqueue_submit_delayed(hi, &wtcd_dwork, WTCD_DELAY_TICKS);
+    TEST_ASSERT(rc == SYS_EALREADY);
+
+    os_time_delay(1);
+    TEST_ASSERT(workqueue_test_num_runs == 0);
+
+    os_time_delay(WTCD_DELAY_TICKS);
+    TEST_ASSERT_FATAL(workqueue_test_num_runs == 1);
+    TEST_ASSERT(!workqueue_delayed_work_pending(&wtcd_dwork));
+
+    /* Cancel before the delay has elapsed. */
+    rc = workqueue_submit_delayed(hi, &wtcd_dwork, WTCD_DELAY_TICKS);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = workqueue_cancel_delayed(&wtcd_dwork);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(!workqueue_delayed_work_pending(&wtcd_dwork));
+    rc = workqueue_cancel_delayed(&wtcd_dwork);
+    TEST_ASSERT(rc == SYS_ENOENT);
+
+    os_time_delay(WTCD_DELAY_TICKS + 1);
+    TEST_ASSERT(workqueue_test_num_runs == 1);
+
+    /* Without a delay, the work is queued right away. */
+    rc = workqueue_submit_delayed(hi, &wtcd_dwork, 0);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT_FATAL(workqueue_test_num_runs == 2);
+
+    /* Cancel after the delay has elapsed, while the worker is busy. */
+    workqueue_work_init(&wtcd_work_block, workqueue_test_block, (void *)2);
+    rc = workqueue_submit(lo, &wtcd_work_block);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT_FATAL(workqueue_test_num_runs == 3);
+
+    rc = workqueue_submit_delayed(lo, &wtcd_dwork, 1);
+    TEST_ASSERT_FATAL(rc == 0);
+    os_time_delay(2);
+    TEST_ASSERT(workqueue_delayed_work_pending(&wtcd_dwork));
+    rc = workqueue_cancel_delayed(&wtcd_dwork);
+    TEST_ASSERT(rc == 0);
+
+    os_sem_release(&workqueue_test_gate);
+    rc = workqueue_flush(lo, OS_TICKS_PER_SEC);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(workqueue_test_num_runs == 3);
+
+    /* Delays must fit in an os_stime_t. */
+    rc = workqueue_submit_delayed(hi, &wtcd_dwork, (os_time_t)INT32_MAX + 1);
+    TEST_ASSERT(rc == SYS_EINVAL);
+    TEST_ASSERT(!workqueue_delayed_work_pending(&wtcd_dwork));
+}
@@ -0,0 +1,66 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "workqueue_test.h"
+
+int workqueue_test_runs[WORKQUEUE_TEST_MAX_RUNS];
+int workqueue_test_num_runs;
+struct os_sem workqueue_test_gate;
+
+void
+workqueue_test_reset(void)
+{
+    int rc;
+
+    workqueue_test_num_runs = 0;
+
+    rc = os_sem_init(&workqueue_test_gate, 0);
+    TEST_ASSERT_FATAL(rc == 0);
+}
+
+void
+workqueue_test_record(struct os_event *ev)
+{
+    TEST_ASSERT_FATAL(workqueue_test_num_runs < WORKQUEUE_TEST_MAX_RUNS);
+    workqueue_test_runs[workqueue_test_num_runs++] = (intptr_t)ev->ev_arg;
+}
+
+void
+workqueue_test_block(struct os_event *ev)
+{
+    int rc;
+
+    workqueue_test_record(ev);
+
+    rc = os_sem_pend(&workqueue_test_gate, OS_TIMEOUT_NEVER);
+    TEST_ASSERT_FATAL(rc == 0);
+}
+
+TEST_SUITE(workqueue_test_suite)
+{
+    workqueue_test_case_basic();
+    workqueue_test_case_delayed();
+}
+
+int
+main(int argc, char **argv)
+{
+    workqueue_test_suite();
+    return tu_any_failed;
+}
@@ -0,0 +1,51 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_WORKQUEUE_TEST_H
+#define H_WORKQUEUE_TEST_H
+
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "workqueue/workqueue.h"
+
+#define WORKQUEUE_TEST_MAX_RUNS     16
+
+/** Values passed to workqueue_test_record(), in the order it was called. */
+extern int workqueue_test_runs[WORKQUEUE_TEST_MAX_RUNS];
+extern int workqueue_test_num_runs;
+
+/** Released to let workqueue_test_block() return. */
+extern struct os_sem workqueue_test_gate;
+
+void workqueue_test_reset(void);
+
+/** Work callback which records its argument, cast to int. */
+void workqueue_test_record(struct os_event *ev);
+
+/**
+ * Work callback which records its argument and then blocks its worker until
+ * workqueue_test_gate is released.
+ */
+void workqueue_test_block(struct os_event *ev);
+
+TEST_SUITE_DECL(workqueue_test_suite);
+TEST_CASE_DECL(workqueue_test_case_basic);
+TEST_CASE_DECL(workqueue_test_case_delayed);
+
+#endif
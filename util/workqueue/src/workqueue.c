@@ -0,0 +1,265 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "os/mynewt.h"
+#include "workqueue/workqueue.h"
+
+#define WORKQUEUE_SYS_COUNT     MYNEWT_VAL(WORKQUEUE_SYS_COUNT)
+
+#if WORKQUEUE_SYS_COUNT > 0
+#if MYNEWT_VAL(WORKQUEUE_SYS_PRIO) + WORKQUEUE_SYS_COUNT - 1 > OS_TASK_PRI_LOWEST
+#error "WORKQUEUE_SYS_PRIO + WORKQUEUE_SYS_COUNT exceeds the lowest task priority"
+#endif
+
+/** Represents a single system workqueue. */
+struct workqueue_sys_entry {
+    OS_TASK_STACK_DEFINE_NOSTATIC(stack, MYNEWT_VAL(WORKQUEUE_SYS_STACK_SIZE));
+    struct workqueue wq;
+    char name[sizeof "workqXX"];
+};
+
+static struct workqueue_sys_entry workqueue_sys[WORKQUEUE_SYS_COUNT];
+#endif
+
+/** Event queued by workqueue_flush() behind the work it waits for. */
+struct workqueue_barrier {
+    struct os_event ev;
+    struct os_sem sem;
+};
+
+static void
+workqueue_task_handler(void *arg)
+{
+    struct workqueue *wq;
+
+    wq = arg;
+
+    while (1) {
+        os_eventq_run(&wq->wq_evq);
+    }
+}
+
+int
+workqueue_init(struct workqueue *wq, const char *name, uint8_t prio,
+               os_stack_t *stack, uint16_t stack_size)
+{
+    os_eventq_init(&wq->wq_evq);
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    /*
+     * Statistics are best effort; workqueues beyond OS_EVENTQ_STATS_MAX
+     * event queues simply go without.
+     */
+    (void)os_eventq_stats_register(&wq->wq_evq, name);
+#endif
+
+    return os_task_init(&wq->wq_task, name, workqueue_task_handler, wq, prio,
+                        OS_WAIT_FOREVER, stack, stack_size);
+}
+
+struct workqueue *
+workqueue_sys_get(int idx)
+{
+#if WORKQUEUE_SYS_COUNT > 0
+    if (idx >= 0 && idx < WORKQUEUE_SYS_COUNT) {
+        return &workqueue_sys[idx].wq;
+    }
+#endif
+
+    return NULL;
+}
+
+void
+workqueue_work_init(struct workqueue_work *work, os_event_fn *fn, void *arg)
+{
+    memset(work, 0, sizeof *work);
+    work->ww_ev.ev_cb = fn;
+    work->ww_ev.ev_arg = arg;
+}
+
+int
+workqueue_submit(struct workqueue *wq, struct workqueue_work *work)
+{
+    /*
+     * If the work gets submitted again from an interrupt right after this
+     * check, the second os_eventq_put() has no effect.
+     */
+    if (OS_EVENT_QUEUED(&work->ww_ev)) {
+        return SYS_EALREADY;
+    }
+
+    work->ww_wq = wq;
+    os_eventq_put(&wq->wq_evq, &work->ww_ev);
+
+    return 0;
+}
+
+int
+workqueue_cancel(struct workqueue_work *work)
+{
+    os_sr_t sr;
+    int rc;
+
+    OS_ENTER_CRITICAL(sr);
+
+    if (OS_EVENT_QUEUED(&work->ww_ev)) {
+        os_eventq_remove(&work->ww_wq->wq_evq, &work->ww_ev);
+        rc = 0;
+    } else {
+        rc = SYS_ENOENT;
+    }
+
+    OS_EXIT_CRITICAL(sr);
+
+    return rc;
+}
+
+void
+workqueue_delayed_work_init(struct workqueue_delayed_work *dwork,
+                            os_event_fn *fn, void *arg)
+{
+    /* The event queue is filled in when the work is submitted. */
+    os_callout_init(&dwork->dw_callout, NULL, fn, arg);
+}
+
+int
+workqueue_submit_delayed(struct workqueue *wq,
+                         struct workqueue_delayed_work *dwork,
+                         os_time_t ticks)
+{
+    int rc;
+
+    if (workqueue_delayed_work_pending(dwork)) {
+        return SYS_EALREADY;
+    }
+
+    dwork->dw_callout.c_evq = &wq->wq_evq;
+
+    if (ticks == 0) {
+        /* A callout expires one tick late at the earliest; skip it. */
+        os_eventq_put(&wq->wq_evq, &dwork->dw_callout.c_ev);
+        return 0;
+    }
+
+    rc = os_callout_reset(&dwork->dw_callout, ticks);
+    if (rc != 0) {
+        return SYS_EINVAL;
+    }
+
+    return 0;
+}
+
+int
+workqueue_cancel_delayed(struct workqueue_delayed_work *dwork)
+{
+    os_sr_t sr;
+    int rc;
+
+    OS_ENTER_CRITICAL(sr);
+
+    if (workqueue_delayed_work_pending(dwork)) {
+        /* Removes the event from the workqueue too if it already expired. */
+        os_callout_stop(&dwork->dw_callout);
+        rc = 0;
+    } else {
+        rc = SYS_ENOENT;
+    }
+
+    OS_EXIT_CRITICAL(sr);
+
+    return rc;
+}
+
+static void
+workqueue_barrier_run(struct os_event *ev)
+{
+    struct workqueue_barrier *barrier;
+
+    barrier = ev->ev_arg;
+    os_sem_release(&barrier->sem);
+}
+
+int
+workqueue_flush(struct workqueue *wq, os_time_t timeout)
+{
+    struct workqueue_barrier barrier;
+    os_sr_t sr;
+    int queued;
+    int rc;
+
+    if (os_sched_get_current_task() == &wq->wq_task) {
+        return SYS_EINVAL;
+    }
+
+    memset(&barrier.ev, 0, sizeof barrier.ev);
+    barrier.ev.ev_cb = workqueue_barrier_run;
+    barrier.ev.ev_arg = &barrier;
+    os_sem_init(&barrier.sem, 0);
+
+    /*
+     * The barrier has the lowest event priority, so everything already
+     * queued runs before it.
+     */
+    os_eventq_put(&wq->wq_evq, &barrier.ev);
+
+    rc = os_sem_pend(&barrier.sem, timeout);
+    if (rc == OS_TIMEOUT) {
+        OS_ENTER_CRITICAL(sr);
+        queued = OS_EVENT_QUEUED(&barrier.ev);
+        os_eventq_remove(&wq->wq_evq, &barrier.ev);
+        OS_EXIT_CRITICAL(sr);
+
+        if (!queued) {
+            /*
+             * The worker has taken the barrier off the queue; it lives on
+             * this stack, so wait for the worker to be done with it.
+             */
+            os_sem_pend(&barrier.sem, OS_TIMEOUT_NEVER);
+            rc = 0;
+        }
+    }
+
+    return rc;
+}
+
+void
+workqueue_pkg_init(void)
+{
+#if WORKQUEUE_SYS_COUNT > 0
+    struct workqueue_sys_entry *entry;
+    int rc;
+    int i;
+
+    /* Ensure this function only gets called by sysinit. */
+    SYSINIT_ASSERT_ACTIVE();
+
+    for (i = 0; i < WORKQUEUE_SYS_COUNT; i++) {
+        entry = &workqueue_sys[i];
+        snprintf(entry->name, sizeof entry->name, "workq%d", i);
+
+        rc = workqueue_init(&entry->wq, entry->name,
+                            MYNEWT_VAL(WORKQUEUE_SYS_PRIO) + i, entry->stack,
+                            MYNEWT_VAL(WORKQUEUE_SYS_STACK_SIZE));
+        SYSINIT_PANIC_ASSERT(rc == 0);
+    }
+#endif
+}